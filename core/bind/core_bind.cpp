@@ -36,6 +36,7 @@
 #include "core/io/json.h"
 #include "core/io/marshalls.h"
 #include "core/math/geometry.h"
+#include "core/method_bind_ext.gen.inc"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
 #include "core/project_settings.h"
@@ -76,6 +77,26 @@ RES _ResourceLoader::load(const String &p_path, const String &p_type_hint, bool
 	return ret;
 }
 
+Error _ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint) {
+	return ResourceLoader::load_threaded_request(p_path, p_type_hint);
+}
+
+_ResourceLoader::ThreadLoadStatus _ResourceLoader::load_threaded_get_status(const String &p_path, Array r_progress) {
+	float progress = 0;
+	ThreadLoadStatus status = (ThreadLoadStatus)ResourceLoader::load_threaded_get_status(p_path, &progress);
+	r_progress.resize(1);
+	r_progress[0] = progress;
+	return status;
+}
+
+RES _ResourceLoader::load_threaded_get(const String &p_path) {
+	Error err = OK;
+	RES ret = ResourceLoader::load_threaded_get(p_path, &err);
+
+	ERR_FAIL_COND_V_MSG(err != OK, ret, "Error loading resource: '" + p_path + "'.");
+	return ret;
+}
+
 PoolVector<String> _ResourceLoader::get_recognized_extensions_for_type(const String &p_type) {
 	List<String> exts;
 	ResourceLoader::get_recognized_extensions_for_type(p_type, &exts);
@@ -122,6 +143,9 @@ bool _ResourceLoader::exists(const String &p_path, const String &p_type_hint) {
 void _ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("load_interactive", "path", "type_hint"), &_ResourceLoader::load_interactive, DEFVAL(""));
 	ClassDB::bind_method(D_METHOD("load", "path", "type_hint", "no_cache"), &_ResourceLoader::load, DEFVAL(""), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint"), &_ResourceLoader::load_threaded_request, DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("load_threaded_get_status", "path", "progress"), &_ResourceLoader::load_threaded_get_status, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("load_threaded_get", "path"), &_ResourceLoader::load_threaded_get);
 	ClassDB::bind_method(D_METHOD("get_recognized_extensions_for_type", "type"), &_ResourceLoader::get_recognized_extensions_for_type);
 	ClassDB::bind_method(D_METHOD("set_abort_on_missing_resources", "abort"), &_ResourceLoader::set_abort_on_missing_resources);
 	ClassDB::bind_method(D_METHOD("get_dependencies", "path"), &_ResourceLoader::get_dependencies);
@@ -130,6 +154,11 @@ void _ResourceLoader::_bind_methods() {
 #ifndef DISABLE_DEPRECATED
 	ClassDB::bind_method(D_METHOD("has", "path"), &_ResourceLoader::has);
 #endif // DISABLE_DEPRECATED
+
+	BIND_ENUM_CONSTANT(THREAD_LOAD_INVALID_RESOURCE);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_IN_PROGRESS);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_FAILED);
+	BIND_ENUM_CONSTANT(THREAD_LOAD_LOADED);
 }
 
 _ResourceLoader::_ResourceLoader() {
@@ -2753,6 +2782,66 @@ _Thread::~_Thread() {
 
 /////////////////////////////////////
 
+_ThreadWorkPool *_ThreadWorkPool::singleton = nullptr;
+
+int64_t _ThreadWorkPool::add_task(Object *p_instance, const StringName &p_method, const Variant &p_userdata, bool p_frame_task) {
+	ERR_FAIL_NULL_V(ThreadWorkPool::get_singleton(), ThreadWorkPool::INVALID_TASK_ID);
+	ERR_FAIL_COND_V(p_method == StringName(), ThreadWorkPool::INVALID_TASK_ID);
+	return ThreadWorkPool::get_singleton()->add_script_task(p_instance, p_method, p_userdata, p_frame_task);
+}
+
+bool _ThreadWorkPool::is_task_completed(int64_t p_task_id) const {
+	ERR_FAIL_NULL_V(ThreadWorkPool::get_singleton(), false);
+	return ThreadWorkPool::get_singleton()->is_task_completed(p_task_id);
+}
+
+void _ThreadWorkPool::wait_for_task_completion(int64_t p_task_id) {
+	ERR_FAIL_NULL(ThreadWorkPool::get_singleton());
+	ThreadWorkPool::get_singleton()->wait_for_task_completion(p_task_id);
+}
+
+int64_t _ThreadWorkPool::add_group_task(Object *p_instance, const StringName &p_method, int p_elements, const Variant &p_userdata, int p_chunk_size, int p_max_tasks, bool p_frame_task) {
+	ERR_FAIL_NULL_V(ThreadWorkPool::get_singleton(), ThreadWorkPool::INVALID_TASK_ID);
+	ERR_FAIL_COND_V(p_method == StringName(), ThreadWorkPool::INVALID_TASK_ID);
+	ERR_FAIL_COND_V(p_elements < 0 || p_chunk_size < 0 || p_max_tasks < 0, ThreadWorkPool::INVALID_TASK_ID);
+	return ThreadWorkPool::get_singleton()->add_script_group_task(p_instance, p_method, p_elements, p_userdata, p_chunk_size, p_max_tasks, p_frame_task);
+}
+
+bool _ThreadWorkPool::is_group_task_completed(int64_t p_group_id) const {
+	ERR_FAIL_NULL_V(ThreadWorkPool::get_singleton(), false);
+	return ThreadWorkPool::get_singleton()->is_group_task_completed(p_group_id);
+}
+
+int _ThreadWorkPool::get_group_processed_element_count(int64_t p_group_id) const {
+	ERR_FAIL_NULL_V(ThreadWorkPool::get_singleton(), 0);
+	return ThreadWorkPool::get_singleton()->get_group_processed_element_count(p_group_id);
+}
+
+void _ThreadWorkPool::wait_for_group_task_completion(int64_t p_group_id) {
+	ERR_FAIL_NULL(ThreadWorkPool::get_singleton());
+	ThreadWorkPool::get_singleton()->wait_for_group_task_completion(p_group_id);
+}
+
+int _ThreadWorkPool::get_thread_count() const {
+	ERR_FAIL_NULL_V(ThreadWorkPool::get_singleton(), 0);
+	return ThreadWorkPool::get_singleton()->get_thread_count();
+}
+
+void _ThreadWorkPool::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("add_task", "instance", "method", "userdata", "frame_task"), &_ThreadWorkPool::add_task, DEFVAL(Variant()), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("is_task_completed", "task_id"), &_ThreadWorkPool::is_task_completed);
+	ClassDB::bind_method(D_METHOD("wait_for_task_completion", "task_id"), &_ThreadWorkPool::wait_for_task_completion);
+
+	ClassDB::bind_method(D_METHOD("add_group_task", "instance", "method", "elements", "userdata", "chunk_size", "max_tasks", "frame_task"), &_ThreadWorkPool::add_group_task, DEFVAL(Variant()), DEFVAL(0), DEFVAL(0), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("is_group_task_completed", "group_id"), &_ThreadWorkPool::is_group_task_completed);
+	ClassDB::bind_method(D_METHOD("get_group_processed_element_count", "group_id"), &_ThreadWorkPool::get_group_processed_element_count);
+	ClassDB::bind_method(D_METHOD("wait_for_group_task_completion", "group_id"), &_ThreadWorkPool::wait_for_group_task_completion);
+
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &_ThreadWorkPool::get_thread_count);
+}
+
+/////////////////////////////////////
+
 PoolStringArray _ClassDB::get_class_list() const {
 	List<StringName> classes;
 	ClassDB::get_class_list(&classes);
@@ -40,6 +40,7 @@
 #include "core/os/os.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
+#include "core/os/thread_work_pool.h"
 #include "core/safe_refcount.h"
 
 class _ResourceLoader : public Object {
@@ -50,9 +51,19 @@ protected:
 	static _ResourceLoader *singleton;
 
 public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED,
+	};
+
 	static _ResourceLoader *get_singleton() { return singleton; }
 	Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "");
 	RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false);
+	Error load_threaded_request(const String &p_path, const String &p_type_hint = "");
+	ThreadLoadStatus load_threaded_get_status(const String &p_path, Array r_progress = Array());
+	RES load_threaded_get(const String &p_path);
 	PoolVector<String> get_recognized_extensions_for_type(const String &p_type);
 	void set_abort_on_missing_resources(bool p_abort);
 	PoolStringArray get_dependencies(const String &p_path);
@@ -65,6 +76,8 @@ public:
 	_ResourceLoader();
 };
 
+VARIANT_ENUM_CAST(_ResourceLoader::ThreadLoadStatus);
+
 class _ResourceSaver : public Object {
 	GDCLASS(_ResourceSaver, Object);
 
@@ -711,6 +724,32 @@ public:
 
 VARIANT_ENUM_CAST(_Thread::Priority);
 
+class _ThreadWorkPool : public Object {
+	GDCLASS(_ThreadWorkPool, Object);
+
+	static _ThreadWorkPool *singleton;
+
+protected:
+	static void _bind_methods();
+
+public:
+	static _ThreadWorkPool *get_singleton() { return singleton; }
+
+	int64_t add_task(Object *p_instance, const StringName &p_method, const Variant &p_userdata = Variant(), bool p_frame_task = false);
+	bool is_task_completed(int64_t p_task_id) const;
+	void wait_for_task_completion(int64_t p_task_id);
+
+	int64_t add_group_task(Object *p_instance, const StringName &p_method, int p_elements, const Variant &p_userdata = Variant(), int p_chunk_size = 0, int p_max_tasks = 0, bool p_frame_task = false);
+	bool is_group_task_completed(int64_t p_group_id) const;
+	int get_group_processed_element_count(int64_t p_group_id) const;
+	void wait_for_group_task_completion(int64_t p_group_id);
+
+	int get_thread_count() const;
+
+	_ThreadWorkPool() { singleton = this; }
+	~_ThreadWorkPool() { singleton = nullptr; }
+};
+
 class _ClassDB : public Object {
 	GDCLASS(_ClassDB, Object);
 
@@ -248,6 +248,7 @@ ClassDB::ClassInfo::ClassInfo() {
 	inherits_ptr = nullptr;
 	disabled = false;
 	exposed = false;
+	call_overridden = false;
 }
 
 ClassDB::ClassInfo::~ClassInfo() {
@@ -272,6 +273,13 @@ bool ClassDB::is_parent_class(const StringName &p_class, const StringName &p_inh
 	return _is_parent_class(p_class, p_inherits);
 }
 
+bool ClassDB::is_call_overridden(const StringName &p_class) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *ti = classes.getptr(p_class);
+	return !ti || ti->call_overridden;
+}
+
 void ClassDB::get_class_list(List<StringName> *p_classes) {
 	OBJTYPE_RLOCK;
 
@@ -519,6 +527,30 @@ Object *ClassDB::instance(const StringName &p_class) {
 #endif
 	return ti->creation_func();
 }
+ClassDB::InstanceFunc ClassDB::get_instance_func(const StringName &p_class, StringName *r_instanced_class) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *ti = classes.getptr(p_class);
+	if (!ti || ti->disabled || !ti->creation_func) {
+		if (compat_classes.has(p_class)) {
+			ti = classes.getptr(compat_classes[p_class]);
+		}
+	}
+	if (!ti || ti->disabled || !ti->creation_func) {
+		return nullptr;
+	}
+#ifdef TOOLS_ENABLED
+	if (ti->api == API_EDITOR && !Engine::get_singleton()->is_editor_hint()) {
+		return nullptr;
+	}
+#endif
+
+	if (r_instanced_class) {
+		*r_instanced_class = ti->name;
+	}
+	return ti->creation_func;
+}
+
 bool ClassDB::can_instance(const StringName &p_class) {
 	OBJTYPE_RLOCK;
 
@@ -532,7 +564,7 @@ bool ClassDB::can_instance(const StringName &p_class) {
 	return (!ti->disabled && ti->creation_func != nullptr);
 }
 
-void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherits) {
+void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherits, bool p_call_overridden) {
 	OBJTYPE_WLOCK;
 
 	const StringName &name = p_class;
@@ -544,6 +576,7 @@ void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherit
 	ti.name = name;
 	ti.inherits = p_inherits;
 	ti.api = current_api;
+	ti.call_overridden = p_call_overridden;
 
 	if (ti.inherits) {
 		ERR_FAIL_COND(!classes.has(ti.inherits)); //it MUST be registered.
@@ -982,38 +1015,24 @@ bool ClassDB::set_property(Object *p_object, const StringName &p_property, const
 	while (check) {
 		const PropertySetGet *psg = check->property_setget.getptr(p_property);
 		if (psg) {
-			if (!psg->setter) {
-				if (r_valid) {
-					*r_valid = false;
-				}
-				return true; //return true but do nothing
-			}
-
-			Variant::CallError ce;
+			call_property_setter(p_object, *psg, p_value, r_valid);
+			return true;
+		}
 
-			if (psg->index >= 0) {
-				Variant index = psg->index;
-				const Variant *arg[2] = { &index, &p_value };
-				//p_object->call(psg->setter,arg,2,ce);
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 2, ce);
-				} else {
-					p_object->call(psg->setter, arg, 2, ce);
-				}
+		check = check->inherits_ptr;
+	}
 
-			} else {
-				const Variant *arg[1] = { &p_value };
-				if (psg->_setptr) {
-					psg->_setptr->call(p_object, arg, 1, ce);
-				} else {
-					p_object->call(psg->setter, arg, 1, ce);
-				}
-			}
+	return false;
+}
 
-			if (r_valid) {
-				*r_valid = ce.error == Variant::CallError::CALL_OK;
-			}
+bool ClassDB::get_property_setget(const StringName &p_class, const StringName &p_property, PropertySetGet &r_setget) {
+	OBJTYPE_RLOCK;
 
+	ClassInfo *check = classes.getptr(p_class);
+	while (check) {
+		const PropertySetGet *psg = check->property_setget.getptr(p_property);
+		if (psg) {
+			r_setget = *psg;
 			return true;
 		}
 
@@ -1022,6 +1041,40 @@ bool ClassDB::set_property(Object *p_object, const StringName &p_property, const
 
 	return false;
 }
+
+void ClassDB::call_property_setter(Object *p_object, const PropertySetGet &p_setget, const Variant &p_value, bool *r_valid) {
+	if (!p_setget.setter) {
+		if (r_valid) {
+			*r_valid = false;
+		}
+		return; //do nothing
+	}
+
+	Variant::CallError ce;
+
+	if (p_setget.index >= 0) {
+		Variant index = p_setget.index;
+		const Variant *arg[2] = { &index, &p_value };
+		//p_object->call(p_setget.setter,arg,2,ce);
+		if (p_setget._setptr) {
+			p_setget._setptr->call(p_object, arg, 2, ce);
+		} else {
+			p_object->call(p_setget.setter, arg, 2, ce);
+		}
+
+	} else {
+		const Variant *arg[1] = { &p_value };
+		if (p_setget._setptr) {
+			p_setget._setptr->call(p_object, arg, 1, ce);
+		} else {
+			p_object->call(p_setget.setter, arg, 1, ce);
+		}
+	}
+
+	if (r_valid) {
+		*r_valid = ce.error == Variant::CallError::CALL_OK;
+	}
+}
 bool ClassDB::get_property(Object *p_object, const StringName &p_property, Variant &r_value) {
 	ERR_FAIL_NULL_V(p_object, false);
 
@@ -130,6 +130,7 @@ public:
 		StringName name;
 		bool disabled;
 		bool exposed;
+		bool call_overridden; // Object::call() is overridden, so any method may be handled outside of method_map
 		Object *(*creation_func)();
 		ClassInfo();
 		~ClassInfo();
@@ -153,7 +154,7 @@ public:
 
 	static APIType current_api;
 
-	static void _add_class2(const StringName &p_class, const StringName &p_inherits);
+	static void _add_class2(const StringName &p_class, const StringName &p_inherits, bool p_call_overridden);
 
 	static HashMap<StringName, HashMap<StringName, Variant>> default_values;
 	static Set<StringName> default_values_cached;
@@ -167,7 +168,7 @@ public:
 	// DO NOT USE THIS!!!!!! NEEDS TO BE PUBLIC BUT DO NOT USE NO MATTER WHAT!!!
 	template <class T>
 	static void _add_class() {
-		_add_class2(T::get_class_static(), T::get_parent_class_static());
+		_add_class2(T::get_class_static(), T::get_parent_class_static(), T::_class_overrides_call());
 	}
 
 	template <class T>
@@ -217,8 +218,14 @@ public:
 	static StringName get_parent_class(const StringName &p_class);
 	static bool class_exists(const StringName &p_class);
 	static bool is_parent_class(const StringName &p_class, const StringName &p_inherits);
+	static bool is_call_overridden(const StringName &p_class);
 	static bool can_instance(const StringName &p_class);
 	static Object *instance(const StringName &p_class);
+
+	typedef Object *(*InstanceFunc)();
+	// Returns the function instance() would use to create the class (and the class it creates), or null if it can't be
+	// instanced. Does not print errors. Lets callers instance the same class repeatedly without looking it up.
+	static InstanceFunc get_instance_func(const StringName &p_class, StringName *r_instanced_class = nullptr);
 	static APIType get_api_type(const StringName &p_class);
 
 	static uint64_t get_api_hash(APIType p_api);
@@ -337,6 +344,10 @@ public:
 	static void set_property_default_value(StringName p_class, const StringName &p_name, const Variant &p_default);
 	static void get_property_list(StringName p_class, List<PropertyInfo> *p_list, bool p_no_inheritance = false, const Object *p_validator = nullptr);
 	static bool set_property(Object *p_object, const StringName &p_property, const Variant &p_value, bool *r_valid = nullptr);
+	// Finds the setter set_property() would use for objects of the given class, so it can be called repeatedly with
+	// call_property_setter() without looking it up.
+	static bool get_property_setget(const StringName &p_class, const StringName &p_property, PropertySetGet &r_setget);
+	static void call_property_setter(Object *p_object, const PropertySetGet &p_setget, const Variant &p_value, bool *r_valid = nullptr);
 	static bool get_property(Object *p_object, const StringName &p_property, Variant &r_value);
 	static bool has_property(const StringName &p_class, const StringName &p_property, bool p_no_inheritance = false);
 	static int get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid = nullptr);
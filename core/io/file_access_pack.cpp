@@ -204,15 +204,47 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files);
 	};
 
-	f->close();
-	memdelete(f);
+	_map_pack(p_path, f);
 	return true;
 };
 
+void PackedSourcePCK::_map_pack(const String &p_path, FileAccess *p_file) {
+	// Only worth it when the address space is large enough to map whole packs.
+	if (sizeof(void *) < 8 || mapped_packs.has(p_path)) {
+		p_file->close();
+		memdelete(p_file);
+		return;
+	}
+
+	const uint8_t *data = p_file->map_contents();
+	if (!data) {
+		p_file->close();
+		memdelete(p_file);
+		return;
+	}
+
+	MappedPack mp;
+	mp.f = p_file;
+	mp.data = data;
+	mp.size = p_file->get_len();
+	mapped_packs[p_path] = mp;
+}
+
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
+	const Map<String, MappedPack>::Element *E = mapped_packs.find(p_file->pack);
+	if (E && p_file->offset + p_file->size <= E->get().size) {
+		return memnew(FileAccessPack(p_path, *p_file, E->get().data + p_file->offset));
+	}
 	return memnew(FileAccessPack(p_path, *p_file));
 };
 
+PackedSourcePCK::~PackedSourcePCK() {
+	for (Map<String, MappedPack>::Element *E = mapped_packs.front(); E; E = E->next()) {
+		E->get().f->close();
+		memdelete(E->get().f);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -221,11 +253,18 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 }
 
 void FileAccessPack::close() {
+	if (mapped) {
+		mapped = nullptr;
+		return;
+	}
 	f->close();
 }
 
 bool FileAccessPack::is_open() const {
-	return f->is_open();
+	if (mapped) {
+		return true;
+	}
+	return f && f->is_open();
 }
 
 void FileAccessPack::seek(uint64_t p_position) {
@@ -235,7 +274,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (!mapped) {
+		f->seek(pf.offset + p_position);
+	}
 	pos = p_position;
 }
 
@@ -261,6 +302,10 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (mapped) {
+		return mapped[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
@@ -278,19 +323,36 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
-	pos += p_length;
-
 	if (to_read <= 0) {
+		pos += p_length;
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+
+	if (mapped) {
+		memcpy(p_dst, mapped + pos, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
+	pos += p_length;
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_mapped_buffer(uint64_t p_length) const {
+	if (!mapped || eof || p_length > pf.size - pos) {
+		return nullptr;
+	}
+
+	const uint8_t *buffer = mapped + pos;
+	pos += p_length;
+	return buffer;
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f) {
+		f->set_endian_swap(p_swap);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -316,14 +378,21 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped) :
 		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		f(nullptr),
+		mapped(p_mapped) {
+	pos = 0;
+	eof = false;
+
+	if (mapped) {
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(!f, "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -131,9 +131,22 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	// Packs kept open and mapped in memory, so files can be read from them without copies.
+	struct MappedPack {
+		FileAccess *f;
+		const uint8_t *data;
+		uint64_t size;
+	};
+
+	Map<String, MappedPack> mapped_packs;
+
+	void _map_pack(const String &p_path, FileAccess *p_file);
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -143,6 +156,7 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *mapped; // start of the file in the mapped pack, f is not used when set
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -167,6 +181,8 @@ public:
 
 	virtual Error get_error() const;
 
+	virtual const uint8_t *get_mapped_buffer(uint64_t p_length) const;
+
 	virtual void flush();
 	virtual void store_8(uint8_t p_dest);
 
@@ -174,7 +190,7 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped = nullptr);
 	~FileAccessPack();
 };
 
@@ -381,11 +381,8 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 			uint32_t len = f->get_32();
 
 			PoolVector<uint8_t> array;
-			array.resize(len);
-			PoolVector<uint8_t>::Write w = array.write();
-			f->get_buffer(w.ptr(), len);
+			f->get_pool_buffer(array, len);
 			_advance_padding(len);
-			w.release();
 			r_v = array;
 
 		} break;
@@ -541,11 +538,8 @@ Error ResourceInteractiveLoaderBinary::parse_variant(Variant &r_v) {
 				uint32_t datalen = f->get_32();
 
 				PoolVector<uint8_t> imgdata;
-				imgdata.resize(datalen);
-				PoolVector<uint8_t>::Write w = imgdata.write();
-				f->get_buffer(w.ptr(), datalen);
+				f->get_pool_buffer(imgdata, datalen);
 				_advance_padding(datalen);
-				w.release();
 
 				Ref<Image> image;
 				image.instance();
@@ -135,6 +135,8 @@ public:
 	virtual Error import_group_file(const String &p_group_file, const Map<String, Map<StringName, Variant>> &p_source_file_options, const Map<String, String> &p_base_paths) { return ERR_UNAVAILABLE; }
 	virtual bool are_import_settings_valid(const String &p_path) const { return true; }
 	virtual String get_import_settings_string() const { return String(); }
+	// Importers returning true may run import() from several worker threads at once.
+	virtual bool can_import_threaded() const { return false; }
 };
 
 VARIANT_ENUM_CAST(ResourceImporter::ImportOrder);
@@ -510,6 +510,326 @@ Ref<ResourceInteractiveLoader> ResourceLoader::load_interactive(const String &p_
 	ERR_FAIL_V_MSG(Ref<ResourceInteractiveLoader>(), "No loader found for resource: " + path + ".");
 }
 
+String ResourceLoader::_localize_path(const String &p_path) {
+	if (p_path.is_rel_path()) {
+		return "res://" + p_path;
+	}
+	return ProjectSettings::get_singleton()->localize_path(p_path);
+}
+
+// Must be called with thread_load_mutex locked.
+ResourceLoader::ThreadLoadTask *ResourceLoader::_request_thread_load_task(const String &p_local_path, const String &p_type_hint, bool &r_created) {
+	ThreadLoadTask **taskptr = thread_load_tasks.getptr(p_local_path);
+	if (taskptr) {
+		r_created = false;
+		return *taskptr;
+	}
+
+	ThreadLoadTask *task = memnew(ThreadLoadTask);
+	task->local_path = p_local_path;
+	task->type_hint = p_type_hint;
+
+	RES cached = ResourceCache::get(p_local_path);
+	if (cached.is_valid()) {
+		task->resource = cached;
+		task->status = THREAD_LOAD_LOADED;
+	}
+
+	thread_load_tasks[p_local_path] = task;
+	r_created = task->status == THREAD_LOAD_IN_PROGRESS;
+	return task;
+}
+
+// Whether p_task waits, directly or not, for p_dependency to be loaded.
+bool ResourceLoader::_thread_load_depends_on(const ThreadLoadTask *p_task, const ThreadLoadTask *p_dependency) {
+	if (p_task == p_dependency) {
+		return true;
+	}
+	for (uint32_t i = 0; i < p_task->dependencies.size(); i++) {
+		const ThreadLoadTask *dependency = p_task->dependencies[i];
+		if (dependency->status == THREAD_LOAD_IN_PROGRESS && _thread_load_depends_on(dependency, p_dependency)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+float ResourceLoader::_get_thread_load_progress(const ThreadLoadTask *p_task) {
+	if (p_task->status != THREAD_LOAD_IN_PROGRESS) {
+		return 1.0;
+	}
+
+	// The resource itself counts as one more dependency, loaded last.
+	float progress = 0;
+	for (uint32_t i = 0; i < p_task->dependencies.size(); i++) {
+		progress += _get_thread_load_progress(p_task->dependencies[i]);
+	}
+	return progress / (p_task->dependencies.size() + 1);
+}
+
+// Must be called with thread_load_mutex locked, adds the task to r_freed if nothing uses it anymore.
+void ResourceLoader::_release_thread_load_task(ThreadLoadTask *p_task, LocalVector<ThreadLoadTask *> &r_freed) {
+	if (p_task->requests > 0 || p_task->getters > 0 || p_task->dependents > 0 || p_task->status == THREAD_LOAD_IN_PROGRESS) {
+		return;
+	}
+
+	thread_load_tasks.erase(p_task->local_path);
+	for (uint32_t i = 0; i < p_task->dependencies.size(); i++) {
+		p_task->dependencies[i]->dependents--;
+		_release_thread_load_task(p_task->dependencies[i], r_freed);
+	}
+	p_task->dependencies.clear();
+	r_freed.push_back(p_task);
+}
+
+void ResourceLoader::_post_thread_load_tasks(void (*p_func)(void *), const LocalVector<ThreadLoadTask *> &p_tasks) {
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	for (uint32_t i = 0; i < p_tasks.size(); i++) {
+		if (!pool) {
+			p_func(p_tasks[i]);
+			continue;
+		}
+
+		// Without worker threads, the task runs right away (and may post more tasks).
+		ThreadWorkPool::TaskID id = pool->add_native_task(p_func, p_tasks[i]);
+		MutexLock lock(thread_load_mutex);
+		thread_load_pool_tasks.push_back(id);
+	}
+}
+
+// Worker pool tasks must all be waited on, which is done once they are completed (or at exit).
+void ResourceLoader::_reap_thread_load_pool_tasks(bool p_wait_all) {
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+
+	while (true) {
+		LocalVector<ThreadWorkPool::TaskID> ids;
+		thread_load_mutex.lock();
+		SWAP(ids, thread_load_pool_tasks);
+		thread_load_mutex.unlock();
+
+		if (ids.empty()) {
+			return;
+		}
+
+		LocalVector<ThreadWorkPool::TaskID> pending;
+		for (uint32_t i = 0; i < ids.size(); i++) {
+			if (p_wait_all || pool->is_task_completed(ids[i])) {
+				pool->wait_for_task_completion(ids[i]);
+			} else {
+				pending.push_back(ids[i]);
+			}
+		}
+
+		thread_load_mutex.lock();
+		for (uint32_t i = 0; i < pending.size(); i++) {
+			thread_load_pool_tasks.push_back(pending[i]);
+		}
+		thread_load_mutex.unlock();
+
+		if (!p_wait_all) {
+			return;
+		}
+		// Otherwise the tasks waited on may have posted more.
+	}
+}
+
+void ResourceLoader::_thread_load_scan(void *p_task) {
+	ThreadLoadTask *task = (ThreadLoadTask *)p_task;
+
+	// The dependencies are listed as "path::type".
+	List<String> dependencies;
+	get_dependencies(task->local_path, &dependencies, true);
+
+	LocalVector<ThreadLoadTask *> created;
+	bool ready;
+	{
+		MutexLock lock(thread_load_mutex);
+
+		for (List<String>::Element *E = dependencies.front(); E; E = E->next()) {
+			String path = _localize_path(E->get().get_slice("::", 0));
+			String type = E->get().get_slice_count("::") > 1 ? E->get().get_slice("::", 1) : String();
+			if (path == task->local_path || (ResourceCache::has(path) && !thread_load_tasks.has(path))) {
+				continue;
+			}
+
+			bool was_created;
+			ThreadLoadTask *dependency = _request_thread_load_task(path, type, was_created);
+			if (was_created) {
+				created.push_back(dependency);
+			}
+
+			if (dependency->status == THREAD_LOAD_IN_PROGRESS) {
+				if (_thread_load_depends_on(dependency, task)) {
+					continue; // Cyclic, left to the regular load of the resource to report.
+				}
+				dependency->dependent_tasks.push_back(task);
+				task->pending_dependencies++;
+			}
+			// Loaded dependencies are kept too, so their resources stay cached until this one is loaded.
+			dependency->dependents++;
+			task->dependencies.push_back(dependency);
+		}
+
+		ready = task->pending_dependencies == 0;
+	}
+
+	_post_thread_load_tasks(_thread_load_scan, created);
+
+	if (ready) {
+		_thread_load_run(task);
+	}
+	// Otherwise the last dependency loaded runs this task.
+}
+
+void ResourceLoader::_thread_load_run(void *p_task) {
+	ThreadLoadTask *task = (ThreadLoadTask *)p_task;
+
+	Error err = OK;
+	RES resource = load(task->local_path, task->type_hint, false, &err);
+
+	LocalVector<ThreadLoadTask *> ready;
+	LocalVector<ThreadLoadTask *> freed;
+	{
+		MutexLock lock(thread_load_mutex);
+
+		task->resource = resource;
+		task->error = resource.is_valid() ? OK : (err != OK ? err : FAILED);
+		task->status = resource.is_valid() ? THREAD_LOAD_LOADED : THREAD_LOAD_FAILED;
+
+		for (uint32_t i = 0; i < task->dependent_tasks.size(); i++) {
+			ThreadLoadTask *dependent = task->dependent_tasks[i];
+			dependent->pending_dependencies--;
+			if (dependent->pending_dependencies == 0) {
+				ready.push_back(dependent);
+			}
+		}
+		task->dependent_tasks.clear();
+
+		// The dependencies were only kept for this load.
+		for (uint32_t i = 0; i < task->dependencies.size(); i++) {
+			task->dependencies[i]->dependents--;
+			_release_thread_load_task(task->dependencies[i], freed);
+		}
+		task->dependencies.clear();
+
+		for (int i = 0; i < task->waiting_threads; i++) {
+			task->completed.post();
+		}
+		task->waiting_threads = 0;
+
+		_release_thread_load_task(task, freed);
+		// The task can be freed by another thread from now on.
+	}
+
+	for (uint32_t i = 0; i < freed.size(); i++) {
+		memdelete(freed[i]);
+	}
+
+	// Load the dependent resources on other threads too, running the last one here.
+	if (ready.size()) {
+		ThreadLoadTask *last = ready[ready.size() - 1];
+		ready.resize(ready.size() - 1);
+		_post_thread_load_tasks(_thread_load_run, ready);
+		_thread_load_run(last);
+	}
+}
+
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint) {
+	String local_path = _localize_path(p_path);
+	ERR_FAIL_COND_V_MSG(!exists(local_path, p_type_hint), ERR_FILE_NOT_FOUND, "Resource file not found: " + local_path + ".");
+
+	_reap_thread_load_pool_tasks(false);
+
+	bool created;
+	ThreadLoadTask *task;
+	{
+		MutexLock lock(thread_load_mutex);
+		task = _request_thread_load_task(local_path, p_type_hint, created);
+		task->requests++;
+	}
+
+	if (created) {
+		LocalVector<ThreadLoadTask *> tasks;
+		tasks.push_back(task);
+		_post_thread_load_tasks(_thread_load_scan, tasks);
+	}
+
+	return OK;
+}
+
+ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path, float *r_progress) {
+	String local_path = _localize_path(p_path);
+
+	MutexLock lock(thread_load_mutex);
+
+	ThreadLoadTask **taskptr = thread_load_tasks.getptr(local_path);
+	if (!taskptr || (*taskptr)->requests == 0) {
+		return THREAD_LOAD_INVALID_RESOURCE;
+	}
+
+	if (r_progress) {
+		*r_progress = _get_thread_load_progress(*taskptr);
+	}
+	return (*taskptr)->status;
+}
+
+RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
+	if (r_error) {
+		*r_error = ERR_INVALID_PARAMETER;
+	}
+
+	String local_path = _localize_path(p_path);
+
+	RES resource;
+	LocalVector<ThreadLoadTask *> freed;
+	{
+		MutexLock lock(thread_load_mutex);
+
+		ThreadLoadTask **taskptr = thread_load_tasks.getptr(local_path);
+		ERR_FAIL_COND_V_MSG(!taskptr || (*taskptr)->requests == 0, RES(), "Attempted to get a resource not requested with load_threaded_request(): " + local_path + ".");
+		ThreadLoadTask *task = *taskptr;
+		task->requests--;
+		task->getters++;
+
+		while (task->status == THREAD_LOAD_IN_PROGRESS) {
+			task->waiting_threads++;
+			thread_load_mutex.unlock();
+			task->completed.wait();
+			thread_load_mutex.lock();
+		}
+
+		resource = task->resource;
+		if (r_error) {
+			*r_error = task->error;
+		}
+
+		task->getters--;
+		_release_thread_load_task(task, freed);
+	}
+
+	for (uint32_t i = 0; i < freed.size(); i++) {
+		memdelete(freed[i]);
+	}
+
+	_reap_thread_load_pool_tasks(false);
+
+	return resource;
+}
+
+// Waits for the background loads in progress and frees them, must be called before the loaders are removed.
+void ResourceLoader::clear_thread_load_tasks() {
+	if (ThreadWorkPool::get_singleton()) {
+		_reap_thread_load_pool_tasks(true);
+	}
+
+	MutexLock lock(thread_load_mutex);
+	const String *K = nullptr;
+	while ((K = thread_load_tasks.next(K))) {
+		memdelete(thread_load_tasks[*K]);
+	}
+	thread_load_tasks.clear();
+}
+
 void ResourceLoader::add_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader, bool p_at_front) {
 	ERR_FAIL_COND(p_format_loader.is_null());
 	ERR_FAIL_COND(loader_count >= MAX_LOADERS);
@@ -966,6 +1286,10 @@ void ResourceLoader::remove_custom_loaders() {
 }
 
 Mutex ResourceLoader::loading_map_mutex;
+
+Mutex ResourceLoader::thread_load_mutex;
+HashMap<String, ResourceLoader::ThreadLoadTask *> ResourceLoader::thread_load_tasks;
+LocalVector<ThreadWorkPool::TaskID> ResourceLoader::thread_load_pool_tasks;
 HashMap<ResourceLoader::LoadingMapKey, int, ResourceLoader::LoadingMapKeyHasher> ResourceLoader::loading_map;
 
 void ResourceLoader::finalize() {
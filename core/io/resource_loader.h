@@ -31,7 +31,10 @@
 #ifndef RESOURCE_LOADER_H
 #define RESOURCE_LOADER_H
 
+#include "core/local_vector.h"
+#include "core/os/semaphore.h"
 #include "core/os/thread.h"
+#include "core/os/thread_work_pool.h"
 #include "core/resource.h"
 
 class ResourceInteractiveLoader : public Reference {
@@ -88,6 +91,15 @@ typedef Error (*ResourceLoaderImport)(const String &p_path);
 typedef void (*ResourceLoadedCallback)(RES p_resource, const String &p_path);
 
 class ResourceLoader {
+public:
+	enum ThreadLoadStatus {
+		THREAD_LOAD_INVALID_RESOURCE,
+		THREAD_LOAD_IN_PROGRESS,
+		THREAD_LOAD_FAILED,
+		THREAD_LOAD_LOADED,
+	};
+
+private:
 	enum {
 		MAX_LOADERS = 64
 	};
@@ -137,11 +149,48 @@ class ResourceLoader {
 	static void _remove_from_loading_map(const String &p_path);
 	static void _remove_from_loading_map_and_thread(const String &p_path, Thread::ID p_thread);
 
+	// Background load of a path, see load_threaded_request(). Its dependencies are loaded by tasks of their
+	// own, which run in parallel on the worker pool, and the path itself is loaded once they are all done.
+	struct ThreadLoadTask {
+		String local_path;
+		String type_hint;
+		ThreadLoadStatus status = THREAD_LOAD_IN_PROGRESS;
+		Error error = OK;
+		RES resource;
+		int requests = 0; // load_threaded_request() calls not yet matched by load_threaded_get()
+		int dependents = 0; // tasks in dependent_tasks, or keeping this one in their dependencies
+		int pending_dependencies = 0;
+		LocalVector<ThreadLoadTask *> dependencies; // kept (as well as their resources) until loaded
+		LocalVector<ThreadLoadTask *> dependent_tasks; // waiting for this one to be loaded
+		int getters = 0; // load_threaded_get() calls in progress
+		int waiting_threads = 0;
+		Semaphore completed;
+	};
+
+	static Mutex thread_load_mutex;
+	static HashMap<String, ThreadLoadTask *> thread_load_tasks;
+	static LocalVector<ThreadWorkPool::TaskID> thread_load_pool_tasks; // waited on once completed
+
+	static String _localize_path(const String &p_path);
+	static ThreadLoadTask *_request_thread_load_task(const String &p_local_path, const String &p_type_hint, bool &r_created);
+	static bool _thread_load_depends_on(const ThreadLoadTask *p_task, const ThreadLoadTask *p_dependency);
+	static float _get_thread_load_progress(const ThreadLoadTask *p_task);
+	static void _release_thread_load_task(ThreadLoadTask *p_task, LocalVector<ThreadLoadTask *> &r_freed);
+	static void _post_thread_load_tasks(void (*p_func)(void *), const LocalVector<ThreadLoadTask *> &p_tasks);
+	static void _reap_thread_load_pool_tasks(bool p_wait_all);
+	static void _thread_load_scan(void *p_task);
+	static void _thread_load_run(void *p_task);
+
 public:
 	static Ref<ResourceInteractiveLoader> load_interactive(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = nullptr);
 	static RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = nullptr);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
 
+	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "");
+	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = nullptr);
+	static RES load_threaded_get(const String &p_path, Error *r_error = nullptr);
+	static void clear_thread_load_tasks();
+
 	static void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions);
 	static void add_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader, bool p_at_front = false);
 	static void remove_resource_format_loader(Ref<ResourceFormatLoader> p_format_loader);
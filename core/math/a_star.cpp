@@ -32,6 +32,7 @@
 
 #include "core/math/geometry.h"
 #include "core/script_language.h"
+#include "core/sort_array.h"
 #include "scene/scene_string_names.h"
 
 int AStar::get_available_point_id() const {
@@ -62,11 +63,16 @@ void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 		pt->open_pass = 0;
 		pt->closed_pass = 0;
 		pt->enabled = true;
+		pt->cluster = nullptr;
+		pt->entrance_index = -1;
 		points.set(p_id, pt);
+		_update_point_cluster(pt);
 	} else {
 		found_pt->pos = p_pos;
 		found_pt->weight_scale = p_weight_scale;
+		_update_point_cluster(found_pt);
 	}
+	version++;
 }
 
 Vector3 AStar::get_point_position(int p_id) const {
@@ -83,6 +89,8 @@ void AStar::set_point_position(int p_id, const Vector3 &p_pos) {
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set point's position. Point with id: %d doesn't exist.", p_id));
 
 	p->pos = p_pos;
+	_update_point_cluster(p);
+	version++;
 }
 
 real_t AStar::get_point_weight_scale(int p_id) const {
@@ -100,6 +108,8 @@ void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND_MSG(p_weight_scale < 1, vformat("Can't set point's weight scale less than one: %f.", p_weight_scale));
 
 	p->weight_scale = p_weight_scale;
+	_mark_cluster_dirty(p->cluster);
+	version++;
 }
 
 void AStar::remove_point(int p_id) {
@@ -107,6 +117,14 @@ void AStar::remove_point(int p_id) {
 	bool p_exists = points.lookup(p_id, p);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't remove point. Point with id: %d doesn't exist.", p_id));
 
+	_mark_neighbour_clusters_dirty(p);
+	_remove_point_from_cluster(p);
+	FlowField *field;
+	if (flow_fields.lookup(p_id, field)) {
+		memdelete(field);
+		flow_fields.remove(p_id);
+	}
+
 	for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
 		Segment s(p_id, (*it.key));
 		segments.erase(s);
@@ -126,6 +144,7 @@ void AStar::remove_point(int p_id) {
 	memdelete(p);
 	points.remove(p_id);
 	last_free_id = p_id;
+	version++;
 }
 
 void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
@@ -164,6 +183,10 @@ void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 	}
 
 	segments.insert(s);
+
+	_mark_cluster_dirty(a->cluster);
+	_mark_cluster_dirty(b->cluster);
+	version++;
 }
 
 void AStar::disconnect_points(int p_id, int p_with_id, bool bidirectional) {
@@ -203,6 +226,10 @@ void AStar::disconnect_points(int p_id, int p_with_id, bool bidirectional) {
 		if (s.direction != Segment::NONE) {
 			segments.insert(s);
 		}
+
+		_mark_cluster_dirty(a->cluster);
+		_mark_cluster_dirty(b->cluster);
+		version++;
 	}
 }
 
@@ -244,11 +271,14 @@ bool AStar::are_points_connected(int p_id, int p_with_id, bool bidirectional) co
 
 void AStar::clear() {
 	last_free_id = 0;
+	_clear_clusters();
+	clear_destination_caches();
 	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
 		memdelete(*(it.value));
 	}
 	segments.clear();
 	points.clear();
+	version++;
 }
 
 int AStar::get_point_count() const {
@@ -428,6 +458,13 @@ PoolVector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
+	FlowField *field;
+	if (flow_fields.lookup(p_to_id, field)) {
+		LocalVector<Point *> route;
+		_get_flow_field_route(this, a, b, field, route);
+		return _get_route_positions(route);
+	}
+
 	Point *begin_point = a;
 	Point *end_point = b;
 
@@ -477,6 +514,13 @@ PoolVector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
+	FlowField *field;
+	if (flow_fields.lookup(p_to_id, field)) {
+		LocalVector<Point *> route;
+		_get_flow_field_route(this, a, b, field, route);
+		return _get_route_ids(route);
+	}
+
 	Point *begin_point = a;
 	Point *end_point = b;
 
@@ -517,6 +561,8 @@ void AStar::set_point_disabled(int p_id, bool p_disabled) {
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set if point is disabled. Point with id: %d doesn't exist.", p_id));
 
 	p->enabled = !p_disabled;
+	_mark_cluster_dirty(p->cluster);
+	version++;
 }
 
 bool AStar::is_point_disabled(int p_id) const {
@@ -527,6 +573,714 @@ bool AStar::is_point_disabled(int p_id) const {
 	return !p->enabled;
 }
 
+PoolVector<int> AStar::_get_route_ids(const LocalVector<Point *> &p_route) {
+	PoolVector<int> path;
+	path.resize(p_route.size());
+
+	PoolVector<int>::Write w = path.write();
+	for (uint32_t i = 0; i < p_route.size(); i++) {
+		w[i] = p_route[i]->id;
+	}
+
+	return path;
+}
+
+PoolVector<Vector3> AStar::_get_route_positions(const LocalVector<Point *> &p_route) {
+	PoolVector<Vector3> path;
+	path.resize(p_route.size());
+
+	PoolVector<Vector3>::Write w = path.write();
+	for (uint32_t i = 0; i < p_route.size(); i++) {
+		w[i] = p_route[i]->pos;
+	}
+
+	return path;
+}
+
+// Dijkstra search from p_source, leaving g_score and prev_point on every point it closes.
+// When p_reverse is set, connections are followed backwards so g_score is the cost to reach p_source.
+// p_cluster restricts the search to a single cluster, p_target stops it once that point is closed.
+template <class C>
+void AStar::_search(C *p_costs, Point *p_source, Point *p_target, Cluster *p_cluster, bool p_reverse, LocalVector<Point *> *r_reached) {
+	pass++;
+
+	LocalVector<SearchEntry> open_list;
+	SortArray<SearchEntry, SortSearchEntries> sorter;
+
+	p_source->g_score = 0;
+	p_source->prev_point = nullptr;
+	p_source->open_pass = pass;
+
+	SearchEntry entry;
+	entry.point = p_source;
+	entry.g_score = 0;
+	open_list.push_back(entry);
+
+	while (!open_list.empty()) {
+		Point *p = open_list[0].point;
+		real_t g_score = open_list[0].g_score;
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.resize(open_list.size() - 1);
+
+		if (p->closed_pass == pass || g_score > p->g_score) {
+			continue; // Outdated entry, the point was reached through a shorter path since.
+		}
+		p->closed_pass = pass;
+
+		if (r_reached) {
+			r_reached->push_back(p);
+		}
+		if (p == p_target) {
+			break;
+		}
+		if (p_reverse && p != p_source && !p->enabled) {
+			continue; // A disabled point can only begin a path.
+		}
+
+		// Going backwards, the points linking to this one are either bidirectional neighbours or unlinked ones.
+		int connection_lists = p_reverse ? 2 : 1;
+		for (int i = 0; i < connection_lists; i++) {
+			const OAHashMap<int, Point *> &connections = i == 0 ? p->neighbours : p->unlinked_neighbours;
+
+			for (OAHashMap<int, Point *>::Iterator it = connections.iter(); it.valid; it = connections.next_iter(it)) {
+				Point *e = *(it.value);
+
+				if (e->closed_pass == pass || (p_cluster && e->cluster != p_cluster)) {
+					continue;
+				}
+
+				real_t cost;
+				if (p_reverse) {
+					if (i == 0 && !e->neighbours.has(p->id)) {
+						continue; // Not connected towards this point.
+					}
+					cost = p_costs->_compute_cost(e->id, p->id) * p->weight_scale;
+				} else {
+					if (!e->enabled) {
+						continue;
+					}
+					cost = p_costs->_compute_cost(p->id, e->id) * e->weight_scale;
+				}
+
+				real_t tentative_g_score = p->g_score + cost;
+				if (e->open_pass == pass && tentative_g_score >= e->g_score) {
+					continue;
+				}
+
+				e->open_pass = pass;
+				e->g_score = tentative_g_score;
+				e->prev_point = p;
+
+				entry.point = e;
+				entry.g_score = tentative_g_score;
+				open_list.push_back(entry);
+				sorter.push_heap(0, open_list.size() - 1, 0, entry, open_list.ptr());
+			}
+		}
+	}
+}
+
+template <class C>
+bool AStar::_get_flow_field_route(C *p_costs, Point *p_begin_point, Point *p_end_point, FlowField *p_field, LocalVector<Point *> &r_route) {
+	if (p_field->version != version) {
+		p_field->next.clear();
+
+		if (p_end_point->enabled) {
+			LocalVector<Point *> reached;
+			_search(p_costs, p_end_point, nullptr, nullptr, true, &reached);
+
+			// Growing the map one point at a time is very slow with consecutive ids.
+			uint32_t capacity = next_power_of_2(reached.size() * 2);
+			if (p_field->next.get_capacity() < capacity) {
+				p_field->next.reserve(capacity);
+			}
+
+			for (uint32_t i = 1; i < reached.size(); i++) {
+				p_field->next.set(reached[i]->id, reached[i]->prev_point);
+			}
+		}
+
+		p_field->version = version;
+	}
+
+	Point *p = p_begin_point;
+	r_route.push_back(p);
+
+	while (p != p_end_point) {
+		if (!p_field->next.lookup(p->id, p)) {
+			r_route.clear();
+			return false; // The destination can't be reached from this point.
+		}
+		r_route.push_back(p);
+	}
+
+	return true;
+}
+
+uint64_t AStar::_get_cluster_key(const Vector3 &p_pos) const {
+	uint64_t x = (uint64_t)(int64_t)Math::floor(p_pos.x / hierarchy_cell_size) & 0x1FFFFF;
+	uint64_t y = (uint64_t)(int64_t)Math::floor(p_pos.y / hierarchy_cell_size) & 0x1FFFFF;
+	uint64_t z = (uint64_t)(int64_t)Math::floor(p_pos.z / hierarchy_cell_size) & 0x1FFFFF;
+	return (x << 42) | (y << 21) | z;
+}
+
+void AStar::_mark_cluster_dirty(Cluster *p_cluster) {
+	if (p_cluster && !p_cluster->dirty) {
+		p_cluster->dirty = true;
+		dirty_clusters.push_back(p_cluster);
+	}
+}
+
+void AStar::_mark_neighbour_clusters_dirty(Point *p_point) {
+	if (!p_point->cluster) {
+		return;
+	}
+
+	for (OAHashMap<int, Point *>::Iterator it = p_point->neighbours.iter(); it.valid; it = p_point->neighbours.next_iter(it)) {
+		_mark_cluster_dirty((*it.value)->cluster);
+	}
+	for (OAHashMap<int, Point *>::Iterator it = p_point->unlinked_neighbours.iter(); it.valid; it = p_point->unlinked_neighbours.next_iter(it)) {
+		_mark_cluster_dirty((*it.value)->cluster);
+	}
+}
+
+void AStar::_update_point_cluster(Point *p_point) {
+	if (hierarchy_cell_size <= 0) {
+		return;
+	}
+
+	uint64_t key = _get_cluster_key(p_point->pos);
+	if (p_point->cluster && p_point->cluster->key == key) {
+		_mark_cluster_dirty(p_point->cluster);
+		return;
+	}
+
+	_remove_point_from_cluster(p_point);
+
+	Cluster *cluster;
+	if (!clusters.lookup(key, cluster)) {
+		cluster = memnew(Cluster);
+		cluster->key = key;
+		cluster->dirty = false;
+		clusters.set(key, cluster);
+	}
+
+	cluster->points.push_back(p_point);
+	p_point->cluster = cluster;
+	_mark_cluster_dirty(cluster);
+
+	// The connections of the point may cross clusters now, or not anymore.
+	_mark_neighbour_clusters_dirty(p_point);
+}
+
+void AStar::_remove_point_from_cluster(Point *p_point) {
+	if (!p_point->cluster) {
+		return;
+	}
+
+	p_point->cluster->points.erase(p_point);
+	_mark_cluster_dirty(p_point->cluster);
+	p_point->cluster = nullptr;
+	p_point->entrance_index = -1;
+}
+
+void AStar::_clear_clusters() {
+	for (OAHashMap<uint64_t, Cluster *>::Iterator it = clusters.iter(); it.valid; it = clusters.next_iter(it)) {
+		memdelete(*(it.value));
+	}
+	clusters.clear();
+	dirty_clusters.clear();
+
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		(*it.value)->cluster = nullptr;
+		(*it.value)->entrance_index = -1;
+	}
+}
+
+bool AStar::_are_points_linked(const Point *p_a, const Point *p_b) {
+	return p_a == p_b || (p_a->neighbours.has(p_b->id) && p_b->neighbours.has(p_a->id));
+}
+
+void AStar::_update_cluster_entrances(Cluster *p_cluster) {
+	for (uint32_t i = 0; i < p_cluster->points.size(); i++) {
+		p_cluster->points[i]->entrance_index = -1;
+	}
+	p_cluster->entrances.clear();
+
+	// Every connection between two enabled points of different clusters is a possible transition.
+	LocalVector<Transition> transitions;
+	for (uint32_t i = 0; i < p_cluster->points.size(); i++) {
+		Point *p = p_cluster->points[i];
+		if (!p->enabled) {
+			continue;
+		}
+
+		for (int j = 0; j < 2; j++) {
+			const OAHashMap<int, Point *> &connections = j == 0 ? p->neighbours : p->unlinked_neighbours;
+			for (OAHashMap<int, Point *>::Iterator it = connections.iter(); it.valid; it = connections.next_iter(it)) {
+				Point *n = *(it.value);
+				if (!n->enabled || !n->cluster || n->cluster == p_cluster) {
+					continue;
+				}
+
+				Transition t;
+				t.point = p;
+				t.cluster_key = n->cluster->key;
+				int direction = (j == 0 ? Segment::FORWARD : 0) | (n->neighbours.has(p->id) ? Segment::BACKWARD : 0);
+				if (p_cluster->key < n->cluster->key) {
+					t.a = p;
+					t.b = n;
+					t.direction = direction;
+				} else {
+					t.a = n;
+					t.b = p;
+					t.direction = ((direction & Segment::FORWARD) ? Segment::BACKWARD : 0) | ((direction & Segment::BACKWARD) ? Segment::FORWARD : 0);
+				}
+				transitions.push_back(t);
+			}
+		}
+	}
+
+	if (transitions.empty()) {
+		return;
+	}
+
+	// Transitions are ordered and grouped the same way from both clusters, so they pick the same ones.
+	SortArray<Transition, SortTransitions> sorter;
+	sorter.sort(transitions.ptr(), transitions.size());
+
+	LocalVector<int> run;
+	LocalVector<Transition *> members;
+	uint32_t from = 0;
+	while (from < transitions.size()) {
+		uint32_t to = from + 1;
+		while (to < transitions.size() && transitions[to].cluster_key == transitions[from].cluster_key) {
+			to++;
+		}
+
+		// Runs of parallel transitions, linked both ways on each side, can all go through the same ones.
+		// Each transition is labeled with the first one of its run.
+		run.resize(to - from);
+		for (uint32_t i = 0; i < run.size(); i++) {
+			run[i] = i;
+			const Transition &ti = transitions[from + i];
+
+			for (uint32_t j = 0; j < i; j++) {
+				const Transition &tj = transitions[from + j];
+				if (run[i] == run[j] || ti.direction != tj.direction || !_are_points_linked(ti.a, tj.a) || !_are_points_linked(ti.b, tj.b)) {
+					continue;
+				}
+
+				int label = MIN(run[i], run[j]);
+				int merged = MAX(run[i], run[j]);
+				for (uint32_t k = 0; k <= i; k++) {
+					if (run[k] == merged) {
+						run[k] = label;
+					}
+				}
+			}
+		}
+
+		// Long runs get a transition at each end, the others one in the middle, as in HPA*.
+		for (uint32_t i = from; i < to; i++) {
+			if (run[i - from] != int(i - from)) {
+				continue; // Not the first transition of its run.
+			}
+
+			members.clear();
+			for (uint32_t j = i; j < to; j++) {
+				if (run[j - from] == int(i - from)) {
+					members.push_back(&transitions[j]);
+				}
+			}
+
+			Point *selected[2] = { nullptr, nullptr };
+			if (members.size() >= TRANSITION_RUN_SPLIT) {
+				selected[0] = members[0]->point;
+				selected[1] = members[members.size() - 1]->point;
+			} else {
+				selected[0] = members[members.size() / 2]->point;
+			}
+
+			for (int j = 0; j < 2; j++) {
+				if (selected[j] && selected[j]->entrance_index < 0) {
+					selected[j]->entrance_index = p_cluster->entrances.size();
+					p_cluster->entrances.push_back(selected[j]);
+				}
+			}
+		}
+
+		from = to;
+	}
+}
+
+template <class C>
+void AStar::_update_clusters(C *p_costs) {
+	// The transitions between two clusters depend on both, so the neighbours of a changed cluster pick theirs again.
+	uint32_t changed_count = dirty_clusters.size();
+	for (uint32_t i = 0; i < changed_count; i++) {
+		Cluster *cluster = dirty_clusters[i];
+		for (uint32_t j = 0; j < cluster->points.size(); j++) {
+			_mark_neighbour_clusters_dirty(cluster->points[j]);
+		}
+	}
+
+	for (uint32_t i = 0; i < dirty_clusters.size(); i++) {
+		Cluster *cluster = dirty_clusters[i];
+		cluster->dirty = false;
+
+		if (cluster->points.empty()) {
+			clusters.remove(cluster->key);
+			memdelete(cluster);
+			dirty_clusters.remove_unordered(i);
+			i--;
+			continue;
+		}
+
+		_update_cluster_entrances(cluster);
+	}
+
+	// Link the entrances through their cluster.
+	for (uint32_t i = 0; i < dirty_clusters.size(); i++) {
+		Cluster *cluster = dirty_clusters[i];
+
+		cluster->entrance_edges.resize(cluster->entrances.size());
+		for (uint32_t j = 0; j < cluster->entrances.size(); j++) {
+			LocalVector<AbstractEdge> &edges = cluster->entrance_edges[j];
+			edges.clear();
+
+			_search(p_costs, cluster->entrances[j], nullptr, cluster, false, nullptr);
+
+			for (uint32_t k = 0; k < cluster->entrances.size(); k++) {
+				Point *e = cluster->entrances[k];
+				if (k != j && e->closed_pass == pass) {
+					AbstractEdge edge;
+					edge.to = e;
+					edge.cost = e->g_score;
+					edges.push_back(edge);
+				}
+			}
+		}
+	}
+
+	dirty_clusters.clear();
+}
+
+template <class C>
+bool AStar::_solve_hierarchical(C *p_costs, Point *p_begin_point, Point *p_end_point, LocalVector<Point *> &r_route) {
+	if (!p_end_point->enabled) {
+		return false;
+	}
+
+	_update_clusters(p_costs);
+
+	Cluster *begin_cluster = p_begin_point->cluster;
+	Cluster *end_cluster = p_end_point->cluster;
+
+	// Link the begin and end points to the entrances of their clusters, and to each other when they share one.
+	LocalVector<AbstractEdge> begin_edges;
+	LocalVector<AbstractEdge> end_edges;
+	AbstractEdge edge;
+
+	_search(p_costs, p_begin_point, nullptr, begin_cluster, false, nullptr);
+	for (uint32_t i = 0; i < begin_cluster->entrances.size(); i++) {
+		Point *e = begin_cluster->entrances[i];
+		if (e != p_begin_point && e->closed_pass == pass) {
+			edge.to = e;
+			edge.cost = e->g_score;
+			begin_edges.push_back(edge);
+		}
+	}
+	if (end_cluster == begin_cluster && p_end_point->closed_pass == pass) {
+		edge.to = p_end_point;
+		edge.cost = p_end_point->g_score;
+		begin_edges.push_back(edge);
+	}
+
+	if (!p_begin_point->enabled) {
+		// A disabled point isn't part of any transition, so the connections leaving its cluster are followed here.
+		for (OAHashMap<int, Point *>::Iterator it = p_begin_point->neighbours.iter(); it.valid; it = p_begin_point->neighbours.next_iter(it)) {
+			Point *n = *(it.value);
+			if (!n->enabled || n->cluster == begin_cluster) {
+				continue;
+			}
+
+			real_t step_cost = p_costs->_compute_cost(p_begin_point->id, n->id) * n->weight_scale;
+			_search(p_costs, n, nullptr, n->cluster, false, nullptr);
+
+			for (uint32_t i = 0; i < n->cluster->entrances.size(); i++) {
+				Point *e = n->cluster->entrances[i];
+				if (e->closed_pass == pass) {
+					edge.to = e;
+					edge.cost = step_cost + e->g_score;
+					begin_edges.push_back(edge);
+				}
+			}
+			if (n->cluster == end_cluster && p_end_point->closed_pass == pass) {
+				edge.to = p_end_point;
+				edge.cost = step_cost + p_end_point->g_score;
+				begin_edges.push_back(edge);
+			}
+		}
+	}
+
+	_search(p_costs, p_end_point, nullptr, end_cluster, true, nullptr);
+	for (uint32_t i = 0; i < end_cluster->entrances.size(); i++) {
+		Point *e = end_cluster->entrances[i];
+		if (e != p_end_point && e->closed_pass == pass) {
+			edge.to = e; // Edge from the entrance to the end point.
+			edge.cost = e->g_score;
+			end_edges.push_back(edge);
+		}
+	}
+
+	// A* over the entrances.
+	pass++;
+
+	bool found_route = false;
+
+	Vector<Point *> open_list;
+	SortArray<Point *, SortPoints> sorter;
+
+	p_begin_point->g_score = 0;
+	p_begin_point->f_score = p_costs->_estimate_cost(p_begin_point->id, p_end_point->id);
+	p_begin_point->prev_point = nullptr;
+	open_list.push_back(p_begin_point);
+
+	LocalVector<AbstractEdge> edges;
+
+	while (!open_list.empty()) {
+		Point *p = open_list[0]; // The currently processed point
+
+		if (p == p_end_point) {
+			found_route = true;
+			break;
+		}
+
+		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
+		open_list.remove(open_list.size() - 1);
+		p->closed_pass = pass; // Mark the point as closed
+
+		edges.clear();
+		if (p == p_begin_point) {
+			for (uint32_t i = 0; i < begin_edges.size(); i++) {
+				edges.push_back(begin_edges[i]);
+			}
+		} else if (p->entrance_index >= 0) {
+			const LocalVector<AbstractEdge> &entrance_edges = p->cluster->entrance_edges[p->entrance_index];
+			for (uint32_t i = 0; i < entrance_edges.size(); i++) {
+				edges.push_back(entrance_edges[i]);
+			}
+
+			if (p->cluster == end_cluster) {
+				for (uint32_t i = 0; i < end_edges.size(); i++) {
+					if (end_edges[i].to == p) {
+						edge.to = p_end_point;
+						edge.cost = end_edges[i].cost;
+						edges.push_back(edge);
+						break;
+					}
+				}
+			}
+		}
+
+		// Connections leaving the cluster.
+		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
+			Point *e = *(it.value);
+			if (e->cluster != p->cluster && e->enabled && (e->entrance_index >= 0 || e == p_end_point)) {
+				edge.to = e;
+				edge.cost = p_costs->_compute_cost(p->id, e->id) * e->weight_scale;
+				edges.push_back(edge);
+			}
+		}
+
+		for (uint32_t i = 0; i < edges.size(); i++) {
+			Point *e = edges[i].to;
+
+			if (e->closed_pass == pass) {
+				continue;
+			}
+
+			real_t tentative_g_score = p->g_score + edges[i].cost;
+
+			bool new_point = false;
+
+			if (e->open_pass != pass) { // The point wasn't inside the open list.
+				e->open_pass = pass;
+				open_list.push_back(e);
+				new_point = true;
+			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+				continue;
+			}
+
+			e->prev_point = p;
+			e->g_score = tentative_g_score;
+			e->f_score = e->g_score + p_costs->_estimate_cost(e->id, p_end_point->id);
+
+			if (new_point) { // The position of the new points is already known.
+				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
+			} else {
+				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
+			}
+		}
+	}
+
+	if (!found_route) {
+		return false;
+	}
+
+	LocalVector<Point *> abstract_route;
+	for (Point *p = p_end_point; p; p = p->prev_point) {
+		abstract_route.push_back(p);
+	}
+	abstract_route.invert();
+
+	// Refine the path inside each cluster, connections between clusters are already single steps.
+	LocalVector<Point *> segment;
+	r_route.push_back(p_begin_point);
+
+	for (uint32_t i = 1; i < abstract_route.size(); i++) {
+		Point *from = abstract_route[i - 1];
+		Point *to = abstract_route[i];
+
+		if (from->cluster != to->cluster) {
+			if (from->neighbours.has(to->id)) {
+				r_route.push_back(to);
+				continue;
+			}
+
+			// Only a disabled begin point is linked to another cluster through more than one step, find its neighbour the path goes through.
+			Point *via = nullptr;
+			real_t via_cost = 0;
+			for (OAHashMap<int, Point *>::Iterator it = from->neighbours.iter(); it.valid; it = from->neighbours.next_iter(it)) {
+				Point *n = *(it.value);
+				if (!n->enabled || n->cluster != to->cluster) {
+					continue;
+				}
+
+				_search(p_costs, n, to, n->cluster, false, nullptr);
+				if (to->closed_pass == pass) {
+					real_t cost = p_costs->_compute_cost(from->id, n->id) * n->weight_scale + to->g_score;
+					if (!via || cost < via_cost) {
+						via = n;
+						via_cost = cost;
+					}
+				}
+			}
+			ERR_FAIL_NULL_V(via, false);
+
+			r_route.push_back(via);
+			from = via;
+		}
+
+		_search(p_costs, from, to, from->cluster, false, nullptr);
+		ERR_FAIL_COND_V(to->closed_pass != pass, false);
+
+		segment.clear();
+		for (Point *p = to; p != from; p = p->prev_point) {
+			segment.push_back(p);
+		}
+		for (int j = segment.size() - 1; j >= 0; j--) {
+			r_route.push_back(segment[j]);
+		}
+	}
+
+	return true;
+}
+
+void AStar::set_hierarchy_cell_size(real_t p_cell_size) {
+	ERR_FAIL_COND_MSG(p_cell_size < 0, vformat("Hierarchy cell size can't be negative: %f.", p_cell_size));
+
+	if (hierarchy_cell_size == p_cell_size) {
+		return;
+	}
+
+	_clear_clusters();
+	hierarchy_cell_size = p_cell_size;
+
+	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
+		_update_point_cluster(*(it.value));
+	}
+}
+
+real_t AStar::get_hierarchy_cell_size() const {
+	return hierarchy_cell_size;
+}
+
+PoolVector<Vector3> AStar::get_hierarchical_point_path(int p_from_id, int p_to_id) {
+	ERR_FAIL_COND_V_MSG(hierarchy_cell_size <= 0, PoolVector<Vector3>(), "Can't get hierarchical point path. The hierarchy cell size must be set first.");
+
+	Point *a;
+	bool from_exists = points.lookup(p_from_id, a);
+	ERR_FAIL_COND_V_MSG(!from_exists, PoolVector<Vector3>(), vformat("Can't get hierarchical point path. Point with id: %d doesn't exist.", p_from_id));
+
+	Point *b;
+	bool to_exists = points.lookup(p_to_id, b);
+	ERR_FAIL_COND_V_MSG(!to_exists, PoolVector<Vector3>(), vformat("Can't get hierarchical point path. Point with id: %d doesn't exist.", p_to_id));
+
+	LocalVector<Point *> route;
+	if (a == b) {
+		route.push_back(a);
+	} else {
+		_solve_hierarchical(this, a, b, route);
+	}
+
+	return _get_route_positions(route);
+}
+
+PoolVector<int> AStar::get_hierarchical_id_path(int p_from_id, int p_to_id) {
+	ERR_FAIL_COND_V_MSG(hierarchy_cell_size <= 0, PoolVector<int>(), "Can't get hierarchical id path. The hierarchy cell size must be set first.");
+
+	Point *a;
+	bool from_exists = points.lookup(p_from_id, a);
+	ERR_FAIL_COND_V_MSG(!from_exists, PoolVector<int>(), vformat("Can't get hierarchical id path. Point with id: %d doesn't exist.", p_from_id));
+
+	Point *b;
+	bool to_exists = points.lookup(p_to_id, b);
+	ERR_FAIL_COND_V_MSG(!to_exists, PoolVector<int>(), vformat("Can't get hierarchical id path. Point with id: %d doesn't exist.", p_to_id));
+
+	LocalVector<Point *> route;
+	if (a == b) {
+		route.push_back(a);
+	} else {
+		_solve_hierarchical(this, a, b, route);
+	}
+
+	return _get_route_ids(route);
+}
+
+void AStar::add_destination_cache(int p_id) {
+	ERR_FAIL_COND_MSG(!points.has(p_id), vformat("Can't add destination cache. Point with id: %d doesn't exist.", p_id));
+
+	if (flow_fields.has(p_id)) {
+		return;
+	}
+
+	FlowField *field = memnew(FlowField);
+	field->version = 0; // Built by the first path query.
+	flow_fields.set(p_id, field);
+}
+
+void AStar::remove_destination_cache(int p_id) {
+	FlowField *field;
+	bool field_exists = flow_fields.lookup(p_id, field);
+	ERR_FAIL_COND_MSG(!field_exists, vformat("Can't remove destination cache. Point with id: %d has none.", p_id));
+
+	memdelete(field);
+	flow_fields.remove(p_id);
+}
+
+bool AStar::has_destination_cache(int p_id) const {
+	return flow_fields.has(p_id);
+}
+
+void AStar::clear_destination_caches() {
+	for (OAHashMap<int, FlowField *>::Iterator it = flow_fields.iter(); it.valid; it = flow_fields.next_iter(it)) {
+		memdelete(*(it.value));
+	}
+	flow_fields.clear();
+}
+
 void AStar::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar::get_available_point_id);
 	ClassDB::bind_method(D_METHOD("add_point", "id", "position", "weight_scale"), &AStar::add_point, DEFVAL(1.0));
@@ -557,6 +1311,16 @@ void AStar::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar::get_id_path);
 
+	ClassDB::bind_method(D_METHOD("set_hierarchy_cell_size", "cell_size"), &AStar::set_hierarchy_cell_size);
+	ClassDB::bind_method(D_METHOD("get_hierarchy_cell_size"), &AStar::get_hierarchy_cell_size);
+	ClassDB::bind_method(D_METHOD("get_hierarchical_point_path", "from_id", "to_id"), &AStar::get_hierarchical_point_path);
+	ClassDB::bind_method(D_METHOD("get_hierarchical_id_path", "from_id", "to_id"), &AStar::get_hierarchical_id_path);
+
+	ClassDB::bind_method(D_METHOD("add_destination_cache", "id"), &AStar::add_destination_cache);
+	ClassDB::bind_method(D_METHOD("remove_destination_cache", "id"), &AStar::remove_destination_cache);
+	ClassDB::bind_method(D_METHOD("has_destination_cache", "id"), &AStar::has_destination_cache);
+	ClassDB::bind_method(D_METHOD("clear_destination_caches"), &AStar::clear_destination_caches);
+
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_estimate_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_compute_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 }
@@ -564,6 +1328,8 @@ void AStar::_bind_methods() {
 AStar::AStar() {
 	last_free_id = 0;
 	pass = 1;
+	version = 1;
+	hierarchy_cell_size = 0;
 }
 
 AStar::~AStar() {
@@ -705,6 +1471,13 @@ PoolVector<Vector2> AStar2D::get_point_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
+	AStar::FlowField *field;
+	if (astar.flow_fields.lookup(p_to_id, field)) {
+		LocalVector<AStar::Point *> route;
+		astar._get_flow_field_route(this, a, b, field, route);
+		return _get_route_positions(route);
+	}
+
 	AStar::Point *begin_point = a;
 	AStar::Point *end_point = b;
 
@@ -754,6 +1527,13 @@ PoolVector<int> AStar2D::get_id_path(int p_from_id, int p_to_id) {
 		return ret;
 	}
 
+	AStar::FlowField *field;
+	if (astar.flow_fields.lookup(p_to_id, field)) {
+		LocalVector<AStar::Point *> route;
+		astar._get_flow_field_route(this, a, b, field, route);
+		return AStar::_get_route_ids(route);
+	}
+
 	AStar::Point *begin_point = a;
 	AStar::Point *end_point = b;
 
@@ -850,6 +1630,84 @@ bool AStar2D::_solve(AStar::Point *begin_point, AStar::Point *end_point) {
 	return found_route;
 }
 
+PoolVector<Vector2> AStar2D::_get_route_positions(const LocalVector<AStar::Point *> &p_route) {
+	PoolVector<Vector2> path;
+	path.resize(p_route.size());
+
+	PoolVector<Vector2>::Write w = path.write();
+	for (uint32_t i = 0; i < p_route.size(); i++) {
+		w[i] = Vector2(p_route[i]->pos.x, p_route[i]->pos.y);
+	}
+
+	return path;
+}
+
+void AStar2D::set_hierarchy_cell_size(real_t p_cell_size) {
+	astar.set_hierarchy_cell_size(p_cell_size);
+}
+
+real_t AStar2D::get_hierarchy_cell_size() const {
+	return astar.get_hierarchy_cell_size();
+}
+
+PoolVector<Vector2> AStar2D::get_hierarchical_point_path(int p_from_id, int p_to_id) {
+	ERR_FAIL_COND_V_MSG(astar.hierarchy_cell_size <= 0, PoolVector<Vector2>(), "Can't get hierarchical point path. The hierarchy cell size must be set first.");
+
+	AStar::Point *a;
+	bool from_exists = astar.points.lookup(p_from_id, a);
+	ERR_FAIL_COND_V_MSG(!from_exists, PoolVector<Vector2>(), vformat("Can't get hierarchical point path. Point with id: %d doesn't exist.", p_from_id));
+
+	AStar::Point *b;
+	bool to_exists = astar.points.lookup(p_to_id, b);
+	ERR_FAIL_COND_V_MSG(!to_exists, PoolVector<Vector2>(), vformat("Can't get hierarchical point path. Point with id: %d doesn't exist.", p_to_id));
+
+	LocalVector<AStar::Point *> route;
+	if (a == b) {
+		route.push_back(a);
+	} else {
+		astar._solve_hierarchical(this, a, b, route);
+	}
+
+	return _get_route_positions(route);
+}
+
+PoolVector<int> AStar2D::get_hierarchical_id_path(int p_from_id, int p_to_id) {
+	ERR_FAIL_COND_V_MSG(astar.hierarchy_cell_size <= 0, PoolVector<int>(), "Can't get hierarchical id path. The hierarchy cell size must be set first.");
+
+	AStar::Point *a;
+	bool from_exists = astar.points.lookup(p_from_id, a);
+	ERR_FAIL_COND_V_MSG(!from_exists, PoolVector<int>(), vformat("Can't get hierarchical id path. Point with id: %d doesn't exist.", p_from_id));
+
+	AStar::Point *b;
+	bool to_exists = astar.points.lookup(p_to_id, b);
+	ERR_FAIL_COND_V_MSG(!to_exists, PoolVector<int>(), vformat("Can't get hierarchical id path. Point with id: %d doesn't exist.", p_to_id));
+
+	LocalVector<AStar::Point *> route;
+	if (a == b) {
+		route.push_back(a);
+	} else {
+		astar._solve_hierarchical(this, a, b, route);
+	}
+
+	return AStar::_get_route_ids(route);
+}
+
+void AStar2D::add_destination_cache(int p_id) {
+	astar.add_destination_cache(p_id);
+}
+
+void AStar2D::remove_destination_cache(int p_id) {
+	astar.remove_destination_cache(p_id);
+}
+
+bool AStar2D::has_destination_cache(int p_id) const {
+	return astar.has_destination_cache(p_id);
+}
+
+void AStar2D::clear_destination_caches() {
+	astar.clear_destination_caches();
+}
+
 void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar2D::get_available_point_id);
 	ClassDB::bind_method(D_METHOD("add_point", "id", "position", "weight_scale"), &AStar2D::add_point, DEFVAL(1.0));
@@ -880,6 +1738,16 @@ void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar2D::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar2D::get_id_path);
 
+	ClassDB::bind_method(D_METHOD("set_hierarchy_cell_size", "cell_size"), &AStar2D::set_hierarchy_cell_size);
+	ClassDB::bind_method(D_METHOD("get_hierarchy_cell_size"), &AStar2D::get_hierarchy_cell_size);
+	ClassDB::bind_method(D_METHOD("get_hierarchical_point_path", "from_id", "to_id"), &AStar2D::get_hierarchical_point_path);
+	ClassDB::bind_method(D_METHOD("get_hierarchical_id_path", "from_id", "to_id"), &AStar2D::get_hierarchical_id_path);
+
+	ClassDB::bind_method(D_METHOD("add_destination_cache", "id"), &AStar2D::add_destination_cache);
+	ClassDB::bind_method(D_METHOD("remove_destination_cache", "id"), &AStar2D::remove_destination_cache);
+	ClassDB::bind_method(D_METHOD("has_destination_cache", "id"), &AStar2D::has_destination_cache);
+	ClassDB::bind_method(D_METHOD("clear_destination_caches"), &AStar2D::clear_destination_caches);
+
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_estimate_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 	BIND_VMETHOD(MethodInfo(Variant::REAL, "_compute_cost", PropertyInfo(Variant::INT, "from_id"), PropertyInfo(Variant::INT, "to_id")));
 }
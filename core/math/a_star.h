@@ -31,6 +31,7 @@
 #ifndef ASTAR_H
 #define ASTAR_H
 
+#include "core/local_vector.h"
 #include "core/oa_hash_map.h"
 #include "core/reference.h"
 
@@ -44,6 +45,8 @@ class AStar : public Reference {
 	GDCLASS(AStar, Reference);
 	friend class AStar2D;
 
+	struct Cluster;
+
 	struct Point {
 		Point() :
 				neighbours(4u),
@@ -63,6 +66,10 @@ class AStar : public Reference {
 		real_t f_score;
 		uint64_t open_pass;
 		uint64_t closed_pass;
+
+		// Used for hierarchical pathfinding.
+		Cluster *cluster;
+		int entrance_index; // Index in the cluster entrances, -1 when the point isn't one.
 	};
 
 	struct SortPoints {
@@ -112,14 +119,100 @@ class AStar : public Reference {
 		}
 	};
 
+	// Entry of the searches below, which can hold the same point more than once.
+	struct SearchEntry {
+		Point *point;
+		real_t g_score;
+	};
+
+	struct SortSearchEntries {
+		_FORCE_INLINE_ bool operator()(const SearchEntry &A, const SearchEntry &B) const { // Returns true when the entry A is worse than entry B.
+			return A.g_score > B.g_score;
+		}
+	};
+
+	struct AbstractEdge {
+		Point *to;
+		real_t cost;
+	};
+
+	// Points inside the same cell of the hierarchy. Entrances are the points picked among the transitions
+	// to other clusters, and are linked together by the cost of the shortest path inside the cluster.
+	struct Cluster {
+		uint64_t key;
+		bool dirty;
+		LocalVector<Point *> points;
+		LocalVector<Point *> entrances;
+		LocalVector<LocalVector<AbstractEdge> > entrance_edges;
+	};
+
+	// Connection between two clusters, a and b being ordered by cluster key so both clusters see it the same way.
+	struct Transition {
+		Point *point; // In the cluster being updated.
+		Point *a;
+		Point *b;
+		uint64_t cluster_key; // Of the other cluster.
+		int direction;
+	};
+
+	struct SortTransitions {
+		_FORCE_INLINE_ bool operator()(const Transition &A, const Transition &B) const {
+			if (A.cluster_key != B.cluster_key) {
+				return A.cluster_key < B.cluster_key;
+			}
+			if (A.a->id != B.a->id) {
+				return A.a->id < B.a->id;
+			}
+			return A.b->id < B.b->id;
+		}
+	};
+
+	enum {
+		TRANSITION_RUN_SPLIT = 6, // Runs of at least this many transitions are entered through both ends.
+	};
+
+	// Reverse search from a destination, giving the next point towards it from every point.
+	struct FlowField {
+		uint64_t version;
+		OAHashMap<int, Point *> next;
+	};
+
 	int last_free_id;
 	uint64_t pass;
+	uint64_t version; // Changes with the graph, invalidates the flow fields.
 
 	OAHashMap<int, Point *> points;
 	Set<Segment> segments;
 
+	real_t hierarchy_cell_size;
+	OAHashMap<uint64_t, Cluster *> clusters;
+	LocalVector<Cluster *> dirty_clusters;
+
+	OAHashMap<int, FlowField *> flow_fields;
+
 	bool _solve(Point *begin_point, Point *end_point);
 
+	template <class C>
+	void _search(C *p_costs, Point *p_source, Point *p_target, Cluster *p_cluster, bool p_reverse, LocalVector<Point *> *r_reached);
+	template <class C>
+	bool _get_flow_field_route(C *p_costs, Point *p_begin_point, Point *p_end_point, FlowField *p_field, LocalVector<Point *> &r_route);
+	template <class C>
+	void _update_clusters(C *p_costs);
+	template <class C>
+	bool _solve_hierarchical(C *p_costs, Point *p_begin_point, Point *p_end_point, LocalVector<Point *> &r_route);
+
+	uint64_t _get_cluster_key(const Vector3 &p_pos) const;
+	static bool _are_points_linked(const Point *p_a, const Point *p_b);
+	void _update_cluster_entrances(Cluster *p_cluster);
+	void _mark_cluster_dirty(Cluster *p_cluster);
+	void _mark_neighbour_clusters_dirty(Point *p_point);
+	void _update_point_cluster(Point *p_point);
+	void _remove_point_from_cluster(Point *p_point);
+	void _clear_clusters();
+
+	static PoolVector<int> _get_route_ids(const LocalVector<Point *> &p_route);
+	static PoolVector<Vector3> _get_route_positions(const LocalVector<Point *> &p_route);
+
 protected:
 	static void _bind_methods();
 
@@ -157,16 +250,29 @@ public:
 	PoolVector<Vector3> get_point_path(int p_from_id, int p_to_id);
 	PoolVector<int> get_id_path(int p_from_id, int p_to_id);
 
+	void set_hierarchy_cell_size(real_t p_cell_size);
+	real_t get_hierarchy_cell_size() const;
+	PoolVector<Vector3> get_hierarchical_point_path(int p_from_id, int p_to_id);
+	PoolVector<int> get_hierarchical_id_path(int p_from_id, int p_to_id);
+
+	void add_destination_cache(int p_id);
+	void remove_destination_cache(int p_id);
+	bool has_destination_cache(int p_id) const;
+	void clear_destination_caches();
+
 	AStar();
 	~AStar();
 };
 
 class AStar2D : public Reference {
 	GDCLASS(AStar2D, Reference);
+	friend class AStar;
 	AStar astar;
 
 	bool _solve(AStar::Point *begin_point, AStar::Point *end_point);
 
+	static PoolVector<Vector2> _get_route_positions(const LocalVector<AStar::Point *> &p_route);
+
 protected:
 	static void _bind_methods();
 
@@ -204,6 +310,16 @@ public:
 	PoolVector<Vector2> get_point_path(int p_from_id, int p_to_id);
 	PoolVector<int> get_id_path(int p_from_id, int p_to_id);
 
+	void set_hierarchy_cell_size(real_t p_cell_size);
+	real_t get_hierarchy_cell_size() const;
+	PoolVector<Vector2> get_hierarchical_point_path(int p_from_id, int p_to_id);
+	PoolVector<int> get_hierarchical_id_path(int p_from_id, int p_to_id);
+
+	void add_destination_cache(int p_id);
+	void remove_destination_cache(int p_id);
+	bool has_destination_cache(int p_id) const;
+	void clear_destination_caches();
+
 	AStar2D();
 	~AStar2D();
 };
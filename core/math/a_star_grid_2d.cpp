@@ -0,0 +1,854 @@
+/*************************************************************************/
+/*  a_star_grid_2d.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "a_star_grid_2d.h"
+
+#include "core/script_language.h"
+#include "core/sort_array.h"
+#include "scene/scene_string_names.h"
+
+static const int grid_directions[8][2] = {
+	{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, // Straight moves first, the diagonal ones are skipped without them.
+	{ 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 },
+};
+
+static _FORCE_INLINE_ int _get_direction(int p_from, int p_to) {
+	return p_to > p_from ? 1 : (p_to < p_from ? -1 : 0);
+}
+
+static _FORCE_INLINE_ int _get_lowest_bit(uint64_t p_bits) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(p_bits);
+#else
+	int bit = 0;
+	while (!(p_bits & 1)) {
+		p_bits >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+static _FORCE_INLINE_ int _get_highest_bit(uint64_t p_bits) {
+#if defined(__GNUC__) || defined(__clang__)
+	return 63 - __builtin_clzll(p_bits);
+#else
+	int bit = 63;
+	while (!(p_bits >> 63)) {
+		p_bits <<= 1;
+		bit--;
+	}
+	return bit;
+#endif
+}
+
+// Returns the 64 bits of a line starting at the given bit, which doesn't need to be aligned.
+static _FORCE_INLINE_ uint64_t _get_line_bits(const uint64_t *p_line, uint32_t p_bit) {
+	const uint32_t word = p_bit >> 6;
+	const uint32_t shift = p_bit & 63;
+	if (shift == 0) {
+		return p_line[word];
+	}
+	return (p_line[word] >> shift) | (p_line[word + 1] << (64 - shift));
+}
+
+real_t AStarGrid2D::_get_heuristic_cost(Heuristic p_heuristic, const Vector2 &p_from_id, const Vector2 &p_to_id) {
+	const real_t dx = Math::abs(p_to_id.x - p_from_id.x);
+	const real_t dy = Math::abs(p_to_id.y - p_from_id.y);
+
+	switch (p_heuristic) {
+		case HEURISTIC_MANHATTAN: {
+			return dx + dy;
+		}
+		case HEURISTIC_OCTILE: {
+			const real_t f = Math_SQRT2 - 1;
+			return dx < dy ? f * dx + dy : f * dy + dx;
+		}
+		case HEURISTIC_CHEBYSHEV: {
+			return MAX(dx, dy);
+		}
+		default: {
+			return Math::sqrt(dx * dx + dy * dy);
+		}
+	}
+}
+
+void AStarGrid2D::_set_solid(int p_x, int p_y, bool p_solid) {
+	const uint32_t row_bit = p_x + BORDER_BITS;
+	const uint32_t column_bit = p_y + BORDER_BITS;
+	uint64_t &row = solid_rows[(p_y + 1) * row_words + (row_bit >> 6)];
+	uint64_t &column = solid_columns[(p_x + 1) * column_words + (column_bit >> 6)];
+
+	if (p_solid) {
+		row |= uint64_t(1) << (row_bit & 63);
+		column |= uint64_t(1) << (column_bit & 63);
+	} else {
+		row &= ~(uint64_t(1) << (row_bit & 63));
+		column &= ~(uint64_t(1) << (column_bit & 63));
+	}
+}
+
+void AStarGrid2D::_set_weight_scale(int p_x, int p_y, real_t p_weight_scale) {
+	if (weight_scales.empty()) {
+		if (p_weight_scale == 1) {
+			return;
+		}
+		weight_scales.resize(width * height);
+		for (uint32_t i = 0; i < weight_scales.size(); i++) {
+			weight_scales[i] = 1;
+		}
+	}
+
+	real_t &weight_scale = weight_scales[p_y * width + p_x];
+	if (weight_scale != 1) {
+		weighted_cells--;
+	}
+	if (p_weight_scale != 1) {
+		weighted_cells++;
+	}
+	weight_scale = p_weight_scale;
+
+	if (weighted_cells == 0) {
+		weight_scales.reset();
+	}
+}
+
+bool AStarGrid2D::_can_move(int p_x, int p_y, int p_dx, int p_dy) const {
+	if (p_dx == 0 || p_dy == 0) {
+		return true;
+	}
+
+	switch (diagonal_mode) {
+		case DIAGONAL_MODE_NEVER: {
+			return false;
+		}
+		case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE: {
+			return _is_walkable(p_x + p_dx, p_y) || _is_walkable(p_x, p_y + p_dy);
+		}
+		case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES: {
+			return _is_walkable(p_x + p_dx, p_y) && _is_walkable(p_x, p_y + p_dy);
+		}
+		default: {
+			return true;
+		}
+	}
+}
+
+// Returns the directions worth jumping to from a cell reached by moving in the given direction, i.e. the natural
+// neighbours plus the forced ones. All the possible moves are returned for the first cell.
+int AStarGrid2D::_get_jump_directions(int p_x, int p_y, int p_dx, int p_dy, int r_directions[8][2]) const {
+	int candidates[8][2];
+	int count = 0;
+
+#define ADD_CANDIDATE(m_dx, m_dy)      \
+	{                                  \
+		candidates[count][0] = (m_dx); \
+		candidates[count][1] = (m_dy); \
+		count++;                       \
+	}
+
+	if (p_dx == 0 && p_dy == 0) {
+		const int direction_count = diagonal_mode == DIAGONAL_MODE_NEVER ? 4 : 8;
+		for (int i = 0; i < direction_count; i++) {
+			ADD_CANDIDATE(grid_directions[i][0], grid_directions[i][1]);
+		}
+	} else if (p_dx != 0 && p_dy != 0) {
+		ADD_CANDIDATE(0, p_dy);
+		ADD_CANDIDATE(p_dx, 0);
+		ADD_CANDIDATE(p_dx, p_dy);
+		if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
+			if (!_is_walkable(p_x - p_dx, p_y)) {
+				ADD_CANDIDATE(-p_dx, p_dy);
+			}
+			if (!_is_walkable(p_x, p_y - p_dy)) {
+				ADD_CANDIDATE(p_dx, -p_dy);
+			}
+		}
+	} else {
+		// Work with the perpendicular axis, whichever the direction is.
+		const int px = p_dy;
+		const int py = p_dx;
+
+		ADD_CANDIDATE(p_dx, p_dy);
+		switch (diagonal_mode) {
+			case DIAGONAL_MODE_ALWAYS:
+			case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE: {
+				if (!_is_walkable(p_x + px, p_y + py)) {
+					ADD_CANDIDATE(p_dx + px, p_dy + py);
+				}
+				if (!_is_walkable(p_x - px, p_y - py)) {
+					ADD_CANDIDATE(p_dx - px, p_dy - py);
+				}
+			} break;
+			case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES: {
+				ADD_CANDIDATE(p_dx + px, p_dy + py);
+				ADD_CANDIDATE(p_dx - px, p_dy - py);
+				ADD_CANDIDATE(px, py);
+				ADD_CANDIDATE(-px, -py);
+			} break;
+			default: {
+				ADD_CANDIDATE(px, py);
+				ADD_CANDIDATE(-px, -py);
+			} break;
+		}
+	}
+
+#undef ADD_CANDIDATE
+
+	int direction_count = 0;
+	for (int i = 0; i < count; i++) {
+		const int dx = candidates[i][0];
+		const int dy = candidates[i][1];
+		if (_is_walkable(p_x + dx, p_y + dy) && _can_move(p_x, p_y, dx, dy)) {
+			r_directions[direction_count][0] = dx;
+			r_directions[direction_count][1] = dy;
+			direction_count++;
+		}
+	}
+	return direction_count;
+}
+
+// Scans a row, or a column when vertical, from the given cell and returns the first one a straight jump stops at:
+// the end point or a cell with a forced neighbour. Returns JUMP_BLOCKED when a solid cell comes first.
+// Each step checks 62 cells at once, using the bits of the line and the lines on both sides of it.
+int AStarGrid2D::_jump_line(bool p_vertical, int p_line, int p_from, int p_dir, int p_end_line, int p_end) const {
+	const uint32_t words = p_vertical ? column_words : row_words;
+	const uint64_t *line = (p_vertical ? solid_columns.ptr() : solid_rows.ptr()) + (p_line + 1) * words;
+	const uint64_t *before = line - words;
+	const uint64_t *after = line + words;
+
+	// With corner cutting, a forced neighbour appears where the side is solid and the next cell on that side isn't.
+	// Without it, where the side is free and the previous cell on that side is solid.
+	const bool cut_corners = diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE;
+	const int end = p_end_line == p_line ? p_end + BORDER_BITS : -1;
+	const uint64_t window = 0x7FFFFFFFFFFFFFFEULL; // Bits 1 to 62, the others lack a neighbour in the loaded bits.
+
+	if (p_dir > 0) {
+		int start = p_from + BORDER_BITS - 1;
+		while (true) {
+			const uint64_t solid = _get_line_bits(line, start);
+			const uint64_t b = _get_line_bits(before, start);
+			const uint64_t a = _get_line_bits(after, start);
+
+			uint64_t stops;
+			if (cut_corners) {
+				stops = ((~b >> 1) & b) | ((~a >> 1) & a);
+			} else {
+				stops = (~b & (b << 1)) | (~a & (a << 1));
+			}
+			stops = (stops | solid) & window;
+			if (end > start && end <= start + 62) {
+				stops |= uint64_t(1) << (end - start);
+			}
+
+			if (stops) {
+				const int bit = _get_lowest_bit(stops);
+				if ((solid >> bit) & 1) {
+					return JUMP_BLOCKED;
+				}
+				return start + bit - BORDER_BITS;
+			}
+			start += 62;
+		}
+	} else {
+		int start = p_from + BORDER_BITS - 62;
+		while (true) {
+			const uint64_t solid = _get_line_bits(line, start);
+			const uint64_t b = _get_line_bits(before, start);
+			const uint64_t a = _get_line_bits(after, start);
+
+			uint64_t stops;
+			if (cut_corners) {
+				stops = ((~b << 1) & b) | ((~a << 1) & a);
+			} else {
+				stops = (~b & (b >> 1)) | (~a & (a >> 1));
+			}
+			stops = (stops | solid) & window;
+			if (end > start && end <= start + 62) {
+				stops |= uint64_t(1) << (end - start);
+			}
+
+			if (stops) {
+				const int bit = _get_highest_bit(stops);
+				if ((solid >> bit) & 1) {
+					return JUMP_BLOCKED;
+				}
+				return start + bit - BORDER_BITS;
+			}
+			start -= 62;
+		}
+	}
+}
+
+// Moves from the given cell in the given direction until a jump point is found, in which case it is returned in
+// r_x and r_y, or a solid cell or a forbidden diagonal move stops the jump.
+bool AStarGrid2D::_jump(int p_x, int p_y, int p_dx, int p_dy, int p_end_x, int p_end_y, int &r_x, int &r_y) const {
+	if (p_dy == 0) {
+		const int x = _jump_line(false, p_y, p_x, p_dx, p_end_y, p_end_x);
+		if (x == JUMP_BLOCKED) {
+			return false;
+		}
+		r_x = x;
+		r_y = p_y;
+		return true;
+	}
+
+	if (p_dx == 0 && diagonal_mode != DIAGONAL_MODE_NEVER) {
+		const int y = _jump_line(true, p_x, p_y, p_dy, p_end_x, p_end_y);
+		if (y == JUMP_BLOCKED) {
+			return false;
+		}
+		r_x = p_x;
+		r_y = y;
+		return true;
+	}
+
+	// Every step here scans whole lines, so long jumps are cut into several ones. The extra jump points only continue
+	// in the same direction, but the ones moving away from the end point are then left in the open list.
+	int x = p_x;
+	int y = p_y;
+	for (int steps = 0;; steps++) {
+		if (!_is_walkable(x, y)) {
+			return false;
+		}
+		if ((x == p_end_x && y == p_end_y) || steps == JUMP_STEP_LIMIT) {
+			break;
+		}
+
+		if (p_dx == 0) {
+			// Without diagonal moves, the paths that turn on the way are only found by looking for horizontal jump points
+			// from every cell of a vertical jump.
+			if ((_is_walkable(x - 1, y) && !_is_walkable(x - 1, y - p_dy)) || (_is_walkable(x + 1, y) && !_is_walkable(x + 1, y - p_dy))) {
+				break;
+			}
+			if (_jump_line(false, y, x + 1, 1, p_end_y, p_end_x) != JUMP_BLOCKED || _jump_line(false, y, x - 1, -1, p_end_y, p_end_x) != JUMP_BLOCKED) {
+				break;
+			}
+			y += p_dy;
+			continue;
+		}
+
+		if (diagonal_mode != DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
+			if ((_is_walkable(x - p_dx, y + p_dy) && !_is_walkable(x - p_dx, y)) || (_is_walkable(x + p_dx, y - p_dy) && !_is_walkable(x, y - p_dy))) {
+				break;
+			}
+		}
+		if (_jump_line(false, y, x + p_dx, p_dx, p_end_y, p_end_x) != JUMP_BLOCKED || _jump_line(true, x, y + p_dy, p_dy, p_end_x, p_end_y) != JUMP_BLOCKED) {
+			break;
+		}
+		if (!_can_move(x, y, p_dx, p_dy)) {
+			return false;
+		}
+		x += p_dx;
+		y += p_dy;
+	}
+
+	r_x = x;
+	r_y = y;
+	return true;
+}
+
+void AStarGrid2D::_visit(uint32_t p_from, int p_x, int p_y, real_t p_cost, const Vector2 &p_end_id) {
+	const real_t g_score = search_nodes[p_from].g_score + p_cost;
+	const uint32_t cell = p_y * width + p_x;
+
+	uint32_t index;
+	if (search_indices.lookup(cell, index)) {
+		SearchNode &node = search_nodes[index];
+		if (node.closed || g_score >= node.g_score) {
+			return;
+		}
+		node.g_score = g_score;
+		node.prev = p_from;
+	} else {
+		index = search_nodes.size();
+		SearchNode node;
+		node.x = p_x;
+		node.y = p_y;
+		node.prev = p_from;
+		node.g_score = g_score;
+		node.closed = false;
+		search_nodes.push_back(node);
+		search_indices.insert(cell, index);
+	}
+
+	OpenEntry entry;
+	entry.node = index;
+	entry.g_score = g_score;
+	entry.f_score = g_score + _estimate_cost(Vector2(p_x, p_y), p_end_id);
+	open_list.push_back(entry);
+
+	SortArray<OpenEntry, SortOpenEntries> sorter;
+	sorter.push_heap(0, open_list.size() - 1, 0, entry, open_list.ptr());
+}
+
+bool AStarGrid2D::_solve(const Vector2 &p_begin_id, const Vector2 &p_end_id, uint32_t &r_end_node) {
+	search_nodes.clear();
+	search_indices.clear();
+	open_list.clear();
+
+	const int end_x = p_end_id.x;
+	const int end_y = p_end_id.y;
+	if (!_is_walkable(end_x, end_y)) {
+		return false;
+	}
+
+	// Jumping over cells is only correct while moving to any neighbour costs the same.
+	const bool jumping = jumping_enabled && weight_scales.empty() && !(get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_compute_cost));
+
+	SearchNode begin;
+	begin.x = p_begin_id.x;
+	begin.y = p_begin_id.y;
+	begin.prev = INVALID_NODE;
+	begin.g_score = 0;
+	begin.closed = false;
+	search_nodes.push_back(begin);
+	search_indices.insert(begin.y * width + begin.x, 0);
+
+	OpenEntry entry;
+	entry.node = 0;
+	entry.g_score = 0;
+	entry.f_score = _estimate_cost(Vector2(begin.x, begin.y), p_end_id);
+	open_list.push_back(entry);
+
+	SortArray<OpenEntry, SortOpenEntries> sorter;
+	const int direction_count = diagonal_mode == DIAGONAL_MODE_NEVER ? 4 : 8;
+
+	while (!open_list.empty()) {
+		const OpenEntry current = open_list[0];
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.resize(open_list.size() - 1);
+
+		SearchNode &node = search_nodes[current.node];
+		if (node.closed || current.g_score > node.g_score) {
+			continue;
+		}
+		if (node.x == end_x && node.y == end_y) {
+			r_end_node = current.node;
+			return true;
+		}
+		node.closed = true;
+
+		// Nodes are added while visiting the neighbours, so the reference can't be used past this point.
+		const int x = node.x;
+		const int y = node.y;
+		const Vector2 id = Vector2(x, y);
+
+		if (jumping) {
+			int dx = 0;
+			int dy = 0;
+			if (node.prev != INVALID_NODE) {
+				dx = _get_direction(search_nodes[node.prev].x, x);
+				dy = _get_direction(search_nodes[node.prev].y, y);
+			}
+
+			int directions[8][2];
+			const int count = _get_jump_directions(x, y, dx, dy, directions);
+			for (int i = 0; i < count; i++) {
+				int jump_x, jump_y;
+				if (_jump(x + directions[i][0], y + directions[i][1], directions[i][0], directions[i][1], end_x, end_y, jump_x, jump_y)) {
+					_visit(current.node, jump_x, jump_y, _compute_cost(id, Vector2(jump_x, jump_y)), p_end_id);
+				}
+			}
+		} else {
+			for (int i = 0; i < direction_count; i++) {
+				const int dx = grid_directions[i][0];
+				const int dy = grid_directions[i][1];
+				if (!_is_walkable(x + dx, y + dy) || !_can_move(x, y, dx, dy)) {
+					continue;
+				}
+
+				real_t cost = _compute_cost(id, Vector2(x + dx, y + dy));
+				if (!weight_scales.empty()) {
+					cost *= weight_scales[(y + dy) * width + x + dx];
+				}
+				_visit(current.node, x + dx, y + dy, cost, p_end_id);
+			}
+		}
+	}
+
+	return false;
+}
+
+// Returns every cell of the route, filling the straight lines between the jump points.
+PoolVector<Vector2> AStarGrid2D::_get_route(uint32_t p_end_node, bool p_positions) const {
+	int count = 1;
+	for (uint32_t i = p_end_node; search_nodes[i].prev != INVALID_NODE; i = search_nodes[i].prev) {
+		const SearchNode &node = search_nodes[i];
+		const SearchNode &prev = search_nodes[node.prev];
+		count += MAX(ABS(node.x - prev.x), ABS(node.y - prev.y));
+	}
+
+	PoolVector<Vector2> path;
+	path.resize(count);
+	{
+		PoolVector<Vector2>::Write w = path.write();
+
+		int index = count - 1;
+		uint32_t i = p_end_node;
+		while (true) {
+			const SearchNode &node = search_nodes[i];
+			if (node.prev == INVALID_NODE) {
+				w[index] = Vector2(node.x, node.y);
+				break;
+			}
+
+			const SearchNode &prev = search_nodes[node.prev];
+			const int dx = _get_direction(prev.x, node.x);
+			const int dy = _get_direction(prev.y, node.y);
+			for (int x = node.x, y = node.y; x != prev.x || y != prev.y; x -= dx, y -= dy) {
+				w[index--] = Vector2(x, y);
+			}
+			i = node.prev;
+		}
+
+		if (p_positions) {
+			for (int j = 0; j < count; j++) {
+				w[j] = offset + w[j] * cell_size;
+			}
+		}
+	}
+
+	return path;
+}
+
+real_t AStarGrid2D::_estimate_cost(const Vector2 &p_from_id, const Vector2 &p_to_id) {
+	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_estimate_cost)) {
+		return get_script_instance()->call(SceneStringNames::get_singleton()->_estimate_cost, p_from_id, p_to_id);
+	}
+
+	return _get_heuristic_cost(default_estimate_heuristic, p_from_id, p_to_id);
+}
+
+real_t AStarGrid2D::_compute_cost(const Vector2 &p_from_id, const Vector2 &p_to_id) {
+	if (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_compute_cost)) {
+		return get_script_instance()->call(SceneStringNames::get_singleton()->_compute_cost, p_from_id, p_to_id);
+	}
+
+	return _get_heuristic_cost(default_compute_heuristic, p_from_id, p_to_id);
+}
+
+void AStarGrid2D::set_size(const Vector2 &p_size) {
+	ERR_FAIL_COND_MSG(p_size.x < 0 || p_size.y < 0, "Grid size can't be negative.");
+	if (p_size.floor() != size) {
+		size = p_size.floor();
+		dirty = true;
+	}
+}
+
+Vector2 AStarGrid2D::get_size() const {
+	return size;
+}
+
+void AStarGrid2D::set_offset(const Vector2 &p_offset) {
+	offset = p_offset;
+}
+
+Vector2 AStarGrid2D::get_offset() const {
+	return offset;
+}
+
+void AStarGrid2D::set_cell_size(const Vector2 &p_cell_size) {
+	cell_size = p_cell_size;
+}
+
+Vector2 AStarGrid2D::get_cell_size() const {
+	return cell_size;
+}
+
+void AStarGrid2D::update() {
+	ERR_FAIL_COND_MSG((int64_t)size.x * (int64_t)size.y > (1 << 30), vformat("Grid size %s is too large.", size));
+
+	width = size.x;
+	height = size.y;
+	row_words = (width + 63) / 64 + 2;
+	column_words = (height + 63) / 64 + 2;
+
+	// Everything starts solid, the border included, then the cells are cleared.
+	solid_rows.resize((height + 2) * row_words);
+	for (uint32_t i = 0; i < solid_rows.size(); i++) {
+		solid_rows[i] = ~uint64_t(0);
+	}
+	solid_columns.resize((width + 2) * column_words);
+	for (uint32_t i = 0; i < solid_columns.size(); i++) {
+		solid_columns[i] = ~uint64_t(0);
+	}
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			_set_solid(x, y, false);
+		}
+	}
+
+	weight_scales.reset();
+	weighted_cells = 0;
+
+	search_nodes.reset();
+	search_indices.clear();
+	open_list.reset();
+
+	dirty = false;
+}
+
+bool AStarGrid2D::is_dirty() const {
+	return dirty;
+}
+
+bool AStarGrid2D::is_in_bounds(int p_x, int p_y) const {
+	return p_x >= 0 && p_x < width && p_y >= 0 && p_y < height;
+}
+
+bool AStarGrid2D::is_in_boundsv(const Vector2 &p_id) const {
+	return is_in_bounds(p_id.x, p_id.y);
+}
+
+void AStarGrid2D::set_jumping_enabled(bool p_enabled) {
+	jumping_enabled = p_enabled;
+}
+
+bool AStarGrid2D::is_jumping_enabled() const {
+	return jumping_enabled;
+}
+
+void AStarGrid2D::set_diagonal_mode(DiagonalMode p_diagonal_mode) {
+	ERR_FAIL_INDEX((int)p_diagonal_mode, (int)DIAGONAL_MODE_MAX);
+	diagonal_mode = p_diagonal_mode;
+}
+
+AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
+	return diagonal_mode;
+}
+
+void AStarGrid2D::set_default_compute_heuristic(Heuristic p_heuristic) {
+	ERR_FAIL_INDEX((int)p_heuristic, (int)HEURISTIC_MAX);
+	default_compute_heuristic = p_heuristic;
+}
+
+AStarGrid2D::Heuristic AStarGrid2D::get_default_compute_heuristic() const {
+	return default_compute_heuristic;
+}
+
+void AStarGrid2D::set_default_estimate_heuristic(Heuristic p_heuristic) {
+	ERR_FAIL_INDEX((int)p_heuristic, (int)HEURISTIC_MAX);
+	default_estimate_heuristic = p_heuristic;
+}
+
+AStarGrid2D::Heuristic AStarGrid2D::get_default_estimate_heuristic() const {
+	return default_estimate_heuristic;
+}
+
+void AStarGrid2D::set_point_solid(const Vector2 &p_id, bool p_solid) {
+	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set if point is solid. Point %s out of bounds.", p_id));
+	_set_solid(p_id.x, p_id.y, p_solid);
+}
+
+bool AStarGrid2D::is_point_solid(const Vector2 &p_id) const {
+	ERR_FAIL_COND_V_MSG(dirty, false, "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), false, vformat("Can't get if point is solid. Point %s out of bounds.", p_id));
+	return !_is_walkable(p_id.x, p_id.y);
+}
+
+void AStarGrid2D::set_point_weight_scale(const Vector2 &p_id, real_t p_weight_scale) {
+	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set point's weight scale. Point %s out of bounds.", p_id));
+	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
+	_set_weight_scale(p_id.x, p_id.y, p_weight_scale);
+}
+
+real_t AStarGrid2D::get_point_weight_scale(const Vector2 &p_id) const {
+	ERR_FAIL_COND_V_MSG(dirty, 0, "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), 0, vformat("Can't get point's weight scale. Point %s out of bounds.", p_id));
+	if (weight_scales.empty()) {
+		return 1;
+	}
+	return weight_scales[(int)p_id.y * width + (int)p_id.x];
+}
+
+void AStarGrid2D::fill_solid_region(const Rect2 &p_region, bool p_solid) {
+	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
+
+	const int from_x = MAX(0, (int)p_region.position.x);
+	const int from_y = MAX(0, (int)p_region.position.y);
+	const int to_x = MIN(width, (int)(p_region.position.x + p_region.size.x));
+	const int to_y = MIN(height, (int)(p_region.position.y + p_region.size.y));
+	for (int y = from_y; y < to_y; y++) {
+		for (int x = from_x; x < to_x; x++) {
+			_set_solid(x, y, p_solid);
+		}
+	}
+}
+
+void AStarGrid2D::fill_weight_scale_region(const Rect2 &p_region, real_t p_weight_scale) {
+	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
+
+	const int from_x = MAX(0, (int)p_region.position.x);
+	const int from_y = MAX(0, (int)p_region.position.y);
+	const int to_x = MIN(width, (int)(p_region.position.x + p_region.size.x));
+	const int to_y = MIN(height, (int)(p_region.position.y + p_region.size.y));
+	for (int y = from_y; y < to_y; y++) {
+		for (int x = from_x; x < to_x; x++) {
+			_set_weight_scale(x, y, p_weight_scale);
+		}
+	}
+}
+
+Vector2 AStarGrid2D::get_point_position(const Vector2 &p_id) const {
+	ERR_FAIL_COND_V_MSG(dirty, Vector2(), "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), Vector2(), vformat("Can't get point's position. Point %s out of bounds.", p_id));
+	return offset + p_id.floor() * cell_size;
+}
+
+void AStarGrid2D::clear() {
+	size = Vector2();
+	width = 0;
+	height = 0;
+	row_words = 0;
+	column_words = 0;
+	solid_rows.reset();
+	solid_columns.reset();
+	weight_scales.reset();
+	weighted_cells = 0;
+	search_nodes.reset();
+	search_indices.clear();
+	open_list.reset();
+	dirty = false;
+}
+
+PoolVector<Vector2> AStarGrid2D::get_point_path(const Vector2 &p_from_id, const Vector2 &p_to_id) {
+	ERR_FAIL_COND_V_MSG(dirty, PoolVector<Vector2>(), "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), PoolVector<Vector2>(), vformat("Can't get point path. Point %s out of bounds.", p_from_id));
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), PoolVector<Vector2>(), vformat("Can't get point path. Point %s out of bounds.", p_to_id));
+
+	if (p_from_id.floor() == p_to_id.floor()) {
+		PoolVector<Vector2> ret;
+		ret.push_back(get_point_position(p_from_id));
+		return ret;
+	}
+
+	uint32_t end_node;
+	if (!_solve(p_from_id.floor(), p_to_id.floor(), end_node)) {
+		return PoolVector<Vector2>();
+	}
+
+	return _get_route(end_node, true);
+}
+
+PoolVector<Vector2> AStarGrid2D::get_id_path(const Vector2 &p_from_id, const Vector2 &p_to_id) {
+	ERR_FAIL_COND_V_MSG(dirty, PoolVector<Vector2>(), "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_from_id), PoolVector<Vector2>(), vformat("Can't get id path. Point %s out of bounds.", p_from_id));
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_to_id), PoolVector<Vector2>(), vformat("Can't get id path. Point %s out of bounds.", p_to_id));
+
+	if (p_from_id.floor() == p_to_id.floor()) {
+		PoolVector<Vector2> ret;
+		ret.push_back(p_from_id.floor());
+		return ret;
+	}
+
+	uint32_t end_node;
+	if (!_solve(p_from_id.floor(), p_to_id.floor(), end_node)) {
+		return PoolVector<Vector2>();
+	}
+
+	return _get_route(end_node, false);
+}
+
+void AStarGrid2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_size", "size"), &AStarGrid2D::set_size);
+	ClassDB::bind_method(D_METHOD("get_size"), &AStarGrid2D::get_size);
+	ClassDB::bind_method(D_METHOD("set_offset", "offset"), &AStarGrid2D::set_offset);
+	ClassDB::bind_method(D_METHOD("get_offset"), &AStarGrid2D::get_offset);
+	ClassDB::bind_method(D_METHOD("set_cell_size", "cell_size"), &AStarGrid2D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &AStarGrid2D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("update"), &AStarGrid2D::update);
+	ClassDB::bind_method(D_METHOD("is_dirty"), &AStarGrid2D::is_dirty);
+	ClassDB::bind_method(D_METHOD("is_in_bounds", "x", "y"), &AStarGrid2D::is_in_bounds);
+	ClassDB::bind_method(D_METHOD("is_in_boundsv", "id"), &AStarGrid2D::is_in_boundsv);
+	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("set_diagonal_mode", "mode"), &AStarGrid2D::set_diagonal_mode);
+	ClassDB::bind_method(D_METHOD("get_diagonal_mode"), &AStarGrid2D::get_diagonal_mode);
+	ClassDB::bind_method(D_METHOD("set_default_compute_heuristic", "heuristic"), &AStarGrid2D::set_default_compute_heuristic);
+	ClassDB::bind_method(D_METHOD("get_default_compute_heuristic"), &AStarGrid2D::get_default_compute_heuristic);
+	ClassDB::bind_method(D_METHOD("set_default_estimate_heuristic", "heuristic"), &AStarGrid2D::set_default_estimate_heuristic);
+	ClassDB::bind_method(D_METHOD("get_default_estimate_heuristic"), &AStarGrid2D::get_default_estimate_heuristic);
+
+	ClassDB::bind_method(D_METHOD("set_point_solid", "id", "solid"), &AStarGrid2D::set_point_solid, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_point_solid", "id"), &AStarGrid2D::is_point_solid);
+	ClassDB::bind_method(D_METHOD("set_point_weight_scale", "id", "weight_scale"), &AStarGrid2D::set_point_weight_scale);
+	ClassDB::bind_method(D_METHOD("get_point_weight_scale", "id"), &AStarGrid2D::get_point_weight_scale);
+	ClassDB::bind_method(D_METHOD("fill_solid_region", "region", "solid"), &AStarGrid2D::fill_solid_region, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("fill_weight_scale_region", "region", "weight_scale"), &AStarGrid2D::fill_weight_scale_region);
+	ClassDB::bind_method(D_METHOD("get_point_position", "id"), &AStarGrid2D::get_point_position);
+	ClassDB::bind_method(D_METHOD("clear"), &AStarGrid2D::clear);
+
+	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStarGrid2D::get_point_path);
+	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStarGrid2D::get_id_path);
+
+	BIND_VMETHOD(MethodInfo(Variant::REAL, "_estimate_cost", PropertyInfo(Variant::VECTOR2, "from_id"), PropertyInfo(Variant::VECTOR2, "to_id")));
+	BIND_VMETHOD(MethodInfo(Variant::REAL, "_compute_cost", PropertyInfo(Variant::VECTOR2, "from_id"), PropertyInfo(Variant::VECTOR2, "to_id")));
+
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "size"), "set_size", "get_size");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "offset"), "set_offset", "get_offset");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "cell_size"), "set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "diagonal_mode", PROPERTY_HINT_ENUM, "Always,Never,At Least One Walkable,Only If No Obstacles"), "set_diagonal_mode", "get_diagonal_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_compute_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_compute_heuristic", "get_default_compute_heuristic");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_estimate_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_estimate_heuristic", "get_default_estimate_heuristic");
+
+	BIND_ENUM_CONSTANT(HEURISTIC_EUCLIDEAN);
+	BIND_ENUM_CONSTANT(HEURISTIC_MANHATTAN);
+	BIND_ENUM_CONSTANT(HEURISTIC_OCTILE);
+	BIND_ENUM_CONSTANT(HEURISTIC_CHEBYSHEV);
+	BIND_ENUM_CONSTANT(HEURISTIC_MAX);
+
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_ALWAYS);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_NEVER);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_MAX);
+}
+
+AStarGrid2D::AStarGrid2D() {
+	cell_size = Vector2(1, 1);
+	dirty = false;
+	jumping_enabled = false;
+	diagonal_mode = DIAGONAL_MODE_ALWAYS;
+	default_compute_heuristic = HEURISTIC_EUCLIDEAN;
+	default_estimate_heuristic = HEURISTIC_EUCLIDEAN;
+	width = 0;
+	height = 0;
+	row_words = 0;
+	column_words = 0;
+	weighted_cells = 0;
+}
+
+AStarGrid2D::~AStarGrid2D() {
+}
@@ -0,0 +1,207 @@
+/*************************************************************************/
+/*  a_star_grid_2d.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef ASTAR_GRID_2D_H
+#define ASTAR_GRID_2D_H
+
+#include "core/local_vector.h"
+#include "core/oa_hash_map.h"
+#include "core/reference.h"
+
+/**
+	A* pathfinding on a dense grid of cells.
+
+	Cells aren't stored as points: solid cells are kept in a bitset and the neighbours are implied by the grid,
+	so large tile maps only cost a couple of bits per cell.
+*/
+
+class AStarGrid2D : public Reference {
+	GDCLASS(AStarGrid2D, Reference);
+
+public:
+	enum Heuristic {
+		HEURISTIC_EUCLIDEAN,
+		HEURISTIC_MANHATTAN,
+		HEURISTIC_OCTILE,
+		HEURISTIC_CHEBYSHEV,
+		HEURISTIC_MAX,
+	};
+
+	enum DiagonalMode {
+		DIAGONAL_MODE_ALWAYS,
+		DIAGONAL_MODE_NEVER,
+		DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE,
+		DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES,
+		DIAGONAL_MODE_MAX,
+	};
+
+private:
+	enum {
+		BORDER_BITS = 64, // Solid bits kept before the first cell of each line.
+		JUMP_BLOCKED = -1,
+		JUMP_STEP_LIMIT = 16, // Diagonal steps, or vertical ones without diagonal moves, before a jump gets cut.
+		INVALID_NODE = 0xFFFFFFFF,
+	};
+
+	struct CellHasher {
+		static _FORCE_INLINE_ uint32_t hash(const uint32_t p_cell) { return hash_one_uint64(p_cell); }
+	};
+
+	struct SearchNode {
+		int x;
+		int y;
+		uint32_t prev;
+		real_t g_score;
+		bool closed;
+	};
+
+	// Open list entries are pushed again when a shorter route is found, the stale ones are skipped when popped.
+	struct OpenEntry {
+		uint32_t node;
+		real_t g_score;
+		real_t f_score;
+	};
+
+	struct SortOpenEntries {
+		_FORCE_INLINE_ bool operator()(const OpenEntry &A, const OpenEntry &B) const { // Returns true when the entry A is worse than entry B.
+			if (A.f_score > B.f_score) {
+				return true;
+			} else if (A.f_score < B.f_score) {
+				return false;
+			} else {
+				return A.g_score < B.g_score; // If the f_costs are the same then prioritize the entries that are further away from the start.
+			}
+		}
+	};
+
+	Vector2 size;
+	Vector2 offset;
+	Vector2 cell_size;
+	bool dirty;
+	bool jumping_enabled;
+	DiagonalMode diagonal_mode;
+	Heuristic default_compute_heuristic;
+	Heuristic default_estimate_heuristic;
+
+	int width;
+	int height;
+
+	// One bit per cell, set for solid cells. The grid is surrounded by solid cells, so lookups next to the edges
+	// and jumps along a line never need bound checks. The columns hold the same bits transposed, so vertical
+	// jumps can scan whole words too.
+	uint32_t row_words;
+	uint32_t column_words;
+	LocalVector<uint64_t> solid_rows;
+	LocalVector<uint64_t> solid_columns;
+
+	// Only allocated while some cell has a weight scale other than 1.
+	LocalVector<real_t> weight_scales;
+	uint32_t weighted_cells;
+
+	// Used for pathfinding.
+	LocalVector<SearchNode> search_nodes;
+	OAHashMap<uint32_t, uint32_t, CellHasher> search_indices;
+	LocalVector<OpenEntry> open_list;
+
+	static real_t _get_heuristic_cost(Heuristic p_heuristic, const Vector2 &p_from_id, const Vector2 &p_to_id);
+
+	_FORCE_INLINE_ bool _is_walkable(int p_x, int p_y) const {
+		const uint32_t bit = p_x + BORDER_BITS;
+		return !((solid_rows[(p_y + 1) * row_words + (bit >> 6)] >> (bit & 63)) & 1);
+	}
+
+	void _set_solid(int p_x, int p_y, bool p_solid);
+	void _set_weight_scale(int p_x, int p_y, real_t p_weight_scale);
+	bool _can_move(int p_x, int p_y, int p_dx, int p_dy) const;
+	int _get_jump_directions(int p_x, int p_y, int p_dx, int p_dy, int r_directions[8][2]) const;
+	int _jump_line(bool p_vertical, int p_line, int p_from, int p_dir, int p_end_line, int p_end) const;
+	bool _jump(int p_x, int p_y, int p_dx, int p_dy, int p_end_x, int p_end_y, int &r_x, int &r_y) const;
+	void _visit(uint32_t p_from, int p_x, int p_y, real_t p_cost, const Vector2 &p_end_id);
+	bool _solve(const Vector2 &p_begin_id, const Vector2 &p_end_id, uint32_t &r_end_node);
+	PoolVector<Vector2> _get_route(uint32_t p_end_node, bool p_positions) const;
+
+protected:
+	static void _bind_methods();
+
+	virtual real_t _estimate_cost(const Vector2 &p_from_id, const Vector2 &p_to_id);
+	virtual real_t _compute_cost(const Vector2 &p_from_id, const Vector2 &p_to_id);
+
+public:
+	void set_size(const Vector2 &p_size);
+	Vector2 get_size() const;
+
+	void set_offset(const Vector2 &p_offset);
+	Vector2 get_offset() const;
+
+	void set_cell_size(const Vector2 &p_cell_size);
+	Vector2 get_cell_size() const;
+
+	void update();
+	bool is_dirty() const;
+
+	bool is_in_bounds(int p_x, int p_y) const;
+	bool is_in_boundsv(const Vector2 &p_id) const;
+
+	void set_jumping_enabled(bool p_enabled);
+	bool is_jumping_enabled() const;
+
+	void set_diagonal_mode(DiagonalMode p_diagonal_mode);
+	DiagonalMode get_diagonal_mode() const;
+
+	void set_default_compute_heuristic(Heuristic p_heuristic);
+	Heuristic get_default_compute_heuristic() const;
+
+	void set_default_estimate_heuristic(Heuristic p_heuristic);
+	Heuristic get_default_estimate_heuristic() const;
+
+	void set_point_solid(const Vector2 &p_id, bool p_solid = true);
+	bool is_point_solid(const Vector2 &p_id) const;
+
+	void set_point_weight_scale(const Vector2 &p_id, real_t p_weight_scale);
+	real_t get_point_weight_scale(const Vector2 &p_id) const;
+
+	void fill_solid_region(const Rect2 &p_region, bool p_solid = true);
+	void fill_weight_scale_region(const Rect2 &p_region, real_t p_weight_scale);
+
+	Vector2 get_point_position(const Vector2 &p_id) const;
+
+	void clear();
+
+	PoolVector<Vector2> get_point_path(const Vector2 &p_from_id, const Vector2 &p_to_id);
+	PoolVector<Vector2> get_id_path(const Vector2 &p_from_id, const Vector2 &p_to_id);
+
+	AStarGrid2D();
+	~AStarGrid2D();
+};
+
+VARIANT_ENUM_CAST(AStarGrid2D::Heuristic);
+VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
+
+#endif // ASTAR_GRID_2D_H
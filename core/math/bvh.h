@@ -207,6 +207,21 @@ public:
 		}
 	}
 
+	// moves several items while taking the lock only once,
+	// p_handles are the uint32_t handles as returned by create()
+	void move_batch(const uint32_t *p_handles, const BOUNDS *p_aabbs, int p_count) {
+		BVH_LOCKED_FUNCTION
+		for (int n = 0; n < p_count; n++) {
+			BVHHandle h;
+			h.set(p_handles[n]);
+			if (tree.item_move(h, p_aabbs[n])) {
+				if (USE_PAIRS) {
+					_add_changed_item(h, p_aabbs[n]);
+				}
+			}
+		}
+	}
+
 	void recheck_pairs(BVHHandle p_handle) {
 		BVH_LOCKED_FUNCTION
 		if (USE_PAIRS) {
@@ -399,6 +414,18 @@ public:
 
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) {
 		BVH_LOCKED_FUNCTION
+		return _cull_convex(p_convex, p_result_array, p_result_max, p_mask, nullptr);
+	}
+
+	// Does not lock, and collects hits in a list owned by the calling thread, so several threads
+	// can cull at the same time. The tree must not be modified until they are all done.
+	int cull_convex_concurrent(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) {
+		static thread_local LocalVector<uint32_t, uint32_t, true> hits;
+		return _cull_convex(p_convex, p_result_array, p_result_max, p_mask, &hits);
+	}
+
+private:
+	int _cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask, LocalVector<uint32_t, uint32_t, true> *r_hits) {
 		if (!p_convex.size()) {
 			return 0;
 		}
@@ -420,13 +447,13 @@ public:
 		params.hull.num_planes = p_convex.size();
 		params.hull.points = &convex_points[0];
 		params.hull.num_points = convex_points.size();
+		params.hits = r_hits;
 
 		tree.cull_convex(params);
 
 		return params.result_count_overall;
 	}
 
-private:
 	// do this after moving etc.
 	void _check_for_collisions(bool p_full_check = false) {
 		if (!changed_items.size()) {
@@ -30,21 +30,132 @@
 
 #include "message_queue.h"
 
+#include "core/engine.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 #include "core/project_settings.h"
 #include "core/script_language.h"
 
 MessageQueue *MessageQueue::singleton = nullptr;
 
+Mutex MessageQueue::thread_buffers_mutex;
+MessageQueue::ThreadBuffer *MessageQueue::thread_buffers = nullptr;
+SafeNumeric<uint32_t> MessageQueue::thread_messages_pending;
+SafeNumeric<uint32_t> MessageQueue::push_order;
+
+// Unregisters the buffer of a thread when it exits, leaving it to the next flush if it still has messages.
+struct MessageQueueThreadBufferRef {
+	MessageQueue::ThreadBuffer *buffer = nullptr;
+
+	~MessageQueueThreadBufferRef() {
+		if (!buffer) {
+			return;
+		}
+
+		MutexLock lock(MessageQueue::thread_buffers_mutex);
+
+		buffer->lock.lock();
+		buffer->exited = true;
+		bool empty = buffer->first == nullptr;
+		buffer->lock.unlock();
+
+		if (!empty) {
+			return;
+		}
+
+		for (MessageQueue::ThreadBuffer **link = &MessageQueue::thread_buffers; *link; link = &(*link)->next) {
+			if (*link == buffer) {
+				*link = buffer->next;
+				break;
+			}
+		}
+		memdelete(buffer);
+	}
+};
+
+static thread_local MessageQueueThreadBufferRef thread_buffer_ref;
+
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
-Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
+MessageQueue::ThreadBuffer *MessageQueue::_get_thread_buffer() {
+	if (likely(thread_buffer_ref.buffer)) {
+		return thread_buffer_ref.buffer;
+	}
+
+	ThreadBuffer *tb = memnew(ThreadBuffer);
+
+	thread_buffers_mutex.lock();
+	tb->next = thread_buffers;
+	thread_buffers = tb;
+	thread_buffers_mutex.unlock();
+
+	thread_buffer_ref.buffer = tb;
+	return tb;
+}
+
+// Returns room for a message of the given size, or null if the queue is full. When pushing from a thread other than the
+// main one, r_thread_buffer is set and stays locked until _commit_message().
+uint8_t *MessageQueue::_alloc_message(uint32_t p_size, ThreadBuffer *&r_thread_buffer) {
+	r_thread_buffer = nullptr;
+
+	if (Thread::get_caller_id() == Thread::get_main_id()) {
+		if ((buffer_end + p_size) >= buffer_size) {
+			return nullptr;
+		}
+		uint8_t *ptr = &buffer[buffer_end];
+		buffer_end += p_size;
+		return ptr;
+	}
+
+	ThreadBuffer *tb = _get_thread_buffer();
+	tb->lock.lock();
+
+	if ((tb->used + p_size) >= buffer_size) {
+		tb->lock.unlock();
+		return nullptr;
+	}
+
+	if (!tb->last || tb->last->end + p_size > tb->last->size) {
+		uint32_t page_size = MAX((uint32_t)THREAD_PAGE_SIZE, p_size);
+		Page *page = (Page *)memalloc(sizeof(Page) + page_size);
+		page->next = nullptr;
+		page->end = 0;
+		page->size = page_size;
+		if (tb->last) {
+			tb->last->next = page;
+		} else {
+			tb->first = page;
+		}
+		tb->last = page;
+	}
+
+	uint8_t *ptr = tb->last->get_data() + tb->last->end;
+	tb->last->end += p_size;
+	tb->used += p_size;
+
+	r_thread_buffer = tb;
+	return ptr;
+}
+
+void MessageQueue::_commit_message(Message *p_message, ThreadBuffer *p_thread_buffer) {
+	// Stamped while the thread buffer is still locked, so flush() never sees a later order before an earlier one.
+	p_message->order = push_order.increment();
 
+	if (p_thread_buffer) {
+		p_thread_buffer->lock.unlock();
+		thread_messages_pending.increment();
+	}
+}
+
+Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	ThreadBuffer *thread_buffer;
+	uint8_t *ptr = _alloc_message(room_needed, thread_buffer);
+
+	if (!ptr) {
 		String type;
 		if (ObjectDB::get_instance(p_id)) {
 			type = ObjectDB::get_instance(p_id)->get_class();
@@ -54,7 +165,7 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const V
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(ptr, Message);
 	msg->args = p_argcount;
 	msg->instance_id = p_id;
 	msg->target = p_method;
@@ -63,14 +174,13 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const V
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
-		*v = *p_args[i];
+		memnew_placement(&args[i], Variant(*p_args[i]));
 	}
 
+	_commit_message(msg, thread_buffer);
+
 	return OK;
 }
 
@@ -90,11 +200,12 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
-
 	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	ThreadBuffer *thread_buffer;
+	uint8_t *ptr = _alloc_message(room_needed, thread_buffer);
+
+	if (!ptr) {
 		String type;
 		if (ObjectDB::get_instance(p_id)) {
 			type = ObjectDB::get_instance(p_id)->get_class();
@@ -104,42 +215,41 @@ Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Vari
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(ptr, Message);
 	msg->args = 1;
 	msg->instance_id = p_id;
 	msg->target = p_prop;
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
+	memnew_placement((Variant *)(msg + 1), Variant(p_value));
 
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
-	*v = p_value;
+	_commit_message(msg, thread_buffer);
 
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
 	uint8_t room_needed = sizeof(Message);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
+	ThreadBuffer *thread_buffer;
+	uint8_t *ptr = _alloc_message(room_needed, thread_buffer);
+
+	if (!ptr) {
 		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
 		statistics();
 		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
 	}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(ptr, Message);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->instance_id = p_id;
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
+	_commit_message(msg, thread_buffer);
 
 	return OK;
 }
@@ -156,6 +266,10 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 void MessageQueue::statistics() {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		return; // the main buffer is only accessed from the main thread
+	}
+
 	Map<StringName, int> set_count;
 	Map<int, int> notify_count;
 	Map<StringName, int> call_count;
@@ -228,6 +342,14 @@ int MessageQueue::get_max_buffer_usage() const {
 	return buffer_max_used;
 }
 
+int MessageQueue::get_frame_message_count() const {
+	return last_frame_message_count;
+}
+
+uint64_t MessageQueue::get_frame_flush_usec() const {
+	return last_frame_flush_usec;
+}
+
 void MessageQueue::_call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error) {
 	const Variant **argptrs = nullptr;
 	if (p_argcount) {
@@ -244,75 +366,165 @@ void MessageQueue::_call_function(Object *p_target, const StringName &p_func, co
 	}
 }
 
-void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		size += sizeof(Variant) * p_message->args;
 	}
+	return size;
+}
 
-	uint32_t read_pos = 0;
+void MessageQueue::_process_message(Message *p_message) {
+	Object *target = ObjectDB::get_instance(p_message->instance_id);
 
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
+	if (target != nullptr) {
+		switch (p_message->type & FLAG_MASK) {
+			case TYPE_CALL: {
+				Variant *args = (Variant *)(p_message + 1);
 
-	ERR_FAIL_COND(flushing); //already flushing, you did something odd
-	flushing = true;
+				// messages don't expect a return value
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
+				_call_function(target, p_message->target, args, p_message->args, p_message->type & FLAG_SHOW_ERROR);
 
-		Message *message = (Message *)&buffer[read_pos];
+			} break;
+			case TYPE_NOTIFICATION: {
+				// messages don't expect a return value
+				target->notification(p_message->notification);
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+			} break;
+			case TYPE_SET: {
+				Variant *arg = (Variant *)(p_message + 1);
+				// messages don't expect a return value
+				target->set(p_message->target, *arg);
+
+			} break;
 		}
+	}
+}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
 
-		_THREAD_SAFE_UNLOCK_
+	p_message->~Message();
+}
 
-		Object *target = ObjectDB::get_instance(message->instance_id);
+// Moves the pages of all the thread buffers to thread_cursors, one cursor per thread.
+void MessageQueue::_detach_thread_pages(uint32_t &r_bytes) {
+	MutexLock lock(thread_buffers_mutex);
+
+	ThreadBuffer **link = &thread_buffers;
+	while (*link) {
+		ThreadBuffer *tb = *link;
+
+		tb->lock.lock();
+		Page *pages = tb->first;
+		r_bytes += tb->used;
+		tb->first = nullptr;
+		tb->last = nullptr;
+		tb->used = 0;
+		bool exited = tb->exited;
+		tb->lock.unlock();
+
+		if (pages) {
+			PageCursor cursor;
+			cursor.page = pages;
+			cursor.pos = 0;
+			thread_cursors.push_back(cursor);
+		}
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					Variant *args = (Variant *)(message + 1);
+		if (exited) {
+			*link = tb->next;
+			memdelete(tb);
+		} else {
+			link = &tb->next;
+		}
+	}
+}
 
-					// messages don't expect a return value
+void MessageQueue::flush() {
+	ERR_FAIL_COND(flushing); //already flushing, you did something odd
+	flushing = true;
 
-					_call_function(target, message->target, args, message->args, message->type & FLAG_SHOW_ERROR);
+	uint64_t frame = Engine::get_singleton()->get_idle_frames();
+	if (frame != stats_frame) {
+		last_frame_message_count = frame_message_count;
+		last_frame_flush_usec = frame_flush_usec;
+		frame_message_count = 0;
+		frame_flush_usec = 0;
+		stats_frame = frame;
+	}
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					// messages don't expect a return value
-					target->notification(message->notification);
+	uint64_t flush_begin = OS::get_singleton()->get_ticks_usec();
+	uint32_t thread_bytes = 0;
+	uint32_t read_pos = 0;
 
-				} break;
-				case TYPE_SET: {
-					Variant *arg = (Variant *)(message + 1);
-					// messages don't expect a return value
-					target->set(message->target, *arg);
+	while (true) {
+		if (thread_messages_pending.get()) {
+			thread_messages_pending.set(0);
+			_detach_thread_pages(thread_bytes);
+		}
 
-				} break;
-			}
+		// Run the oldest of the messages at the front of the main buffer and of each thread's pages.
+		// Only the main thread writes to the main buffer, so calls can add messages to it while it's read.
+		Message *message = nullptr;
+		int cursor_index = -1;
+
+		if (read_pos < buffer_end) {
+			message = (Message *)&buffer[read_pos];
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
+		for (uint32_t i = 0; i < thread_cursors.size(); i++) {
+			Message *thread_message = (Message *)&thread_cursors[i].page->get_data()[thread_cursors[i].pos];
+			// The order wraps around, compare the difference.
+			if (!message || (int32_t)(thread_message->order - message->order) < 0) {
+				message = thread_message;
+				cursor_index = i;
 			}
 		}
 
-		message->~Message();
+		if (!message) {
+			break;
+		}
+
+		//pre-advance so this function is reentrant
+		if (cursor_index < 0) {
+			read_pos += _get_message_size(message);
+		} else {
+			thread_cursors[cursor_index].pos += _get_message_size(message);
+		}
 
-		_THREAD_SAFE_LOCK_
+		_process_message(message);
+		_destroy_message(message);
+		frame_message_count++;
+
+		if (cursor_index >= 0) {
+			PageCursor &cursor = thread_cursors[cursor_index];
+			if (cursor.pos >= cursor.page->end) {
+				Page *next = cursor.page->next;
+				memfree(cursor.page);
+				if (next) {
+					cursor.page = next;
+					cursor.pos = 0;
+				} else {
+					thread_cursors.remove_unordered(cursor_index);
+				}
+			}
+		}
+	}
+
+	if (buffer_end + thread_bytes > buffer_max_used) {
+		buffer_max_used = buffer_end + thread_bytes;
 	}
 
 	buffer_end = 0; // reset buffer
 	flushing = false;
-	_THREAD_SAFE_UNLOCK_
+
+	frame_flush_usec += OS::get_singleton()->get_ticks_usec() - flush_begin;
 }
 
 bool MessageQueue::is_flushing() const {
@@ -326,6 +538,11 @@ MessageQueue::MessageQueue() {
 
 	buffer_end = 0;
 	buffer_max_used = 0;
+	stats_frame = 0;
+	frame_message_count = 0;
+	frame_flush_usec = 0;
+	last_frame_message_count = 0;
+	last_frame_flush_usec = 0;
 	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
 	buffer_size *= 1024;
@@ -337,18 +554,24 @@ MessageQueue::~MessageQueue() {
 
 	while (read_pos < buffer_end) {
 		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
-			}
-		}
-		message->~Message();
+		read_pos += _get_message_size(message);
+		_destroy_message(message);
+	}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+	uint32_t thread_bytes = 0;
+	_detach_thread_pages(thread_bytes);
+	for (uint32_t i = 0; i < thread_cursors.size(); i++) {
+		Page *page = thread_cursors[i].page;
+		while (page) {
+			uint32_t page_pos = 0;
+			while (page_pos < page->end) {
+				Message *message = (Message *)&page->get_data()[page_pos];
+				page_pos += _get_message_size(message);
+				_destroy_message(message);
+			}
+			Page *next = page->next;
+			memfree(page);
+			page = next;
 		}
 	}
 
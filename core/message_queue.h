@@ -31,14 +31,21 @@
 #ifndef MESSAGE_QUEUE_H
 #define MESSAGE_QUEUE_H
 
+#include "core/local_vector.h"
 #include "core/object.h"
-#include "core/os/thread_safe.h"
-
+#include "core/os/mutex.h"
+#include "core/os/spin_lock.h"
+#include "core/safe_refcount.h"
+
+// Messages pushed from the main thread go to the main buffer, which only the main thread touches. Other threads append
+// to their own paged buffers, which flush() detaches and merges with the main buffer.
+// Every message is stamped with a global push order, so flush() runs the messages of all threads in the order they
+// were pushed. Messages pushed by other threads while flushing run in the same flush if they are seen in time,
+// otherwise in the next one.
 class MessageQueue {
-	_THREAD_SAFE_CLASS_
-
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		THREAD_PAGE_SIZE = 64 * 1024
 	};
 
 	enum {
@@ -53,6 +60,7 @@ class MessageQueue {
 	struct Message {
 		ObjectID instance_id;
 		StringName target;
+		uint32_t order;
 		int16_t type;
 		union {
 			int16_t notification;
@@ -60,13 +68,59 @@ class MessageQueue {
 		};
 	};
 
+	struct Page {
+		Page *next;
+		uint32_t end;
+		uint32_t size;
+		_FORCE_INLINE_ uint8_t *get_data() { return (uint8_t *)(this + 1); }
+	};
+
+	// Read position in the detached pages of one thread.
+	struct PageCursor {
+		Page *page;
+		uint32_t pos;
+	};
+
+	struct ThreadBuffer {
+		SpinLock lock;
+		Page *first = nullptr;
+		Page *last = nullptr;
+		uint32_t used = 0;
+		bool exited = false; // the thread is gone, free once drained
+		ThreadBuffer *next = nullptr;
+	};
+
+	friend struct MessageQueueThreadBufferRef;
+
+	// Thread buffers may outlive the queue, so the list is not part of it.
+	static Mutex thread_buffers_mutex;
+	static ThreadBuffer *thread_buffers;
+	static SafeNumeric<uint32_t> thread_messages_pending;
+	static SafeNumeric<uint32_t> push_order;
+
 	uint8_t *buffer;
 	uint32_t buffer_end;
 	uint32_t buffer_max_used;
 	uint32_t buffer_size;
 
+	LocalVector<PageCursor> thread_cursors;
+
+	uint64_t stats_frame;
+	uint32_t frame_message_count;
+	uint64_t frame_flush_usec;
+	uint32_t last_frame_message_count;
+	uint64_t last_frame_flush_usec;
+
 	void _call_function(Object *p_target, const StringName &p_func, const Variant *p_args, int p_argcount, bool p_show_error);
 
+	static ThreadBuffer *_get_thread_buffer();
+	uint8_t *_alloc_message(uint32_t p_size, ThreadBuffer *&r_thread_buffer);
+	static void _commit_message(Message *p_message, ThreadBuffer *p_thread_buffer);
+	void _detach_thread_pages(uint32_t &r_bytes);
+	static uint32_t _get_message_size(const Message *p_message);
+	void _process_message(Message *p_message);
+	static void _destroy_message(Message *p_message);
+
 	static MessageQueue *singleton;
 
 	bool flushing;
@@ -90,6 +144,10 @@ public:
 
 	int get_max_buffer_usage() const;
 
+	// Statistics of the last whole frame.
+	int get_frame_message_count() const;
+	uint64_t get_frame_flush_usec() const;
+
 	MessageQueue();
 	~MessageQueue();
 };
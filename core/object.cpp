@@ -42,18 +42,6 @@
 
 #ifdef DEBUG_ENABLED
 
-struct _ObjectDebugLock {
-	Object *obj;
-
-	_ObjectDebugLock(Object *p_obj) {
-		obj = p_obj;
-		obj->_lock_index.ref();
-	}
-	~_ObjectDebugLock() {
-		obj->_lock_index.unref();
-	}
-};
-
 #define OBJ_DEBUG_LOCK _ObjectDebugLock _debug_lock(this);
 
 #else
@@ -1022,6 +1010,7 @@ void Object::set_script(const RefPtr &p_script) {
 		}
 	}
 
+	_script_instance_changed();
 	_change_notify(); //scripts may add variables, so refresh is desired
 	emit_signal(CoreStringNames::get_singleton()->script_changed);
 }
@@ -1042,6 +1031,8 @@ void Object::set_script_instance(ScriptInstance *p_instance) {
 	} else {
 		script = RefPtr();
 	}
+
+	_script_instance_changed();
 }
 
 RefPtr Object::get_script() const {
@@ -42,6 +42,7 @@
 #include "core/vmap.h"
 
 #include <atomic>
+#include <type_traits>
 
 #define VARIANT_ARG_LIST const Variant &p_arg1 = Variant(), const Variant &p_arg2 = Variant(), const Variant &p_arg3 = Variant(), const Variant &p_arg4 = Variant(), const Variant &p_arg5 = Variant()
 #define VARIANT_ARG_PASS p_arg1, p_arg2, p_arg3, p_arg4, p_arg5
@@ -326,6 +327,11 @@ public:
 		initialized = true;                                                                                                             \
 	}                                                                                                                                   \
                                                                                                                                         \
+	/* Whether the class or one of its parents below Object overrides Object::call(). */                                                \
+	static bool _class_overrides_call() {                                                                                               \
+		return !std::is_same<decltype(Object::_get_call_owner(&m_class::call)), Object *>::value;                                       \
+	}                                                                                                                                   \
+                                                                                                                                        \
 protected:                                                                                                                              \
 	virtual void _initialize_classv() {                                                                                                 \
 		initialize_class();                                                                                                             \
@@ -570,6 +576,11 @@ public: //should be protected, but bug in clang++
 	static void initialize_class();
 	_FORCE_INLINE_ static void register_custom_data_to_otdb(){};
 
+	// Deduces the class declaring the call() found through &T::call, used by _class_overrides_call().
+	template <class C>
+	static C *_get_call_owner(Variant (C::*)(const StringName &, const Variant **, int, Variant::CallError &)) { return nullptr; }
+	static bool _class_overrides_call() { return false; }
+
 public:
 #ifdef TOOLS_ENABLED
 	_FORCE_INLINE_ void _change_notify(const char *p_property = "") {
@@ -700,6 +711,7 @@ public:
 
 	void set_script_instance(ScriptInstance *p_instance);
 	_FORCE_INLINE_ ScriptInstance *get_script_instance() const { return script_instance; }
+	virtual void _script_instance_changed() {} // Also called by scripts reloaded while keeping their instances.
 
 	void set_script_and_instance(const RefPtr &p_script, ScriptInstance *p_instance); //some script languages can't control instance creation, so this function eases the process
 
@@ -757,6 +769,21 @@ public:
 	virtual ~Object();
 };
 
+#ifdef DEBUG_ENABLED
+// Keeps the object from being freed while one of its methods runs, see Object::call().
+struct _ObjectDebugLock {
+	Object *obj;
+
+	_ObjectDebugLock(Object *p_obj) {
+		obj = p_obj;
+		obj->_lock_index.ref();
+	}
+	~_ObjectDebugLock() {
+		obj->_lock_index.unref();
+	}
+};
+#endif
+
 bool predelete_handler(Object *p_object);
 void postinitialize_handler(Object *p_object);
 
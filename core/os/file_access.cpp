@@ -378,6 +378,22 @@ uint64_t FileAccess::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return i;
 }
 
+uint64_t FileAccess::get_pool_buffer(PoolVector<uint8_t> &r_buffer, uint64_t p_length) const {
+	const uint8_t *mapped = get_mapped_buffer(p_length);
+	if (mapped) {
+		r_buffer.reference_external(mapped, p_length);
+		return p_length;
+	}
+
+	r_buffer.resize(p_length);
+	if (p_length == 0) {
+		return 0;
+	}
+
+	PoolVector<uint8_t>::Write w = r_buffer.write();
+	return get_buffer(w.ptr(), p_length);
+}
+
 String FileAccess::get_as_utf8_string() const {
 	PoolVector<uint8_t> sourcef;
 	uint64_t len = get_len();
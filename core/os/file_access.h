@@ -33,6 +33,7 @@
 
 #include "core/math/math_defs.h"
 #include "core/os/memory.h"
+#include "core/pool_vector.h"
 #include "core/typedefs.h"
 #include "core/ustring.h"
 
@@ -111,6 +112,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	uint64_t get_pool_buffer(PoolVector<uint8_t> &r_buffer, uint64_t p_length) const; ///< get an array of bytes, referencing mapped memory instead of copying when possible
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -126,6 +128,9 @@ public:
 
 	virtual Error get_error() const = 0; ///< get last error
 
+	virtual const uint8_t *map_contents() { return nullptr; } ///< map the whole file read-only, valid until the file is closed; null if not supported
+	virtual const uint8_t *get_mapped_buffer(uint64_t p_length) const { return nullptr; } ///< get read-only memory for the next bytes and advance, valid after the file is closed; null if not supported
+
 	virtual void flush() = 0;
 	virtual void store_8(uint8_t p_dest) = 0; ///< store a byte
 	virtual void store_16(uint16_t p_dest); ///< store 16 bits uint
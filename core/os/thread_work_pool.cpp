@@ -0,0 +1,474 @@
+/*************************************************************************/
+/*  thread_work_pool.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "thread_work_pool.h"
+
+#include "core/object.h"
+#include "core/os/os.h"
+
+ThreadWorkPool *ThreadWorkPool::singleton = nullptr;
+
+// Queue owned by the calling thread, or -1 if it is not one of the pool workers.
+static thread_local int32_t worker_queue_index = -1;
+
+void ThreadWorkPool::_thread_function(void *p_user) {
+	ThreadData *td = (ThreadData *)p_user;
+	ThreadWorkPool *pool = td->pool;
+	worker_queue_index = td->index;
+	Thread::set_name("WorkerPool " + itos(td->index));
+
+	while (true) {
+		pool->task_available.wait();
+		if (pool->exit_threads.is_set()) {
+			break;
+		}
+		// May find nothing if a waiting thread already took the task, just go back to sleep.
+		Task *task = pool->_pop_task(td->index);
+		if (task) {
+			pool->_process_task(task);
+		}
+	}
+}
+
+bool ThreadWorkPool::is_worker_thread() const {
+	return worker_queue_index >= 0;
+}
+
+uint32_t ThreadWorkPool::_get_submit_queue() const {
+	return worker_queue_index >= 0 ? (uint32_t)worker_queue_index : thread_count;
+}
+
+void ThreadWorkPool::_post_task(Task *p_task) {
+	if (thread_count == 0) {
+		// No workers (single core or threads disabled), run right away.
+		_process_task(p_task);
+		return;
+	}
+
+	uint32_t q = _get_submit_queue();
+	p_task->queue = q;
+	queues[q].mutex.lock();
+	p_task->queue_element = queues[q].tasks.push_back(p_task);
+	queues[q].mutex.unlock();
+
+	task_available.post();
+}
+
+ThreadWorkPool::Task *ThreadWorkPool::_pop_task(uint32_t p_preferred_queue) {
+	uint32_t queue_count = thread_count + 1;
+	for (uint32_t i = 0; i < queue_count; i++) {
+		uint32_t q = (p_preferred_queue + i) % queue_count;
+		Queue &queue = queues[q];
+		MutexLock lock(queue.mutex);
+		if (queue.tasks.empty()) {
+			continue;
+		}
+		// Workers take the newest task from their own queue, since it is most likely still in cache.
+		// Stealing and the shared queue go oldest first.
+		List<Task *>::Element *E = (i == 0 && q != thread_count) ? queue.tasks.back() : queue.tasks.front();
+		Task *task = E->get();
+		task->queue_element = nullptr;
+		queue.tasks.erase(E);
+		return task;
+	}
+	return nullptr;
+}
+
+bool ThreadWorkPool::_dequeue_task(Task *p_task) {
+	Queue &queue = queues[p_task->queue];
+	MutexLock lock(queue.mutex);
+	if (!p_task->queue_element) {
+		return false; // Already running or done.
+	}
+	queue.tasks.erase(p_task->queue_element);
+	p_task->queue_element = nullptr;
+	return true;
+}
+
+void ThreadWorkPool::_process_task(Task *p_task) {
+	if (p_task->group) {
+		// Group runners are owned by the group, don't touch the task once done.
+		Group *group = p_task->group;
+		_process_group_chunks(group);
+		_finish_group_runner(group);
+		return;
+	}
+
+	if (p_task->template_userdata) {
+		p_task->template_userdata->callback();
+	} else if (p_task->native_func) {
+		p_task->native_func(p_task->native_userdata);
+	} else {
+		Object *obj = ObjectDB::get_instance(p_task->script_instance);
+		if (obj) {
+			const Variant *args[1] = { &p_task->script_userdata };
+			int argc = p_task->script_userdata.get_type() != Variant::NIL ? 1 : 0;
+			Variant::CallError ce;
+			obj->call(p_task->script_method, args, argc, ce);
+			if (ce.error != Variant::CallError::CALL_OK) {
+				ERR_PRINT("Error calling method from worker pool task: " + Variant::get_call_error_text(obj, p_task->script_method, args, argc, ce) + ".");
+			}
+		} else {
+			ERR_PRINT("Could not call function '" + String(p_task->script_method) + "' on previously freed instance from worker pool task.");
+		}
+	}
+
+	p_task->completed.set();
+	p_task->done_semaphore.post();
+}
+
+void ThreadWorkPool::_call_group_element(Group *p_group, uint32_t p_index) {
+	if (p_group->template_userdata) {
+		p_group->template_userdata->callback_indexed(p_index);
+	} else if (p_group->native_func) {
+		p_group->native_func(p_group->native_userdata, p_index);
+	} else {
+		Object *obj = ObjectDB::get_instance(p_group->script_instance);
+		ERR_FAIL_COND_MSG(!obj, "Could not call function '" + String(p_group->script_method) + "' on previously freed instance from worker pool group task.");
+
+		Variant index = p_index;
+		const Variant *args[2] = { &index, &p_group->script_userdata };
+		int argc = p_group->script_userdata.get_type() != Variant::NIL ? 2 : 1;
+		Variant::CallError ce;
+		obj->call(p_group->script_method, args, argc, ce);
+		if (ce.error != Variant::CallError::CALL_OK) {
+			ERR_PRINT("Error calling method from worker pool group task: " + Variant::get_call_error_text(obj, p_group->script_method, args, argc, ce) + ".");
+		}
+	}
+}
+
+void ThreadWorkPool::_process_group_chunks(Group *p_group) {
+	while (true) {
+		uint32_t from = p_group->next_index.postadd(p_group->chunk_size);
+		if (from >= p_group->elements) {
+			break;
+		}
+		uint32_t to = MIN(from + p_group->chunk_size, p_group->elements);
+		for (uint32_t i = from; i < to; i++) {
+			_call_group_element(p_group, i);
+		}
+		p_group->processed.add(to - from);
+	}
+}
+
+void ThreadWorkPool::_finish_group_runner(Group *p_group) {
+	if (p_group->finished_runners.increment() == p_group->runners.size()) {
+		p_group->done_semaphore.post();
+	}
+}
+
+void ThreadWorkPool::_start_group(Group *p_group, uint32_t p_max_tasks, bool p_caller_helps) {
+	if (p_group->chunk_size == 0) {
+		// A few chunks per thread, so uneven elements still balance out.
+		p_group->chunk_size = MAX(1u, p_group->elements / ((thread_count + 1) * 4));
+	}
+
+	uint32_t chunks = (p_group->elements + p_group->chunk_size - 1) / p_group->chunk_size;
+	uint32_t runner_count = MIN(thread_count, p_caller_helps ? chunks - 1 : chunks);
+	if (p_max_tasks > 0) {
+		runner_count = MIN(runner_count, p_caller_helps ? p_max_tasks - 1 : p_max_tasks);
+	}
+
+	if (runner_count == 0) {
+		if (!p_caller_helps) {
+			_process_group_chunks(p_group);
+		}
+		return;
+	}
+
+	// Create all runners before posting any, the last one to finish checks against the total.
+	p_group->runners.resize(runner_count);
+	for (uint32_t i = 0; i < runner_count; i++) {
+		Task *task = memnew(Task);
+		task->group = p_group;
+		p_group->runners[i] = task;
+	}
+	for (uint32_t i = 0; i < runner_count; i++) {
+		_post_task(p_group->runners[i]);
+	}
+}
+
+void ThreadWorkPool::_wait_task(Task *p_task) {
+	if (_dequeue_task(p_task)) {
+		// Nobody picked it up yet, run it here instead of blocking.
+		_process_task(p_task);
+	}
+	p_task->done_semaphore.wait();
+}
+
+void ThreadWorkPool::_wait_group(Group *p_group) {
+	_process_group_chunks(p_group);
+
+	if (p_group->runners.size() == 0) {
+		return;
+	}
+	for (uint32_t i = 0; i < p_group->runners.size(); i++) {
+		if (_dequeue_task(p_group->runners[i])) {
+			_finish_group_runner(p_group);
+		}
+	}
+	p_group->done_semaphore.wait();
+}
+
+void ThreadWorkPool::_free_task(Task *p_task) {
+	if (p_task->template_userdata) {
+		memdelete(p_task->template_userdata);
+	}
+	memdelete(p_task);
+}
+
+void ThreadWorkPool::_clear_group(Group *p_group) {
+	for (uint32_t i = 0; i < p_group->runners.size(); i++) {
+		memdelete(p_group->runners[i]);
+	}
+	p_group->runners.clear();
+	if (p_group->template_userdata) {
+		memdelete(p_group->template_userdata);
+		p_group->template_userdata = nullptr;
+	}
+}
+
+ThreadWorkPool::TaskID ThreadWorkPool::_add_task(Task *p_task, bool p_frame) {
+	task_mutex.lock();
+	TaskID id = last_task++;
+	p_task->self = id;
+	tasks[id] = p_task;
+	if (p_frame) {
+		frame_tasks.push_back(id);
+	}
+	task_mutex.unlock();
+
+	_post_task(p_task);
+	return id;
+}
+
+ThreadWorkPool::GroupID ThreadWorkPool::_add_group(Group *p_group, uint32_t p_max_tasks, bool p_frame) {
+	task_mutex.lock();
+	GroupID id = last_group++;
+	p_group->self = id;
+	groups[id] = p_group;
+	if (p_frame) {
+		frame_groups.push_back(id);
+	}
+	task_mutex.unlock();
+
+	_start_group(p_group, p_max_tasks, false);
+	return id;
+}
+
+ThreadWorkPool::TaskID ThreadWorkPool::add_native_task(void (*p_func)(void *), void *p_userdata, bool p_frame_task) {
+	Task *task = memnew(Task);
+	task->native_func = p_func;
+	task->native_userdata = p_userdata;
+	return _add_task(task, p_frame_task);
+}
+
+ThreadWorkPool::TaskID ThreadWorkPool::add_script_task(Object *p_instance, const StringName &p_method, const Variant &p_userdata, bool p_frame_task) {
+	ERR_FAIL_NULL_V(p_instance, INVALID_TASK_ID);
+	Task *task = memnew(Task);
+	task->script_instance = p_instance->get_instance_id();
+	task->script_method = p_method;
+	task->script_userdata = p_userdata;
+	return _add_task(task, p_frame_task);
+}
+
+bool ThreadWorkPool::is_task_completed(TaskID p_task) const {
+	MutexLock lock(task_mutex);
+	Task *const *task = tasks.getptr(p_task);
+	ERR_FAIL_COND_V_MSG(!task, false, "Invalid Task ID.");
+	return (*task)->completed.is_set();
+}
+
+void ThreadWorkPool::wait_for_task_completion(TaskID p_task) {
+	task_mutex.lock();
+	Task **taskp = tasks.getptr(p_task);
+	if (!taskp) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Invalid Task ID.");
+	}
+	Task *task = *taskp;
+	tasks.erase(p_task);
+	task_mutex.unlock();
+
+	_wait_task(task);
+	_free_task(task);
+}
+
+ThreadWorkPool::GroupID ThreadWorkPool::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, uint32_t p_elements, uint32_t p_chunk_size, uint32_t p_max_tasks, bool p_frame_task) {
+	Group *group = memnew(Group);
+	group->native_func = p_func;
+	group->native_userdata = p_userdata;
+	group->elements = p_elements;
+	group->chunk_size = p_chunk_size;
+	return _add_group(group, p_max_tasks, p_frame_task);
+}
+
+ThreadWorkPool::GroupID ThreadWorkPool::add_script_group_task(Object *p_instance, const StringName &p_method, uint32_t p_elements, const Variant &p_userdata, uint32_t p_chunk_size, uint32_t p_max_tasks, bool p_frame_task) {
+	ERR_FAIL_NULL_V(p_instance, INVALID_TASK_ID);
+	Group *group = memnew(Group);
+	group->script_instance = p_instance->get_instance_id();
+	group->script_method = p_method;
+	group->script_userdata = p_userdata;
+	group->elements = p_elements;
+	group->chunk_size = p_chunk_size;
+	return _add_group(group, p_max_tasks, p_frame_task);
+}
+
+bool ThreadWorkPool::is_group_task_completed(GroupID p_group) const {
+	MutexLock lock(task_mutex);
+	Group *const *group = groups.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!group, false, "Invalid Group ID.");
+	return (*group)->processed.get() == (*group)->elements;
+}
+
+uint32_t ThreadWorkPool::get_group_processed_element_count(GroupID p_group) const {
+	MutexLock lock(task_mutex);
+	Group *const *group = groups.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!group, 0, "Invalid Group ID.");
+	return (*group)->processed.get();
+}
+
+void ThreadWorkPool::wait_for_group_task_completion(GroupID p_group) {
+	task_mutex.lock();
+	Group **groupp = groups.getptr(p_group);
+	if (!groupp) {
+		task_mutex.unlock();
+		ERR_FAIL_MSG("Invalid Group ID.");
+	}
+	Group *group = *groupp;
+	groups.erase(p_group);
+	task_mutex.unlock();
+
+	_wait_group(group);
+	_clear_group(group);
+	memdelete(group);
+}
+
+void ThreadWorkPool::sync_frame_tasks() {
+	task_mutex.lock();
+	LocalVector<TaskID> pending_tasks = frame_tasks;
+	LocalVector<GroupID> pending_groups = frame_groups;
+	frame_tasks.clear();
+	frame_groups.clear();
+	task_mutex.unlock();
+
+	for (uint32_t i = 0; i < pending_groups.size(); i++) {
+		task_mutex.lock();
+		bool exists = groups.has(pending_groups[i]);
+		task_mutex.unlock();
+		if (exists) { // May have been waited for explicitly already.
+			wait_for_group_task_completion(pending_groups[i]);
+		}
+	}
+	for (uint32_t i = 0; i < pending_tasks.size(); i++) {
+		task_mutex.lock();
+		bool exists = tasks.has(pending_tasks[i]);
+		task_mutex.unlock();
+		if (exists) {
+			wait_for_task_completion(pending_tasks[i]);
+		}
+	}
+}
+
+void ThreadWorkPool::init(int p_thread_count) {
+	ERR_FAIL_COND(threads != nullptr || queues != nullptr);
+
+#ifdef NO_THREADS
+	p_thread_count = 0;
+#else
+	if (p_thread_count < 0) {
+		// The thread waiting on the work also helps, so leave a core for it.
+		p_thread_count = MAX(1, OS::get_singleton()->get_processor_count() - 1);
+	}
+#endif
+
+	thread_count = p_thread_count;
+	queues = memnew_arr(Queue, thread_count + 1);
+	if (thread_count == 0) {
+		return;
+	}
+
+	exit_threads.clear();
+	threads = memnew_arr(ThreadData, thread_count);
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].pool = this;
+		threads[i].index = i;
+		threads[i].thread.start(&ThreadWorkPool::_thread_function, &threads[i]);
+	}
+}
+
+void ThreadWorkPool::finish() {
+	sync_frame_tasks();
+
+	if (threads) {
+		exit_threads.set();
+		for (uint32_t i = 0; i < thread_count; i++) {
+			task_available.post();
+		}
+		for (uint32_t i = 0; i < thread_count; i++) {
+			threads[i].thread.wait_to_finish();
+		}
+		memdelete_arr(threads);
+		threads = nullptr;
+	}
+
+	if (queues) {
+		memdelete_arr(queues);
+		queues = nullptr;
+	}
+
+	task_mutex.lock();
+	if (tasks.size() || groups.size()) {
+		WARN_PRINT("ThreadWorkPool finished with " + itos(tasks.size()) + " task(s) and " + itos(groups.size()) + " group task(s) that were never waited for.");
+	}
+	const TaskID *task_key = nullptr;
+	while ((task_key = tasks.next(task_key))) {
+		_free_task(tasks[*task_key]);
+	}
+	tasks.clear();
+	const GroupID *group_key = nullptr;
+	while ((group_key = groups.next(group_key))) {
+		_clear_group(groups[*group_key]);
+		memdelete(groups[*group_key]);
+	}
+	groups.clear();
+	task_mutex.unlock();
+
+	thread_count = 0;
+}
+
+ThreadWorkPool::ThreadWorkPool() {
+	singleton = this;
+}
+
+ThreadWorkPool::~ThreadWorkPool() {
+	finish();
+	singleton = nullptr;
+}
@@ -0,0 +1,248 @@
+/*************************************************************************/
+/*  thread_work_pool.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef THREAD_WORK_POOL_H
+#define THREAD_WORK_POOL_H
+
+#include "core/hash_map.h"
+#include "core/list.h"
+#include "core/local_vector.h"
+#include "core/object_id.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "core/string_name.h"
+#include "core/variant.h"
+
+// Persistent pool of worker threads shared by the whole engine.
+// Tasks submitted from a worker go to that worker's own queue, tasks submitted
+// from any other thread go to a shared queue, and idle workers steal from the
+// other queues. Threads that wait for a task or a group help process it instead
+// of blocking, so waiting from inside a task is safe.
+class ThreadWorkPool {
+public:
+	typedef int64_t TaskID;
+	typedef int64_t GroupID;
+
+	enum {
+		INVALID_TASK_ID = -1,
+	};
+
+private:
+	struct BaseTemplateUserdata {
+		virtual void callback() {}
+		virtual void callback_indexed(uint32_t p_index) {}
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	template <class C, class M, class U>
+	struct TaskUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback() {
+			(instance->*method)(userdata);
+		}
+	};
+
+	template <class C, class M, class U>
+	struct GroupUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback_indexed(uint32_t p_index) {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+	struct Group;
+
+	struct Task {
+		TaskID self = INVALID_TASK_ID;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		void (*native_func)(void *) = nullptr;
+		void *native_userdata = nullptr;
+		ObjectID script_instance = 0;
+		StringName script_method;
+		Variant script_userdata;
+		Group *group = nullptr; // Set when this task is one of the runners of a group.
+		uint32_t queue = 0;
+		List<Task *>::Element *queue_element = nullptr; // Only valid while queued, protected by the queue mutex.
+		SafeFlag completed;
+		Semaphore done_semaphore;
+	};
+
+	struct Group {
+		GroupID self = INVALID_TASK_ID;
+		BaseTemplateUserdata *template_userdata = nullptr;
+		void (*native_func)(void *, uint32_t) = nullptr;
+		void *native_userdata = nullptr;
+		ObjectID script_instance = 0;
+		StringName script_method;
+		Variant script_userdata;
+		uint32_t elements = 0;
+		uint32_t chunk_size = 1;
+		SafeNumeric<uint32_t> next_index;
+		SafeNumeric<uint32_t> processed;
+		SafeNumeric<uint32_t> finished_runners;
+		LocalVector<Task *> runners;
+		Semaphore done_semaphore;
+	};
+
+	struct Queue {
+		BinaryMutex mutex;
+		List<Task *> tasks;
+	};
+
+	struct ThreadData {
+		ThreadWorkPool *pool = nullptr;
+		uint32_t index = 0;
+		Thread thread;
+	};
+
+	static ThreadWorkPool *singleton;
+
+	ThreadData *threads = nullptr;
+	uint32_t thread_count = 0;
+	// One queue per worker, plus a shared one (the last) for external submitters.
+	Queue *queues = nullptr;
+	Semaphore task_available;
+	SafeFlag exit_threads;
+
+	BinaryMutex task_mutex;
+	HashMap<TaskID, Task *> tasks;
+	HashMap<GroupID, Group *> groups;
+	TaskID last_task = 1;
+	GroupID last_group = 1;
+	LocalVector<TaskID> frame_tasks;
+	LocalVector<GroupID> frame_groups;
+
+	static void _thread_function(void *p_user);
+
+	uint32_t _get_submit_queue() const;
+	void _post_task(Task *p_task);
+	Task *_pop_task(uint32_t p_preferred_queue);
+	bool _dequeue_task(Task *p_task);
+	void _process_task(Task *p_task);
+	void _process_group_chunks(Group *p_group);
+	void _call_group_element(Group *p_group, uint32_t p_index);
+	void _finish_group_runner(Group *p_group);
+
+	TaskID _add_task(Task *p_task, bool p_frame);
+	GroupID _add_group(Group *p_group, uint32_t p_max_tasks, bool p_frame);
+	void _start_group(Group *p_group, uint32_t p_max_tasks, bool p_caller_helps);
+	void _wait_task(Task *p_task);
+	void _free_task(Task *p_task);
+	void _wait_group(Group *p_group);
+	void _clear_group(Group *p_group);
+
+public:
+	static ThreadWorkPool *get_singleton() { return singleton; }
+
+	_FORCE_INLINE_ uint32_t get_thread_count() const { return thread_count; }
+	bool is_worker_thread() const;
+
+	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, bool p_frame_task = false);
+
+	template <class C, class M, class U>
+	TaskID add_template_task(C *p_instance, M p_method, U p_userdata, bool p_frame_task = false) {
+		TaskUserData<C, M, U> *ud = memnew((TaskUserData<C, M, U>));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Task *task = memnew(Task);
+		task->template_userdata = ud;
+		return _add_task(task, p_frame_task);
+	}
+
+	TaskID add_script_task(Object *p_instance, const StringName &p_method, const Variant &p_userdata = Variant(), bool p_frame_task = false);
+
+	bool is_task_completed(TaskID p_task) const;
+	void wait_for_task_completion(TaskID p_task);
+
+	// p_chunk_size is the amount of consecutive elements a runner claims at once (0 picks one automatically).
+	// p_max_tasks limits how many workers may take part (0 uses all of them).
+	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, uint32_t p_elements, uint32_t p_chunk_size = 0, uint32_t p_max_tasks = 0, bool p_frame_task = false);
+
+	template <class C, class M, class U>
+	GroupID add_template_group_task(C *p_instance, M p_method, U p_userdata, uint32_t p_elements, uint32_t p_chunk_size = 0, uint32_t p_max_tasks = 0, bool p_frame_task = false) {
+		GroupUserData<C, M, U> *ud = memnew((GroupUserData<C, M, U>));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+
+		Group *group = memnew(Group);
+		group->template_userdata = ud;
+		group->elements = p_elements;
+		group->chunk_size = p_chunk_size;
+		return _add_group(group, p_max_tasks, p_frame_task);
+	}
+
+	GroupID add_script_group_task(Object *p_instance, const StringName &p_method, uint32_t p_elements, const Variant &p_userdata = Variant(), uint32_t p_chunk_size = 0, uint32_t p_max_tasks = 0, bool p_frame_task = false);
+
+	bool is_group_task_completed(GroupID p_group) const;
+	uint32_t get_group_processed_element_count(GroupID p_group) const;
+	void wait_for_group_task_completion(GroupID p_group);
+
+	// Blocking parallel for, the calling thread takes part in the work.
+	// Nothing is registered in the task tables, so this is the cheapest way to split work every frame.
+	template <class C, class M, class U>
+	void do_parallel_for(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, uint32_t p_chunk_size = 0, uint32_t p_max_tasks = 0) {
+		if (p_elements == 0) {
+			return;
+		}
+		GroupUserData<C, M, U> ud;
+		ud.instance = p_instance;
+		ud.method = p_method;
+		ud.userdata = p_userdata;
+
+		Group group;
+		group.template_userdata = &ud;
+		group.elements = p_elements;
+		group.chunk_size = p_chunk_size;
+		_start_group(&group, p_max_tasks, true);
+		_wait_group(&group);
+		group.template_userdata = nullptr;
+		_clear_group(&group);
+	}
+
+	// Waits for every task and group submitted as a frame task. Called by Main at the end of each iteration.
+	void sync_frame_tasks();
+
+	void init(int p_thread_count = -1);
+	void finish();
+
+	ThreadWorkPool();
+	~ThreadWorkPool();
+};
+
+#endif // THREAD_WORK_POOL_H
@@ -35,6 +35,7 @@
 #include "core/os/os.h"
 #include "core/os/thread.h"
 #include "core/os/thread_safe.h"
+#include "core/os/thread_work_pool.h"
 #include "core/safe_refcount.h"
 
 template <class C, class U>
@@ -68,6 +69,20 @@ void process_array_thread(void *ud) {
 // Negative values subtract from the total number of logical CPU cores available.
 template <class C, class M, class U>
 void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, int p_num_threads = 0) {
+	int thread_count;
+	if (p_num_threads <= 0) {
+		thread_count = MAX(1, OS::get_singleton()->get_processor_count() + p_num_threads);
+	} else {
+		thread_count = p_num_threads;
+	}
+
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	if (pool && pool->get_thread_count() > 0) {
+		// Reuse the engine workers instead of spawning threads. The calling thread takes part too.
+		pool->do_parallel_for(p_elements, p_instance, p_method, p_userdata, 1, thread_count + 1);
+		return;
+	}
+
 	ThreadArrayProcessData<C, U> data;
 	data.method = p_method;
 	data.instance = p_instance;
@@ -76,13 +91,6 @@ void thread_process_array(uint32_t p_elements, C *p_instance, M p_method, U p_us
 	data.elements = p_elements;
 	data.process(0); //process first, let threads increment for next
 
-	int thread_count;
-	if (p_num_threads <= 0) {
-		thread_count = MAX(1, OS::get_singleton()->get_processor_count() + p_num_threads);
-	} else {
-		thread_count = p_num_threads;
-	}
-
 	Thread *threads = memnew_arr(Thread, thread_count);
 
 	for (int i = 0; i < thread_count; i++) {
@@ -51,6 +51,7 @@ struct MemoryPool {
 		void *mem;
 		PoolAllocator::ID pool_id;
 		size_t size;
+		bool external; // mem is read-only and owned elsewhere (such as a memory mapped file), copied on write
 
 		Alloc *free_list;
 
@@ -59,6 +60,7 @@ struct MemoryPool {
 				mem(nullptr),
 				pool_id(POOL_ALLOCATOR_INVALID_ID),
 				size(0),
+				external(false),
 				free_list(nullptr) {
 		}
 	};
@@ -87,7 +89,7 @@ class PoolVector {
 		//		ERR_FAIL_COND(alloc->lock>0); should not be illegal to lock this for copy on write, as it's a copy on write after all
 
 		// Refcount should not be zero, otherwise it's a misuse of COW
-		if (alloc->refcount.get() == 1) {
+		if (alloc->refcount.get() == 1 && !alloc->external) {
 			return; //nothing to do
 		}
 
@@ -112,6 +114,7 @@ class PoolVector {
 		alloc->refcount.init();
 		alloc->pool_id = POOL_ALLOCATOR_INVALID_ID;
 		alloc->lock.set(0);
+		alloc->external = false;
 
 #ifdef DEBUG_ENABLED
 		MemoryPool::total_memory += alloc->size;
@@ -166,9 +169,12 @@ class PoolVector {
 				//if none, create
 				//if some resize
 			} else {
-				memfree(old_alloc->mem);
+				if (!old_alloc->external) {
+					memfree(old_alloc->mem);
+				}
 				old_alloc->mem = nullptr;
 				old_alloc->size = 0;
+				old_alloc->external = false;
 
 				MemoryPool::alloc_mutex.lock();
 				old_alloc->free_list = MemoryPool::free_list;
@@ -232,9 +238,12 @@ class PoolVector {
 			//if none, create
 			//if some resize
 		} else {
-			memfree(alloc->mem);
+			if (!alloc->external) {
+				memfree(alloc->mem);
+			}
 			alloc->mem = nullptr;
 			alloc->size = 0;
+			alloc->external = false;
 
 			MemoryPool::alloc_mutex.lock();
 			alloc->free_list = MemoryPool::free_list;
@@ -444,6 +453,11 @@ public:
 
 	bool is_locked() const { return alloc && alloc->lock.get() > 0; }
 
+	// References read-only memory owned elsewhere (such as a memory mapped file) instead of copying it. The
+	// memory must outlive the vector and its copies, and is copied on the first write. Only for plain types.
+	void reference_external(const T *p_mem, int p_size);
+	bool is_external() const { return alloc && alloc->external; }
+
 	inline T operator[](int p_index) const;
 
 	Error resize(int p_size);
@@ -522,6 +536,7 @@ Error PoolVector<T>::resize(int p_size) {
 		alloc->size = 0;
 		alloc->refcount.init();
 		alloc->pool_id = POOL_ALLOCATOR_INVALID_ID;
+		alloc->external = false;
 		MemoryPool::alloc_mutex.unlock();
 
 	} else {
@@ -608,6 +623,45 @@ Error PoolVector<T>::resize(int p_size) {
 	return OK;
 }
 
+template <class T>
+void PoolVector<T>::reference_external(const T *p_mem, int p_size) {
+	ERR_FAIL_COND_MSG(p_size < 0, "Size of PoolVector cannot be negative.");
+
+	_unreference();
+
+	if (p_size == 0) {
+		return;
+	}
+
+	MemoryPool::alloc_mutex.lock();
+	if (MemoryPool::allocs_used == MemoryPool::alloc_count) {
+		MemoryPool::alloc_mutex.unlock();
+		ERR_FAIL_MSG("All memory pool allocations are in use.");
+	}
+
+	//take one from the free list
+	alloc = MemoryPool::free_list;
+	MemoryPool::free_list = alloc->free_list;
+	//increment the used counter
+	MemoryPool::allocs_used++;
+
+	alloc->size = sizeof(T) * p_size;
+	alloc->refcount.init();
+	alloc->pool_id = POOL_ALLOCATOR_INVALID_ID;
+	alloc->lock.set(0);
+	alloc->mem = const_cast<T *>(p_mem);
+	alloc->external = true;
+
+#ifdef DEBUG_ENABLED
+	MemoryPool::total_memory += alloc->size;
+	if (MemoryPool::total_memory > MemoryPool::max_memory) {
+		MemoryPool::max_memory = MemoryPool::total_memory;
+	}
+#endif
+
+	MemoryPool::alloc_mutex.unlock();
+}
+
 template <class T>
 void PoolVector<T>::invert() {
 	T temp;
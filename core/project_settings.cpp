@@ -1060,6 +1060,8 @@ ProjectSettings::ProjectSettings() {
 	extensions.push_back("gdshader");
 	extensions.push_back("shader");
 
+	GLOBAL_DEF("editor/import/use_multiple_threads", true);
+
 	GLOBAL_DEF("editor/main_run_args", "");
 
 	GLOBAL_DEF("editor/search_in_file_extensions", extensions);
@@ -33,8 +33,8 @@
 RID_Data::~RID_Data() {
 }
 
-SafeRefCount RID_OwnerBase::refcount;
+SafeNumeric<uint32_t> RID_OwnerBase::id_counter;
 
 void RID_OwnerBase::init_rid() {
-	refcount.init();
+	id_counter.set(1);
 }
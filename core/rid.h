@@ -32,7 +32,9 @@
 #define RID_H
 
 #include "core/list.h"
+#include "core/local_vector.h"
 #include "core/os/memory.h"
+#include "core/os/spin_lock.h"
 #include "core/safe_refcount.h"
 #include "core/set.h"
 #include "core/typedefs.h"
@@ -40,73 +42,64 @@
 class RID_OwnerBase;
 
 class RID_Data {
-	friend class RID_OwnerBase;
-
-#ifndef DEBUG_ENABLED
-	RID_OwnerBase *_owner;
-#endif
-	uint32_t _id;
-
 public:
-	_FORCE_INLINE_ uint32_t get_id() const { return _id; }
-
 	virtual ~RID_Data();
 };
 
 class RID {
 	friend class RID_OwnerBase;
 
-	mutable RID_Data *_data;
+	// Slot index in the owner in the high 32 bits, unique ID in the low 32 bits.
+	uint64_t _id;
 
 public:
-	_FORCE_INLINE_ RID_Data *get_data() const { return _data; }
-
 	_FORCE_INLINE_ bool operator==(const RID &p_rid) const {
-		return _data == p_rid._data;
+		return _id == p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator<(const RID &p_rid) const {
-		return _data < p_rid._data;
+		return _id < p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator<=(const RID &p_rid) const {
-		return _data <= p_rid._data;
+		return _id <= p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator>(const RID &p_rid) const {
-		return _data > p_rid._data;
+		return _id > p_rid._id;
 	}
 	_FORCE_INLINE_ bool operator!=(const RID &p_rid) const {
-		return _data != p_rid._data;
+		return _id != p_rid._id;
 	}
-	_FORCE_INLINE_ bool is_valid() const { return _data != nullptr; }
+	_FORCE_INLINE_ bool is_valid() const { return _id != 0; }
 
-	_FORCE_INLINE_ uint32_t get_id() const { return _data ? _data->get_id() : 0; }
+	_FORCE_INLINE_ uint32_t get_id() const { return (uint32_t)(_id & 0xFFFFFFFF); }
 
 	_FORCE_INLINE_ RID() {
-		_data = nullptr;
+		_id = 0;
 	}
 };
 
 class RID_OwnerBase {
 protected:
-	static SafeRefCount refcount;
-	_FORCE_INLINE_ void _set_data(RID &p_rid, RID_Data *p_data) {
-		p_rid._data = p_data;
-		refcount.ref();
-		p_data->_id = refcount.get();
-#ifndef DEBUG_ENABLED
-		p_data->_owner = this;
-#endif
-	}
+	static SafeNumeric<uint32_t> id_counter;
 
-#ifndef DEBUG_ENABLED
+	_FORCE_INLINE_ static RID _make_rid(uint32_t p_index) {
+		uint32_t id = id_counter.increment();
+		if (unlikely(id == 0)) {
+			id = id_counter.increment(); // wrapped around, zero means invalid
+		}
+		RID rid;
+		rid._id = ((uint64_t)p_index << 32) | id;
+		return rid;
+	}
 
-	_FORCE_INLINE_ bool _is_owner(const RID &p_rid) const {
-		return this == p_rid._data->_owner;
+	_FORCE_INLINE_ static uint32_t _get_index(const RID &p_rid) {
+		return (uint32_t)(p_rid._id >> 32);
 	}
 
-	_FORCE_INLINE_ void _remove_owner(RID &p_rid) {
-		p_rid._data->_owner = NULL;
+	_FORCE_INLINE_ static RID _make_rid(uint32_t p_index, uint32_t p_id) {
+		RID rid;
+		rid._id = ((uint64_t)p_index << 32) | p_id;
+		return rid;
 	}
-#endif
 
 public:
 	virtual void get_owned_list(List<RID> *p_owned) = 0;
@@ -115,75 +108,191 @@ public:
 	virtual ~RID_OwnerBase() {}
 };
 
+// Slot map of the objects behind RIDs. Slots are allocated in chunks that never move, and a RID stores its slot index
+// along with a unique ID, so lookups are validated in constant time without touching the (possibly freed) object.
 template <class T>
 class RID_Owner : public RID_OwnerBase {
-public:
-#ifdef DEBUG_ENABLED
-	mutable Set<RID_Data *> id_map;
-#endif
+	enum {
+		CHUNK_SHIFT = 8,
+		CHUNK_SIZE = 1 << CHUNK_SHIFT,
+		CHUNK_MASK = CHUNK_SIZE - 1,
+	};
+
+	struct Slot {
+		T *data;
+		uint32_t id; // zero when the slot is free
+	};
+
+	// Lookups may run on other threads while slots are added, so replaced chunk arrays are only freed on destruction.
+	Slot **chunks;
+	uint32_t chunk_count;
+	uint32_t chunk_capacity;
+	LocalVector<Slot **> old_chunk_arrays;
+
+	uint32_t slot_count;
+	uint32_t rid_count;
+	LocalVector<uint32_t> free_slots;
+
+	SpinLock spin_lock;
+
+	_FORCE_INLINE_ Slot *_get_slot(const RID &p_rid) const {
+		uint32_t index = _get_index(p_rid);
+		if (unlikely(index >= slot_count)) {
+			return nullptr;
+		}
+		Slot *slot = &chunks[index >> CHUNK_SHIFT][index & CHUNK_MASK];
+		if (unlikely(slot->id != p_rid.get_id())) {
+			return nullptr;
+		}
+		return slot;
+	}
+
+	uint32_t _alloc_slot() {
+		if (free_slots.size()) {
+			uint32_t index = free_slots[free_slots.size() - 1];
+			free_slots.resize(free_slots.size() - 1);
+			return index;
+		}
+
+		if ((slot_count & CHUNK_MASK) == 0) {
+			if (chunk_count == chunk_capacity) {
+				uint32_t new_capacity = chunk_capacity ? chunk_capacity * 2 : 4;
+				Slot **new_chunks = (Slot **)memalloc(sizeof(Slot *) * new_capacity);
+				for (uint32_t i = 0; i < chunk_count; i++) {
+					new_chunks[i] = chunks[i];
+				}
+				if (chunks) {
+					old_chunk_arrays.push_back(chunks);
+				}
+				chunks = new_chunks;
+				chunk_capacity = new_capacity;
+			}
+
+			Slot *chunk = (Slot *)memalloc(sizeof(Slot) * CHUNK_SIZE);
+			for (uint32_t i = 0; i < CHUNK_SIZE; i++) {
+				chunk[i].data = nullptr;
+				chunk[i].id = 0;
+			}
+			chunks[chunk_count++] = chunk;
+		}
+
+		return slot_count++;
+	}
+
 public:
 	_FORCE_INLINE_ RID make_rid(T *p_data) {
-		RID rid;
-		_set_data(rid, p_data);
-
-#ifdef DEBUG_ENABLED
-		id_map.insert(p_data);
-#endif
+		spin_lock.lock();
+		uint32_t index = _alloc_slot();
+		RID rid = _make_rid(index);
+		Slot *slot = &chunks[index >> CHUNK_SHIFT][index & CHUNK_MASK];
+		slot->data = p_data;
+		slot->id = rid.get_id();
+		rid_count++;
+		spin_lock.unlock();
 
 		return rid;
 	}
 
 	_FORCE_INLINE_ T *get(const RID &p_rid) {
 #ifdef DEBUG_ENABLED
-
 		ERR_FAIL_COND_V(!p_rid.is_valid(), nullptr);
-		ERR_FAIL_COND_V(!id_map.has(p_rid.get_data()), nullptr);
 #endif
-		return static_cast<T *>(p_rid.get_data());
+		Slot *slot = _get_slot(p_rid);
+#ifdef DEBUG_ENABLED
+		ERR_FAIL_COND_V(!slot, nullptr);
+#endif
+		return slot ? slot->data : nullptr;
 	}
 
 	_FORCE_INLINE_ T *getornull(const RID &p_rid) {
-#ifdef DEBUG_ENABLED
-
-		if (p_rid.get_data()) {
-			ERR_FAIL_COND_V(!id_map.has(p_rid.get_data()), nullptr);
+		if (!p_rid.is_valid()) {
+			return nullptr;
 		}
+		Slot *slot = _get_slot(p_rid);
+#ifdef DEBUG_ENABLED
+		ERR_FAIL_COND_V(!slot, nullptr);
 #endif
-		return static_cast<T *>(p_rid.get_data());
+		return slot ? slot->data : nullptr;
 	}
 
+	// Unlike get(), does not report errors, returns null if the RID is not owned.
 	_FORCE_INLINE_ T *getptr(const RID &p_rid) {
-		return static_cast<T *>(p_rid.get_data());
+		Slot *slot = _get_slot(p_rid);
+		return slot ? slot->data : nullptr;
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
-		if (p_rid.get_data() == nullptr) {
+		if (!p_rid.is_valid()) {
 			return false;
 		}
-#ifdef DEBUG_ENABLED
-		return id_map.has(p_rid.get_data());
-#else
-		return _is_owner(p_rid);
-#endif
+		return _get_slot(p_rid) != nullptr;
 	}
 
 	void free(RID p_rid) {
-#ifdef DEBUG_ENABLED
-		id_map.erase(p_rid.get_data());
-#else
-		_remove_owner(p_rid);
-#endif
+		spin_lock.lock();
+		Slot *slot = p_rid.is_valid() ? _get_slot(p_rid) : nullptr;
+		if (!slot) {
+			spin_lock.unlock();
+			ERR_FAIL_MSG("Attempted to free a RID that is not owned.");
+		}
+		slot->data = nullptr;
+		slot->id = 0;
+		free_slots.push_back(_get_index(p_rid));
+		rid_count--;
+		spin_lock.unlock();
+	}
+
+	_FORCE_INLINE_ uint32_t get_rid_count() const { return rid_count; }
+
+	// Fills the buffer (get_rid_count() elements) with all owned RIDs, in slot order.
+	void fill_owned_buffer(RID *p_rid_buffer) const {
+		uint32_t idx = 0;
+		for (uint32_t i = 0; i < slot_count; i++) {
+			const Slot &slot = chunks[i >> CHUNK_SHIFT][i & CHUNK_MASK];
+			if (slot.id) {
+				p_rid_buffer[idx++] = _make_rid(i, slot.id);
+			}
+		}
+	}
+
+	// Calls p_method with every owned object, in slot order. Cheaper than going through the RIDs.
+	template <class M>
+	void for_each_owned(M p_method) const {
+		for (uint32_t i = 0; i < slot_count; i++) {
+			const Slot &slot = chunks[i >> CHUNK_SHIFT][i & CHUNK_MASK];
+			if (slot.id) {
+				p_method(slot.data);
+			}
+		}
 	}
 
 	void get_owned_list(List<RID> *p_owned) {
-#ifdef DEBUG_ENABLED
+		for (uint32_t i = 0; i < slot_count; i++) {
+			const Slot &slot = chunks[i >> CHUNK_SHIFT][i & CHUNK_MASK];
+			if (slot.id) {
+				p_owned->push_back(_make_rid(i, slot.id));
+			}
+		}
+	}
+
+	RID_Owner() :
+			chunks(nullptr),
+			chunk_count(0),
+			chunk_capacity(0),
+			slot_count(0),
+			rid_count(0) {
+	}
 
-		for (typename Set<RID_Data *>::Element *E = id_map.front(); E; E = E->next()) {
-			RID r;
-			_set_data(r, static_cast<T *>(E->get()));
-			p_owned->push_back(r);
+	~RID_Owner() {
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			memfree(chunks[i]);
+		}
+		if (chunks) {
+			memfree(chunks);
+		}
+		for (uint32_t i = 0; i < old_chunk_arrays.size(); i++) {
+			memfree(old_chunk_arrays[i]);
 		}
-#endif
 	}
 };
 
@@ -39,69 +39,180 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+StringName::_Shard StringName::_shards[STRING_TABLE_SHARD_COUNT];
 
 StringName _scs_create(const char *p_chr) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr)) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::lock;
+
+bool StringName::_Data::matches(const char *p_name) const {
+	if (cname) {
+		return strcmp(cname, p_name) == 0;
+	}
+	return name == p_name;
+}
+
+bool StringName::_Data::matches(const CharType *p_name) const {
+	if (cname) {
+		const char *c = cname;
+		while (*c && (CharType)(uint8_t)*c == *p_name) {
+			c++;
+			p_name++;
+		}
+		return *c == 0 && *p_name == 0;
+	}
+	return name == p_name;
+}
+
+bool StringName::_Data::matches(const String &p_name) const {
+	if (cname) {
+		return p_name == cname;
+	}
+	return name == p_name;
+}
+
+// Must be called with the shard locked. Returns the data with a reference taken for the caller (immortal data is
+// returned as is), or null if the name is not in the table.
+template <class T>
+StringName::_Data *StringName::_find(_Shard &p_shard, uint32_t p_hash, const T &p_name) {
+	_Data *data = p_shard.table[p_hash & p_shard.mask];
+
+	while (data) {
+		// compare hash first
+		if (data->hash == p_hash && data->matches(p_name)) {
+			break;
+		}
+		data = data->next;
+	}
+
+	if (data && (data->immortal.is_set() || data->refcount.ref())) {
+		return data;
+	}
+	// If the reference count already dropped to zero, the data is about to be removed, so it's like it wasn't found.
+	return nullptr;
+}
+
+// Must be called with the shard locked.
+void StringName::_insert(_Shard &p_shard, _Data *p_data) {
+	if (p_shard.count > p_shard.mask) {
+		// Grow to keep the load factor under one.
+		uint32_t new_len = (p_shard.mask + 1) * 2;
+		_Data **new_table = (_Data **)memalloc(sizeof(_Data *) * new_len);
+		for (uint32_t i = 0; i < new_len; i++) {
+			new_table[i] = nullptr;
+		}
+
+		for (uint32_t i = 0; i <= p_shard.mask; i++) {
+			_Data *d = p_shard.table[i];
+			while (d) {
+				_Data *next = d->next;
+				uint32_t idx = d->hash & (new_len - 1);
+				d->prev = nullptr;
+				d->next = new_table[idx];
+				if (new_table[idx]) {
+					new_table[idx]->prev = d;
+				}
+				new_table[idx] = d;
+				d = next;
+			}
+		}
+
+		memfree(p_shard.table);
+		p_shard.table = new_table;
+		p_shard.mask = new_len - 1;
+	}
+
+	uint32_t idx = p_data->hash & p_shard.mask;
+	p_data->next = p_shard.table[idx];
+	p_data->prev = nullptr;
+	if (p_shard.table[idx]) {
+		p_shard.table[idx]->prev = p_data;
+	}
+	p_shard.table[idx] = p_data;
+	p_shard.count++;
+}
 
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+	for (int i = 0; i < STRING_TABLE_SHARD_COUNT; i++) {
+		_Shard &shard = _shards[i];
+		shard.table = (_Data **)memalloc(sizeof(_Data *) * STRING_TABLE_SHARD_INITIAL_LEN);
+		for (int j = 0; j < STRING_TABLE_SHARD_INITIAL_LEN; j++) {
+			shard.table[j] = nullptr;
+		}
+		shard.mask = STRING_TABLE_SHARD_INITIAL_LEN - 1;
+		shard.count = 0;
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	lock.lock();
-
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
-			lost_strings++;
-			if (OS::get_singleton()->is_stdout_verbose()) {
-				if (d->cname) {
-					print_line("Orphan StringName: " + String(d->cname));
-				} else {
-					print_line("Orphan StringName: " + String(d->name));
+	for (int i = 0; i < STRING_TABLE_SHARD_COUNT; i++) {
+		// Only called at exit, from a single thread. Not locking, as printing could intern names.
+		_Shard &shard = _shards[i];
+
+		for (uint32_t j = 0; j <= shard.mask; j++) {
+			while (shard.table[j]) {
+				_Data *d = shard.table[j];
+				if (!d->immortal.is_set()) {
+					// Immortal names are never released, so they are not lost.
+					lost_strings++;
+					if (OS::get_singleton()->is_stdout_verbose()) {
+						if (d->cname) {
+							print_line("Orphan StringName: " + String(d->cname));
+						} else {
+							print_line("Orphan StringName: " + String(d->name));
+						}
+					}
 				}
-			}
 
-			_table[i] = _table[i]->next;
-			memdelete(d);
+				shard.table[j] = shard.table[j]->next;
+				memdelete(d);
+			}
 		}
+
+		memfree(shard.table);
+		shard.table = nullptr;
+		shard.mask = 0;
+		shard.count = 0;
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
-	lock.unlock();
 }
 
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
-	if (_data && _data->refcount.unref()) {
-		lock.lock();
+	if (_data && !_data->immortal.is_set() && _data->refcount.unref()) {
+		_Shard &shard = _get_shard(_data->hash);
+		bool bug = false;
+
+		shard.mutex.lock();
 
 		if (_data->prev) {
 			_data->prev->next = _data->next;
 		} else {
-			if (_table[_data->idx] != _data) {
-				ERR_PRINT("BUG!");
-			}
-			_table[_data->idx] = _data->next;
+			uint32_t idx = _data->hash & shard.mask;
+			bug = shard.table[idx] != _data;
+			shard.table[idx] = _data->next;
 		}
 
 		if (_data->next) {
 			_data->next->prev = _data->prev;
 		}
+		shard.count--;
 		memdelete(_data);
-		lock.unlock();
+
+		// The shard lock is not recursive, and printing could intern names.
+		shard.mutex.unlock();
+
+		if (bug) {
+			ERR_PRINT("BUG!");
+		}
 	}
 
 	_data = nullptr;
@@ -112,7 +223,7 @@ bool StringName::operator==(const String &p_name) const {
 		return (p_name.length() == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return _data->matches(p_name);
 }
 
 bool StringName::operator==(const char *p_name) const {
@@ -120,7 +231,7 @@ bool StringName::operator==(const char *p_name) const {
 		return (p_name[0] == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return _data->matches(p_name);
 }
 
 bool StringName::operator!=(const String &p_name) const {
@@ -140,7 +251,7 @@ void StringName::operator=(const StringName &p_name) {
 
 	unref();
 
-	if (p_name._data && p_name._data->refcount.ref()) {
+	if (p_name._data && (p_name._data->immortal.is_set() || p_name._data->refcount.ref())) {
 		_data = p_name._data;
 	}
 }
@@ -150,7 +261,7 @@ StringName::StringName(const StringName &p_name) {
 
 	ERR_FAIL_COND(!configured);
 
-	if (p_name._data && p_name._data->refcount.ref()) {
+	if (p_name._data && (p_name._data->immortal.is_set() || p_name._data->refcount.ref())) {
 		_data = p_name._data;
 	}
 }
@@ -164,44 +275,23 @@ StringName::StringName(const char *p_name) {
 		return; //empty, ignore
 	}
 
-	lock.lock();
-
 	uint32_t hash = String::hash(p_name);
+	_Shard &shard = _get_shard(hash);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
+	MutexLock lock(shard.mutex);
 
+	_data = _find(shard, hash, p_name);
 	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock.unlock();
-			return;
-		}
+		// exists
+		return;
 	}
 
 	_data = memnew(_Data);
 	_data->name = p_name;
 	_data->refcount.init();
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
-
-	lock.unlock();
+	_insert(shard, _data);
 }
 
 StringName::StringName(const StaticCString &p_static_string) {
@@ -211,44 +301,25 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	lock.lock();
-
 	uint32_t hash = String::hash(p_static_string.ptr);
+	_Shard &shard = _get_shard(hash);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
+	MutexLock lock(shard.mutex);
 
+	_data = _find(shard, hash, p_static_string.ptr);
 	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock.unlock();
-			return;
-		}
+		// Exists, make it immortal. The reference just taken is never released, so it can't be freed anymore.
+		_data->immortal.set();
+		return;
 	}
 
 	_data = memnew(_Data);
 
 	_data->refcount.init();
+	_data->immortal.set();
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
-
-	lock.unlock();
+	_insert(shard, _data);
 }
 
 StringName::StringName(const String &p_name) {
@@ -260,43 +331,23 @@ StringName::StringName(const String &p_name) {
 		return;
 	}
 
-	lock.lock();
-
 	uint32_t hash = p_name.hash();
+	_Shard &shard = _get_shard(hash);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
+	MutexLock lock(shard.mutex);
 
+	_data = _find(shard, hash, p_name);
 	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			lock.unlock();
-			return;
-		}
+		// exists
+		return;
 	}
 
 	_data = memnew(_Data);
 	_data->name = p_name;
 	_data->refcount.init();
 	_data->hash = hash;
-	_data->idx = idx;
 	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
-
-	lock.unlock();
+	_insert(shard, _data);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -307,29 +358,16 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	lock.lock();
-
 	uint32_t hash = String::hash(p_name);
+	_Shard &shard = _get_shard(hash);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		lock.unlock();
+	MutexLock lock(shard.mutex);
 
-		return StringName(_data);
+	_Data *data = _find(shard, hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
-	lock.unlock();
 	return StringName(); //does not exist
 }
 
@@ -341,55 +379,31 @@ StringName StringName::search(const CharType *p_name) {
 		return StringName();
 	}
 
-	lock.lock();
-
 	uint32_t hash = String::hash(p_name);
+	_Shard &shard = _get_shard(hash);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
+	MutexLock lock(shard.mutex);
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		lock.unlock();
-		return StringName(_data);
+	_Data *data = _find(shard, hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
-	lock.unlock();
 	return StringName(); //does not exist
 }
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	lock.lock();
-
 	uint32_t hash = p_name.hash();
+	_Shard &shard = _get_shard(hash);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
+	MutexLock lock(shard.mutex);
 
-	if (_data && _data->refcount.ref()) {
-		lock.unlock();
-		return StringName(_data);
+	_Data *data = _find(shard, hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
-	lock.unlock();
 	return StringName(); //does not exist
 }
 
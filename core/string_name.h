@@ -43,30 +43,49 @@ struct StaticCString {
 class StringName {
 	enum {
 
-		STRING_TABLE_BITS = 12,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARD_COUNT = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_INITIAL_LEN = 64
 	};
 
 	struct _Data {
 		SafeRefCount refcount;
+		SafeFlag immortal; // created from a static C string, lives until exit and skips reference counting
 		const char *cname;
 		String name;
 
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx;
+		bool matches(const char *p_name) const;
+		bool matches(const CharType *p_name) const;
+		bool matches(const String &p_name) const;
 		uint32_t hash;
 		_Data *prev;
 		_Data *next;
 		_Data() {
 			cname = nullptr;
 			next = prev = nullptr;
-			idx = 0;
 			hash = 0;
 		}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	// The table is split in shards, picked by the top bits of the hash, each with its own lock and growing bucket
+	// array, so threads interning different names rarely wait on each other.
+	struct _Shard {
+		BinaryMutex mutex;
+		_Data **table = nullptr;
+		uint32_t mask = 0;
+		uint32_t count = 0;
+	};
+
+	static _Shard _shards[STRING_TABLE_SHARD_COUNT];
+
+	_FORCE_INLINE_ static _Shard &_get_shard(uint32_t p_hash) {
+		return _shards[p_hash >> (32 - STRING_TABLE_SHARD_BITS)];
+	}
+
+	template <class T>
+	static _Data *_find(_Shard &p_shard, uint32_t p_hash, const T &p_name);
+	static void _insert(_Shard &p_shard, _Data *p_data);
 
 	_Data *_data;
 
@@ -79,7 +98,6 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 
-	static Mutex lock;
 	static void setup();
 	static void cleanup();
 	static bool configured;
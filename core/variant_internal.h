@@ -0,0 +1,118 @@
+/*************************************************************************/
+/*  variant_internal.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef VARIANT_INTERNAL_H
+#define VARIANT_INTERNAL_H
+
+#include "core/object_rc.h"
+#include "core/reference.h"
+#include "core/variant.h"
+
+// Direct access to the value stored in a Variant, without any type check or conversion.
+// Only meant for performance critical code (such as script VMs) that has already checked
+// the type of the Variant.
+class VariantInternal {
+public:
+	_FORCE_INLINE_ static bool *get_bool(Variant *v) { return &v->_data._bool; }
+	_FORCE_INLINE_ static const bool *get_bool(const Variant *v) { return &v->_data._bool; }
+	_FORCE_INLINE_ static int64_t *get_int(Variant *v) { return &v->_data._int; }
+	_FORCE_INLINE_ static const int64_t *get_int(const Variant *v) { return &v->_data._int; }
+	_FORCE_INLINE_ static double *get_real(Variant *v) { return &v->_data._real; }
+	_FORCE_INLINE_ static const double *get_real(const Variant *v) { return &v->_data._real; }
+	_FORCE_INLINE_ static Vector2 *get_vector2(Variant *v) { return reinterpret_cast<Vector2 *>(v->_data._mem); }
+	_FORCE_INLINE_ static const Vector2 *get_vector2(const Variant *v) { return reinterpret_cast<const Vector2 *>(v->_data._mem); }
+	_FORCE_INLINE_ static Vector3 *get_vector3(Variant *v) { return reinterpret_cast<Vector3 *>(v->_data._mem); }
+	_FORCE_INLINE_ static const Vector3 *get_vector3(const Variant *v) { return reinterpret_cast<const Vector3 *>(v->_data._mem); }
+	_FORCE_INLINE_ static Array *get_array(Variant *v) { return reinterpret_cast<Array *>(v->_data._mem); }
+	_FORCE_INLINE_ static const Array *get_array(const Variant *v) { return reinterpret_cast<const Array *>(v->_data._mem); }
+
+	// Null if the object was freed.
+	_FORCE_INLINE_ static Object *get_object(const Variant *v) { return _OBJ_PTR(*v); }
+
+	// Pointer to the value, as expected by MethodBind::ptrcall() (see PtrToArg).
+	// Not valid for OBJECT, which is passed as the Object pointer itself.
+	_FORCE_INLINE_ static void *get_opaque_pointer(Variant *v) {
+		switch (v->type) {
+			case Variant::TRANSFORM2D:
+				return v->_data._transform2d;
+			case Variant::AABB:
+				return v->_data._aabb;
+			case Variant::BASIS:
+				return v->_data._basis;
+			case Variant::TRANSFORM:
+				return v->_data._transform;
+			default:
+				return v->_data._mem;
+		}
+	}
+
+	_FORCE_INLINE_ static const void *get_opaque_pointer(const Variant *v) {
+		return get_opaque_pointer(const_cast<Variant *>(v));
+	}
+
+	// Same as assigning an empty Variant, without going through operator=().
+	_FORCE_INLINE_ static void clear(Variant *v) {
+		if (v->type != Variant::NIL) {
+			v->clear();
+		}
+	}
+
+	// True for the types whose value lives in the Variant itself and needs no construction or destruction.
+	_FORCE_INLINE_ static bool is_stored_by_value(Variant::Type p_type) {
+		switch (p_type) {
+			case Variant::BOOL:
+			case Variant::INT:
+			case Variant::REAL:
+			case Variant::VECTOR2:
+			case Variant::RECT2:
+			case Variant::VECTOR3:
+			case Variant::PLANE:
+			case Variant::QUAT:
+			case Variant::COLOR:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	// Changes the type of the Variant, leaving its value uninitialized.
+	// Only valid for the types stored by value (see is_stored_by_value()), the value must be written right after.
+	_FORCE_INLINE_ static void initialize(Variant *v, Variant::Type p_type) {
+#ifdef DEBUG_ENABLED
+		CRASH_COND_MSG(!is_stored_by_value(p_type), "VariantInternal::initialize() used with a type that is not stored by value.");
+#endif
+		if (v->type != p_type) {
+			v->clear();
+			v->type = p_type;
+		}
+	}
+};
+
+#endif // VARIANT_INTERNAL_H
@@ -41,6 +41,7 @@
 #include <errno.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -70,8 +71,19 @@ void FileAccessUnix::check_errors() const {
 	}
 }
 
+void FileAccessUnix::_unmap() {
+#if defined(UNIX_ENABLED)
+	if (mapped) {
+		munmap(mapped, mapped_size);
+	}
+#endif
+	mapped = nullptr;
+	mapped_size = 0;
+}
+
 Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 	if (f) {
+		_unmap();
 		fclose(f);
 	}
 	f = nullptr;
@@ -153,6 +165,7 @@ void FileAccessUnix::close() {
 		return;
 	}
 
+	_unmap();
 	fclose(f);
 	f = nullptr;
 
@@ -252,6 +265,34 @@ Error FileAccessUnix::get_error() const {
 	return last_error;
 }
 
+const uint8_t *FileAccessUnix::map_contents() {
+#if defined(UNIX_ENABLED)
+	ERR_FAIL_COND_V_MSG(!f, nullptr, "File must be opened before use.");
+	if (mapped) {
+		return mapped;
+	}
+	if (flags != READ) {
+		return nullptr;
+	}
+
+	uint64_t len = get_len();
+	if (len == 0 || len != (uint64_t)(size_t)len) {
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (data == MAP_FAILED) {
+		return nullptr;
+	}
+
+	mapped = (uint8_t *)data;
+	mapped_size = len;
+	return mapped;
+#else
+	return nullptr;
+#endif
+}
+
 void FileAccessUnix::flush() {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 	fflush(f);
@@ -344,6 +385,8 @@ CloseNotificationFunc FileAccessUnix::close_notification_func = nullptr;
 FileAccessUnix::FileAccessUnix() :
 		f(nullptr),
 		flags(0),
+		mapped(nullptr),
+		mapped_size(0),
 		last_error(OK) {
 }
 
@@ -43,6 +43,9 @@ typedef void (*CloseNotificationFunc)(const String &p_file, int p_flags);
 class FileAccessUnix : public FileAccess {
 	FILE *f;
 	int flags;
+	uint8_t *mapped;
+	uint64_t mapped_size;
+	void _unmap();
 	void check_errors() const;
 	mutable Error last_error;
 	String save_path;
@@ -73,6 +76,8 @@ public:
 
 	virtual Error get_error() const; ///< get last error
 
+	virtual const uint8_t *map_contents();
+
 	virtual void flush();
 	virtual void store_8(uint8_t p_dest); ///< store a byte
 	virtual void store_buffer(const uint8_t *p_src, uint64_t p_length); ///< store an array of bytes
@@ -35,8 +35,11 @@
 #include "core/io/resource_saver.h"
 #include "core/os/file_access.h"
 #include "core/os/os.h"
+#include "core/os/thread_work_pool.h"
 #include "core/project_settings.h"
 #include "core/variant_parser.h"
+#include "core/version.h"
+#include "editor_log.h"
 #include "editor_node.h"
 #include "editor_resource_preview.h"
 #include "editor_settings.h"
@@ -1665,11 +1668,15 @@ Error EditorFileSystem::_reimport_group(const String &p_group_file, const Vector
 	return err;
 }
 
-void EditorFileSystem::_reimport_file(const String &p_file) {
+Error EditorFileSystem::_reimport_file(const String &p_file, bool p_update_file_system) {
+	// When called from a worker thread (p_update_file_system is false), the file system tree
+	// must not be touched, reimport_files() updates it on the main thread afterwards.
 	EditorFileSystemDirectory *fs = nullptr;
 	int cpos = -1;
-	bool found = _find_file(p_file, &fs, cpos);
-	ERR_FAIL_COND_MSG(!found, "Can't find file '" + p_file + "'.");
+	if (p_update_file_system) {
+		bool found = _find_file(p_file, &fs, cpos);
+		ERR_FAIL_COND_V_MSG(!found, ERR_FILE_NOT_FOUND, "Can't find file '" + p_file + "'.");
+	}
 
 	//try to obtain existing params
 
@@ -1695,19 +1702,23 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		}
 
 	} else {
-		late_added_files.insert(p_file); //imported files do not call update_file(), but just in case..
+		if (p_update_file_system) {
+			late_added_files.insert(p_file); //imported files do not call update_file(), but just in case..
+		}
 		params["nodes/use_legacy_names"] = false;
 	}
 
 	if (importer_name == "keep") {
 		//keep files, do nothing.
-		fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_file);
-		fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_file + ".import");
-		fs->files[cpos]->deps.clear();
-		fs->files[cpos]->type = "";
-		fs->files[cpos]->import_valid = false;
-		EditorResourcePreview::get_singleton()->check_for_invalidation(p_file);
-		return;
+		if (p_update_file_system) {
+			fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_file);
+			fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_file + ".import");
+			fs->files[cpos]->deps.clear();
+			fs->files[cpos]->type = "";
+			fs->files[cpos]->import_valid = false;
+			EditorResourcePreview::get_singleton()->check_for_invalidation(p_file);
+		}
+		return OK;
 	}
 	Ref<ResourceImporter> importer;
 	bool load_default = false;
@@ -1722,7 +1733,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 		load_default = true;
 		if (importer.is_null()) {
 			ERR_PRINT("BUG: File queued for import, but can't be imported!");
-			ERR_FAIL();
+			ERR_FAIL_V(ERR_FILE_UNRECOGNIZED);
 		}
 	}
 
@@ -1749,11 +1760,26 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 
 	//finally, perform import!!
 	String base_path = ResourceFormatImporter::get_singleton()->get_import_base_path(p_file);
+	String source_md5 = FileAccess::get_md5(p_file);
+
+	// Only importers that can run threaded are known not to depend on anything but the source and options.
+	String cache_key;
+	if (import_cache_path != String() && importer->can_import_threaded() && importer->get_save_extension() != "") {
+		cache_key = _get_import_cache_key(source_md5, importer, opts, params);
+	}
 
 	List<String> import_variants;
 	List<String> gen_files;
 	Variant metadata;
-	Error err = importer->import(p_file, base_path, params, &import_variants, &gen_files, &metadata);
+	Error err = OK;
+	bool store_in_cache = false;
+
+	if (cache_key != String() && _load_from_import_cache(cache_key, base_path, importer, &import_variants, &metadata)) {
+		print_verbose("Reused import of '" + p_file + "' from the shared import cache.");
+	} else {
+		err = importer->import(p_file, base_path, params, &import_variants, &gen_files, &metadata);
+		store_in_cache = cache_key != String() && err == OK && gen_files.empty();
+	}
 
 	if (err != OK) {
 		ERR_PRINT("Error importing '" + p_file + "'.");
@@ -1762,7 +1788,7 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	//as import is complete, save the .import file
 
 	FileAccess *f = FileAccess::open(p_file + ".import", FileAccess::WRITE);
-	ERR_FAIL_COND_MSG(!f, "Cannot open file from path '" + p_file + ".import'.");
+	ERR_FAIL_COND_V_MSG(!f, ERR_FILE_CANT_WRITE, "Cannot open file from path '" + p_file + ".import'.");
 
 	//write manually, as order matters ([remap] has to go first for performance).
 	f->store_line("[remap]");
@@ -1843,20 +1869,38 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 
 	// Store the md5's of the various files. These are stored separately so that the .import files can be version controlled.
 	FileAccess *md5s = FileAccess::open(base_path + ".md5", FileAccess::WRITE);
-	ERR_FAIL_COND_MSG(!md5s, "Cannot open MD5 file '" + base_path + ".md5'.");
+	ERR_FAIL_COND_V_MSG(!md5s, ERR_FILE_CANT_WRITE, "Cannot open MD5 file '" + base_path + ".md5'.");
 
-	md5s->store_line("source_md5=\"" + FileAccess::get_md5(p_file) + "\"");
+	md5s->store_line("source_md5=\"" + source_md5 + "\"");
 	if (dest_paths.size()) {
 		md5s->store_line("dest_md5=\"" + FileAccess::get_multiple_md5(dest_paths) + "\"\n");
 	}
 	md5s->close();
 	memdelete(md5s);
 
+	if (store_in_cache) {
+		_store_in_import_cache(cache_key, base_path, importer, import_variants, metadata);
+	}
+
+	if (p_update_file_system) {
+		_update_reimported_file(p_file, importer->get_resource_type());
+	}
+
+	// A failed import is written as invalid in the .import file, the file is still up to date.
+	return OK;
+}
+
+void EditorFileSystem::_update_reimported_file(const String &p_file, const String &p_type) {
+	EditorFileSystemDirectory *fs = nullptr;
+	int cpos = -1;
+	bool found = _find_file(p_file, &fs, cpos);
+	ERR_FAIL_COND_MSG(!found, "Can't find file '" + p_file + "'.");
+
 	//update modified times, to avoid reimport
 	fs->files[cpos]->modified_time = FileAccess::get_modified_time(p_file);
 	fs->files[cpos]->import_modified_time = FileAccess::get_modified_time(p_file + ".import");
 	fs->files[cpos]->deps = _get_dependencies(p_file);
-	fs->files[cpos]->type = importer->get_resource_type();
+	fs->files[cpos]->type = p_type;
 	fs->files[cpos]->import_valid = ResourceLoader::is_import_valid(p_file);
 
 	//if file is currently up, maybe the source it was loaded from changed, so import math must be updated for it
@@ -1874,6 +1918,170 @@ void EditorFileSystem::_reimport_file(const String &p_file) {
 	EditorResourcePreview::get_singleton()->check_for_invalidation(p_file);
 }
 
+Ref<ResourceImporter> EditorFileSystem::_get_file_importer(const String &p_file) const {
+	String importer_name;
+
+	if (FileAccess::exists(p_file + ".import")) {
+		Ref<ConfigFile> cf;
+		cf.instance();
+		if (cf->load(p_file + ".import") == OK && cf->has_section_key("remap", "importer")) {
+			importer_name = cf->get_value("remap", "importer");
+		}
+	}
+
+	if (importer_name == "keep") {
+		return Ref<ResourceImporter>();
+	}
+
+	Ref<ResourceImporter> importer;
+	if (importer_name != "") {
+		importer = ResourceFormatImporter::get_singleton()->get_importer_by_name(importer_name);
+	}
+	if (importer.is_null()) {
+		importer = ResourceFormatImporter::get_singleton()->get_importer_by_extension(p_file.get_extension());
+	}
+	return importer;
+}
+
+static thread_local void *reimport_thread_file = nullptr; // ImportFile being imported by the calling worker thread.
+
+void EditorFileSystem::_reimport_thread_error_handler(void *p_self, const char *p_func, const char *p_file, int p_line, const char *p_error, const char *p_errorexp, ErrorHandlerType p_type) {
+	ImportFile *file = (ImportFile *)reimport_thread_file;
+	if (!file) {
+		return;
+	}
+
+	// Same text as EditorLog, which ignores errors raised outside of the main thread.
+	ImportMessage message;
+	if (p_errorexp && p_errorexp[0]) {
+		message.text = p_errorexp;
+	} else {
+		message.text = String(p_file) + ":" + itos(p_line) + " - " + String(p_error);
+	}
+	message.warning = p_type == ERR_HANDLER_WARNING;
+	file->messages.push_back(message);
+}
+
+void EditorFileSystem::_reimport_thread(uint32_t p_index, ImportFile *p_files) {
+	reimport_thread_file = &p_files[p_index];
+	p_files[p_index].error = _reimport_file(p_files[p_index].path, false);
+	reimport_thread_file = nullptr;
+}
+
+static Vector<String> _get_import_cache_suffixes(const List<String> &p_import_variants, const String &p_extension) {
+	Vector<String> suffixes;
+	if (p_import_variants.size()) {
+		for (const List<String>::Element *E = p_import_variants.front(); E; E = E->next()) {
+			suffixes.push_back("." + E->get() + "." + p_extension);
+		}
+	} else {
+		suffixes.push_back("." + p_extension);
+	}
+	return suffixes;
+}
+
+static Error _copy_import_cache_file(const String &p_from, const String &p_to) {
+	Error err;
+	Vector<uint8_t> data = FileAccess::get_file_as_array(p_from, &err);
+	if (err != OK) {
+		return err;
+	}
+	FileAccessRef f = FileAccess::open(p_to, FileAccess::WRITE, &err);
+	if (!f) {
+		return err;
+	}
+	f->store_buffer(data.ptr(), data.size());
+	return f->get_error();
+}
+
+String EditorFileSystem::_get_import_cache_key(const String &p_source_md5, const Ref<ResourceImporter> &p_importer, const List<ResourceImporter::ImportOption> &p_options, const Map<StringName, Variant> &p_params) const {
+	// The path is left out on purpose, so copies of an asset (or other checkouts) share the entry.
+	String key = String(VERSION_FULL_CONFIG) + "\n" + p_importer->get_importer_name() + "\n" + p_importer->get_import_settings_string() + "\n" + p_source_md5 + "\n";
+
+	for (const List<ResourceImporter::ImportOption>::Element *E = p_options.front(); E; E = E->next()) {
+		String name = E->get().option.name;
+		String value;
+		VariantWriter::write_to_string(p_params[name], value);
+		key += name + "=" + value + "\n";
+	}
+
+	return key.md5_text();
+}
+
+bool EditorFileSystem::_load_from_import_cache(const String &p_key, const String &p_base_path, const Ref<ResourceImporter> &p_importer, List<String> *r_import_variants, Variant *r_metadata) const {
+	String entry = import_cache_path.plus_file(p_key.substr(0, 2)).plus_file(p_key);
+
+	Ref<ConfigFile> cf;
+	cf.instance();
+	if (!FileAccess::exists(entry.plus_file("manifest.cfg")) || cf->load(entry.plus_file("manifest.cfg")) != OK) {
+		return false;
+	}
+
+	List<String> import_variants;
+	PoolStringArray variants = cf->get_value("import", "variants", PoolStringArray());
+	for (int i = 0; i < variants.size(); i++) {
+		import_variants.push_back(variants[i]);
+	}
+
+	Vector<String> suffixes = _get_import_cache_suffixes(import_variants, p_importer->get_save_extension());
+	for (int i = 0; i < suffixes.size(); i++) {
+		if (_copy_import_cache_file(entry.plus_file("import" + suffixes[i]), p_base_path + suffixes[i]) != OK) {
+			return false;
+		}
+	}
+
+	*r_import_variants = import_variants;
+	if (cf->has_section_key("import", "metadata")) {
+		*r_metadata = cf->get_value("import", "metadata");
+	}
+	return true;
+}
+
+void EditorFileSystem::_store_in_import_cache(const String &p_key, const String &p_base_path, const Ref<ResourceImporter> &p_importer, const List<String> &p_import_variants, const Variant &p_metadata) const {
+	String entry = import_cache_path.plus_file(p_key.substr(0, 2)).plus_file(p_key);
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	if (da->dir_exists(entry)) {
+		return; // Stored meanwhile by another thread or editor.
+	}
+
+	// Fill a temporary folder and rename it once complete, so readers never see a partial entry.
+	String tmp_path = entry + "." + itos(OS::get_singleton()->get_process_id()) + "_" + String::num_uint64(Thread::get_caller_id()) + ".tmp";
+	Error err = da->make_dir_recursive(tmp_path);
+	ERR_FAIL_COND_MSG(err != OK, "Cannot create folder in the shared import cache '" + tmp_path + "'.");
+
+	Vector<String> suffixes = _get_import_cache_suffixes(p_import_variants, p_importer->get_save_extension());
+	for (int i = 0; i < suffixes.size() && err == OK; i++) {
+		err = _copy_import_cache_file(p_base_path + suffixes[i], tmp_path.plus_file("import" + suffixes[i]));
+	}
+
+	if (err == OK) {
+		PoolStringArray variants;
+		for (const List<String>::Element *E = p_import_variants.front(); E; E = E->next()) {
+			variants.push_back(E->get());
+		}
+
+		Ref<ConfigFile> cf;
+		cf.instance();
+		cf->set_value("import", "variants", variants);
+		if (p_metadata != Variant()) {
+			cf->set_value("import", "metadata", p_metadata);
+		}
+		err = cf->save(tmp_path.plus_file("manifest.cfg"));
+	}
+
+	if (err == OK) {
+		err = da->rename(tmp_path, entry);
+	}
+
+	if (err != OK) {
+		if (da->change_dir(tmp_path) == OK) {
+			da->erase_contents_recursive();
+		}
+		da->remove(tmp_path);
+	}
+}
+
 void EditorFileSystem::_find_group_files(EditorFileSystemDirectory *efd, Map<String, Vector<String>> &group_files, Set<String> &groups_to_reimport) {
 	int fc = efd->files.size();
 	const EditorFileSystemDirectory::FileInfo *const *files = efd->files.ptr();
@@ -1940,9 +2148,13 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 			groups_to_reimport.insert(group_file);
 		} else {
 			//it's a regular file
+			Ref<ResourceImporter> importer = _get_file_importer(p_files[i]);
 			ImportFile ifile;
 			ifile.path = p_files[i];
+			ifile.importer = importer.is_valid() ? importer->get_importer_name() : String();
 			ifile.order = ResourceFormatImporter::get_singleton()->get_import_order(p_files[i]);
+			ifile.threaded = importer.is_valid() && importer->can_import_threaded();
+			ifile.error = OK;
 			files.push_back(ifile);
 		}
 
@@ -1956,9 +2168,62 @@ void EditorFileSystem::reimport_files(const Vector<String> &p_files) {
 
 	files.sort();
 
+	import_cache_path = EditorSettings::get_singleton()->get("filesystem/import/shared_cache_path");
+	import_cache_path = import_cache_path.strip_edges();
+
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	bool use_multiple_threads = pool && pool->get_thread_count() > 0 && bool(GLOBAL_GET("editor/import/use_multiple_threads"));
+
 	for (int i = 0; i < files.size(); i++) {
-		pr.step(files[i].path.get_file(), i);
-		_reimport_file(files[i].path);
+		if (!use_multiple_threads || !files[i].threaded) {
+			pr.step(files[i].path.get_file(), i);
+			_reimport_file(files[i].path);
+			continue;
+		}
+
+		// Import all the following files that use the same importer at once, sorting keeps them together.
+		int from = i;
+		int to = i + 1;
+		while (to < files.size() && files[to].threaded && files[to].importer == files[from].importer) {
+			to++;
+		}
+
+		for (int j = from; j < to; j++) {
+			if (!FileAccess::exists(files[j].path + ".import")) {
+				late_added_files.insert(files[j].path); //imported files do not call update_file(), but just in case..
+			}
+		}
+
+		ErrorHandlerList error_handler;
+		error_handler.errfunc = _reimport_thread_error_handler;
+		add_error_handler(&error_handler);
+
+		ThreadWorkPool::GroupID group = pool->add_template_group_task(this, &EditorFileSystem::_reimport_thread, files.ptrw() + from, to - from, 1);
+		while (!pool->is_group_task_completed(group)) {
+			int done = MIN((int)pool->get_group_processed_element_count(group), to - from - 1);
+			pr.step(files[from + done].path.get_file(), from + done, false);
+			OS::get_singleton()->delay_usec(1000);
+		}
+		pool->wait_for_group_task_completion(group);
+
+		remove_error_handler(&error_handler);
+
+		String type = ResourceFormatImporter::get_singleton()->get_importer_by_name(files[from].importer)->get_resource_type();
+		for (int j = from; j < to; j++) {
+			if (EditorNode::get_singleton()) {
+				const Vector<ImportMessage> &messages = files[j].messages;
+				for (int k = 0; k < messages.size(); k++) {
+					EditorNode::get_log()->add_message(messages[k].text, messages[k].warning ? EditorLog::MSG_TYPE_WARNING : EditorLog::MSG_TYPE_ERROR);
+				}
+			}
+
+			// Files whose import stopped early are left dirty, to be imported again like on the main thread.
+			if (files[j].error == OK) {
+				_update_reimported_file(files[j].path, type);
+			}
+		}
+
+		i = to - 1;
 	}
 
 	//reimport groups
@@ -31,6 +31,7 @@
 #ifndef EDITOR_FILE_SYSTEM_H
 #define EDITOR_FILE_SYSTEM_H
 
+#include "core/io/resource_importer.h"
 #include "core/os/dir_access.h"
 #include "core/os/thread.h"
 #include "core/os/thread_safe.h"
@@ -214,7 +215,8 @@ class EditorFileSystem : public Node {
 
 	void _update_extensions();
 
-	void _reimport_file(const String &p_file);
+	Error _reimport_file(const String &p_file, bool p_update_file_system = true);
+	void _update_reimported_file(const String &p_file, const String &p_type);
 	Error _reimport_group(const String &p_group_file, const Vector<String> &p_files);
 
 	bool _test_for_reimport(const String &p_path, bool p_only_imported_files);
@@ -223,14 +225,34 @@ class EditorFileSystem : public Node {
 
 	Vector<String> _get_dependencies(const String &p_path);
 
+	struct ImportMessage {
+		String text;
+		bool warning;
+	};
+
 	struct ImportFile {
 		String path;
+		String importer;
 		int order;
+		bool threaded;
+		Error error; // Result of _reimport_file() when imported on a worker thread.
+		Vector<ImportMessage> messages; // Errors raised on the worker thread, reported once the group is done.
 		bool operator<(const ImportFile &p_if) const {
-			return order < p_if.order;
+			return order == p_if.order ? (importer < p_if.importer) : (order < p_if.order);
 		}
 	};
 
+	Ref<ResourceImporter> _get_file_importer(const String &p_file) const;
+	void _reimport_thread(uint32_t p_index, ImportFile *p_files);
+	static void _reimport_thread_error_handler(void *p_self, const char *p_func, const char *p_file, int p_line, const char *p_error, const char *p_errorexp, ErrorHandlerType p_type);
+
+	/* Shared import cache, entries are addressed by the md5 of the source file, importer and options */
+	String import_cache_path;
+
+	String _get_import_cache_key(const String &p_source_md5, const Ref<ResourceImporter> &p_importer, const List<ResourceImporter::ImportOption> &p_options, const Map<StringName, Variant> &p_params) const;
+	bool _load_from_import_cache(const String &p_key, const String &p_base_path, const Ref<ResourceImporter> &p_importer, List<String> *r_import_variants, Variant *r_metadata) const;
+	void _store_in_import_cache(const String &p_key, const String &p_base_path, const Ref<ResourceImporter> &p_importer, const List<String> &p_import_variants, const Variant &p_metadata) const;
+
 	void _scan_script_classes(EditorFileSystemDirectory *p_dir);
 	SafeFlag update_script_classes_queued;
 	void _queue_update_script_classes();
@@ -599,6 +599,11 @@ String ResourceImporterTexture::get_import_settings_string() const {
 		index++;
 	}
 
+	// Only appended when enabled, so the string stays the same for projects not using it.
+	if (ProjectSettings::get_singleton()->get("rendering/misc/lossless_compression/force_png")) {
+		s += "force_png";
+	}
+
 	return s;
 }
 
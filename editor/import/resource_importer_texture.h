@@ -92,6 +92,7 @@ public:
 
 	virtual bool are_import_settings_valid(const String &p_path) const;
 	virtual String get_import_settings_string() const;
+	virtual bool can_import_threaded() const { return true; }
 
 	ResourceImporterTexture();
 };
@@ -41,6 +41,7 @@
 #include "core/message_queue.h"
 #include "core/os/dir_access.h"
 #include "core/os/os.h"
+#include "core/os/thread_work_pool.h"
 #include "core/project_settings.h"
 #include "core/register_core_types.h"
 #include "core/script_debugger_local.h"
@@ -100,6 +101,7 @@ static ZipArchive *zip_packed_data = nullptr;
 static FileAccessNetworkClient *file_access_network_client = nullptr;
 static ScriptDebugger *script_debugger = nullptr;
 static MessageQueue *message_queue = nullptr;
+static ThreadWorkPool *thread_work_pool = nullptr;
 
 // Initialized in setup2()
 static AudioServer *audio_server = nullptr;
@@ -183,6 +185,8 @@ void initialize_physics() {
 	GLOBAL_DEF("physics/3d/godot_physics/use_bvh", true);
 	GLOBAL_DEF("physics/3d/godot_physics/bvh_collision_margin", 0.1);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/godot_physics/bvh_collision_margin", PropertyInfo(Variant::REAL, "physics/3d/godot_physics/bvh_collision_margin", PROPERTY_HINT_RANGE, "0.0,2.0,0.01"));
+	GLOBAL_DEF("physics/3d/godot_physics/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/godot_physics/max_threads", PropertyInfo(Variant::INT, "physics/3d/godot_physics/max_threads", PROPERTY_HINT_RANGE, "-1,256,1,or_greater"));
 
 	/// 3D Physics Server
 	physics_server = PhysicsServerManager::new_server(ProjectSettings::get_singleton()->get(PhysicsServerManager::setting_property_name));
@@ -1226,6 +1230,12 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 	message_queue = memnew(MessageQueue);
 
+	// -1 uses one worker per logical core, minus the one taken by the main thread.
+	GLOBAL_DEF("threading/worker_pool/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("threading/worker_pool/max_threads", PropertyInfo(Variant::INT, "threading/worker_pool/max_threads", PROPERTY_HINT_RANGE, "-1,256,1,or_greater"));
+	thread_work_pool = memnew(ThreadWorkPool);
+	thread_work_pool->init(GLOBAL_GET("threading/worker_pool/max_threads"));
+
 	if (p_second_phase) {
 		return setup2();
 	}
@@ -2237,6 +2247,9 @@ bool Main::iteration() {
 
 	AudioServer::get_singleton()->update();
 
+	// Frame tasks must not outlive the frame they were submitted in.
+	thread_work_pool->sync_frame_tasks();
+
 	if (script_debugger) {
 		if (script_debugger->is_profiling()) {
 			script_debugger->profiling_set_frame_times(USEC_TO_SEC(frame_time), USEC_TO_SEC(idle_process_ticks), USEC_TO_SEC(physics_process_ticks), frame_slice);
@@ -2315,6 +2328,9 @@ void Main::cleanup(bool p_force) {
 		script_debugger->idle_poll();
 	}
 
+	// Background loads use the loaders, and may still be running.
+	ResourceLoader::clear_thread_load_tasks();
+
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
 
@@ -2338,6 +2354,9 @@ void Main::cleanup(bool p_force) {
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
+	// Pending frame tasks may still call into scripts.
+	thread_work_pool->sync_frame_tasks();
+
 	ScriptServer::finish_languages();
 
 	// Sync pending commands that may have been queued from a different thread during ScriptServer finalization
@@ -2372,6 +2391,10 @@ void Main::cleanup(bool p_force) {
 	OS::get_singleton()->finalize();
 	finalize_physics();
 
+	if (thread_work_pool) {
+		memdelete(thread_work_pool);
+	}
+
 	if (packed_data) {
 		memdelete(packed_data);
 	}
@@ -75,6 +75,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(MESSAGE_QUEUE_MESSAGES_IN_FRAME);
+	BIND_ENUM_CONSTANT(MESSAGE_QUEUE_FLUSH_TIME);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -123,6 +125,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"message_queue/messages",
+		"message_queue/flush_time",
 
 	};
 
@@ -193,6 +197,10 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case MESSAGE_QUEUE_MESSAGES_IN_FRAME:
+			return MessageQueue::get_singleton()->get_frame_message_count();
+		case MESSAGE_QUEUE_FLUSH_TIME:
+			return MessageQueue::get_singleton()->get_frame_flush_usec() / 1000000.0;
 
 		default: {
 		}
@@ -237,6 +245,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
 
 	};
 
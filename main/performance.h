@@ -82,6 +82,8 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		MESSAGE_QUEUE_MESSAGES_IN_FRAME,
+		MESSAGE_QUEUE_FLUSH_TIME,
 		MONITOR_MAX
 	};
 
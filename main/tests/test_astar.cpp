@@ -31,6 +31,7 @@
 #include "test_astar.h"
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
 #include "core/math/math_funcs.h"
 #include "core/os/os.h"
 
@@ -220,111 +221,140 @@ bool test_add_remove() {
 	return ok;
 }
 
-bool test_solutions() {
-	// Random stress tests with Floyd-Warshall
+// Random graph of the stress tests below, with its shortest distances given by Floyd-Warshall.
+struct RandomGraph {
+	enum {
+		N = 30
+	};
 
-	const int N = 30;
-	Math::seed(0);
+	Vector3 p[N];
+	bool adj[N][N];
+	float d[N][N];
+};
 
-	for (int test = 0; test < 1000; test++) {
-		AStar a;
-		Vector3 p[N];
-		bool adj[N][N] = { { false } };
+static void add_random_points(AStar &a, RandomGraph &g) {
+	const int N = RandomGraph::N;
 
-		// Assign initial coordinates
-		for (int u = 0; u < N; u++) {
-			p[u].x = Math::rand() % 100;
-			p[u].y = Math::rand() % 100;
-			p[u].z = Math::rand() % 100;
-			a.add_point(u, p[u]);
+	// Assign initial coordinates
+	for (int u = 0; u < N; u++) {
+		g.p[u].x = Math::rand() % 100;
+		g.p[u].y = Math::rand() % 100;
+		g.p[u].z = Math::rand() % 100;
+		a.add_point(u, g.p[u]);
+
+		for (int v = 0; v < N; v++) {
+			g.adj[u][v] = false;
 		}
+	}
+}
 
-		// Generate a random sequence of operations
-		for (int i = 0; i < 1000; i++) {
-			// Pick two different vertices
-			int u, v;
-			u = Math::rand() % N;
-			v = Math::rand() % (N - 1);
-			if (u == v) {
-				v = N - 1;
-			}
+static void apply_random_operations(AStar &a, RandomGraph &g) {
+	const int N = RandomGraph::N;
 
-			// Pick a random operation
-			int op = Math::rand();
-			switch (op % 9) {
-				case 0:
-				case 1:
-				case 2:
-				case 3:
-				case 4:
-				case 5:
-					// Add edge (u, v); possibly bidirectional
-					a.connect_points(u, v, op % 2);
-					adj[u][v] = true;
-					if (op % 2) {
-						adj[v][u] = true;
-					}
-					break;
-				case 6:
-				case 7:
-					// Remove edge (u, v); possibly bidirectional
-					a.disconnect_points(u, v, op % 2);
-					adj[u][v] = false;
-					if (op % 2) {
-						adj[v][u] = false;
-					}
-					break;
-				case 8:
-					// Remove point u and add it back; clears adjacent edges and changes coordinates
-					a.remove_point(u);
-					p[u].x = Math::rand() % 100;
-					p[u].y = Math::rand() % 100;
-					p[u].z = Math::rand() % 100;
-					a.add_point(u, p[u]);
-					for (v = 0; v < N; v++) {
-						adj[u][v] = adj[v][u] = false;
-					}
-					break;
-			}
+	// Generate a random sequence of operations
+	for (int i = 0; i < 1000; i++) {
+		// Pick two different vertices
+		int u, v;
+		u = Math::rand() % N;
+		v = Math::rand() % (N - 1);
+		if (u == v) {
+			v = N - 1;
 		}
 
-		// Floyd-Warshall
-		float d[N][N];
-		for (int u = 0; u < N; u++) {
-			for (int v = 0; v < N; v++) {
-				d[u][v] = (u == v || adj[u][v]) ? p[u].distance_to(p[v]) : INFINITY;
-			}
+		// Pick a random operation
+		int op = Math::rand();
+		switch (op % 9) {
+			case 0:
+			case 1:
+			case 2:
+			case 3:
+			case 4:
+			case 5:
+				// Add edge (u, v); possibly bidirectional
+				a.connect_points(u, v, op % 2);
+				g.adj[u][v] = true;
+				if (op % 2) {
+					g.adj[v][u] = true;
+				}
+				break;
+			case 6:
+			case 7:
+				// Remove edge (u, v); possibly bidirectional
+				a.disconnect_points(u, v, op % 2);
+				g.adj[u][v] = false;
+				if (op % 2) {
+					g.adj[v][u] = false;
+				}
+				break;
+			case 8:
+				// Remove point u and add it back; clears adjacent edges and changes coordinates
+				a.remove_point(u);
+				g.p[u].x = Math::rand() % 100;
+				g.p[u].y = Math::rand() % 100;
+				g.p[u].z = Math::rand() % 100;
+				a.add_point(u, g.p[u]);
+				for (v = 0; v < N; v++) {
+					g.adj[u][v] = g.adj[v][u] = false;
+				}
+				break;
 		}
+	}
+}
 
-		for (int w = 0; w < N; w++) {
-			for (int u = 0; u < N; u++) {
-				for (int v = 0; v < N; v++) {
-					if (d[u][v] > d[u][w] + d[w][v]) {
-						d[u][v] = d[u][w] + d[w][v];
-					}
-				}
-			}
+static void solve_random_graph(RandomGraph &g, int p_test) {
+	const int N = RandomGraph::N;
+
+	// Floyd-Warshall
+	for (int u = 0; u < N; u++) {
+		for (int v = 0; v < N; v++) {
+			g.d[u][v] = (u == v || g.adj[u][v]) ? g.p[u].distance_to(g.p[v]) : INFINITY;
 		}
+	}
 
-		// Display statistics
-		int count = 0;
+	for (int w = 0; w < N; w++) {
 		for (int u = 0; u < N; u++) {
 			for (int v = 0; v < N; v++) {
-				if (adj[u][v]) {
-					count++;
+				if (g.d[u][v] > g.d[u][w] + g.d[w][v]) {
+					g.d[u][v] = g.d[u][w] + g.d[w][v];
 				}
 			}
 		}
-		printf("Test #%4d: %3d edges, ", test + 1, count);
-		count = 0;
-		for (int u = 0; u < N; u++) {
-			for (int v = 0; v < N; v++) {
-				if (!Math::is_inf(d[u][v])) {
-					count++;
-				}
+	}
+
+	// Display statistics
+	int count = 0;
+	for (int u = 0; u < N; u++) {
+		for (int v = 0; v < N; v++) {
+			if (g.adj[u][v]) {
+				count++;
+			}
+		}
+	}
+	printf("Test #%4d: %3d edges, ", p_test + 1, count);
+	count = 0;
+	for (int u = 0; u < N; u++) {
+		for (int v = 0; v < N; v++) {
+			if (!Math::is_inf(g.d[u][v])) {
+				count++;
 			}
 		}
-		printf("%3d/%d pairs of reachable points\n", count - N, N * (N - 1));
+	}
+	printf("%3d/%d pairs of reachable points\n", count - N, N * (N - 1));
+}
+
+bool test_solutions() {
+	// Random stress tests with Floyd-Warshall
+
+	const int N = RandomGraph::N;
+	Math::seed(0);
+
+	for (int test = 0; test < 1000; test++) {
+		AStar a;
+		RandomGraph g;
+
+		add_random_points(a, g);
+		apply_random_operations(a, g);
+		solve_random_graph(g, test);
 
 		// Check A*'s output
 		bool match = true;
@@ -332,7 +362,7 @@ bool test_solutions() {
 			for (int v = 0; v < N; v++) {
 				if (u != v) {
 					PoolVector<int> route = a.get_id_path(u, v);
-					if (!Math::is_inf(d[u][v])) {
+					if (!Math::is_inf(g.d[u][v])) {
 						// Reachable
 						if (route.size() == 0) {
 							printf("From %d to %d: A* did not find a path\n", u, v);
@@ -341,17 +371,17 @@ bool test_solutions() {
 						}
 						float astar_dist = 0;
 						for (int i = 1; i < route.size(); i++) {
-							if (!adj[route[i - 1]][route[i]]) {
+							if (!g.adj[route[i - 1]][route[i]]) {
 								printf("From %d to %d: edge (%d, %d) does not exist\n",
 										u, v, route[i - 1], route[i]);
 								match = false;
 								goto exit;
 							}
-							astar_dist += p[route[i - 1]].distance_to(p[route[i]]);
+							astar_dist += g.p[route[i - 1]].distance_to(g.p[route[i]]);
 						}
-						if (!Math::is_equal_approx(astar_dist, d[u][v])) {
+						if (!Math::is_equal_approx(astar_dist, g.d[u][v])) {
 							printf("From %d to %d: Floyd-Warshall gives %.6f, A* gives %.6f\n",
-									u, v, d[u][v], astar_dist);
+									u, v, g.d[u][v], astar_dist);
 							match = false;
 							goto exit;
 						}
@@ -375,6 +405,174 @@ bool test_solutions() {
 	return true;
 }
 
+bool test_hierarchy_solutions() {
+	// Same as test_solutions(), with the destination caches (flow fields) and the hierarchical search
+
+	const int N = RandomGraph::N;
+	Math::seed(1);
+
+	for (int test = 0; test < 1000; test++) {
+		AStar a;
+		RandomGraph g;
+
+		// Keep the hierarchy and the destination caches up to date through the operations
+		a.set_hierarchy_cell_size(25);
+		add_random_points(a, g);
+		for (int u = 0; u < N; u += 2) {
+			a.add_destination_cache(u);
+		}
+		apply_random_operations(a, g);
+
+		// Removed points lost their cache, get_id_path() goes through the flow fields for even destinations
+		for (int u = 0; u < N; u += 2) {
+			a.add_destination_cache(u);
+		}
+
+		solve_random_graph(g, test);
+
+		// Check A*'s output, and the hierarchical one's which must find a path whenever there is one
+		bool match = true;
+		for (int solver = 0; solver < 2; solver++) {
+			const char *name = solver == 0 ? "A*" : "Hierarchical A*";
+			for (int u = 0; u < N; u++) {
+				for (int v = 0; v < N; v++) {
+					if (u != v) {
+						PoolVector<int> route = solver == 0 ? a.get_id_path(u, v) : a.get_hierarchical_id_path(u, v);
+						if (!Math::is_inf(g.d[u][v])) {
+							// Reachable
+							if (route.size() == 0) {
+								printf("From %d to %d: %s did not find a path\n", u, v, name);
+								match = false;
+								goto exit;
+							}
+							float astar_dist = 0;
+							for (int i = 1; i < route.size(); i++) {
+								if (!g.adj[route[i - 1]][route[i]]) {
+									printf("From %d to %d: edge (%d, %d) does not exist\n",
+											u, v, route[i - 1], route[i]);
+									match = false;
+									goto exit;
+								}
+								astar_dist += g.p[route[i - 1]].distance_to(g.p[route[i]]);
+							}
+							// The hierarchical search only goes through some of the connections between clusters
+							bool optimal = Math::is_equal_approx(astar_dist, g.d[u][v]);
+							if (solver == 0 ? !optimal : (!optimal && astar_dist < g.d[u][v])) {
+								printf("From %d to %d: Floyd-Warshall gives %.6f, %s gives %.6f\n",
+										u, v, g.d[u][v], name, astar_dist);
+								match = false;
+								goto exit;
+							}
+						} else {
+							// Unreachable
+							if (route.size() > 0) {
+								printf("From %d to %d: %s somehow found a nonexistent path\n", u, v, name);
+								match = false;
+								goto exit;
+							}
+						}
+					}
+				}
+			}
+		}
+
+	exit:
+		if (!match) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Returns the cost of a grid path, or -1 when it is empty and -2 when it isn't a valid path between the cells.
+static real_t grid_path_cost(const AStarGrid2D &p_grid, const PoolVector<Vector2> &p_path, const Vector2 &p_from, const Vector2 &p_to) {
+	if (p_path.size() == 0) {
+		return -1;
+	}
+	if (p_path[0] != p_from || p_path[p_path.size() - 1] != p_to) {
+		return -2;
+	}
+
+	real_t cost = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		const Vector2 from = p_path[i - 1];
+		const Vector2 to = p_path[i];
+		const Vector2 step = to - from;
+		if (Math::abs(step.x) > 1 || Math::abs(step.y) > 1 || step == Vector2() || p_grid.is_point_solid(to)) {
+			return -2;
+		}
+
+		if (step.x != 0 && step.y != 0) {
+			const Vector2 side_x = Vector2(to.x, from.y);
+			const Vector2 side_y = Vector2(from.x, to.y);
+			const bool walkable_x = p_grid.is_in_boundsv(side_x) && !p_grid.is_point_solid(side_x);
+			const bool walkable_y = p_grid.is_in_boundsv(side_y) && !p_grid.is_point_solid(side_y);
+			switch (p_grid.get_diagonal_mode()) {
+				case AStarGrid2D::DIAGONAL_MODE_NEVER:
+					return -2;
+				case AStarGrid2D::DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE:
+					if (!walkable_x && !walkable_y) {
+						return -2;
+					}
+					break;
+				case AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES:
+					if (!walkable_x || !walkable_y) {
+						return -2;
+					}
+					break;
+				default:
+					break;
+			}
+			cost += Math_SQRT2;
+		} else {
+			cost += 1;
+		}
+	}
+	return cost;
+}
+
+bool test_grid_solutions() {
+	// Random grids, jump point search has to find paths as short as the plain search
+
+	Math::seed(0);
+
+	for (int test = 0; test < 500; test++) {
+		AStarGrid2D grid;
+		const int width = 1 + Math::rand() % 80;
+		const int height = 1 + Math::rand() % 80;
+		grid.set_size(Vector2(width, height));
+		grid.set_default_compute_heuristic(AStarGrid2D::HEURISTIC_OCTILE);
+		grid.set_default_estimate_heuristic(AStarGrid2D::HEURISTIC_OCTILE);
+		grid.update();
+
+		const int density = Math::rand() % 40;
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				if ((int)(Math::rand() % 100) < density) {
+					grid.set_point_solid(Vector2(x, y));
+				}
+			}
+		}
+
+		for (int i = 0; i < 20; i++) {
+			grid.set_diagonal_mode(AStarGrid2D::DiagonalMode(i % AStarGrid2D::DIAGONAL_MODE_MAX));
+			const Vector2 from = Vector2(Math::rand() % width, Math::rand() % height);
+			const Vector2 to = Vector2(Math::rand() % width, Math::rand() % height);
+
+			grid.set_jumping_enabled(false);
+			const real_t cost = grid_path_cost(grid, grid.get_id_path(from, to), from, to);
+			grid.set_jumping_enabled(true);
+			const real_t jump_cost = grid_path_cost(grid, grid.get_id_path(from, to), from, to);
+
+			if (cost == -2 || jump_cost == -2 || !Math::is_equal_approx(cost, jump_cost)) {
+				printf("Test #%d failed: from (%d, %d) to (%d, %d), diagonal mode %d, cost %f, jump cost %f\n", test, (int)from.x, (int)from.y, (int)to.x, (int)to.y, (int)grid.get_diagonal_mode(), cost, jump_cost);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
 typedef bool (*TestFunc)();
 
 TestFunc test_funcs[] = {
@@ -382,6 +580,8 @@ TestFunc test_funcs[] = {
 	test_abcx,
 	test_add_remove,
 	test_solutions,
+	test_hierarchy_solutions,
+	test_grid_solutions,
 	nullptr
 };
 
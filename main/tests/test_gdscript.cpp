@@ -41,6 +41,7 @@
 #include "modules/gdscript/gdscript_compiler.h"
 #include "modules/gdscript/gdscript_parser.h"
 #include "modules/gdscript/gdscript_tokenizer.h"
+#include "scene/main/node.h"
 
 namespace TestGDScript {
 
@@ -530,7 +531,11 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 			String txt = itos(ip) + " ";
 
 			switch (code[ip]) {
-				case GDScriptFunction::OPCODE_OPERATOR: {
+				case GDScriptFunction::OPCODE_OPERATOR:
+				case GDScriptFunction::OPCODE_OPERATOR_INT:
+				case GDScriptFunction::OPCODE_OPERATOR_REAL:
+				case GDScriptFunction::OPCODE_OPERATOR_VECTOR2:
+				case GDScriptFunction::OPCODE_OPERATOR_VECTOR3: {
 					int op = code[ip + 1];
 					txt += " op ";
 
@@ -544,7 +549,8 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					incr += 5;
 
 				} break;
-				case GDScriptFunction::OPCODE_SET: {
+				case GDScriptFunction::OPCODE_SET:
+				case GDScriptFunction::OPCODE_SET_ARRAY: {
 					txt += "set ";
 					txt += DADDR(1);
 					txt += "[";
@@ -554,7 +560,8 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					incr += 4;
 
 				} break;
-				case GDScriptFunction::OPCODE_GET: {
+				case GDScriptFunction::OPCODE_GET:
+				case GDScriptFunction::OPCODE_GET_ARRAY: {
 					txt += " get ";
 					txt += DADDR(3);
 					txt += "=";
@@ -585,6 +592,27 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += "\"]";
 					incr += 4;
 
+				} break;
+				case GDScriptFunction::OPCODE_SET_VECTOR_AXIS: {
+					txt += " set_vector_axis ";
+					txt += DADDR(1);
+					txt += "[\"";
+					txt += func.get_global_name(code[ip + 2]);
+					txt += "\"]=";
+					txt += DADDR(3);
+					incr += 5;
+
+				} break;
+				case GDScriptFunction::OPCODE_GET_VECTOR_AXIS: {
+					txt += " get_vector_axis ";
+					txt += DADDR(4);
+					txt += "=";
+					txt += DADDR(1);
+					txt += "[\"";
+					txt += func.get_global_name(code[ip + 2]);
+					txt += "\"]";
+					incr += 5;
+
 				} break;
 				case GDScriptFunction::OPCODE_SET_MEMBER: {
 					txt += " set_member ";
@@ -731,7 +759,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					int argc = code[ip + 1];
 					if (ret) {
-						txt += DADDR(4 + argc) + "=";
+						txt += DADDR(5 + argc) + "=";
 					}
 
 					txt += DADDR(2) + ".";
@@ -742,11 +770,11 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 						if (i > 0) {
 							txt += ", ";
 						}
-						txt += DADDR(4 + i);
+						txt += DADDR(5 + i);
 					}
 					txt += ")";
 
-					incr = 5 + argc;
+					incr = 6 + argc;
 
 				} break;
 				case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
@@ -883,7 +911,108 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 	}
 }
 
+// Same loop twice, untyped and typed, so the second one is compiled to the typed opcodes.
+static const char *_benchmark_code =
+		"static func untyped_loop(iterations):\n"
+		"\tvar total = 0\n"
+		"\tvar scale = 0.5\n"
+		"\tvar position = Vector3()\n"
+		"\tvar step = Vector3(1, 2, 3)\n"
+		"\tvar values = [1, 2, 3, 4]\n"
+		"\tvar i = 0\n"
+		"\twhile i < iterations:\n"
+		"\t\ttotal += i * 2 - values[i & 3]\n"
+		"\t\tscale = scale * 0.5 + 1.0\n"
+		"\t\tposition += step * scale\n"
+		"\t\tposition.x = position.y - position.z\n"
+		"\t\ti += 1\n"
+		"\treturn total\n"
+		"\n"
+		"static func typed_loop(iterations: int) -> int:\n"
+		"\tvar total: int = 0\n"
+		"\tvar scale: float = 0.5\n"
+		"\tvar position: Vector3 = Vector3()\n"
+		"\tvar step: Vector3 = Vector3(1, 2, 3)\n"
+		"\tvar values: Array = [1, 2, 3, 4]\n"
+		"\tvar i: int = 0\n"
+		"\twhile i < iterations:\n"
+		"\t\ttotal += i * 2 - values[i & 3]\n"
+		"\t\tscale = scale * 0.5 + 1.0\n"
+		"\t\tposition += step * scale\n"
+		"\t\tposition.x = position.y - position.z\n"
+		"\t\ti += 1\n"
+		"\treturn total\n";
+
+static void _benchmark() {
+	const int iterations = 1000000;
+
+	Ref<GDScript> gds;
+	gds.instance();
+	gds->set_source_code(_benchmark_code);
+	Error err = gds->reload();
+	ERR_FAIL_COND_MSG(err != OK, "Could not compile the benchmark script.");
+
+	const char *functions[2] = { "untyped_loop", "typed_loop" };
+	uint64_t usecs[2];
+	Variant results[2];
+
+	for (int i = 0; i < 2; i++) {
+		Variant arg = iterations;
+		const Variant *args[1] = { &arg };
+		Variant::CallError ce;
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		results[i] = static_cast<Object *>(gds.ptr())->call(functions[i], args, 1, ce);
+		usecs[i] = OS::get_singleton()->get_ticks_usec() - from;
+
+		ERR_FAIL_COND_MSG(ce.error != Variant::CallError::CALL_OK, "Could not call " + String(functions[i]) + "().");
+		print_line(String(functions[i]) + ": " + itos(usecs[i] / 1000) + " msec (" + itos(iterations) + " iterations)");
+	}
+
+	ERR_FAIL_COND_MSG(results[0] != results[1], "Typed and untyped results differ: " + String(results[0]) + " vs " + String(results[1]) + ".");
+	print_line("Speedup of the typed version: " + rtos((double)usecs[0] / MAX(usecs[1], (uint64_t)1)) + "x");
+}
+
+// Soft reloads keep the instances, which must still see the callbacks added or removed by the new version.
+static void _test_reload() {
+	Ref<GDScript> gds;
+	gds.instance();
+	gds->set_source_code("extends Node\nvar processed = false\n");
+	Error err = gds->reload();
+	ERR_FAIL_COND_MSG(err != OK, "Could not compile the reload script.");
+
+	Node *node = memnew(Node);
+	node->set_script(gds.get_ref_ptr());
+	node->notification(Node::NOTIFICATION_PROCESS);
+
+	gds->set_source_code("extends Node\nvar processed = false\nfunc _process(delta):\n\tprocessed = true\n");
+	err = gds->reload(true);
+	node->notification(Node::NOTIFICATION_PROCESS);
+	bool added = err == OK && bool(node->get("processed"));
+
+	node->set("processed", false);
+	gds->set_source_code("extends Node\nvar processed = false\n");
+	err = gds->reload(true);
+	node->notification(Node::NOTIFICATION_PROCESS);
+	bool removed = err == OK && !bool(node->get("processed"));
+
+	memdelete(node);
+
+	print_line(String("_process() added by a reload is called: ") + (added ? "PASS" : "FAILED"));
+	print_line(String("_process() removed by a reload is not called: ") + (removed ? "PASS" : "FAILED"));
+}
+
 MainLoop *test(TestType p_type) {
+	if (p_type == TEST_BENCHMARK) {
+		_benchmark();
+		return nullptr;
+	}
+
+	if (p_type == TEST_RELOAD) {
+		_test_reload();
+		return nullptr;
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
@@ -57,7 +57,9 @@ const char **tests_get_names() {
 		"basis",
 		"transform",
 		"physics",
+		"physics_kernels",
 		"physics_2d",
+		"physics_2d_broadphase",
 		"render",
 		"oa_hash_map",
 		"gui",
@@ -66,6 +68,8 @@ const char **tests_get_names() {
 		"gd_parser",
 		"gd_compiler",
 		"gd_bytecode",
+		"gd_benchmark",
+		"gd_reload",
 		"ordered_hash_map",
 		"astar",
 		"xml_parser",
@@ -96,10 +100,18 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestPhysics::test();
 	}
 
+	if (p_test == "physics_kernels") {
+		return TestPhysics::test_collision_kernels();
+	}
+
 	if (p_test == "physics_2d") {
 		return TestPhysics2D::test();
 	}
 
+	if (p_test == "physics_2d_broadphase") {
+		return TestPhysics2D::test_broadphase();
+	}
+
 	if (p_test == "render") {
 		return TestRender::test();
 	}
@@ -138,6 +150,14 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_benchmark") {
+		return TestGDScript::test(TestGDScript::TEST_BENCHMARK);
+	}
+
+	if (p_test == "gd_reload") {
+		return TestGDScript::test(TestGDScript::TEST_RELOAD);
+	}
+
 	if (p_test == "ordered_hash_map") {
 		return TestOrderedHashMap::test();
 	}
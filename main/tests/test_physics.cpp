@@ -36,6 +36,7 @@
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
 #include "core/print_string.h"
+#include "servers/physics/collision_kernels_sw.h"
 #include "servers/physics_server.h"
 #include "servers/visual_server.h"
 
@@ -408,4 +409,124 @@ namespace TestPhysics {
 MainLoop *test() {
 	return memnew(TestPhysicsMainLoop);
 }
+
+MainLoop *test_collision_kernels() {
+	// Compares the batched collision kernels against the scalar code they replace.
+	const int vertex_count = 64;
+	const int iterations = 200000;
+
+	Math::seed(1234);
+
+	Vector<Vector3> vertices;
+	int stride = CollisionKernelsSW::get_padded_count(vertex_count);
+	Vector<real_t> soa;
+	soa.resize(stride * 3);
+	for (int i = 0; i < vertex_count; i++) {
+		vertices.push_back(Vector3(Math::random(-1.0, 1.0), Math::random(-1.0, 1.0), Math::random(-1.0, 1.0)));
+	}
+	for (int i = 0; i < stride; i++) {
+		const Vector3 &v = vertices[i < vertex_count ? i : 0];
+		soa.write[i] = v.x;
+		soa.write[stride + i] = v.y;
+		soa.write[stride * 2 + i] = v.z;
+	}
+	const real_t *x = soa.ptr();
+	const real_t *y = x + stride;
+	const real_t *z = y + stride;
+
+	Vector<Vector3> normals;
+	for (int i = 0; i < 256; i++) {
+		normals.push_back(Vector3(Math::random(-1.0, 1.0), Math::random(-1.0, 1.0), Math::random(-1.0, 1.0)).normalized());
+	}
+
+	Transform xform(Basis(Vector3(0.3, 0.8, 0.1).normalized(), 0.7), Vector3(1, 2, 3));
+	print_line("SIMD kernels: " + String(CollisionKernelsSW::is_simd_supported() ? "yes" : "no (scalar fallback)"));
+
+	// Convex projection, as ConvexPolygonShapeSW::project_range() used to do it.
+	real_t sum = 0;
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		const Vector3 &n = normals[i & 255];
+		real_t min = 0, max = 0;
+		for (int j = 0; j < vertex_count; j++) {
+			real_t d = n.dot(xform.xform(vertices[j]));
+			if (j == 0 || d > max) {
+				max = d;
+			}
+			if (j == 0 || d < min) {
+				min = d;
+			}
+		}
+		sum += max - min;
+	}
+	uint64_t reference_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	real_t scalar_sum = 0;
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		const Vector3 &n = normals[i & 255];
+		real_t min, max;
+		CollisionKernelsSW::project_points_scalar(x, y, z, vertex_count, xform.basis.xform_inv(n), min, max);
+		scalar_sum += max - min;
+	}
+	uint64_t scalar_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	real_t kernel_sum = 0;
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		const Vector3 &n = normals[i & 255];
+		real_t min, max;
+		CollisionKernelsSW::project_points(x, y, z, vertex_count, xform.basis.xform_inv(n), min, max);
+		kernel_sum += max - min;
+	}
+	uint64_t kernel_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	print_line("Convex projection (" + itos(vertex_count) + " vertices): reference " + itos(reference_usec) + " usec, scalar " + itos(scalar_usec) + " usec, kernel " + itos(kernel_usec) + " usec" + (Math::is_equal_approx(sum, kernel_sum, (real_t)(sum * 0.0001)) && Math::is_equal_approx(scalar_sum, kernel_sum, (real_t)(sum * 0.0001)) ? "" : " (MISMATCH)"));
+
+	// Support points, as used by GJK/EPA.
+	int index_sum = 0;
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		index_sum += CollisionKernelsSW::get_support_index_scalar(x, y, z, vertex_count, normals[i & 255]);
+	}
+	scalar_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	int kernel_index_sum = 0;
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		kernel_index_sum += CollisionKernelsSW::get_support_index(x, y, z, vertex_count, normals[i & 255]);
+	}
+	kernel_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	print_line("Convex support: scalar " + itos(scalar_usec) + " usec, kernel " + itos(kernel_usec) + " usec" + (index_sum == kernel_index_sum ? "" : " (MISMATCH)"));
+
+	// Box ranges on the 15 box-box separating axes.
+	Vector3 axes[15];
+	real_t min[15], max[15];
+	for (int i = 0; i < 15; i++) {
+		axes[i] = normals[i];
+	}
+
+	sum = 0;
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		xform.origin.x = i & 7;
+		CollisionKernelsSW::project_box_scalar(xform, Vector3(1, 2, 3), axes, 15, min, max);
+		sum += max[i % 15] - min[i % 15];
+	}
+	scalar_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	kernel_sum = 0;
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < iterations; i++) {
+		xform.origin.x = i & 7;
+		CollisionKernelsSW::project_box(xform, Vector3(1, 2, 3), axes, 15, min, max);
+		kernel_sum += max[i % 15] - min[i % 15];
+	}
+	kernel_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	print_line("Box projection (15 axes): scalar " + itos(scalar_usec) + " usec, kernel " + itos(kernel_usec) + " usec" + (Math::is_equal_approx(sum, kernel_sum, (real_t)(sum * 0.0001)) ? "" : " (MISMATCH)"));
+
+	return nullptr;
+}
 } // namespace TestPhysics
@@ -34,7 +34,11 @@
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
 #include "core/print_string.h"
+#include "core/project_settings.h"
 #include "scene/resources/texture.h"
+#include "servers/physics_2d/body_2d_sw.h"
+#include "servers/physics_2d/broad_phase_2d_bvh.h"
+#include "servers/physics_2d/broad_phase_2d_multi_level_grid.h"
 #include "servers/physics_2d_server.h"
 #include "servers/visual_server.h"
 
@@ -402,4 +406,151 @@ namespace TestPhysics2D {
 MainLoop *test() {
 	return memnew(TestPhysics2DMainLoop);
 }
+
+static int broadphase_pair_count = 0;
+
+static void *_broadphase_pair(CollisionObject2DSW *p_object_A, int p_subindex_A, CollisionObject2DSW *p_object_B, int p_subindex_B, void *p_pair_data, void *p_user_data) {
+	if (!p_pair_data) {
+		broadphase_pair_count++;
+	}
+	return p_user_data;
+}
+
+static void _broadphase_unpair(CollisionObject2DSW *p_object_A, int p_subindex_A, CollisionObject2DSW *p_object_B, int p_subindex_B, void *p_pair_data, void *p_user_data) {
+	broadphase_pair_count--;
+}
+
+// What a broadphase reported during the benchmark, which must be the same for every implementation.
+struct BroadPhaseResults {
+	Vector<int> pair_counts; // After each update().
+	Vector<int> cull_counts; // For each cull_aabb() and cull_segment().
+	int pairs_left; // After removing everything, must be 0.
+};
+
+static BroadPhaseResults _benchmark_broadphase(const String &p_name, BroadPhase2DSW *p_broadphase, const Vector<CollisionObject2DSW *> &p_objects, const Vector<Rect2> &p_aabbs, int p_static_count) {
+	const int steps = 60;
+	const int queries = 1000;
+
+	broadphase_pair_count = 0;
+	p_broadphase->set_pair_callback(_broadphase_pair, p_broadphase);
+	p_broadphase->set_unpair_callback(_broadphase_unpair, p_broadphase);
+
+	BroadPhaseResults results;
+
+	Math::seed(1234);
+	Vector<BroadPhase2DSW::ID> ids;
+	ids.resize(p_objects.size());
+	Vector<Rect2> aabbs = p_aabbs;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_objects.size(); i++) {
+		ids.write[i] = p_broadphase->create(p_objects[i], 0, aabbs[i], i < p_static_count);
+	}
+	p_broadphase->update();
+	uint64_t create_usec = OS::get_singleton()->get_ticks_usec() - from;
+	results.pair_counts.push_back(broadphase_pair_count);
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int s = 0; s < steps; s++) {
+		for (int i = p_static_count; i < p_objects.size(); i++) {
+			aabbs.write[i].position += Vector2(Math::random(-4.0, 4.0), Math::random(-4.0, 4.0));
+			p_broadphase->move(ids[i], aabbs[i]);
+		}
+		p_broadphase->update();
+
+		// Cheap next to update(), so it stays in the timed loop.
+		results.pair_counts.push_back(broadphase_pair_count);
+	}
+	uint64_t move_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	CollisionObject2DSW *culled_objects[256];
+	int culled = 0;
+	results.cull_counts.resize(queries * 2);
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < queries; i++) {
+		Vector2 pos(Math::random(0.0, 8192.0), Math::random(0.0, 8192.0));
+		int count = p_broadphase->cull_aabb(Rect2(pos, Vector2(64, 64)), culled_objects, 256);
+		results.cull_counts.write[i * 2] = count;
+		culled += count;
+		count = p_broadphase->cull_segment(pos, pos + Vector2(Math::random(-512.0, 512.0), Math::random(-512.0, 512.0)), culled_objects, 256);
+		results.cull_counts.write[i * 2 + 1] = count;
+		culled += count;
+	}
+	uint64_t cull_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	for (int i = 0; i < ids.size(); i++) {
+		p_broadphase->remove(ids[i]);
+	}
+
+	results.pairs_left = broadphase_pair_count;
+
+	print_line(p_name + ": create " + itos(create_usec) + " usec, " + itos(steps) + " steps " + itos(move_usec) + " usec, " + itos(queries * 2) + " culls " + itos(cull_usec) + " usec (" + itos(culled) + " results), pairs left " + itos(broadphase_pair_count));
+	return results;
+}
+
+// Checks the results of p_name against the reference ones, given by the BVH.
+static bool _check_broadphase_results(const String &p_name, const BroadPhaseResults &p_results, const BroadPhaseResults &p_expected) {
+	if (p_results.pairs_left != 0) {
+		print_line(p_name + ": " + itos(p_results.pairs_left) + " pairs left after removing every object.");
+		return false;
+	}
+
+	for (int i = 0; i < p_expected.pair_counts.size(); i++) {
+		if (p_results.pair_counts[i] != p_expected.pair_counts[i]) {
+			print_line(p_name + ": " + itos(p_results.pair_counts[i]) + " pairs after update " + itos(i) + ", expected " + itos(p_expected.pair_counts[i]) + ".");
+			return false;
+		}
+	}
+
+	for (int i = 0; i < p_expected.cull_counts.size(); i++) {
+		if (p_results.cull_counts[i] != p_expected.cull_counts[i]) {
+			print_line(p_name + ": " + itos(p_results.cull_counts[i]) + " results for cull " + itos(i) + ", expected " + itos(p_expected.cull_counts[i]) + ".");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+MainLoop *test_broadphase() {
+	// Many tiny moving bodies (bullets) mixed with large static geometry, the case where
+	// a single cell size is a bad fit for everything.
+	const int static_count = 200;
+	const int bullet_count = 10000;
+
+	Math::seed(4321);
+	Vector<CollisionObject2DSW *> objects;
+	Vector<Rect2> aabbs;
+	for (int i = 0; i < static_count + bullet_count; i++) {
+		objects.push_back(memnew(Body2DSW));
+		Vector2 pos(Math::random(0.0, 8192.0), Math::random(0.0, 8192.0));
+		if (i < static_count) {
+			aabbs.push_back(Rect2(pos, Vector2(Math::random(256.0, 2048.0), Math::random(64.0, 512.0))));
+		} else {
+			aabbs.push_back(Rect2(pos, Vector2(4, 4)));
+		}
+	}
+
+	// The BVH is the reference, without margin so its pairs are the exact overlaps like the grid's.
+	Variant margin = ProjectSettings::get_singleton()->get("physics/2d/bvh_collision_margin");
+	ProjectSettings::get_singleton()->set("physics/2d/bvh_collision_margin", 0);
+	BroadPhase2DSW *bvh = memnew(BroadPhase2DBVH);
+	ProjectSettings::get_singleton()->set("physics/2d/bvh_collision_margin", margin);
+	BroadPhaseResults bvh_results = _benchmark_broadphase("BVH", bvh, objects, aabbs, static_count);
+	memdelete(bvh);
+
+	BroadPhase2DSW *grid = memnew(BroadPhase2DMultiLevelGrid(4, 128, 512));
+	BroadPhaseResults grid_results = _benchmark_broadphase("Multi-level hash grid", grid, objects, aabbs, static_count);
+	memdelete(grid);
+
+	bool pass = _check_broadphase_results("BVH", bvh_results, bvh_results);
+	pass = _check_broadphase_results("Multi-level hash grid", grid_results, bvh_results) && pass;
+	print_line(pass ? "PASS" : "FAILED");
+
+	for (int i = 0; i < objects.size(); i++) {
+		memdelete(objects[i]);
+	}
+
+	return nullptr;
+}
 } // namespace TestPhysics2D
@@ -610,6 +610,13 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 	_clear_pending_func_states();
 
+	// Kept instances may have cached what the previous version defined (e.g. Node and _process()).
+	GDScriptLanguage::singleton->lock.lock();
+	for (Set<Object *>::Element *E = instances.front(); E; E = E->next()) {
+		E->get()->_script_instance_changed();
+	}
+	GDScriptLanguage::singleton->lock.unlock();
+
 	return OK;
 }
 
@@ -30,6 +30,7 @@
 
 #include "gdscript_compiler.h"
 
+#include "core/core_string_names.h"
 #include "gdscript.h"
 
 bool GDScriptCompiler::_is_class_member_property(CodeGen &codegen, const StringName &p_name) {
@@ -74,6 +75,97 @@ void GDScriptCompiler::_set_error(const String &p_error, const GDScriptParser::N
 	}
 }
 
+static Variant::Type _get_builtin_type(const GDScriptParser::Node *p_node) {
+	GDScriptParser::DataType datatype = p_node->get_datatype();
+	if (datatype.has_type && datatype.kind == GDScriptParser::DataType::BUILTIN) {
+		return datatype.builtin_type;
+	}
+	return Variant::NIL;
+}
+
+// Picks a typed operator opcode when the static types of the operands are known. The types are
+// still checked at runtime, falling back to the generic evaluation if they don't match.
+GDScriptFunction::Opcode GDScriptCompiler::_get_operator_opcode(Variant::Operator p_op, const GDScriptParser::Node *p_a, const GDScriptParser::Node *p_b) const {
+	Variant::Type type_a = _get_builtin_type(p_a);
+	Variant::Type type_b = _get_builtin_type(p_b);
+
+	if (type_a == Variant::INT && type_b == Variant::INT) {
+		switch (p_op) {
+			case Variant::OP_EQUAL:
+			case Variant::OP_NOT_EQUAL:
+			case Variant::OP_LESS:
+			case Variant::OP_LESS_EQUAL:
+			case Variant::OP_GREATER:
+			case Variant::OP_GREATER_EQUAL:
+			case Variant::OP_ADD:
+			case Variant::OP_SUBTRACT:
+			case Variant::OP_MULTIPLY:
+			case Variant::OP_DIVIDE:
+			case Variant::OP_MODULE:
+			case Variant::OP_NEGATE:
+			case Variant::OP_BIT_AND:
+			case Variant::OP_BIT_OR:
+			case Variant::OP_BIT_XOR:
+				return GDScriptFunction::OPCODE_OPERATOR_INT;
+			default:
+				break;
+		}
+	} else if (type_a == Variant::REAL && type_b == Variant::REAL) {
+		switch (p_op) {
+			case Variant::OP_EQUAL:
+			case Variant::OP_NOT_EQUAL:
+			case Variant::OP_LESS:
+			case Variant::OP_LESS_EQUAL:
+			case Variant::OP_GREATER:
+			case Variant::OP_GREATER_EQUAL:
+			case Variant::OP_ADD:
+			case Variant::OP_SUBTRACT:
+			case Variant::OP_MULTIPLY:
+			case Variant::OP_DIVIDE:
+			case Variant::OP_NEGATE:
+				return GDScriptFunction::OPCODE_OPERATOR_REAL;
+			default:
+				break;
+		}
+	} else if (type_a == Variant::VECTOR2 || type_a == Variant::VECTOR3) {
+		GDScriptFunction::Opcode opcode = type_a == Variant::VECTOR2 ? GDScriptFunction::OPCODE_OPERATOR_VECTOR2 : GDScriptFunction::OPCODE_OPERATOR_VECTOR3;
+		if (type_b == type_a) {
+			switch (p_op) {
+				case Variant::OP_EQUAL:
+				case Variant::OP_NOT_EQUAL:
+				case Variant::OP_ADD:
+				case Variant::OP_SUBTRACT:
+				case Variant::OP_MULTIPLY:
+				case Variant::OP_NEGATE:
+					return opcode;
+				default:
+					break;
+			}
+		} else if (p_op == Variant::OP_MULTIPLY && (type_b == Variant::REAL || type_b == Variant::INT)) {
+			return opcode;
+		}
+	}
+
+	return GDScriptFunction::OPCODE_OPERATOR;
+}
+
+// Returns the axis accessed by p_name on a base statically known to be a Vector2 or Vector3, or -1.
+int GDScriptCompiler::_get_vector_axis(const GDScriptParser::Node *p_base, const StringName &p_name) const {
+	Variant::Type type = _get_builtin_type(p_base);
+	if (type != Variant::VECTOR2 && type != Variant::VECTOR3) {
+		return -1;
+	}
+
+	if (p_name == CoreStringNames::get_singleton()->x) {
+		return 0;
+	} else if (p_name == CoreStringNames::get_singleton()->y) {
+		return 1;
+	} else if (p_name == CoreStringNames::get_singleton()->z && type == Variant::VECTOR3) {
+		return 2;
+	}
+	return -1;
+}
+
 bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level) {
 	ERR_FAIL_COND_V(on->arguments.size() != 1, false);
 
@@ -82,7 +174,7 @@ bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptPa
 		return false;
 	}
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	codegen.opcodes.push_back(_get_operator_opcode(op, on->arguments[0], on->arguments[0])); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_a); // argument 2 (repeated)
@@ -106,7 +198,7 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 		return false;
 	}
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	codegen.opcodes.push_back(_get_operator_opcode(op, on->arguments[0], on->arguments[1])); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
@@ -673,6 +765,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						codegen.alloc_call(on->arguments.size() - 2);
 						for (int i = 0; i < arguments.size(); i++) {
 							codegen.opcodes.push_back(arguments[i]);
+							if (i == 1) {
+								codegen.opcodes.push_back(codegen.call_cache_count++); // call cache, after base and name
+							}
 						}
 					}
 				} break;
@@ -761,9 +856,27 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						}
 					}
 
-					codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
-					codegen.opcodes.push_back(from); // argument 1
-					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
+					int axis = -1;
+					if (on->op == GDScriptParser::OperatorNode::OP_INDEX_NAMED && p_index_addr == 0) {
+						axis = _get_vector_axis(on->arguments[0], static_cast<const GDScriptParser::IdentifierNode *>(on->arguments[1])->name);
+					}
+
+					if (axis >= 0) {
+						codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_VECTOR_AXIS);
+						codegen.opcodes.push_back(from);
+						codegen.opcodes.push_back(index);
+						codegen.opcodes.push_back(axis);
+					} else {
+						if (named) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_NAMED); // perform operator
+						} else if (p_index_addr == 0 && _get_builtin_type(on->arguments[0]) == Variant::ARRAY && _get_builtin_type(on->arguments[1]) == Variant::INT) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_ARRAY);
+						} else {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET);
+						}
+						codegen.opcodes.push_back(from); // argument 1
+						codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
+					}
 
 				} break;
 				case GDScriptParser::OperatorNode::OP_AND: {
@@ -1149,10 +1262,23 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							return set_value;
 						}
 
-						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
+						int axis = named ? _get_vector_axis(op->arguments[0], static_cast<const GDScriptParser::IdentifierNode *>(op->arguments[1])->name) : -1;
+
+						if (axis >= 0) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET_VECTOR_AXIS);
+						} else if (named) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET_NAMED);
+						} else if (_get_builtin_type(op->arguments[0]) == Variant::ARRAY && _get_builtin_type(op->arguments[1]) == Variant::INT) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET_ARRAY);
+						} else {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET);
+						}
 						codegen.opcodes.push_back(prev_pos);
 						codegen.opcodes.push_back(set_index);
 						codegen.opcodes.push_back(set_value);
+						if (axis >= 0) {
+							codegen.opcodes.push_back(axis);
+						}
 
 						for (int i = 0; i < setchain.size(); i++) {
 							codegen.opcodes.push_back(setchain[i]);
@@ -1631,6 +1757,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.call_cache_count = 0;
 	codegen.debug_stack = ScriptDebugger::get_singleton() != nullptr;
 	Vector<StringName> argnames;
 
@@ -1809,6 +1936,15 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	gdfunc->_argument_count = p_func ? p_func->arguments.size() : 0;
 	gdfunc->_stack_size = codegen.stack_max;
 	gdfunc->_call_size = codegen.call_max;
+	if (codegen.call_cache_count) {
+		gdfunc->_call_caches = memnew_arr(GDScriptFunction::CallCache, codegen.call_cache_count);
+		for (int i = 0; i < codegen.call_cache_count; i++) {
+			for (int j = 0; j < GDScriptFunction::CallCache::MAX_ENTRIES; j++) {
+				gdfunc->_call_caches[i].slots[j].version.store(0, std::memory_order_relaxed);
+			}
+		}
+		gdfunc->_call_cache_count = codegen.call_cache_count;
+	}
 	gdfunc->name = func_name;
 #ifdef DEBUG_ENABLED
 	if (ScriptDebugger::get_singleton()) {
@@ -2200,6 +2336,9 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 
 	source = p_script->get_path();
 
+	// The methods of the script are about to change, so calls cached for its instances become stale.
+	GDScriptFunction::invalidate_call_caches();
+
 	// The best fully qualified name for a base level script is its file path
 	p_script->fully_qualified_name = p_script->path;
 
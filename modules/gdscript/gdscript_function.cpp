@@ -30,7 +30,10 @@
 
 #include "gdscript_function.h"
 
+#include "core/class_db.h"
+#include "core/core_string_names.h"
 #include "core/os/os.h"
+#include "core/variant_internal.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
 
@@ -183,16 +186,652 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 	return err_text;
 }
 
+// Generic operator evaluation, also used by the typed operators when the operands don't have
+// the expected types at runtime.
+static _FORCE_INLINE_ bool _evaluate_operator(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, Variant *r_dst, String &r_err_text) {
+	bool valid;
+#ifdef DEBUG_ENABLED
+	Variant ret;
+	Variant::evaluate(p_op, *p_a, *p_b, ret, valid);
+	if (!valid) {
+		if (ret.get_type() == Variant::STRING) {
+			//return a string when invalid with the error
+			r_err_text = ret;
+			r_err_text += " in operator '" + Variant::get_operator_name(p_op) + "'.";
+		} else {
+			r_err_text = "Invalid operands '" + Variant::get_type_name(p_a->get_type()) + "' and '" + Variant::get_type_name(p_b->get_type()) + "' in operator '" + Variant::get_operator_name(p_op) + "'.";
+		}
+		return false;
+	}
+	*r_dst = ret;
+#else
+	Variant::evaluate(p_op, *p_a, *p_b, *r_dst, valid);
+#endif
+	return true;
+}
+
+static _FORCE_INLINE_ void _set_bool(Variant *r_dst, bool p_value) {
+	VariantInternal::initialize(r_dst, Variant::BOOL);
+	*VariantInternal::get_bool(r_dst) = p_value;
+}
+
+static _FORCE_INLINE_ void _set_int(Variant *r_dst, int64_t p_value) {
+	VariantInternal::initialize(r_dst, Variant::INT);
+	*VariantInternal::get_int(r_dst) = p_value;
+}
+
+static _FORCE_INLINE_ void _set_real(Variant *r_dst, double p_value) {
+	VariantInternal::initialize(r_dst, Variant::REAL);
+	*VariantInternal::get_real(r_dst) = p_value;
+}
+
+static _FORCE_INLINE_ void _set_vector2(Variant *r_dst, const Vector2 &p_value) {
+	VariantInternal::initialize(r_dst, Variant::VECTOR2);
+	*VariantInternal::get_vector2(r_dst) = p_value;
+}
+
+static _FORCE_INLINE_ void _set_vector3(Variant *r_dst, const Vector3 &p_value) {
+	VariantInternal::initialize(r_dst, Variant::VECTOR3);
+	*VariantInternal::get_vector3(r_dst) = p_value;
+}
+
+// The typed operators return false for anything they don't handle, so the generic path is used instead.
+// This includes divisions by zero, so they still raise the usual error.
+
+static _FORCE_INLINE_ bool _evaluate_operator_int(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+	if (unlikely(p_a->get_type() != Variant::INT || p_b->get_type() != Variant::INT)) {
+		return false;
+	}
+
+	int64_t a = *VariantInternal::get_int(p_a);
+	int64_t b = *VariantInternal::get_int(p_b);
+
+	switch (p_op) {
+		case Variant::OP_EQUAL: {
+			_set_bool(r_dst, a == b);
+		} break;
+		case Variant::OP_NOT_EQUAL: {
+			_set_bool(r_dst, a != b);
+		} break;
+		case Variant::OP_LESS: {
+			_set_bool(r_dst, a < b);
+		} break;
+		case Variant::OP_LESS_EQUAL: {
+			_set_bool(r_dst, a <= b);
+		} break;
+		case Variant::OP_GREATER: {
+			_set_bool(r_dst, a > b);
+		} break;
+		case Variant::OP_GREATER_EQUAL: {
+			_set_bool(r_dst, a >= b);
+		} break;
+		case Variant::OP_ADD: {
+			_set_int(r_dst, a + b);
+		} break;
+		case Variant::OP_SUBTRACT: {
+			_set_int(r_dst, a - b);
+		} break;
+		case Variant::OP_MULTIPLY: {
+			_set_int(r_dst, a * b);
+		} break;
+		case Variant::OP_DIVIDE: {
+			if (b == 0) {
+				return false;
+			}
+			_set_int(r_dst, a / b);
+		} break;
+		case Variant::OP_MODULE: {
+			if (b == 0) {
+				return false;
+			}
+			_set_int(r_dst, a % b);
+		} break;
+		case Variant::OP_NEGATE: {
+			_set_int(r_dst, -a);
+		} break;
+		case Variant::OP_BIT_AND: {
+			_set_int(r_dst, a & b);
+		} break;
+		case Variant::OP_BIT_OR: {
+			_set_int(r_dst, a | b);
+		} break;
+		case Variant::OP_BIT_XOR: {
+			_set_int(r_dst, a ^ b);
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static _FORCE_INLINE_ bool _evaluate_operator_real(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, Variant *r_dst) {
+	if (unlikely(p_a->get_type() != Variant::REAL || p_b->get_type() != Variant::REAL)) {
+		return false;
+	}
+
+	double a = *VariantInternal::get_real(p_a);
+	double b = *VariantInternal::get_real(p_b);
+
+	switch (p_op) {
+		case Variant::OP_EQUAL: {
+			_set_bool(r_dst, a == b);
+		} break;
+		case Variant::OP_NOT_EQUAL: {
+			_set_bool(r_dst, a != b);
+		} break;
+		case Variant::OP_LESS: {
+			_set_bool(r_dst, a < b);
+		} break;
+		case Variant::OP_LESS_EQUAL: {
+			_set_bool(r_dst, a <= b);
+		} break;
+		case Variant::OP_GREATER: {
+			_set_bool(r_dst, a > b);
+		} break;
+		case Variant::OP_GREATER_EQUAL: {
+			_set_bool(r_dst, a >= b);
+		} break;
+		case Variant::OP_ADD: {
+			_set_real(r_dst, a + b);
+		} break;
+		case Variant::OP_SUBTRACT: {
+			_set_real(r_dst, a - b);
+		} break;
+		case Variant::OP_MULTIPLY: {
+			_set_real(r_dst, a * b);
+		} break;
+		case Variant::OP_DIVIDE: {
+#ifdef DEBUG_ENABLED
+			if (b == 0) {
+				return false;
+			}
+#endif
+			_set_real(r_dst, a / b);
+		} break;
+		case Variant::OP_NEGATE: {
+			_set_real(r_dst, -a);
+		} break;
+		default: {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#define TYPED_VECTOR_OPERATOR(m_name, m_type, m_variant_type, m_get, m_set)                                               \
+	static _FORCE_INLINE_ bool m_name(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, Variant *r_dst) { \
+		if (unlikely(p_a->get_type() != Variant::m_variant_type)) {                                                    \
+			return false;                                                                                              \
+		}                                                                                                              \
+                                                                                                                       \
+		const m_type a = *VariantInternal::m_get(p_a);                                                                 \
+                                                                                                                       \
+		if (p_b->get_type() == Variant::m_variant_type) {                                                              \
+			const m_type b = *VariantInternal::m_get(p_b);                                                             \
+			switch (p_op) {                                                                                            \
+				case Variant::OP_EQUAL: {                                                                              \
+					_set_bool(r_dst, a == b);                                                                          \
+				} break;                                                                                               \
+				case Variant::OP_NOT_EQUAL: {                                                                          \
+					_set_bool(r_dst, a != b);                                                                          \
+				} break;                                                                                               \
+				case Variant::OP_ADD: {                                                                                \
+					m_set(r_dst, a + b);                                                                               \
+				} break;                                                                                               \
+				case Variant::OP_SUBTRACT: {                                                                           \
+					m_set(r_dst, a - b);                                                                               \
+				} break;                                                                                               \
+				case Variant::OP_MULTIPLY: {                                                                           \
+					m_set(r_dst, a * b);                                                                               \
+				} break;                                                                                               \
+				case Variant::OP_NEGATE: {                                                                             \
+					m_set(r_dst, -a);                                                                                  \
+				} break;                                                                                               \
+				default: {                                                                                             \
+					return false;                                                                                      \
+				}                                                                                                      \
+			}                                                                                                          \
+			return true;                                                                                               \
+		}                                                                                                              \
+                                                                                                                       \
+		if (p_op == Variant::OP_MULTIPLY) {                                                                            \
+			if (p_b->get_type() == Variant::REAL) {                                                                    \
+				m_set(r_dst, a * *VariantInternal::get_real(p_b));                                                     \
+				return true;                                                                                           \
+			}                                                                                                          \
+			if (p_b->get_type() == Variant::INT) {                                                                     \
+				m_set(r_dst, a * *VariantInternal::get_int(p_b));                                                      \
+				return true;                                                                                           \
+			}                                                                                                          \
+		}                                                                                                              \
+                                                                                                                       \
+		return false;                                                                                                  \
+	}
+
+TYPED_VECTOR_OPERATOR(_evaluate_operator_vector2, Vector2, VECTOR2, get_vector2, _set_vector2)
+TYPED_VECTOR_OPERATOR(_evaluate_operator_vector3, Vector3, VECTOR3, get_vector3, _set_vector3)
+
+#undef TYPED_VECTOR_OPERATOR
+
+// Generic indexing, also used by the typed versions when the operands don't have the expected types
+// at runtime, or the index is out of bounds (so the usual error is raised).
+
+static _FORCE_INLINE_ bool _set_indexed(Variant *p_dst, const Variant *p_index, const Variant *p_value, String &r_err_text) {
+	bool valid;
+	p_dst->set(*p_index, *p_value, &valid);
+
+#ifdef DEBUG_ENABLED
+	if (!valid) {
+		String v = p_index->operator String();
+		if (v != "") {
+			v = "'" + v + "'";
+		} else {
+			v = "of type '" + _get_var_type(p_index) + "'";
+		}
+		r_err_text = "Invalid set index " + v + " (on base: '" + _get_var_type(p_dst) + "') with value of type '" + _get_var_type(p_value) + "'";
+		return false;
+	}
+#endif
+	return true;
+}
+
+static _FORCE_INLINE_ bool _get_indexed(const Variant *p_src, const Variant *p_index, Variant *r_dst, String &r_err_text) {
+	bool valid;
+#ifdef DEBUG_ENABLED
+	//allow better error message in cases where src and dst are the same stack position
+	Variant ret = p_src->get(*p_index, &valid);
+	if (!valid) {
+		String v = p_index->operator String();
+		if (v != "") {
+			v = "'" + v + "'";
+		} else {
+			v = "of type '" + _get_var_type(p_index) + "'";
+		}
+		r_err_text = "Invalid get index " + v + " (on base: '" + _get_var_type(p_src) + "').";
+		return false;
+	}
+	*r_dst = ret;
+#else
+	*r_dst = p_src->get(*p_index, &valid);
+#endif
+	return true;
+}
+
+static _FORCE_INLINE_ bool _set_named(Variant *p_dst, const StringName &p_index, const Variant *p_value, String &r_err_text) {
+	bool valid;
+	p_dst->set_named(p_index, *p_value, &valid);
+
+#ifdef DEBUG_ENABLED
+	if (!valid) {
+		r_err_text = "Invalid set index '" + String(p_index) + "' (on base: '" + _get_var_type(p_dst) + "') with value of type '" + _get_var_type(p_value) + "'.";
+		return false;
+	}
+#endif
+	return true;
+}
+
+static _FORCE_INLINE_ bool _get_named(const Variant *p_src, const StringName &p_index, Variant *r_dst, String &r_err_text) {
+	bool valid;
+#ifdef DEBUG_ENABLED
+	//allow better error message in cases where src and dst are the same stack position
+	Variant ret = p_src->get_named(p_index, &valid);
+	if (!valid) {
+		if (p_src->has_method(p_index)) {
+			r_err_text = "Invalid get index '" + p_index.operator String() + "' (on base: '" + _get_var_type(p_src) + "'). Did you mean '." + p_index.operator String() + "()' or funcref(obj, \"" + p_index.operator String() + "\") ?";
+		} else {
+			r_err_text = "Invalid get index '" + p_index.operator String() + "' (on base: '" + _get_var_type(p_src) + "').";
+		}
+		return false;
+	}
+	*r_dst = ret;
+#else
+	*r_dst = p_src->get_named(p_index, &valid);
+#endif
+	return true;
+}
+
+// Resolves an int index (negative ones counting from the end) into an Array, as Variant::get() does.
+static _FORCE_INLINE_ bool _get_array_index(const Variant *p_array, const Variant *p_index, int &r_index) {
+	if (unlikely(p_array->get_type() != Variant::ARRAY || p_index->get_type() != Variant::INT)) {
+		return false;
+	}
+
+	int index = *VariantInternal::get_int(p_index);
+	int size = VariantInternal::get_array(p_array)->size();
+	if (index < 0) {
+		index += size;
+	}
+	if (unlikely(index < 0 || index >= size)) {
+		return false;
+	}
+
+	r_index = index;
+	return true;
+}
+
+// Variant stacks of the functions running on a thread. Unused slots are kept as empty Variants, so calls
+// only write their arguments when starting and only clear the slots that hold a value when returning.
+class GDScriptFrameArena {
+	enum {
+		CHUNK_SIZE = 4096,
+	};
+
+	struct Chunk {
+		Variant *slots;
+		uint32_t size;
+		uint32_t used;
+	};
+
+	LocalVector<Chunk> chunks;
+	int32_t current = -1;
+
+public:
+	_FORCE_INLINE_ Variant *push(uint32_t p_size) {
+		if (likely(current >= 0)) {
+			Chunk &chunk = chunks[current];
+			if (likely(chunk.used + p_size <= chunk.size)) {
+				Variant *frame = chunk.slots + chunk.used;
+				chunk.used += p_size;
+				return frame;
+			}
+		}
+
+		// Frames don't span chunks, continue in the next one (which is unused).
+		current++;
+		if (uint32_t(current) == chunks.size()) {
+			Chunk chunk;
+			chunk.slots = nullptr;
+			chunk.size = 0;
+			chunk.used = 0;
+			chunks.push_back(chunk);
+		}
+
+		Chunk &chunk = chunks[current];
+		if (chunk.size < p_size) {
+			if (chunk.slots) {
+				memdelete_arr(chunk.slots);
+			}
+			chunk.size = MAX(uint32_t(CHUNK_SIZE), p_size);
+			chunk.slots = memnew_arr(Variant, chunk.size);
+		}
+		chunk.used = p_size;
+		return chunk.slots;
+	}
+
+	// Frames must be popped in reverse order.
+	_FORCE_INLINE_ void pop(Variant *p_frame, uint32_t p_size) {
+		for (uint32_t i = 0; i < p_size; i++) {
+			VariantInternal::clear(&p_frame[i]);
+		}
+
+		Chunk &chunk = chunks[current];
+		chunk.used -= p_size;
+		if (chunk.used == 0 && current > 0) {
+			current--;
+		}
+	}
+
+	~GDScriptFrameArena() {
+		for (uint32_t i = 0; i < chunks.size(); i++) {
+			if (chunks[i].slots) {
+				memdelete_arr(chunks[i].slots);
+			}
+		}
+	}
+};
+
+static thread_local GDScriptFrameArena frame_arena;
+
+SafeNumeric<uint32_t> GDScriptFunction::call_cache_version(1);
+
+// Calls can be cached for objects without script or with a GDScript instance, as their native methods only
+// depend on the class and the script then. Other script instances may handle any method in Object::call().
+bool GDScriptFunction::_get_call_cache_key(const Variant *p_base, Object *&r_object, const GDScript *&r_script) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return false;
+	}
+
+	Object *object = VariantInternal::get_object(p_base);
+	if (unlikely(!object)) {
+		return false; // Reported by the generic path.
+	}
+
+	ScriptInstance *script_instance = object->get_script_instance();
+	if (script_instance) {
+		if (script_instance->is_placeholder() || script_instance->get_language() != GDScriptLanguage::get_singleton()) {
+			return false;
+		}
+		r_script = static_cast<GDScriptInstance *>(script_instance)->script.ptr();
+	} else {
+		r_script = nullptr;
+	}
+
+	r_object = object;
+	return true;
+}
+
+bool GDScriptFunction::_get_call_cache_entry(const CallCache &p_cache, const Object *p_object, const GDScript *p_script, CallCache::Entry &r_entry) {
+	const void *class_name = p_object->get_class_name().data_unique_pointer();
+	uint32_t version = call_cache_version.get();
+
+	for (int i = 0; i < CallCache::MAX_ENTRIES; i++) {
+		const CallCache::Slot &slot = p_cache.slots[i];
+		uint32_t slot_version = slot.version.load(std::memory_order_acquire);
+		if (slot_version == 0) {
+			break; // Slots are filled in order, a slot being rewritten is a miss.
+		}
+		if (slot_version != version || slot.entry.class_name != class_name || slot.entry.script != p_script) {
+			continue;
+		}
+
+		// The entry may be rewritten while it is copied, the copy is only valid if the version is unchanged.
+		r_entry = slot.entry;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.version.load(std::memory_order_relaxed) == slot_version;
+	}
+
+	return false;
+}
+
+#if defined(PTRCALL_ENABLED) && defined(DEBUG_METHODS_ENABLED)
+// Types whose Variant storage is what PtrToArg expects, NIL standing for Variant itself.
+static _FORCE_INLINE_ bool _is_ptrcall_type(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::NIL:
+		case Variant::BOOL:
+		case Variant::INT:
+		case Variant::REAL:
+		case Variant::STRING:
+		case Variant::VECTOR2:
+		case Variant::RECT2:
+		case Variant::VECTOR3:
+		case Variant::TRANSFORM2D:
+		case Variant::PLANE:
+		case Variant::QUAT:
+		case Variant::AABB:
+		case Variant::BASIS:
+		case Variant::TRANSFORM:
+		case Variant::COLOR:
+			return true;
+		default:
+			return false;
+	}
+}
+#endif
+
+void GDScriptFunction::_call_method_bind(const CallCache::Entry *p_entry, Object *p_object, const Variant **p_args, int p_argcount, Variant *r_ret, Variant::CallError &r_err) {
+#if defined(PTRCALL_ENABLED) && defined(DEBUG_METHODS_ENABLED)
+	if (p_entry->ptrcall && p_argcount == p_entry->method->get_argument_count()) {
+		const void *argptrs[CallCache::MAX_PTRCALL_ARGS];
+		int i = 0;
+		for (; i < p_argcount; i++) {
+			Variant::Type type = p_entry->argument_types[i];
+			if (type == Variant::NIL) {
+				argptrs[i] = p_args[i];
+			} else if (p_args[i]->get_type() == type) {
+				argptrs[i] = VariantInternal::get_opaque_pointer(p_args[i]);
+			} else {
+				break; // Needs a conversion, done by call().
+			}
+		}
+
+		if (i == p_argcount) {
+			r_err.error = Variant::CallError::CALL_OK;
+
+			if (!p_entry->method->has_return()) {
+				p_entry->method->ptrcall(p_object, argptrs, nullptr);
+				if (r_ret) {
+					*r_ret = Variant();
+				}
+				return;
+			}
+
+			// The return value may be one of the arguments, so it is written once the call is done.
+			Variant ret;
+			switch (p_entry->return_type) {
+				case Variant::NIL: {
+					p_entry->method->ptrcall(p_object, argptrs, &ret);
+				} break;
+				case Variant::STRING:
+				case Variant::TRANSFORM2D:
+				case Variant::AABB:
+				case Variant::BASIS:
+				case Variant::TRANSFORM: {
+					Variant::CallError ce;
+					ret = Variant::construct(p_entry->return_type, nullptr, 0, ce);
+					p_entry->method->ptrcall(p_object, argptrs, VariantInternal::get_opaque_pointer(&ret));
+				} break;
+				default: {
+					VariantInternal::initialize(&ret, p_entry->return_type);
+					p_entry->method->ptrcall(p_object, argptrs, VariantInternal::get_opaque_pointer(&ret));
+				} break;
+			}
+			if (r_ret) {
+				*r_ret = ret;
+			}
+			return;
+		}
+	}
+#endif
+
+	Variant ret = p_entry->method->call(p_object, p_args, p_argcount, r_err);
+	if (r_ret && r_err.error == Variant::CallError::CALL_OK) {
+		*r_ret = ret;
+	}
+}
+
+bool GDScriptFunction::_update_call_cache(CallCache &p_cache, const StringName &p_method, Object *p_object, const GDScript *p_script, CallCache::Entry &r_entry) {
+	const void *class_name = p_object->get_class_name().data_unique_pointer();
+	uint32_t version = call_cache_version.get();
+
+	// Don't lock when the cache is already full of valid entries.
+	int i = 0;
+	for (; i < CallCache::MAX_ENTRIES; i++) {
+		if (p_cache.slots[i].version.load(std::memory_order_acquire) != version) {
+			break;
+		}
+	}
+	if (i == CallCache::MAX_ENTRIES) {
+		return false;
+	}
+
+	MutexLock lock(call_cache_mutex);
+
+	// Another thread may have cached the receiver meanwhile, otherwise the first empty or stale slot is used.
+	// Slots are only written with the lock held, so they can be read directly here.
+	int slot_index = -1;
+	for (i = 0; i < CallCache::MAX_ENTRIES; i++) {
+		const CallCache::Slot &slot = p_cache.slots[i];
+		uint32_t slot_version = slot.version.load(std::memory_order_relaxed);
+		if (slot_version != version) {
+			if (slot_index == -1) {
+				slot_index = i;
+			}
+			if (slot_version == 0) {
+				break;
+			}
+		} else if (slot.entry.class_name == class_name && slot.entry.script == p_script) {
+			r_entry = slot.entry;
+			return true;
+		}
+	}
+	if (slot_index == -1) {
+		return false;
+	}
+
+	CallCache::Entry entry;
+	entry.class_name = class_name;
+	entry.script = p_script;
+	entry.method = nullptr;
+	entry.ptrcall = false;
+	entry.return_type = Variant::NIL;
+
+	// Same lookup as Object::call(), methods defined by the script take precedence. Classes overriding
+	// Object::call() may handle any method themselves, so they always use the generic path.
+	bool native = p_method != CoreStringNames::get_singleton()->_free && !ClassDB::is_call_overridden(p_object->get_class_name());
+	for (const GDScript *script = p_script; script && native; script = script->_base) {
+		if (script->member_functions.has(p_method)) {
+			native = false;
+		}
+	}
+	if (native) {
+		entry.method = ClassDB::get_method(p_object->get_class_name(), p_method);
+	}
+
+#if defined(PTRCALL_ENABLED) && defined(DEBUG_METHODS_ENABLED)
+	MethodBind *method = entry.method;
+	if (method && !method->is_vararg() && method->get_argument_count() <= CallCache::MAX_PTRCALL_ARGS) {
+		entry.ptrcall = true;
+
+		if (method->has_return()) {
+			entry.return_type = method->get_argument_type(-1);
+			// Enums are encoded as int, leaving the rest of the int64_t storage unset.
+			if (!_is_ptrcall_type(entry.return_type) || (method->get_return_info().usage & PROPERTY_USAGE_CLASS_IS_ENUM)) {
+				entry.ptrcall = false;
+			}
+		}
+
+		for (int j = 0; j < method->get_argument_count(); j++) {
+			entry.argument_types[j] = method->get_argument_type(j);
+			if (!_is_ptrcall_type(entry.argument_types[j])) {
+				entry.ptrcall = false;
+			}
+		}
+	}
+#endif
+
+	// Readers seeing version 0 skip the slot, and those which copied it before recheck the version afterwards.
+	CallCache::Slot &slot = p_cache.slots[slot_index];
+	slot.version.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.entry = entry;
+	slot.version.store(version, std::memory_order_release);
+
+	r_entry = entry;
+	return true;
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_INT,                \
+		&&OPCODE_OPERATOR_REAL,               \
+		&&OPCODE_OPERATOR_VECTOR2,            \
+		&&OPCODE_OPERATOR_VECTOR3,            \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_IS_BUILTIN,                  \
 		&&OPCODE_SET,                         \
 		&&OPCODE_GET,                         \
+		&&OPCODE_SET_ARRAY,                   \
+		&&OPCODE_GET_ARRAY,                   \
 		&&OPCODE_SET_NAMED,                   \
 		&&OPCODE_GET_NAMED,                   \
+		&&OPCODE_SET_VECTOR_AXIS,             \
+		&&OPCODE_GET_VECTOR_AXIS,             \
 		&&OPCODE_SET_MEMBER,                  \
 		&&OPCODE_GET_MEMBER,                  \
 		&&OPCODE_ASSIGN,                      \
@@ -309,50 +948,37 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 		alloca_size = sizeof(Variant *) * _call_size + sizeof(Variant) * _stack_size;
 
-		if (alloca_size) {
-			uint8_t *aptr = (uint8_t *)alloca(alloca_size);
+		if (_stack_size) {
+			// The frame slots are empty, arguments are constructed in place.
+			stack = frame_arena.push(_stack_size);
+			for (int i = 0; i < p_argcount; i++) {
+				if (!argument_types[i].has_type) {
+					memnew_placement(&stack[i], Variant(*p_args[i]));
+					continue;
+				}
 
-			if (_stack_size) {
-				stack = (Variant *)aptr;
-				for (int i = 0; i < p_argcount; i++) {
-					if (!argument_types[i].has_type) {
-						memnew_placement(&stack[i], Variant(*p_args[i]));
+				if (!argument_types[i].is_type(*p_args[i], true)) {
+					if (argument_types[i].is_type(Variant(), true)) {
 						continue;
-					}
-
-					if (!argument_types[i].is_type(*p_args[i], true)) {
-						if (argument_types[i].is_type(Variant(), true)) {
-							memnew_placement(&stack[i], Variant);
-							continue;
-						} else {
-							r_err.error = Variant::CallError::CALL_ERROR_INVALID_ARGUMENT;
-							r_err.argument = i;
-							r_err.expected = argument_types[i].kind == GDScriptDataType::BUILTIN ? argument_types[i].builtin_type : Variant::OBJECT;
-							return Variant();
-						}
-					}
-					if (argument_types[i].kind == GDScriptDataType::BUILTIN) {
-						Variant arg = Variant::construct(argument_types[i].builtin_type, &p_args[i], 1, r_err);
-						memnew_placement(&stack[i], Variant(arg));
 					} else {
-						memnew_placement(&stack[i], Variant(*p_args[i]));
+						r_err.error = Variant::CallError::CALL_ERROR_INVALID_ARGUMENT;
+						r_err.argument = i;
+						r_err.expected = argument_types[i].kind == GDScriptDataType::BUILTIN ? argument_types[i].builtin_type : Variant::OBJECT;
+						frame_arena.pop(stack, _stack_size);
+						return Variant();
 					}
 				}
-				for (int i = p_argcount; i < _stack_size; i++) {
-					memnew_placement(&stack[i], Variant);
+				if (argument_types[i].kind == GDScriptDataType::BUILTIN) {
+					memnew_placement(&stack[i], Variant(Variant::construct(argument_types[i].builtin_type, &p_args[i], 1, r_err)));
+				} else {
+					memnew_placement(&stack[i], Variant(*p_args[i]));
 				}
-			} else {
-				stack = nullptr;
-			}
-
-			if (_call_size) {
-				call_args = (Variant **)&aptr[sizeof(Variant) * _stack_size];
-			} else {
-				call_args = nullptr;
 			}
+		}
 
+		if (_call_size) {
+			call_args = (Variant **)alloca(sizeof(Variant *) * _call_size);
 		} else {
-			stack = nullptr;
 			call_args = nullptr;
 		}
 
@@ -429,7 +1055,6 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_OPERATOR) {
 				CHECK_SPACE(5);
 
-				bool valid;
 				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
 				GD_ERR_BREAK(op >= Variant::OP_MAX);
 
@@ -437,26 +1062,85 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(b, 3);
 				GET_VARIANT_PTR(dst, 4);
 
-#ifdef DEBUG_ENABLED
+				if (!_evaluate_operator(op, a, b, dst, err_text)) {
+					OPCODE_BREAK;
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
 
-				Variant ret;
-				Variant::evaluate(op, *a, *b, ret, valid);
-#else
-				Variant::evaluate(op, *a, *b, *dst, valid);
-#endif
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					if (ret.get_type() == Variant::STRING) {
-						//return a string when invalid with the error
-						err_text = ret;
-						err_text += " in operator '" + Variant::get_operator_name(op) + "'.";
-					} else {
-						err_text = "Invalid operands '" + Variant::get_type_name(a->get_type()) + "' and '" + Variant::get_type_name(b->get_type()) + "' in operator '" + Variant::get_operator_name(op) + "'.";
+			OPCODE(OPCODE_OPERATOR_INT) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (unlikely(!_evaluate_operator_int(op, a, b, dst))) {
+					if (!_evaluate_operator(op, a, b, dst, err_text)) {
+						OPCODE_BREAK;
+					}
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_REAL) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (unlikely(!_evaluate_operator_real(op, a, b, dst))) {
+					if (!_evaluate_operator(op, a, b, dst, err_text)) {
+						OPCODE_BREAK;
+					}
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_VECTOR2) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (unlikely(!_evaluate_operator_vector2(op, a, b, dst))) {
+					if (!_evaluate_operator(op, a, b, dst, err_text)) {
+						OPCODE_BREAK;
+					}
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_OPERATOR_VECTOR3) {
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (unlikely(!_evaluate_operator_vector3(op, a, b, dst))) {
+					if (!_evaluate_operator(op, a, b, dst, err_text)) {
+						OPCODE_BREAK;
 					}
-					OPCODE_BREAK;
 				}
-				*dst = ret;
-#endif
 				ip += 5;
 			}
 			DISPATCH_OPCODE;
@@ -543,21 +1227,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(index, 2);
 				GET_VARIANT_PTR(value, 3);
 
-				bool valid;
-				dst->set(*index, *value, &valid);
-
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					String v = index->operator String();
-					if (v != "") {
-						v = "'" + v + "'";
-					} else {
-						v = "of type '" + _get_var_type(index) + "'";
-					}
-					err_text = "Invalid set index " + v + " (on base: '" + _get_var_type(dst) + "') with value of type '" + _get_var_type(value) + "'";
+				if (!_set_indexed(dst, index, value, err_text)) {
 					OPCODE_BREAK;
 				}
-#endif
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
@@ -569,27 +1241,50 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(index, 2);
 				GET_VARIANT_PTR(dst, 3);
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get(*index, &valid);
-#else
-				*dst = src->get(*index, &valid);
+				if (!_get_indexed(src, index, dst, err_text)) {
+					OPCODE_BREAK;
+				}
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
 
-#endif
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					String v = index->operator String();
-					if (v != "") {
-						v = "'" + v + "'";
+			OPCODE(OPCODE_SET_ARRAY) {
+				CHECK_SPACE(3);
+
+				GET_VARIANT_PTR(dst, 1);
+				GET_VARIANT_PTR(index, 2);
+				GET_VARIANT_PTR(value, 3);
+
+				int array_index;
+				if (likely(_get_array_index(dst, index, array_index))) {
+					(*VariantInternal::get_array(dst))[array_index] = *value;
+				} else if (!_set_indexed(dst, index, value, err_text)) {
+					OPCODE_BREAK;
+				}
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_ARRAY) {
+				CHECK_SPACE(3);
+
+				GET_VARIANT_PTR(src, 1);
+				GET_VARIANT_PTR(index, 2);
+				GET_VARIANT_PTR(dst, 3);
+
+				int array_index;
+				if (likely(_get_array_index(src, index, array_index))) {
+					const Variant &value = (*VariantInternal::get_array(src))[array_index];
+					if (likely(dst != src)) {
+						*dst = value;
 					} else {
-						v = "of type '" + _get_var_type(index) + "'";
+						// assigning would free the array holding the value
+						Variant ret = value;
+						*dst = ret;
 					}
-					err_text = "Invalid get index " + v + " (on base: '" + _get_var_type(src) + "').";
+				} else if (!_get_indexed(src, index, dst, err_text)) {
 					OPCODE_BREAK;
 				}
-				*dst = ret;
-#endif
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
@@ -605,16 +1300,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-				dst->set_named(*index, *value, &valid);
-
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					String err_type;
-					err_text = "Invalid set index '" + String(*index) + "' (on base: '" + _get_var_type(dst) + "') with value of type '" + _get_var_type(value) + "'.";
+				if (!_set_named(dst, *index, value, err_text)) {
 					OPCODE_BREAK;
 				}
-#endif
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
@@ -630,29 +1318,66 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, &valid);
-
-#else
-				*dst = src->get_named(*index, &valid);
-#endif
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					if (src->has_method(*index)) {
-						err_text = "Invalid get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "'). Did you mean '." + index->operator String() + "()' or funcref(obj, \"" + index->operator String() + "\") ?";
-					} else {
-						err_text = "Invalid get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "').";
-					}
+				if (!_get_named(src, *index, dst, err_text)) {
 					OPCODE_BREAK;
 				}
-				*dst = ret;
-#endif
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_SET_VECTOR_AXIS) {
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(dst, 1);
+				GET_VARIANT_PTR(value, 3);
+
+				int indexname = _code_ptr[ip + 2];
+				int axis = _code_ptr[ip + 4];
+
+				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+				GD_ERR_BREAK(axis < 0 || axis > 2);
+
+				real_t *component = nullptr;
+				if (dst->get_type() == Variant::VECTOR3) {
+					component = &(*VariantInternal::get_vector3(dst))[axis];
+				} else if (dst->get_type() == Variant::VECTOR2 && axis < 2) {
+					component = &(*VariantInternal::get_vector2(dst))[axis];
+				}
+
+				if (likely(component && value->get_type() == Variant::REAL)) {
+					*component = *VariantInternal::get_real(value);
+				} else if (likely(component && value->get_type() == Variant::INT)) {
+					*component = *VariantInternal::get_int(value);
+				} else if (!_set_named(dst, _global_names_ptr[indexname], value, err_text)) {
+					OPCODE_BREAK;
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_VECTOR_AXIS) {
+				CHECK_SPACE(5);
+
+				GET_VARIANT_PTR(src, 1);
+				GET_VARIANT_PTR(dst, 4);
+
+				int indexname = _code_ptr[ip + 2];
+				int axis = _code_ptr[ip + 3];
+
+				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+				GD_ERR_BREAK(axis < 0 || axis > 2);
+
+				if (likely(src->get_type() == Variant::VECTOR3)) {
+					_set_real(dst, (*VariantInternal::get_vector3(src))[axis]);
+				} else if (likely(src->get_type() == Variant::VECTOR2 && axis < 2)) {
+					_set_real(dst, (*VariantInternal::get_vector2(src))[axis]);
+				} else if (!_get_named(src, _global_names_ptr[indexname], dst, err_text)) {
+					OPCODE_BREAK;
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_SET_MEMBER) {
 				CHECK_SPACE(3);
 				int indexname = _code_ptr[ip + 1];
@@ -1010,18 +1735,22 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
 
 				int argc = _code_ptr[ip + 1];
 				GET_VARIANT_PTR(base, 2);
 				int nameg = _code_ptr[ip + 3];
+				int cache_index = _code_ptr[ip + 4];
 
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
+				GD_ERR_BREAK(cache_index < 0 || cache_index >= _call_cache_count);
+				CallCache &call_cache = _call_caches[cache_index];
+
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -1039,11 +1768,29 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #endif
 				Variant::CallError err;
+				Variant *ret = nullptr;
 				if (call_ret) {
-					GET_VARIANT_PTR(ret, argc);
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
+					GET_VARIANT_PTR(dst, argc);
+					ret = dst;
+				}
+
+				// The receiver is looked up before calling, as the call may free it.
+				Object *object;
+				const GDScript *object_script;
+				CallCache::Entry call_cache_entry;
+				bool cached = false;
+				if (_get_call_cache_key(base, object, object_script)) {
+					cached = _get_call_cache_entry(call_cache, object, object_script, call_cache_entry) || _update_call_cache(call_cache, *methodname, object, object_script, call_cache_entry);
+				}
+
+				if (cached && call_cache_entry.method) {
+#ifdef DEBUG_ENABLED
+					// Like Object::call(), so the receiver can't be freed by its own method.
+					_ObjectDebugLock debug_lock(object);
+#endif
+					_call_method_bind(&call_cache_entry, object, (const Variant **)argptrs, argc, ret, err);
 				} else {
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, nullptr, err);
+					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1571,11 +2318,15 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		}
 #endif
 
-		if (_stack_size) {
-			//free stack
-			for (int i = 0; i < _stack_size; i++) {
-				stack[i].~Variant();
+		if (p_state) {
+			if (_stack_size) {
+				//free stack
+				for (int i = 0; i < _stack_size; i++) {
+					stack[i].~Variant();
+				}
 			}
+		} else if (stack) {
+			frame_arena.pop(stack, _stack_size);
 		}
 
 #ifdef DEBUG_ENABLED
@@ -1694,6 +2445,8 @@ GDScriptFunction::GDScriptFunction() :
 		function_list(this) {
 	_stack_size = 0;
 	_call_size = 0;
+	_call_caches = nullptr;
+	_call_cache_count = 0;
 	rpc_mode = MultiplayerAPI::RPC_MODE_DISABLED;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -1717,6 +2470,10 @@ GDScriptFunction::GDScriptFunction() :
 }
 
 GDScriptFunction::~GDScriptFunction() {
+	if (_call_caches) {
+		memdelete_arr(_call_caches);
+	}
+
 #ifdef DEBUG_ENABLED
 	GDScriptLanguage::get_singleton()->lock.lock();
 	GDScriptLanguage::get_singleton()->function_list.remove(&function_list);
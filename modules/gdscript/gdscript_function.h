@@ -31,9 +31,11 @@
 #ifndef GDSCRIPT_FUNCTION_H
 #define GDSCRIPT_FUNCTION_H
 
+#include "core/os/mutex.h"
 #include "core/os/thread.h"
 #include "core/pair.h"
 #include "core/reference.h"
+#include "core/safe_refcount.h"
 #include "core/script_language.h"
 #include "core/self_list.h"
 #include "core/string_name.h"
@@ -41,6 +43,7 @@
 
 class GDScriptInstance;
 class GDScript;
+class MethodBind;
 
 struct GDScriptDataType {
 	bool has_type;
@@ -160,12 +163,20 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_INT, // typed versions of OPCODE_OPERATOR, for operands known to be of the given type
+		OPCODE_OPERATOR_REAL,
+		OPCODE_OPERATOR_VECTOR2,
+		OPCODE_OPERATOR_VECTOR3,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET,
 		OPCODE_GET,
+		OPCODE_SET_ARRAY, // OPCODE_SET/OPCODE_GET on an Array with an int index
+		OPCODE_GET_ARRAY,
 		OPCODE_SET_NAMED,
 		OPCODE_GET_NAMED,
+		OPCODE_SET_VECTOR_AXIS, // OPCODE_SET_NAMED/OPCODE_GET_NAMED of x, y or z on a Vector2/Vector3
+		OPCODE_GET_VECTOR_AXIS,
 		OPCODE_SET_MEMBER,
 		OPCODE_GET_MEMBER,
 		OPCODE_ASSIGN,
@@ -268,6 +279,43 @@ private:
 
 	List<StackDebug> stack_debug;
 
+	// Inline cache of a call site (OPCODE_CALL and OPCODE_CALL_RETURN), holding the native method resolved
+	// for the last receiver types seen. Stale entries are rewritten in place under call_cache_mutex, so
+	// readers copy an entry out without locking and only use the copy if its slot version didn't change.
+	struct CallCache {
+		enum {
+			MAX_ENTRIES = 4, // call sites seeing more receiver types than this are not cached further
+			MAX_PTRCALL_ARGS = 8,
+		};
+
+		struct Entry {
+			const void *class_name; // StringName::data_unique_pointer() of the receiver class
+			const GDScript *script; // GDScript of the receiver, or null
+			MethodBind *method; // null if the method is not native, the generic path is used then
+			bool ptrcall; // whether method can be called with ptrcall() when the argument types match
+			Variant::Type return_type;
+			Variant::Type argument_types[MAX_PTRCALL_ARGS];
+		};
+
+		struct Slot {
+			std::atomic<uint32_t> version; // call_cache_version when the entry was written, 0 if empty or being written
+			Entry entry;
+		};
+
+		Slot slots[MAX_ENTRIES];
+	};
+
+	CallCache *_call_caches;
+	int _call_cache_count;
+	Mutex call_cache_mutex;
+
+	static SafeNumeric<uint32_t> call_cache_version;
+
+	_FORCE_INLINE_ static bool _get_call_cache_key(const Variant *p_base, Object *&r_object, const GDScript *&r_script);
+	_FORCE_INLINE_ static bool _get_call_cache_entry(const CallCache &p_cache, const Object *p_object, const GDScript *p_script, CallCache::Entry &r_entry);
+	_FORCE_INLINE_ static void _call_method_bind(const CallCache::Entry *p_entry, Object *p_object, const Variant **p_args, int p_argcount, Variant *r_ret, Variant::CallError &r_err);
+	bool _update_call_cache(CallCache &p_cache, const StringName &p_method, Object *p_object, const GDScript *p_script, CallCache::Entry &r_entry);
+
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Variant::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
@@ -347,6 +395,14 @@ public:
 	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Variant::CallError &r_err, CallState *p_state = nullptr);
 
 	_FORCE_INLINE_ MultiplayerAPI::RPCMode get_rpc_mode() const { return rpc_mode; }
+
+	// Must be called whenever the methods of a script change, as the call caches rely on them.
+	static void invalidate_call_caches() {
+		if (call_cache_version.increment() == 0) {
+			call_cache_version.increment(); // 0 marks empty slots.
+		}
+	}
+
 	GDScriptFunction();
 	~GDScriptFunction();
 };
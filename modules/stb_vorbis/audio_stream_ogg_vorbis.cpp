@@ -151,7 +151,11 @@ String AudioStreamOGGVorbis::get_stream_name() const {
 
 void AudioStreamOGGVorbis::clear_data() {
 	if (data) {
-		AudioServer::get_singleton()->audio_data_free(data);
+		if (data_reference.size()) {
+			data_reference = PoolVector<uint8_t>();
+		} else {
+			AudioServer::get_singleton()->audio_data_free(data);
+		}
 		data = nullptr;
 		data_len = 0;
 	}
@@ -202,7 +206,13 @@ void AudioStreamOGGVorbis::set_data(const PoolVector<uint8_t> &p_data) {
 			// free any existing data
 			clear_data();
 
-			data = AudioServer::get_singleton()->audio_data_alloc(src_data_len, src_datar.ptr());
+			if (p_data.is_external()) {
+				// Read-only memory that outlives the stream (such as a mapped pack), no need to copy it.
+				data_reference = p_data;
+				data = (void *)src_datar.ptr();
+			} else {
+				data = AudioServer::get_singleton()->audio_data_alloc(src_data_len, src_datar.ptr());
+			}
 			data_len = src_data_len;
 
 			break;
@@ -213,6 +223,10 @@ void AudioStreamOGGVorbis::set_data(const PoolVector<uint8_t> &p_data) {
 }
 
 PoolVector<uint8_t> AudioStreamOGGVorbis::get_data() const {
+	if (data_reference.size()) {
+		return data_reference;
+	}
+
 	PoolVector<uint8_t> vdata;
 
 	if (data_len && data) {
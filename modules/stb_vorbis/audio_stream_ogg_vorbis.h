@@ -78,6 +78,7 @@ class AudioStreamOGGVorbis : public AudioStream {
 
 	void *data;
 	uint32_t data_len;
+	PoolVector<uint8_t> data_reference; // keeps external (mapped) data alive when data points into it instead of a copy
 
 	int decode_mem_size;
 	float sample_rate;
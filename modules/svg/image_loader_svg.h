@@ -32,6 +32,7 @@
 #define IMAGE_LOADER_SVG_H
 
 #include "core/io/image_loader.h"
+#include "core/os/mutex.h"
 #include "core/ustring.h"
 
 /**
@@ -44,6 +45,8 @@ struct NSVGimage;
 
 class SVGRasterizer {
 	NSVGrasterizer *rasterizer;
+	// The rasterizer keeps scratch buffers, textures can be imported from several threads at once.
+	Mutex mutex;
 
 public:
 	void rasterize(NSVGimage *p_image, float p_tx, float p_ty, float p_scale, unsigned char *p_dst, int p_w, int p_h, int p_stride);
@@ -30,6 +30,8 @@
 
 #include "navigation_2d.h"
 
+#include "core/sort_array.h"
+
 #define USE_ENTRY_POINT
 
 void Navigation2D::_navpoly_link(int p_id) {
@@ -37,6 +39,8 @@ void Navigation2D::_navpoly_link(int p_id) {
 	NavMesh &nm = navpoly_map[p_id];
 	ERR_FAIL_COND(nm.linked);
 
+	_wait_path_batches();
+
 	PoolVector<Vector2> vertices = nm.navpoly->get_vertices();
 	int len = vertices.size();
 	if (len == 0) {
@@ -51,6 +55,7 @@ void Navigation2D::_navpoly_link(int p_id) {
 		List<Polygon>::Element *P = nm.polygons.push_back(Polygon());
 		Polygon &p = P->get();
 		p.owner = &nm;
+		p.id = -1;
 
 		Vector<int> poly = nm.navpoly->get_polygon(i);
 		int plen = poly.size();
@@ -129,6 +134,7 @@ void Navigation2D::_navpoly_link(int p_id) {
 	}
 
 	nm.linked = true;
+	polygons_dirty = true;
 }
 
 void Navigation2D::_navpoly_unlink(int p_id) {
@@ -136,6 +142,8 @@ void Navigation2D::_navpoly_unlink(int p_id) {
 	NavMesh &nm = navpoly_map[p_id];
 	ERR_FAIL_COND(!nm.linked);
 
+	_wait_path_batches();
+
 	for (List<Polygon>::Element *E = nm.polygons.front(); E; E = E->next()) {
 		Polygon &p = E->get();
 
@@ -192,6 +200,204 @@ void Navigation2D::_navpoly_unlink(int p_id) {
 	nm.polygons.clear();
 
 	nm.linked = false;
+	polygons_dirty = true;
+}
+
+int Navigation2D::_create_polygon_bvh(PolygonBVH *p_bvh, PolygonBVH **p_bb, int p_from, int p_size, int &max_alloc) {
+	if (p_size == 1) {
+		return p_bb[p_from] - p_bvh;
+	} else if (p_size == 0) {
+		return -1;
+	}
+
+	Rect2 aabb;
+	aabb = p_bb[p_from]->aabb;
+	for (int i = 1; i < p_size; i++) {
+		aabb = aabb.merge(p_bb[p_from + i]->aabb);
+	}
+
+	if (aabb.size.x > aabb.size.y) {
+		SortArray<PolygonBVH *, BVHCmpX> sort_x;
+		sort_x.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+	} else {
+		SortArray<PolygonBVH *, BVHCmpY> sort_y;
+		sort_y.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+	}
+
+	int left = _create_polygon_bvh(p_bvh, p_bb, p_from, p_size / 2, max_alloc);
+	int right = _create_polygon_bvh(p_bvh, p_bb, p_from + p_size / 2, p_size - p_size / 2, max_alloc);
+
+	int index = max_alloc++;
+	PolygonBVH *_new = &p_bvh[index];
+	_new->aabb = aabb;
+	_new->center = aabb.position + aabb.size * 0.5;
+	_new->polygon = nullptr;
+	_new->left = left;
+	_new->right = right;
+
+	return index;
+}
+
+void Navigation2D::_update_polygons() {
+	if (!polygons_dirty) {
+		return;
+	}
+	polygons_dirty = false;
+
+	polygons.clear();
+	polygon_bvh.clear();
+
+	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
+		if (!E->get().linked) {
+			continue;
+		}
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+			Polygon &p = F->get();
+			if (p.edges.size() == 0) {
+				continue;
+			}
+			p.id = polygons.size();
+			polygons.push_back(&p);
+		}
+	}
+
+	int count = polygons.size();
+	if (count == 0) {
+		return;
+	}
+
+	// Leaves first, then the nodes, the root being the last one.
+	polygon_bvh.resize(count * 2 - 1);
+	LocalVector<PolygonBVH *> bb;
+	bb.resize(count);
+
+	for (int i = 0; i < count; i++) {
+		Polygon *p = polygons[i];
+		PolygonBVH &leaf = polygon_bvh[i];
+		leaf.aabb = Rect2(_get_vertex(p->edges[0].point), Vector2());
+		for (int j = 1; j < p->edges.size(); j++) {
+			leaf.aabb.expand_to(_get_vertex(p->edges[j].point));
+		}
+		leaf.center = leaf.aabb.position + leaf.aabb.size * 0.5;
+		leaf.left = -1;
+		leaf.right = -1;
+		leaf.polygon = p;
+		bb[i] = &leaf;
+	}
+
+	int max_alloc = count;
+	_create_polygon_bvh(polygon_bvh.ptr(), bb.ptr(), 0, count, max_alloc);
+}
+
+static _FORCE_INLINE_ real_t _get_rect_distance_squared(const Rect2 &p_rect, const Vector2 &p_point) {
+	Vector2 d;
+	if (p_point.x < p_rect.position.x) {
+		d.x = p_rect.position.x - p_point.x;
+	} else if (p_point.x > p_rect.position.x + p_rect.size.x) {
+		d.x = p_point.x - p_rect.position.x - p_rect.size.x;
+	}
+	if (p_point.y < p_rect.position.y) {
+		d.y = p_rect.position.y - p_point.y;
+	} else if (p_point.y > p_rect.position.y + p_rect.size.y) {
+		d.y = p_point.y - p_rect.position.y - p_rect.size.y;
+	}
+	return d.length_squared();
+}
+
+Navigation2D::Polygon *Navigation2D::_get_closest_polygon(const Vector2 &p_point, Vector2 &r_point) const {
+	if (polygon_bvh.empty()) {
+		return nullptr;
+	}
+
+	Polygon *closest = nullptr;
+	real_t closest_d = 1e20;
+
+	// Nearest node first, skipping the nodes further than the closest polygon found so far.
+	int stack[64];
+	int stack_size = 0;
+	stack[stack_size++] = polygon_bvh.size() - 1;
+
+	while (stack_size) {
+		const PolygonBVH &node = polygon_bvh[stack[--stack_size]];
+		real_t node_d = _get_rect_distance_squared(node.aabb, p_point);
+		if (node_d >= closest_d) {
+			continue;
+		}
+
+		if (node.polygon) {
+			const Polygon &p = *node.polygon;
+
+			if (node_d == 0) {
+				for (int i = 2; i < p.edges.size(); i++) {
+					if (Geometry::is_point_in_triangle(p_point, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
+						r_point = p_point; //inside triangle, nothing else to discuss
+						return node.polygon;
+					}
+				}
+			}
+
+			int es = p.edges.size();
+			for (int i = 0; i < es; i++) {
+				Vector2 edge[2] = {
+					_get_vertex(p.edges[i].point),
+					_get_vertex(p.edges[(i + 1) % es].point)
+				};
+
+				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
+				real_t d = spoint.distance_squared_to(p_point);
+				if (d < closest_d) {
+					closest_d = d;
+					closest = node.polygon;
+					r_point = spoint;
+				}
+			}
+			continue;
+		}
+
+		ERR_FAIL_COND_V(stack_size + 2 > 64, closest);
+		const PolygonBVH &left = polygon_bvh[node.left];
+		const PolygonBVH &right = polygon_bvh[node.right];
+		if (left.center.distance_squared_to(p_point) < right.center.distance_squared_to(p_point)) {
+			stack[stack_size++] = node.right;
+			stack[stack_size++] = node.left;
+		} else {
+			stack[stack_size++] = node.left;
+			stack[stack_size++] = node.right;
+		}
+	}
+
+	return closest;
+}
+
+float Navigation2D::_get_polygon_cost(const Polygon *p_poly, const PolygonState &p_state, const Vector2 &p_end_point) const {
+#ifdef USE_ENTRY_POINT
+	int es = p_poly->edges.size();
+
+	float shortest_distance = 1e30;
+
+	for (int i = 0; i < es; i++) {
+		const Polygon::Edge &e = p_poly->edges[i];
+
+		if (!e.C) {
+			continue;
+		}
+
+		Vector2 edge[2] = {
+			_get_vertex(p_poly->edges[i].point),
+			_get_vertex(p_poly->edges[(i + 1) % es].point)
+		};
+
+		Vector2 edge_point = Geometry::get_closest_point_to_segment_2d(p_state.entry, edge);
+		float dist = p_state.entry.distance_to(edge_point);
+		if (dist < shortest_distance) {
+			shortest_distance = dist;
+		}
+	}
+
+	return p_state.distance + shortest_distance;
+#else
+	return p_state.distance + p_poly->center.distance_to(p_end_point);
+#endif
 }
 
 int Navigation2D::navpoly_add(const Ref<NavigationPolygon> &p_mesh, const Transform2D &p_xform, Object *p_owner) {
@@ -227,232 +433,235 @@ void Navigation2D::navpoly_remove(int p_id) {
 }
 
 Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) {
-	Polygon *begin_poly = nullptr;
-	Polygon *end_poly = nullptr;
-	Vector2 begin_point;
-	Vector2 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
+	_update_polygons();
+	return _get_simple_path(path_query, p_start, p_end, p_optimize);
+}
 
-	//look for point inside triangle
+Navigation2D::PathBatch *Navigation2D::_create_path_batch(const PoolVector<Vector2> &p_starts, const PoolVector<Vector2> &p_ends, bool p_optimize) {
+	ERR_FAIL_COND_V_MSG(p_starts.size() != p_ends.size(), nullptr, "Start and end points must have the same size.");
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
-		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			if (begin_d || end_d) {
-				for (int i = 2; i < p.edges.size(); i++) {
-					if (begin_d > 0) {
-						if (Geometry::is_point_in_triangle(p_start, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
-							begin_poly = &p;
-							begin_point = p_start;
-							begin_d = 0;
-							if (end_d == 0) {
-								break;
-							}
-						}
-					}
+	_update_polygons();
 
-					if (end_d > 0) {
-						if (Geometry::is_point_in_triangle(p_end, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
-							end_poly = &p;
-							end_point = p_end;
-							end_d = 0;
-							if (begin_d == 0) {
-								break;
-							}
-						}
-					}
-				}
-			}
+	PathBatch *batch = memnew(PathBatch);
+	batch->id = last_batch_id++;
+	batch->optimize = p_optimize;
+	batch->runner_queries = nullptr;
+	batch->group = ThreadWorkPool::INVALID_TASK_ID;
 
-			p.prev_edge = -1;
-		}
+	int count = p_starts.size();
+	batch->starts.resize(count);
+	batch->ends.resize(count);
+	batch->paths.resize(count);
+
+	PoolVector<Vector2>::Read starts = p_starts.read();
+	PoolVector<Vector2>::Read ends = p_ends.read();
+	for (int i = 0; i < count; i++) {
+		batch->starts[i] = starts[i];
+		batch->ends[i] = ends[i];
 	}
 
-	//start or end not inside triangle.. look for closest segment :|
-	if (begin_d || end_d) {
-		for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
-			if (!E->get().linked) {
-				continue;
-			}
-			for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-				Polygon &p = F->get();
-				int es = p.edges.size();
-				for (int i = 0; i < es; i++) {
-					Vector2 edge[2] = {
-						_get_vertex(p.edges[i].point),
-						_get_vertex(p.edges[(i + 1) % es].point)
-					};
-
-					if (begin_d > 0) {
-						Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_start, edge);
-						float d = spoint.distance_to(p_start);
-						if (d < begin_d) {
-							begin_poly = &p;
-							begin_point = spoint;
-							begin_d = d;
-						}
-					}
+	return batch;
+}
 
-					if (end_d > 0) {
-						Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_end, edge);
-						float d = spoint.distance_to(p_end);
-						if (d < end_d) {
-							end_poly = &p;
-							end_point = spoint;
-							end_d = d;
-						}
-					}
-				}
-			}
+void Navigation2D::_solve_path_batch(uint32_t p_runner, PathBatch *p_batch) {
+	PathQuery &query = p_batch->runner_queries[p_runner];
+	uint32_t count = p_batch->paths.size();
+
+	while (true) {
+		uint32_t i = p_batch->next_path.postincrement();
+		if (i >= count) {
+			break;
 		}
+		p_batch->paths[i] = _get_simple_path(query, p_batch->starts[i], p_batch->ends[i], p_batch->optimize);
 	}
+}
 
-	if (!begin_poly || !end_poly) {
-		return Vector<Vector2>(); //no path
+Array Navigation2D::_get_path_batch_result(const PathBatch *p_batch) const {
+	Array paths;
+	paths.resize(p_batch->paths.size());
+	for (uint32_t i = 0; i < p_batch->paths.size(); i++) {
+		paths[i] = p_batch->paths[i];
 	}
+	return paths;
+}
 
-	if (begin_poly == end_poly) {
-		Vector<Vector2> path;
-		path.resize(2);
-		path.write[0] = begin_point;
-		path.write[1] = end_point;
-		return path;
+void Navigation2D::_wait_path_batches() {
+	// Asynchronous queries read the polygons, so they must be done before anything is modified.
+	for (uint32_t i = 0; i < path_batches.size(); i++) {
+		PathBatch *batch = path_batches[i];
+		if (batch->group != ThreadWorkPool::INVALID_TASK_ID) {
+			ThreadWorkPool::get_singleton()->wait_for_group_task_completion(batch->group);
+			batch->group = ThreadWorkPool::INVALID_TASK_ID;
+		}
 	}
+}
 
-	bool found_route = false;
-
-	List<Polygon *> open_list;
+Array Navigation2D::get_simple_paths(const PoolVector<Vector2> &p_starts, const PoolVector<Vector2> &p_ends, bool p_optimize) {
+	PathBatch *batch = _create_path_batch(p_starts, p_ends, p_optimize);
+	ERR_FAIL_NULL_V(batch, Array());
 
-	begin_poly->entry = p_start;
+	// The calling thread helps, so there is one more runner than workers.
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	uint32_t runners = MIN(batch->paths.size(), pool ? pool->get_thread_count() + 1 : 1);
+	if (batch_queries.size() < runners) {
+		batch_queries.resize(runners);
+	}
+	batch->runner_queries = batch_queries.ptr();
 
-	for (int i = 0; i < begin_poly->edges.size(); i++) {
-		if (begin_poly->edges[i].C) {
-			begin_poly->edges[i].C->prev_edge = begin_poly->edges[i].C_edge;
-#ifdef USE_ENTRY_POINT
-			Vector2 edge[2] = {
-				_get_vertex(begin_poly->edges[i].point),
-				_get_vertex(begin_poly->edges[(i + 1) % begin_poly->edges.size()].point)
-			};
+	if (runners > 1) {
+		pool->do_parallel_for(runners, this, &Navigation2D::_solve_path_batch, batch, 1);
+	} else if (runners == 1) {
+		_solve_path_batch(0, batch);
+	}
 
-			Vector2 entry = Geometry::get_closest_point_to_segment_2d(begin_poly->entry, edge);
-			begin_poly->edges[i].C->distance = begin_poly->entry.distance_to(entry);
-			begin_poly->edges[i].C->entry = entry;
-#else
-			begin_poly->edges[i].C->distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
-#endif
-			open_list.push_back(begin_poly->edges[i].C);
+	Array paths = _get_path_batch_result(batch);
+	memdelete(batch);
+	return paths;
+}
 
-			if (begin_poly->edges[i].C == end_poly) {
-				found_route = true;
-			}
-		}
-	}
+int Navigation2D::get_simple_paths_async(const PoolVector<Vector2> &p_starts, const PoolVector<Vector2> &p_ends, bool p_optimize) {
+	PathBatch *batch = _create_path_batch(p_starts, p_ends, p_optimize);
+	ERR_FAIL_NULL_V(batch, -1);
 
-	while (!found_route) {
-		if (open_list.size() == 0) {
-			break;
-		}
-		//check open list
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	uint32_t runners = MIN(batch->paths.size(), pool ? pool->get_thread_count() : 0);
+	batch->queries.resize(MAX(runners, 1u));
+	batch->runner_queries = batch->queries.ptr();
 
-		List<Polygon *>::Element *least_cost_poly = nullptr;
-		float least_cost = 1e30;
+	if (runners > 0) {
+		batch->group = pool->add_template_group_task(this, &Navigation2D::_solve_path_batch, batch, runners, 1, runners);
+	} else {
+		// No workers to run it, solve it now. The signal is emitted as usual.
+		_solve_path_batch(0, batch);
+	}
 
-		//this could be faster (cache previous results)
-		for (List<Polygon *>::Element *E = open_list.front(); E; E = E->next()) {
-			Polygon *p = E->get();
+	path_batches.push_back(batch);
+	set_process_internal(true);
+	return batch->id;
+}
 
-			float cost = p->distance;
+void Navigation2D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_INTERNAL_PROCESS: {
+			for (uint32_t i = 0; i < path_batches.size(); i++) {
+				PathBatch *batch = path_batches[i];
+				if (batch->group != ThreadWorkPool::INVALID_TASK_ID) {
+					ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+					if (!pool->is_group_task_completed(batch->group)) {
+						continue;
+					}
+					pool->wait_for_group_task_completion(batch->group);
+					batch->group = ThreadWorkPool::INVALID_TASK_ID;
+				}
 
-#ifdef USE_ENTRY_POINT
-			int es = p->edges.size();
+				path_batches.remove(i);
+				i--;
+				emit_signal("simple_paths_completed", batch->id, _get_path_batch_result(batch));
+				memdelete(batch);
+			}
 
-			float shortest_distance = 1e30;
+			if (path_batches.empty()) {
+				set_process_internal(false);
+			}
+		} break;
+	}
+}
 
-			for (int i = 0; i < es; i++) {
-				Polygon::Edge &e = p->edges.write[i];
+Vector<Vector2> Navigation2D::_get_simple_path(PathQuery &r_query, const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) const {
+	Vector2 begin_point;
+	Vector2 end_point;
+	const Polygon *begin_poly = _get_closest_polygon(p_start, begin_point);
+	const Polygon *end_poly = _get_closest_polygon(p_end, end_point);
 
-				if (!e.C) {
-					continue;
-				}
+	if (!begin_poly || !end_poly) {
+		return Vector<Vector2>(); //no path
+	}
 
-				Vector2 edge[2] = {
-					_get_vertex(p->edges[i].point),
-					_get_vertex(p->edges[(i + 1) % es].point)
-				};
+	if (begin_poly == end_poly) {
+		Vector<Vector2> path;
+		path.resize(2);
+		path.write[0] = begin_point;
+		path.write[1] = end_point;
+		return path;
+	}
 
-				Vector2 edge_point = Geometry::get_closest_point_to_segment_2d(p->entry, edge);
-				float dist = p->entry.distance_to(edge_point);
-				if (dist < shortest_distance) {
-					shortest_distance = dist;
-				}
-			}
+	bool found_route = false;
 
-			cost += shortest_distance;
-#else
-			cost += p->center.distance_to(end_point);
-#endif
-			if (cost < least_cost) {
-				least_cost_poly = E;
-				least_cost = cost;
-			}
+	// Search state, valid for polygons opened during this query only.
+	if (r_query.states.size() < polygons.size()) {
+		uint32_t from = r_query.states.size();
+		r_query.states.resize(polygons.size());
+		for (uint32_t i = from; i < r_query.states.size(); i++) {
+			r_query.states[i].open_pass = 0;
+			r_query.states[i].closed_pass = 0;
 		}
-
-		Polygon *p = least_cost_poly->get();
+	}
+	r_query.pass++;
+	PolygonState *states = r_query.states.ptr();
+	LocalVector<OpenEntry> &open_list = r_query.open_list;
+	open_list.clear();
+
+	// Polygons reached through a shorter path are pushed again, the outdated entries are skipped when popped.
+	SortArray<OpenEntry, SortOpenEntries> sorter;
+	OpenEntry entry;
+
+	const Polygon *p = begin_poly;
+	PolygonState *p_state = &states[begin_poly->id];
+	p_state->closed_pass = r_query.pass;
+	p_state->entry = p_start;
+	p_state->distance = 0;
+
+	while (true) {
 		//open the neighbours for search
 		int es = p->edges.size();
 
 		for (int i = 0; i < es; i++) {
-			Polygon::Edge &e = p->edges.write[i];
+			const Polygon::Edge &e = p->edges[i];
 
 			if (!e.C) {
 				continue;
 			}
 
+			PolygonState &state = states[e.C->id];
+			if (state.closed_pass == r_query.pass) {
+				continue;
+			}
+
 #ifdef USE_ENTRY_POINT
 			Vector2 edge[2] = {
 				_get_vertex(p->edges[i].point),
 				_get_vertex(p->edges[(i + 1) % es].point)
 			};
 
-			Vector2 edge_entry = Geometry::get_closest_point_to_segment_2d(p->entry, edge);
-			float distance = p->entry.distance_to(edge_entry) + p->distance;
-
+			Vector2 edge_entry = Geometry::get_closest_point_to_segment_2d(p_state->entry, edge);
+			float distance = p_state->entry.distance_to(edge_entry) + p_state->distance;
 #else
-
-			float distance = p->center.distance_to(e.C->center) + p->distance;
-
+			float distance = p->center.distance_to(e.C->center) + p_state->distance;
 #endif
 
-			if (e.C->prev_edge != -1) {
-				//oh this was visited already, can we win the cost?
-
-				if (e.C->distance > distance) {
-					e.C->prev_edge = e.C_edge;
-					e.C->distance = distance;
-#ifdef USE_ENTRY_POINT
-					e.C->entry = edge_entry;
-#endif
-				}
-			} else {
-				//add to open neighbours
+			bool new_polygon = state.open_pass != r_query.pass;
+			if (!new_polygon && state.distance <= distance) {
+				continue; // Already reached through a shorter path.
+			}
 
-				e.C->prev_edge = e.C_edge;
-				e.C->distance = distance;
+			state.prev_edge = e.C_edge;
+			state.distance = distance;
 #ifdef USE_ENTRY_POINT
-				e.C->entry = edge_entry;
+			state.entry = edge_entry;
 #endif
+			state.cost = _get_polygon_cost(e.C, state, end_point);
+			state.open_pass = r_query.pass;
 
-				open_list.push_back(e.C);
+			entry.id = e.C->id;
+			entry.distance = distance;
+			entry.cost = state.cost;
+			open_list.push_back(entry);
+			sorter.push_heap(0, open_list.size() - 1, 0, entry, open_list.ptr());
 
-				if (e.C == end_poly) {
-					//oh my reached end! stop algorithm
-					found_route = true;
-					break;
-				}
+			if (new_polygon && e.C == end_poly) {
+				//oh my reached end! stop algorithm
+				found_route = true;
+				break;
 			}
 		}
 
@@ -460,7 +669,25 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 			break;
 		}
 
-		open_list.erase(least_cost_poly);
+		p = nullptr;
+		while (!open_list.empty()) {
+			entry = open_list[0]; // The least costly polygon.
+			sorter.pop_heap(0, open_list.size(), open_list.ptr());
+			open_list.resize(open_list.size() - 1);
+
+			const PolygonState &state = states[entry.id];
+			if (state.closed_pass != r_query.pass && entry.distance <= state.distance) {
+				p = polygons[entry.id];
+				break;
+			}
+		}
+
+		if (!p) {
+			break;
+		}
+
+		p_state = &states[p->id];
+		p_state->closed_pass = r_query.pass;
 	}
 
 	if (found_route) {
@@ -472,9 +699,9 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 			Vector2 apex_point = end_point;
 			Vector2 portal_left = apex_point;
 			Vector2 portal_right = apex_point;
-			Polygon *left_poly = end_poly;
-			Polygon *right_poly = end_poly;
-			Polygon *p = end_poly;
+			const Polygon *left_poly = end_poly;
+			const Polygon *right_poly = end_poly;
+			const Polygon *p = end_poly;
 
 			while (p) {
 				Vector2 left;
@@ -487,8 +714,8 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 					left = begin_point;
 					right = begin_point;
 				} else {
-					int prev = p->prev_edge;
-					int prev_n = (p->prev_edge + 1) % p->edges.size();
+					int prev = states[p->id].prev_edge;
+					int prev_n = (prev + 1) % p->edges.size();
 					left = _get_vertex(p->edges[prev].point);
 					right = _get_vertex(p->edges[prev_n].point);
 
@@ -554,7 +781,7 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 				}
 
 				if (p != begin_poly) {
-					p = p->edges[p->prev_edge].C;
+					p = p->edges[states[p->id].prev_edge].C;
 				} else {
 					p = nullptr;
 				}
@@ -562,11 +789,11 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 
 		} else {
 			//midpoints
-			Polygon *p = end_poly;
+			const Polygon *p = end_poly;
 
 			while (true) {
-				int prev = p->prev_edge;
-				int prev_n = (p->prev_edge + 1) % p->edges.size();
+				int prev = states[p->id].prev_edge;
+				int prev_n = (prev + 1) % p->edges.size();
 				Vector2 point = (_get_vertex(p->edges[prev].point) + _get_vertex(p->edges[prev_n].point)) * 0.5;
 				path.push_back(point);
 				p = p->edges[prev].C;
@@ -597,93 +824,19 @@ Vector<Vector2> Navigation2D::get_simple_path(const Vector2 &p_start, const Vect
 }
 
 Vector2 Navigation2D::get_closest_point(const Vector2 &p_point) {
-	Vector2 closest_point = Vector2();
-	float closest_point_d = 1e20;
-
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
-		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-				if (Geometry::is_point_in_triangle(p_point, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
-					return p_point; //inside triangle, nothing else to discuss
-				}
-			}
-		}
-	}
-
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
-		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			int es = p.edges.size();
-			for (int i = 0; i < es; i++) {
-				Vector2 edge[2] = {
-					_get_vertex(p.edges[i].point),
-					_get_vertex(p.edges[(i + 1) % es].point)
-				};
-
-				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
-				float d = spoint.distance_squared_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = spoint;
-					closest_point_d = d;
-				}
-			}
-		}
-	}
+	_update_polygons();
 
+	Vector2 closest_point = Vector2();
+	_get_closest_polygon(p_point, closest_point);
 	return closest_point;
 }
 
 Object *Navigation2D::get_closest_point_owner(const Vector2 &p_point) {
-	Object *owner = nullptr;
-	Vector2 closest_point = Vector2();
-	float closest_point_d = 1e20;
+	_update_polygons();
 
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
-		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-				if (Geometry::is_point_in_triangle(p_point, _get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point))) {
-					return E->get().owner;
-				}
-			}
-		}
-	}
-
-	for (Map<int, NavMesh>::Element *E = navpoly_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
-		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			int es = p.edges.size();
-			for (int i = 0; i < es; i++) {
-				Vector2 edge[2] = {
-					_get_vertex(p.edges[i].point),
-					_get_vertex(p.edges[(i + 1) % es].point)
-				};
-
-				Vector2 spoint = Geometry::get_closest_point_to_segment_2d(p_point, edge);
-				float d = spoint.distance_squared_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = spoint;
-					closest_point_d = d;
-					owner = E->get().owner;
-				}
-			}
-		}
-	}
-
-	return owner;
+	Vector2 closest_point;
+	const Polygon *closest = _get_closest_polygon(p_point, closest_point);
+	return closest ? closest->owner->owner : nullptr;
 }
 
 void Navigation2D::_bind_methods() {
@@ -692,12 +845,25 @@ void Navigation2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("navpoly_remove", "id"), &Navigation2D::navpoly_remove);
 
 	ClassDB::bind_method(D_METHOD("get_simple_path", "start", "end", "optimize"), &Navigation2D::get_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_simple_paths", "starts", "ends", "optimize"), &Navigation2D::get_simple_paths, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_simple_paths_async", "starts", "ends", "optimize"), &Navigation2D::get_simple_paths_async, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Navigation2D::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_point_owner", "to_point"), &Navigation2D::get_closest_point_owner);
+
+	ADD_SIGNAL(MethodInfo("simple_paths_completed", PropertyInfo(Variant::INT, "query_id"), PropertyInfo(Variant::ARRAY, "paths")));
 }
 
 Navigation2D::Navigation2D() {
 	ERR_FAIL_COND(sizeof(Point) != 8);
 	cell_size = 1; // one pixel
 	last_id = 1;
+	polygons_dirty = false;
+	last_batch_id = 1;
+}
+
+Navigation2D::~Navigation2D() {
+	_wait_path_batches();
+	for (uint32_t i = 0; i < path_batches.size(); i++) {
+		memdelete(path_batches[i]);
+	}
 }
@@ -31,6 +31,9 @@
 #ifndef NAVIGATION_2D_H
 #define NAVIGATION_2D_H
 
+#include "core/local_vector.h"
+#include "core/os/thread_work_pool.h"
+#include "core/safe_refcount.h"
 #include "scene/2d/navigation_polygon.h"
 #include "scene/2d/node_2d.h"
 
@@ -88,13 +91,10 @@ class Navigation2D : public Node2D {
 		Vector<Edge> edges;
 
 		Vector2 center;
-		Vector2 entry;
-
-		float distance;
-		int prev_edge;
 
 		bool clockwise;
 
+		int id; // Index in polygons.
 		NavMesh *owner;
 	};
 
@@ -139,14 +139,104 @@ class Navigation2D : public Node2D {
 		return Vector2(p_point.x, p_point.y) * cell_size;
 	}
 
+	// Polygons of every linked navpoly, with a BVH over them for closest point queries.
+	// Both are rebuilt lazily once navpolys are linked or unlinked.
+	struct PolygonBVH {
+		Rect2 aabb;
+		Vector2 center;
+		int left;
+		int right;
+		Polygon *polygon; // Only for leaves.
+	};
+
+	struct BVHCmpX {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.x < p_right->center.x;
+		}
+	};
+
+	struct BVHCmpY {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.y < p_right->center.y;
+		}
+	};
+
+	LocalVector<Polygon *> polygons;
+	LocalVector<PolygonBVH> polygon_bvh;
+	bool polygons_dirty;
+
+	// Search state of a polygon, kept out of Polygon so path queries don't modify the navpolys.
+	struct PolygonState {
+		uint64_t open_pass;
+		uint64_t closed_pass;
+		float distance;
+		float cost;
+		int prev_edge;
+		Vector2 entry;
+	};
+
+	// Entry of the open list, which can hold the same polygon more than once.
+	struct OpenEntry {
+		int id;
+		float distance; // Outdated once the polygon is reached through a shorter path.
+		float cost;
+	};
+
+	struct SortOpenEntries {
+		_FORCE_INLINE_ bool operator()(const OpenEntry &A, const OpenEntry &B) const { // Returns true when the entry A is worse than entry B.
+			return A.cost > B.cost;
+		}
+	};
+
+	// Scratch memory of path queries, reused from one query to the next.
+	struct PathQuery {
+		LocalVector<PolygonState> states;
+		LocalVector<OpenEntry> open_list;
+		uint64_t pass;
+
+		PathQuery() { pass = 0; }
+	};
+
+	PathQuery path_query;
+
+	// Path queries solved together on the worker pool. Every runner takes the next
+	// unsolved pair until none is left, using its own scratch.
+	struct PathBatch {
+		int id;
+		LocalVector<Vector2> starts;
+		LocalVector<Vector2> ends;
+		bool optimize;
+		LocalVector<Vector<Vector2> > paths;
+		LocalVector<PathQuery> queries; // Only for asynchronous batches, the others use batch_queries.
+		PathQuery *runner_queries;
+		SafeNumeric<uint32_t> next_path;
+		ThreadWorkPool::GroupID group;
+	};
+
+	LocalVector<PathQuery> batch_queries;
+	LocalVector<PathBatch *> path_batches;
+	int last_batch_id;
+
+	PathBatch *_create_path_batch(const PoolVector<Vector2> &p_starts, const PoolVector<Vector2> &p_ends, bool p_optimize);
+	void _solve_path_batch(uint32_t p_runner, PathBatch *p_batch);
+	Array _get_path_batch_result(const PathBatch *p_batch) const;
+	void _wait_path_batches();
+
 	void _navpoly_link(int p_id);
 	void _navpoly_unlink(int p_id);
 
+	void _update_polygons();
+	int _create_polygon_bvh(PolygonBVH *p_bvh, PolygonBVH **p_bb, int p_from, int p_size, int &max_alloc);
+	Polygon *_get_closest_polygon(const Vector2 &p_point, Vector2 &r_point) const;
+	float _get_polygon_cost(const Polygon *p_poly, const PolygonState &p_state, const Vector2 &p_end_point) const;
+	Vector<Vector2> _get_simple_path(PathQuery &r_query, const Vector2 &p_start, const Vector2 &p_end, bool p_optimize) const;
+
 	float cell_size;
 	Map<int, NavMesh> navpoly_map;
 	int last_id;
 
 protected:
+	void _notification(int p_what);
 	static void _bind_methods();
 
 public:
@@ -156,10 +246,13 @@ public:
 	void navpoly_remove(int p_id);
 
 	Vector<Vector2> get_simple_path(const Vector2 &p_start, const Vector2 &p_end, bool p_optimize = true);
+	Array get_simple_paths(const PoolVector<Vector2> &p_starts, const PoolVector<Vector2> &p_ends, bool p_optimize = true);
+	int get_simple_paths_async(const PoolVector<Vector2> &p_starts, const PoolVector<Vector2> &p_ends, bool p_optimize = true);
 	Vector2 get_closest_point(const Vector2 &p_point);
 	Object *get_closest_point_owner(const Vector2 &p_point);
 
 	Navigation2D();
+	~Navigation2D();
 };
 
 #endif // NAVIGATION_2D_H
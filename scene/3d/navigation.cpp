@@ -30,6 +30,8 @@
 
 #include "navigation.h"
 
+#include "core/sort_array.h"
+
 #define USE_ENTRY_POINT
 
 void Navigation::_navmesh_link(int p_id) {
@@ -38,6 +40,8 @@ void Navigation::_navmesh_link(int p_id) {
 	ERR_FAIL_COND(nm.linked);
 	ERR_FAIL_COND(nm.navmesh.is_null());
 
+	_wait_path_batches();
+
 	PoolVector<Vector3> vertices = nm.navmesh->get_vertices();
 	int len = vertices.size();
 	if (len == 0) {
@@ -52,6 +56,7 @@ void Navigation::_navmesh_link(int p_id) {
 		List<Polygon>::Element *P = nm.polygons.push_back(Polygon());
 		Polygon &p = P->get();
 		p.owner = &nm;
+		p.id = -1;
 
 		Vector<int> poly = nm.navmesh->get_polygon(i);
 		int plen = poly.size();
@@ -130,6 +135,7 @@ void Navigation::_navmesh_link(int p_id) {
 	}
 
 	nm.linked = true;
+	polygons_dirty = true;
 }
 
 void Navigation::_navmesh_unlink(int p_id) {
@@ -137,6 +143,8 @@ void Navigation::_navmesh_unlink(int p_id) {
 	NavMesh &nm = navmesh_map[p_id];
 	ERR_FAIL_COND(!nm.linked);
 
+	_wait_path_batches();
+
 	for (List<Polygon>::Element *E = nm.polygons.front(); E; E = E->next()) {
 		Polygon &p = E->get();
 
@@ -192,6 +200,166 @@ void Navigation::_navmesh_unlink(int p_id) {
 	nm.polygons.clear();
 
 	nm.linked = false;
+	polygons_dirty = true;
+}
+
+int Navigation::_create_polygon_bvh(PolygonBVH *p_bvh, PolygonBVH **p_bb, int p_from, int p_size, int &max_alloc) {
+	if (p_size == 1) {
+		return p_bb[p_from] - p_bvh;
+	} else if (p_size == 0) {
+		return -1;
+	}
+
+	AABB aabb;
+	aabb = p_bb[p_from]->aabb;
+	for (int i = 1; i < p_size; i++) {
+		aabb.merge_with(p_bb[p_from + i]->aabb);
+	}
+
+	int li = aabb.get_longest_axis_index();
+
+	switch (li) {
+		case Vector3::AXIS_X: {
+			SortArray<PolygonBVH *, BVHCmpX> sort_x;
+			sort_x.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+		case Vector3::AXIS_Y: {
+			SortArray<PolygonBVH *, BVHCmpY> sort_y;
+			sort_y.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+		case Vector3::AXIS_Z: {
+			SortArray<PolygonBVH *, BVHCmpZ> sort_z;
+			sort_z.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+	}
+
+	int left = _create_polygon_bvh(p_bvh, p_bb, p_from, p_size / 2, max_alloc);
+	int right = _create_polygon_bvh(p_bvh, p_bb, p_from + p_size / 2, p_size - p_size / 2, max_alloc);
+
+	int index = max_alloc++;
+	PolygonBVH *_new = &p_bvh[index];
+	_new->aabb = aabb;
+	_new->center = aabb.position + aabb.size * 0.5;
+	_new->polygon = nullptr;
+	_new->left = left;
+	_new->right = right;
+
+	return index;
+}
+
+void Navigation::_update_polygons() {
+	if (!polygons_dirty) {
+		return;
+	}
+	polygons_dirty = false;
+
+	polygons.clear();
+	polygon_bvh.clear();
+
+	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
+		if (!E->get().linked) {
+			continue;
+		}
+		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
+			Polygon &p = F->get();
+			if (p.edges.size() == 0) {
+				continue;
+			}
+			p.id = polygons.size();
+			polygons.push_back(&p);
+		}
+	}
+
+	int count = polygons.size();
+	if (count == 0) {
+		return;
+	}
+
+	// Leaves first, then the nodes, the root being the last one.
+	polygon_bvh.resize(count * 2 - 1);
+	LocalVector<PolygonBVH *> bb;
+	bb.resize(count);
+
+	for (int i = 0; i < count; i++) {
+		Polygon *p = polygons[i];
+		PolygonBVH &leaf = polygon_bvh[i];
+		leaf.aabb = AABB(_get_vertex(p->edges[0].point), Vector3());
+		for (int j = 1; j < p->edges.size(); j++) {
+			leaf.aabb.expand_to(_get_vertex(p->edges[j].point));
+		}
+		leaf.center = leaf.aabb.position + leaf.aabb.size * 0.5;
+		leaf.left = -1;
+		leaf.right = -1;
+		leaf.polygon = p;
+		bb[i] = &leaf;
+	}
+
+	int max_alloc = count;
+	_create_polygon_bvh(polygon_bvh.ptr(), bb.ptr(), 0, count, max_alloc);
+}
+
+static _FORCE_INLINE_ real_t _get_aabb_distance_squared(const AABB &p_aabb, const Vector3 &p_point) {
+	Vector3 d;
+	for (int i = 0; i < 3; i++) {
+		if (p_point[i] < p_aabb.position[i]) {
+			d[i] = p_aabb.position[i] - p_point[i];
+		} else if (p_point[i] > p_aabb.position[i] + p_aabb.size[i]) {
+			d[i] = p_point[i] - p_aabb.position[i] - p_aabb.size[i];
+		}
+	}
+	return d.length_squared();
+}
+
+Navigation::Polygon *Navigation::_get_closest_polygon(const Vector3 &p_point, Vector3 &r_point, Vector3 *r_normal) const {
+	if (polygon_bvh.empty()) {
+		return nullptr;
+	}
+
+	Polygon *closest = nullptr;
+	real_t closest_d = 1e20;
+
+	// Nearest node first, skipping the nodes further than the closest polygon found so far.
+	int stack[64];
+	int stack_size = 0;
+	stack[stack_size++] = polygon_bvh.size() - 1;
+
+	while (stack_size) {
+		const PolygonBVH &node = polygon_bvh[stack[--stack_size]];
+		if (_get_aabb_distance_squared(node.aabb, p_point) >= closest_d) {
+			continue;
+		}
+
+		if (node.polygon) {
+			const Polygon &p = *node.polygon;
+			for (int i = 2; i < p.edges.size(); i++) {
+				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
+				Vector3 spoint = f.get_closest_point_to(p_point);
+				real_t d = spoint.distance_squared_to(p_point);
+				if (d < closest_d) {
+					closest_d = d;
+					closest = node.polygon;
+					r_point = spoint;
+					if (r_normal) {
+						*r_normal = f.get_plane().normal;
+					}
+				}
+			}
+			continue;
+		}
+
+		ERR_FAIL_COND_V(stack_size + 2 > 64, closest);
+		const PolygonBVH &left = polygon_bvh[node.left];
+		const PolygonBVH &right = polygon_bvh[node.right];
+		if (left.center.distance_squared_to(p_point) < right.center.distance_squared_to(p_point)) {
+			stack[stack_size++] = node.right;
+			stack[stack_size++] = node.left;
+		} else {
+			stack[stack_size++] = node.left;
+			stack[stack_size++] = node.right;
+		}
+	}
+
+	return closest;
 }
 
 int Navigation::navmesh_add(const Ref<NavigationMesh> &p_mesh, const Transform &p_xform, Object *p_owner) {
@@ -224,7 +392,7 @@ void Navigation::navmesh_remove(int p_id) {
 	navmesh_map.erase(p_id);
 }
 
-void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly) {
+void Navigation::_clip_path(const PathQuery &p_query, Vector<Vector3> &path, const Polygon *from_poly, const Vector3 &p_to_point, const Polygon *p_to_poly) const {
 	Vector3 from = path[path.size() - 1];
 
 	if (from.distance_to(p_to_point) < CMP_EPSILON) {
@@ -241,7 +409,7 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 	while (from_poly != p_to_poly) {
 		int edge_count = from_poly->edges.size();
 		ERR_FAIL_COND_MSG(edge_count == 0, "Polygon has no edges.");
-		int pe = from_poly->prev_edge;
+		int pe = p_query.states[from_poly->id].prev_edge;
 		int next = (pe + 1) % edge_count;
 		Vector3 a = _get_vertex(from_poly->edges[pe].point);
 		Vector3 b = _get_vertex(from_poly->edges[next].point);
@@ -261,41 +429,145 @@ void Navigation::_clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vec
 }
 
 Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) {
-	Polygon *begin_poly = nullptr;
-	Polygon *end_poly = nullptr;
-	Vector3 begin_point;
-	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
+	_update_polygons();
+	return _get_simple_path(path_query, p_start, p_end, p_optimize);
+}
 
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
+Navigation::PathBatch *Navigation::_create_path_batch(const PoolVector<Vector3> &p_starts, const PoolVector<Vector3> &p_ends, bool p_optimize) {
+	ERR_FAIL_COND_V_MSG(p_starts.size() != p_ends.size(), nullptr, "Start and end points must have the same size.");
+
+	_update_polygons();
+
+	PathBatch *batch = memnew(PathBatch);
+	batch->id = last_batch_id++;
+	batch->optimize = p_optimize;
+	batch->runner_queries = nullptr;
+	batch->group = ThreadWorkPool::INVALID_TASK_ID;
+
+	int count = p_starts.size();
+	batch->starts.resize(count);
+	batch->ends.resize(count);
+	batch->paths.resize(count);
+
+	PoolVector<Vector3>::Read starts = p_starts.read();
+	PoolVector<Vector3>::Read ends = p_ends.read();
+	for (int i = 0; i < count; i++) {
+		batch->starts[i] = starts[i];
+		batch->ends[i] = ends[i];
+	}
+
+	return batch;
+}
+
+void Navigation::_solve_path_batch(uint32_t p_runner, PathBatch *p_batch) {
+	PathQuery &query = p_batch->runner_queries[p_runner];
+	uint32_t count = p_batch->paths.size();
+
+	while (true) {
+		uint32_t i = p_batch->next_path.postincrement();
+		if (i >= count) {
+			break;
 		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 spoint = f.get_closest_point_to(p_start);
-				float dpoint = spoint.distance_to(p_start);
-				if (dpoint < begin_d) {
-					begin_d = dpoint;
-					begin_poly = &p;
-					begin_point = spoint;
-				}
+		p_batch->paths[i] = _get_simple_path(query, p_batch->starts[i], p_batch->ends[i], p_batch->optimize);
+	}
+}
+
+Array Navigation::_get_path_batch_result(const PathBatch *p_batch) const {
+	Array paths;
+	paths.resize(p_batch->paths.size());
+	for (uint32_t i = 0; i < p_batch->paths.size(); i++) {
+		paths[i] = p_batch->paths[i];
+	}
+	return paths;
+}
 
-				spoint = f.get_closest_point_to(p_end);
-				dpoint = spoint.distance_to(p_end);
-				if (dpoint < end_d) {
-					end_d = dpoint;
-					end_poly = &p;
-					end_point = spoint;
+void Navigation::_wait_path_batches() {
+	// Asynchronous queries read the polygons, so they must be done before anything is modified.
+	for (uint32_t i = 0; i < path_batches.size(); i++) {
+		PathBatch *batch = path_batches[i];
+		if (batch->group != ThreadWorkPool::INVALID_TASK_ID) {
+			ThreadWorkPool::get_singleton()->wait_for_group_task_completion(batch->group);
+			batch->group = ThreadWorkPool::INVALID_TASK_ID;
+		}
+	}
+}
+
+Array Navigation::get_simple_paths(const PoolVector<Vector3> &p_starts, const PoolVector<Vector3> &p_ends, bool p_optimize) {
+	PathBatch *batch = _create_path_batch(p_starts, p_ends, p_optimize);
+	ERR_FAIL_NULL_V(batch, Array());
+
+	// The calling thread helps, so there is one more runner than workers.
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	uint32_t runners = MIN(batch->paths.size(), pool ? pool->get_thread_count() + 1 : 1);
+	if (batch_queries.size() < runners) {
+		batch_queries.resize(runners);
+	}
+	batch->runner_queries = batch_queries.ptr();
+
+	if (runners > 1) {
+		pool->do_parallel_for(runners, this, &Navigation::_solve_path_batch, batch, 1);
+	} else if (runners == 1) {
+		_solve_path_batch(0, batch);
+	}
+
+	Array paths = _get_path_batch_result(batch);
+	memdelete(batch);
+	return paths;
+}
+
+int Navigation::get_simple_paths_async(const PoolVector<Vector3> &p_starts, const PoolVector<Vector3> &p_ends, bool p_optimize) {
+	PathBatch *batch = _create_path_batch(p_starts, p_ends, p_optimize);
+	ERR_FAIL_NULL_V(batch, -1);
+
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	uint32_t runners = MIN(batch->paths.size(), pool ? pool->get_thread_count() : 0);
+	batch->queries.resize(MAX(runners, 1u));
+	batch->runner_queries = batch->queries.ptr();
+
+	if (runners > 0) {
+		batch->group = pool->add_template_group_task(this, &Navigation::_solve_path_batch, batch, runners, 1, runners);
+	} else {
+		// No workers to run it, solve it now. The signal is emitted as usual.
+		_solve_path_batch(0, batch);
+	}
+
+	path_batches.push_back(batch);
+	set_process_internal(true);
+	return batch->id;
+}
+
+void Navigation::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_INTERNAL_PROCESS: {
+			for (uint32_t i = 0; i < path_batches.size(); i++) {
+				PathBatch *batch = path_batches[i];
+				if (batch->group != ThreadWorkPool::INVALID_TASK_ID) {
+					ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+					if (!pool->is_group_task_completed(batch->group)) {
+						continue;
+					}
+					pool->wait_for_group_task_completion(batch->group);
+					batch->group = ThreadWorkPool::INVALID_TASK_ID;
 				}
+
+				path_batches.remove(i);
+				i--;
+				emit_signal("simple_paths_completed", batch->id, _get_path_batch_result(batch));
+				memdelete(batch);
 			}
 
-			p.prev_edge = -1;
-		}
+			if (path_batches.empty()) {
+				set_process_internal(false);
+			}
+		} break;
 	}
+}
+
+Vector<Vector3> Navigation::_get_simple_path(PathQuery &r_query, const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) const {
+	Vector3 begin_point;
+	Vector3 end_point;
+	const Polygon *begin_poly = _get_closest_polygon(p_start, begin_point);
+	const Polygon *end_poly = _get_closest_polygon(p_end, end_point);
 
 	if (!begin_poly || !end_poly) {
 		return Vector<Vector3>(); //no path
@@ -311,56 +583,83 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 
 	bool found_route = false;
 
-	List<Polygon *> open_list;
+	// Search state, valid for polygons opened during this query only.
+	if (r_query.states.size() < polygons.size()) {
+		uint32_t from = r_query.states.size();
+		r_query.states.resize(polygons.size());
+		for (uint32_t i = from; i < r_query.states.size(); i++) {
+			r_query.states[i].open_pass = 0;
+			r_query.states[i].closed_pass = 0;
+		}
+	}
+	r_query.pass++;
+	PolygonState *states = r_query.states.ptr();
+	LocalVector<OpenEntry> &open_list = r_query.open_list;
+	open_list.clear();
+
+	// Polygons reached through a shorter path are pushed again, the outdated entries are skipped when popped.
+	SortArray<OpenEntry, SortOpenEntries> sorter;
+	OpenEntry entry;
+
+	PolygonState &begin_state = states[begin_poly->id];
+	begin_state.closed_pass = r_query.pass;
+	begin_state.entry = begin_point;
+
 	int begin_edge_count = begin_poly->edges.size();
 
 	for (int i = 0; i < begin_edge_count; i++) {
-		if (begin_poly->edges[i].C) {
-			begin_poly->edges[i].C->prev_edge = begin_poly->edges[i].C_edge;
-#ifdef USE_ENTRY_POINT
-			int next = (i + 1) % begin_edge_count;
-			Vector3 edge[2] = {
-				_get_vertex(begin_poly->edges[i].point),
-				_get_vertex(begin_poly->edges[next].point)
-			};
+		const Polygon *c = begin_poly->edges[i].C;
+		if (!c) {
+			continue;
+		}
 
-			Vector3 entry = Geometry::get_closest_point_to_segment(begin_poly->entry, edge);
-			begin_poly->edges[i].C->distance = begin_point.distance_to(entry);
-			begin_poly->edges[i].C->entry = entry;
+#ifdef USE_ENTRY_POINT
+		int next = (i + 1) % begin_edge_count;
+		Vector3 edge[2] = {
+			_get_vertex(begin_poly->edges[i].point),
+			_get_vertex(begin_poly->edges[next].point)
+		};
+
+		Vector3 edge_entry = Geometry::get_closest_point_to_segment(begin_state.entry, edge);
+		float distance = begin_point.distance_to(edge_entry);
 #else
-			begin_poly->edges[i].C->distance = begin_poly->center.distance_to(begin_poly->edges[i].C->center);
+		float distance = begin_poly->center.distance_to(c->center);
 #endif
-			open_list.push_back(begin_poly->edges[i].C);
-		}
-	}
 
-	while (!found_route) {
-		if (open_list.size() == 0) {
-			break;
+		PolygonState &state = states[c->id];
+		if (state.open_pass == r_query.pass && state.distance <= distance) {
+			continue;
 		}
-		//check open list
-
-		List<Polygon *>::Element *least_cost_poly = nullptr;
-		float least_cost = 1e30;
 
-		//this could be faster (cache previous results)
-		for (List<Polygon *>::Element *E = open_list.front(); E; E = E->next()) {
-			Polygon *p = E->get();
-
-			float cost = p->distance;
+		state.prev_edge = begin_poly->edges[i].C_edge;
+		state.distance = distance;
 #ifdef USE_ENTRY_POINT
-			cost += p->entry.distance_to(end_point);
+		state.entry = edge_entry;
+		state.cost = distance + edge_entry.distance_to(end_point);
 #else
-			cost += p->center.distance_to(end_point);
+		state.cost = distance + c->center.distance_to(end_point);
 #endif
-			if (cost < least_cost) {
-				least_cost_poly = E;
-				least_cost = cost;
-			}
-		}
 
-		Polygon *p = least_cost_poly->get();
-		//open the neighbours for search
+		state.open_pass = r_query.pass;
+
+		entry.id = c->id;
+		entry.distance = distance;
+		entry.cost = state.cost;
+		open_list.push_back(entry);
+		sorter.push_heap(0, open_list.size() - 1, 0, entry, open_list.ptr());
+	}
+
+	while (!open_list.empty()) {
+		entry = open_list[0]; // The least costly polygon.
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.resize(open_list.size() - 1);
+
+		const Polygon *p = polygons[entry.id];
+		PolygonState &p_state = states[p->id];
+		if (p_state.closed_pass == r_query.pass || entry.distance > p_state.distance) {
+			continue; // Outdated entry.
+		}
+		p_state.closed_pass = r_query.pass;
 
 		if (p == end_poly) {
 			//oh my reached end! stop algorithm
@@ -368,14 +667,20 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 			break;
 		}
 
+		//open the neighbours for search
 		int edge_count = p->edges.size();
 		for (int i = 0; i < edge_count; i++) {
-			Polygon::Edge &e = p->edges.write[i];
+			const Polygon::Edge &e = p->edges[i];
 
 			if (!e.C) {
 				continue;
 			}
 
+			PolygonState &state = states[e.C->id];
+			if (state.closed_pass == r_query.pass) {
+				continue;
+			}
+
 #ifdef USE_ENTRY_POINT
 			int next = (i + 1) % edge_count;
 			Vector3 edge[2] = {
@@ -383,35 +688,32 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 				_get_vertex(p->edges[next].point)
 			};
 
-			Vector3 entry = Geometry::get_closest_point_to_segment(p->entry, edge);
-			float distance = p->entry.distance_to(entry) + p->distance;
+			Vector3 edge_entry = Geometry::get_closest_point_to_segment(p_state.entry, edge);
+			float distance = p_state.entry.distance_to(edge_entry) + p_state.distance;
 #else
-			float distance = p->center.distance_to(e.C->center) + p->distance;
+			float distance = p->center.distance_to(e.C->center) + p_state.distance;
 #endif
 
-			if (e.C->prev_edge != -1) {
-				//oh this was visited already, can we win the cost?
+			if (state.open_pass == r_query.pass && state.distance <= distance) {
+				continue; // Already reached through a shorter path.
+			}
 
-				if (e.C->distance > distance) {
-					e.C->prev_edge = e.C_edge;
-					e.C->distance = distance;
+			state.open_pass = r_query.pass;
+			state.prev_edge = e.C_edge;
+			state.distance = distance;
 #ifdef USE_ENTRY_POINT
-					e.C->entry = entry;
+			state.entry = edge_entry;
+			state.cost = distance + edge_entry.distance_to(end_point);
+#else
+			state.cost = distance + e.C->center.distance_to(end_point);
 #endif
-				}
-			} else {
-				//add to open neighbours
 
-				e.C->prev_edge = e.C_edge;
-				e.C->distance = distance;
-#ifdef USE_ENTRY_POINT
-				e.C->entry = entry;
-#endif
-				open_list.push_back(e.C);
-			}
+			entry.id = e.C->id;
+			entry.distance = distance;
+			entry.cost = state.cost;
+			open_list.push_back(entry);
+			sorter.push_heap(0, open_list.size() - 1, 0, entry, open_list.ptr());
 		}
-
-		open_list.erase(least_cost_poly);
 	}
 
 	if (found_route) {
@@ -420,13 +722,13 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 		if (p_optimize) {
 			//string pulling
 
-			Polygon *apex_poly = end_poly;
+			const Polygon *apex_poly = end_poly;
 			Vector3 apex_point = end_point;
 			Vector3 portal_left = apex_point;
 			Vector3 portal_right = apex_point;
-			Polygon *left_poly = end_poly;
-			Polygon *right_poly = end_poly;
-			Polygon *p = end_poly;
+			const Polygon *left_poly = end_poly;
+			const Polygon *right_poly = end_poly;
+			const Polygon *p = end_poly;
 			path.push_back(end_point);
 
 			while (p) {
@@ -441,8 +743,8 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 				} else {
 					int edge_count = p->edges.size();
 					ERR_FAIL_COND_V_MSG(edge_count == 0, Vector<Vector3>(), "Polygon has no edges.");
-					int prev = p->prev_edge;
-					int prev_n = (p->prev_edge + 1) % edge_count;
+					int prev = states[p->id].prev_edge;
+					int prev_n = (prev + 1) % edge_count;
 					left = _get_vertex(p->edges[prev].point);
 					right = _get_vertex(p->edges[prev_n].point);
 
@@ -460,7 +762,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 						left_poly = p;
 						portal_left = left;
 					} else {
-						_clip_path(path, apex_poly, portal_right, right_poly);
+						_clip_path(r_query, path, apex_poly, portal_right, right_poly);
 
 						apex_point = portal_right;
 						p = right_poly;
@@ -479,7 +781,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 						right_poly = p;
 						portal_right = right;
 					} else {
-						_clip_path(path, apex_poly, portal_left, left_poly);
+						_clip_path(r_query, path, apex_poly, portal_left, left_poly);
 
 						apex_point = portal_left;
 						p = left_poly;
@@ -492,7 +794,7 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 				}
 
 				if (p != begin_poly) {
-					p = p->edges[p->prev_edge].C;
+					p = p->edges[states[p->id].prev_edge].C;
 				} else {
 					p = nullptr;
 				}
@@ -506,17 +808,17 @@ Vector<Vector3> Navigation::get_simple_path(const Vector3 &p_start, const Vector
 
 		} else {
 			//midpoints
-			Polygon *p = end_poly;
+			const Polygon *p = end_poly;
 
 			path.push_back(end_point);
 			while (true) {
-				int prev = p->prev_edge;
+				int prev = states[p->id].prev_edge;
 #ifdef USE_ENTRY_POINT
-				Vector3 point = p->entry;
+				Vector3 point = states[p->id].entry;
 #else
 				int edge_count = p->edges.size();
 				ERR_FAIL_COND_V_MSG(edge_count == 0, Vector<Vector3>(), "Polygon has no edges.");
-				int prev_n = (p->prev_edge + 1) % edge_count;
+				int prev_n = (prev + 1) % edge_count;
 				Vector3 point = (_get_vertex(p->edges[prev].point) + _get_vertex(p->edges[prev_n].point)) * 0.5;
 #endif
 				path.push_back(point);
@@ -584,85 +886,32 @@ Vector3 Navigation::get_closest_point_to_segment(const Vector3 &p_from, const Ve
 }
 
 Vector3 Navigation::get_closest_point(const Vector3 &p_point) {
-	Vector3 closest_point;
-	float closest_point_d = 1e20;
-
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
-		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-				}
-			}
-		}
-	}
+	_update_polygons();
 
+	Vector3 closest_point;
+	_get_closest_polygon(p_point, closest_point);
 	return closest_point;
 }
 
 Vector3 Navigation::get_closest_point_normal(const Vector3 &p_point) {
+	_update_polygons();
+
 	Vector3 closest_point;
 	Vector3 closest_normal;
-	float closest_point_d = 1e20;
-
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
-		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-					closest_normal = f.get_plane().normal;
-				}
-			}
-		}
-	}
-
+	_get_closest_polygon(p_point, closest_point, &closest_normal);
 	return closest_normal;
 }
 
 Object *Navigation::get_closest_point_owner(const Vector3 &p_point) {
-	Vector3 closest_point;
-	Object *owner = nullptr;
-	float closest_point_d = 1e20;
+	_update_polygons();
 
-	for (Map<int, NavMesh>::Element *E = navmesh_map.front(); E; E = E->next()) {
-		if (!E->get().linked) {
-			continue;
-		}
-		for (List<Polygon>::Element *F = E->get().polygons.front(); F; F = F->next()) {
-			Polygon &p = F->get();
-			for (int i = 2; i < p.edges.size(); i++) {
-				Face3 f(_get_vertex(p.edges[0].point), _get_vertex(p.edges[i - 1].point), _get_vertex(p.edges[i].point));
-				Vector3 inters = f.get_closest_point_to(p_point);
-				float d = inters.distance_to(p_point);
-				if (d < closest_point_d) {
-					closest_point = inters;
-					closest_point_d = d;
-					owner = E->get().owner;
-				}
-			}
-		}
-	}
-
-	return owner;
+	Vector3 closest_point;
+	const Polygon *closest = _get_closest_polygon(p_point, closest_point);
+	return closest ? closest->owner->owner : nullptr;
 }
 
 void Navigation::set_up_vector(const Vector3 &p_up) {
+	_wait_path_batches();
 	up = p_up;
 }
 
@@ -676,6 +925,8 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("navmesh_remove", "id"), &Navigation::navmesh_remove);
 
 	ClassDB::bind_method(D_METHOD("get_simple_path", "start", "end", "optimize"), &Navigation::get_simple_path, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_simple_paths", "starts", "ends", "optimize"), &Navigation::get_simple_paths, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("get_simple_paths_async", "starts", "ends", "optimize"), &Navigation::get_simple_paths_async, DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("get_closest_point_to_segment", "start", "end", "use_collision"), &Navigation::get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_closest_point", "to_point"), &Navigation::get_closest_point);
 	ClassDB::bind_method(D_METHOD("get_closest_point_normal", "to_point"), &Navigation::get_closest_point_normal);
@@ -685,11 +936,22 @@ void Navigation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_up_vector"), &Navigation::get_up_vector);
 
 	ADD_PROPERTY(PropertyInfo(Variant::VECTOR3, "up_vector"), "set_up_vector", "get_up_vector");
+
+	ADD_SIGNAL(MethodInfo("simple_paths_completed", PropertyInfo(Variant::INT, "query_id"), PropertyInfo(Variant::ARRAY, "paths")));
 }
 
 Navigation::Navigation() {
 	ERR_FAIL_COND(sizeof(Point) != 8);
 	cell_size = 0.01; //one centimeter
 	last_id = 1;
+	polygons_dirty = false;
+	last_batch_id = 1;
 	up = Vector3(0, 1, 0);
 }
+
+Navigation::~Navigation() {
+	_wait_path_batches();
+	for (uint32_t i = 0; i < path_batches.size(); i++) {
+		memdelete(path_batches[i]);
+	}
+}
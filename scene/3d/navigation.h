@@ -31,6 +31,9 @@
 #ifndef NAVIGATION_H
 #define NAVIGATION_H
 
+#include "core/local_vector.h"
+#include "core/os/thread_work_pool.h"
+#include "core/safe_refcount.h"
 #include "scene/3d/navigation_mesh.h"
 #include "scene/3d/spatial.h"
 
@@ -89,12 +92,9 @@ class Navigation : public Spatial {
 		Vector<Edge> edges;
 
 		Vector3 center;
-		Vector3 entry;
-
-		float distance;
-		int prev_edge;
 		bool clockwise;
 
+		int id; // Index in polygons.
 		NavMesh *owner;
 	};
 
@@ -141,17 +141,112 @@ class Navigation : public Spatial {
 		return Vector3(p_point.x, p_point.y, p_point.z) * cell_size;
 	}
 
+	// Polygons of every linked navmesh, with a BVH over them for closest point queries.
+	// Both are rebuilt lazily once navmeshes are linked or unlinked.
+	struct PolygonBVH {
+		AABB aabb;
+		Vector3 center;
+		int left;
+		int right;
+		Polygon *polygon; // Only for leaves.
+	};
+
+	struct BVHCmpX {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.x < p_right->center.x;
+		}
+	};
+
+	struct BVHCmpY {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.y < p_right->center.y;
+		}
+	};
+
+	struct BVHCmpZ {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.z < p_right->center.z;
+		}
+	};
+
+	LocalVector<Polygon *> polygons;
+	LocalVector<PolygonBVH> polygon_bvh;
+	bool polygons_dirty;
+
+	// Search state of a polygon, kept out of Polygon so path queries don't modify the navmeshes.
+	struct PolygonState {
+		uint64_t open_pass;
+		uint64_t closed_pass;
+		float distance;
+		float cost;
+		int prev_edge;
+		Vector3 entry;
+	};
+
+	// Entry of the open list, which can hold the same polygon more than once.
+	struct OpenEntry {
+		int id;
+		float distance; // Outdated once the polygon is reached through a shorter path.
+		float cost;
+	};
+
+	struct SortOpenEntries {
+		_FORCE_INLINE_ bool operator()(const OpenEntry &A, const OpenEntry &B) const { // Returns true when the entry A is worse than entry B.
+			return A.cost > B.cost;
+		}
+	};
+
+	// Scratch memory of path queries, reused from one query to the next.
+	struct PathQuery {
+		LocalVector<PolygonState> states;
+		LocalVector<OpenEntry> open_list;
+		uint64_t pass;
+
+		PathQuery() { pass = 0; }
+	};
+
+	PathQuery path_query;
+
+	// Path queries solved together on the worker pool. Every runner takes the next
+	// unsolved pair until none is left, using its own scratch.
+	struct PathBatch {
+		int id;
+		LocalVector<Vector3> starts;
+		LocalVector<Vector3> ends;
+		bool optimize;
+		LocalVector<Vector<Vector3> > paths;
+		LocalVector<PathQuery> queries; // Only for asynchronous batches, the others use batch_queries.
+		PathQuery *runner_queries;
+		SafeNumeric<uint32_t> next_path;
+		ThreadWorkPool::GroupID group;
+	};
+
+	LocalVector<PathQuery> batch_queries;
+	LocalVector<PathBatch *> path_batches;
+	int last_batch_id;
+
+	PathBatch *_create_path_batch(const PoolVector<Vector3> &p_starts, const PoolVector<Vector3> &p_ends, bool p_optimize);
+	void _solve_path_batch(uint32_t p_runner, PathBatch *p_batch);
+	Array _get_path_batch_result(const PathBatch *p_batch) const;
+	void _wait_path_batches();
+
 	void _navmesh_link(int p_id);
 	void _navmesh_unlink(int p_id);
 
+	void _update_polygons();
+	int _create_polygon_bvh(PolygonBVH *p_bvh, PolygonBVH **p_bb, int p_from, int p_size, int &max_alloc);
+	Polygon *_get_closest_polygon(const Vector3 &p_point, Vector3 &r_point, Vector3 *r_normal = nullptr) const;
+
 	float cell_size;
 	Map<int, NavMesh> navmesh_map;
 	int last_id;
 
 	Vector3 up;
-	void _clip_path(Vector<Vector3> &path, Polygon *from_poly, const Vector3 &p_to_point, Polygon *p_to_poly);
+	void _clip_path(const PathQuery &p_query, Vector<Vector3> &path, const Polygon *from_poly, const Vector3 &p_to_point, const Polygon *p_to_poly) const;
+	Vector<Vector3> _get_simple_path(PathQuery &r_query, const Vector3 &p_start, const Vector3 &p_end, bool p_optimize) const;
 
 protected:
+	void _notification(int p_what);
 	static void _bind_methods();
 
 public:
@@ -164,12 +259,15 @@ public:
 	void navmesh_remove(int p_id);
 
 	Vector<Vector3> get_simple_path(const Vector3 &p_start, const Vector3 &p_end, bool p_optimize = true);
+	Array get_simple_paths(const PoolVector<Vector3> &p_starts, const PoolVector<Vector3> &p_ends, bool p_optimize = true);
+	int get_simple_paths_async(const PoolVector<Vector3> &p_starts, const PoolVector<Vector3> &p_ends, bool p_optimize = true);
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool &p_use_collision = false);
 	Vector3 get_closest_point(const Vector3 &p_point);
 	Vector3 get_closest_point_normal(const Vector3 &p_point);
 	Object *get_closest_point_owner(const Vector3 &p_point);
 
 	Navigation();
+	~Navigation();
 };
 
 #endif // NAVIGATION_H
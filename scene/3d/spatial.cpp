@@ -32,6 +32,7 @@
 
 #include "core/engine.h"
 #include "core/message_queue.h"
+#include "core/sort_array.h"
 #include "scene/main/scene_tree.h"
 #include "scene/main/viewport.h"
 #include "scene/scene_string_names.h"
@@ -81,7 +82,7 @@ void Spatial::_notify_dirty() {
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 
 #endif
-		get_tree()->xform_change_list.add(&xform_change);
+		get_tree()->_add_xform_change(&xform_change);
 	}
 }
 
@@ -90,11 +91,32 @@ void Spatial::_update_local_transform() const {
 
 	data.dirty &= ~DIRTY_LOCAL;
 }
+void Spatial::_queue_transform_notification() {
+#ifdef TOOLS_ENABLED
+	if ((data.gizmo.is_valid() || data.notify_transform) && !data.ignore_notification && !xform_change.in_list()) {
+#else
+	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
+#endif
+		get_tree()->_add_xform_change(&xform_change);
+	}
+}
+
 void Spatial::_propagate_transform_changed(Spatial *p_origin) {
 	if (!is_inside_tree()) {
 		return;
 	}
 
+	SceneTree *tree = get_tree();
+	if (tree->spatial_xform_batching && !tree->process_thread_groups_active) {
+		// Only remember where the change starts, the whole subtree is updated at once when flushing.
+		// Thread groups can't share the dirty roots, so they propagate right away within their subtree.
+		data.dirty |= DIRTY_GLOBAL;
+		if (!xform_dirty_root.in_list()) {
+			tree->spatial_xform_dirty_roots.add(&xform_dirty_root);
+		}
+		return;
+	}
+
 	/*
 	if (data.dirty&DIRTY_GLOBAL)
 		return; //already dirty
@@ -108,18 +130,90 @@ void Spatial::_propagate_transform_changed(Spatial *p_origin) {
 		}
 		E->get()->_propagate_transform_changed(p_origin);
 	}
-#ifdef TOOLS_ENABLED
-	if ((data.gizmo.is_valid() || data.notify_transform) && !data.ignore_notification && !xform_change.in_list()) {
-#else
-	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
-#endif
-		get_tree()->xform_change_list.add(&xform_change);
-	}
+	_queue_transform_notification();
 	data.dirty |= DIRTY_GLOBAL;
 
 	data.children_lock--;
 }
 
+struct _SpatialDirtyRoot {
+	Spatial *spatial;
+	int depth;
+
+	bool operator<(const _SpatialDirtyRoot &p_other) const { return depth < p_other.depth; }
+};
+
+void Spatial::_update_batched_transforms(SceneTree *p_tree) {
+	// Shallowest roots first, so a root inside the subtree of another one is already updated when its turn comes.
+	LocalVector<_SpatialDirtyRoot> roots;
+	for (SelfList<Node> *E = p_tree->spatial_xform_dirty_roots.first(); E; E = E->next()) {
+		_SpatialDirtyRoot root;
+		root.spatial = static_cast<Spatial *>(E->self());
+		root.depth = 0;
+		for (const Spatial *p = root.spatial->data.parent; p; p = p->data.parent) {
+			root.depth++;
+		}
+		roots.push_back(root);
+	}
+
+	if (roots.size() > 1) {
+		SortArray<_SpatialDirtyRoot> sorter;
+		sorter.sort(roots.ptr(), roots.size());
+	}
+
+	LocalVector<Spatial *> &batch = p_tree->spatial_xform_batch;
+
+	for (uint32_t i = 0; i < roots.size(); i++) {
+		Spatial *root = roots[i].spatial;
+		if (!root->xform_dirty_root.in_list()) {
+			continue; // Updated along with an ancestor.
+		}
+
+		// Gather the subtree in hierarchy order, parents always come before their children.
+		batch.clear();
+		batch.push_back(root);
+		for (uint32_t j = 0; j < batch.size(); j++) {
+			Spatial *s = batch[j];
+			for (List<Spatial *>::Element *E = s->data.children.front(); E; E = E->next()) {
+				if (E->get()->data.toplevel_active) {
+					continue; //don't propagate to a toplevel
+				}
+				batch.push_back(E->get());
+			}
+		}
+
+		for (uint32_t j = 0; j < batch.size(); j++) {
+			Spatial *s = batch[j];
+			Data &d = s->data;
+
+			if (s->xform_dirty_root.in_list()) {
+				p_tree->spatial_xform_dirty_roots.remove(&s->xform_dirty_root);
+			}
+
+			if (d.dirty & DIRTY_LOCAL) {
+				s->_update_local_transform();
+			}
+
+			if (d.parent && !d.toplevel_active) {
+				// The parent is earlier in the batch, unless this is the root.
+				d.global_transform = d.parent->_get_global_transform() * d.local_transform;
+			} else {
+				d.global_transform = d.local_transform;
+			}
+
+			if (d.disable_scale) {
+				d.global_transform.basis.orthonormalize();
+			}
+
+			d.dirty &= ~DIRTY_GLOBAL;
+
+			s->_queue_transform_notification();
+		}
+	}
+
+	batch.clear();
+}
+
 void Spatial::notification_callback(int p_message_type) {
 	switch (p_message_type) {
 		default:
@@ -174,6 +268,9 @@ void Spatial::_notification(int p_what) {
 			if (xform_change.in_list()) {
 				get_tree()->xform_change_list.remove(&xform_change);
 			}
+			if (xform_dirty_root.in_list()) {
+				get_tree()->spatial_xform_dirty_roots.remove(&xform_dirty_root);
+			}
 			if (data.C) {
 				data.parent->data.children.erase(data.C);
 			}
@@ -271,13 +368,23 @@ Transform Spatial::get_transform() const {
 Transform Spatial::get_global_transform() const {
 	ERR_FAIL_COND_V(!is_inside_tree(), Transform());
 
+	SceneTree *tree = get_tree();
+	if (tree->spatial_xform_dirty_roots.first()) {
+		// A batched change may be pending above this node.
+		_update_batched_transforms(tree);
+	}
+
+	return _get_global_transform();
+}
+
+Transform Spatial::_get_global_transform() const {
 	if (data.dirty & DIRTY_GLOBAL) {
 		if (data.dirty & DIRTY_LOCAL) {
 			_update_local_transform();
 		}
 
 		if (data.parent && !data.toplevel_active) {
-			data.global_transform = data.parent->get_global_transform() * data.local_transform;
+			data.global_transform = data.parent->_get_global_transform() * data.local_transform;
 		} else {
 			data.global_transform = data.local_transform;
 		}
@@ -707,6 +814,14 @@ bool Spatial::is_local_transform_notification_enabled() const {
 
 void Spatial::force_update_transform() {
 	ERR_FAIL_COND(!is_inside_tree());
+	if (get_tree()->process_thread_groups_active) {
+		// The shared lists can't be changed from thread groups, a queued notification is just sent again later.
+		notification(NOTIFICATION_TRANSFORM_CHANGED);
+		return;
+	}
+	if (get_tree()->spatial_xform_dirty_roots.first()) {
+		_update_batched_transforms(get_tree());
+	}
 	if (!xform_change.in_list()) {
 		return; //nothing to update
 	}
@@ -802,7 +917,8 @@ void Spatial::_bind_methods() {
 }
 
 Spatial::Spatial() :
-		xform_change(this) {
+		xform_change(this),
+		xform_dirty_root(this) {
 	data.dirty = DIRTY_NONE;
 	data.children_lock = 0;
 
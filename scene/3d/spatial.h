@@ -69,6 +69,7 @@ private:
 	};
 
 	mutable SelfList<Node> xform_change;
+	SelfList<Node> xform_dirty_root;
 
 	struct Data {
 		// defined in Spatial::SpatialFlags
@@ -110,6 +111,11 @@ private:
 	void _update_gizmo();
 	void _notify_dirty();
 	void _propagate_transform_changed(Spatial *p_origin);
+	_FORCE_INLINE_ void _queue_transform_notification();
+	Transform _get_global_transform() const;
+
+	friend class SceneTree;
+	static void _update_batched_transforms(SceneTree *p_tree);
 
 	void _propagate_visibility_changed();
 
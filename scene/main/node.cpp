@@ -44,20 +44,21 @@
 #endif
 
 VARIANT_ENUM_CAST(Node::PauseMode);
+VARIANT_ENUM_CAST(Node::ProcessThreadGroup);
 
 int Node::orphan_node_count = 0;
 
 void Node::_notification(int p_notification) {
 	switch (p_notification) {
 		case NOTIFICATION_PROCESS: {
-			if (get_script_instance()) {
+			if (get_script_instance() && _script_has_process_method(SCRIPT_HAS_PROCESS)) {
 				Variant time = get_process_delta_time();
 				const Variant *ptr[1] = { &time };
 				get_script_instance()->call_multilevel(SceneStringNames::get_singleton()->_process, ptr, 1);
 			}
 		} break;
 		case NOTIFICATION_PHYSICS_PROCESS: {
-			if (get_script_instance()) {
+			if (get_script_instance() && _script_has_process_method(SCRIPT_HAS_PHYSICS_PROCESS)) {
 				Variant time = get_physics_process_delta_time();
 				const Variant *ptr[1] = { &time };
 				get_script_instance()->call_multilevel(SceneStringNames::get_singleton()->_physics_process, ptr, 1);
@@ -78,6 +79,15 @@ void Node::_notification(int p_notification) {
 				data.pause_owner = this;
 			}
 
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+				data.process_thread_group_owner = data.parent ? data.parent->data.process_thread_group_owner : nullptr;
+			} else {
+				data.process_thread_group_owner = this;
+			}
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+				get_tree()->process_thread_group_count++;
+			}
+
 			if (data.input) {
 				add_to_group("_vp_input" + itos(get_viewport()->get_instance_id()));
 			}
@@ -110,6 +120,10 @@ void Node::_notification(int p_notification) {
 			}
 
 			data.pause_owner = nullptr;
+			data.process_thread_group_owner = nullptr;
+			if (data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+				get_tree()->process_thread_group_count--;
+			}
 			if (data.path_cache) {
 				memdelete(data.path_cache);
 				data.path_cache = nullptr;
@@ -210,6 +224,10 @@ void Node::_propagate_enter_tree() {
 		E->get().group = data.tree->add_to_group(E->key(), this);
 	}
 
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		_update_process_list(SceneTree::ProcessListType(i));
+	}
+
 	notification(NOTIFICATION_ENTER_TREE);
 
 	if (get_script_instance()) {
@@ -306,6 +324,11 @@ void Node::_propagate_exit_tree() {
 	}
 
 	data.inside_tree = false;
+
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		_update_process_list(SceneTree::ProcessListType(i));
+	}
+
 	data.ready_notified = false;
 	data.tree = nullptr;
 	data.depth = -1;
@@ -316,6 +339,7 @@ void Node::move_child(Node *p_child, int p_pos) {
 	ERR_FAIL_INDEX_MSG(p_pos, data.children.size() + 1, vformat("Invalid new child position: %d.", p_pos));
 	ERR_FAIL_COND_MSG(p_child->data.parent != this, "Child is not a child of this node.");
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, move_child() failed. Consider using call_deferred(\"move_child\") instead (or \"popup\" if this is from a popup).");
+	ERR_FAIL_COND_MSG(_is_thread_group_call(), "Can't move child nodes while processing thread groups, move_child() failed. Consider using call_deferred(\"move_child\") instead.");
 
 	// Specifying one place beyond the end
 	// means the same as moving to the last position
@@ -352,6 +376,11 @@ void Node::move_child(Node *p_child, int p_pos) {
 			E->get().group->changed = true;
 		}
 	}
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		if (p_child->data.process_bucket[i]) {
+			p_child->data.process_bucket[i]->get().changed = true;
+		}
+	}
 
 	data.blocked--;
 }
@@ -381,13 +410,14 @@ void Node::set_physics_process(bool p_process) {
 		return;
 	}
 
+	if (_is_thread_group_call()) {
+		MessageQueue::get_singleton()->push_call(this, "set_physics_process", p_process);
+		return;
+	}
+
 	data.physics_process = p_process;
 
-	if (data.physics_process) {
-		add_to_group("physics_process", false);
-	} else {
-		remove_from_group("physics_process");
-	}
+	_update_process_list(SceneTree::PROCESS_LIST_PHYSICS);
 
 	_change_notify("physics_process");
 }
@@ -401,13 +431,14 @@ void Node::set_physics_process_internal(bool p_process_internal) {
 		return;
 	}
 
+	if (_is_thread_group_call()) {
+		MessageQueue::get_singleton()->push_call(this, "set_physics_process_internal", p_process_internal);
+		return;
+	}
+
 	data.physics_process_internal = p_process_internal;
 
-	if (data.physics_process_internal) {
-		add_to_group("physics_process_internal", false);
-	} else {
-		remove_from_group("physics_process_internal");
-	}
+	_update_process_list(SceneTree::PROCESS_LIST_PHYSICS_INTERNAL);
 
 	_change_notify("physics_process_internal");
 }
@@ -457,6 +488,65 @@ void Node::_propagate_pause_owner(Node *p_owner) {
 	}
 }
 
+void Node::set_process_thread_group(ProcessThreadGroup p_group) {
+	if (data.process_thread_group == p_group) {
+		return;
+	}
+
+	if (_is_thread_group_call()) {
+		MessageQueue::get_singleton()->push_call(this, "set_process_thread_group", p_group);
+		return;
+	}
+
+	ProcessThreadGroup prev_group = data.process_thread_group;
+	data.process_thread_group = p_group;
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	if (prev_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+		data.tree->process_thread_group_count--;
+	}
+	if (p_group == PROCESS_THREAD_GROUP_SUB_THREAD) {
+		data.tree->process_thread_group_count++;
+	}
+
+	if ((p_group == PROCESS_THREAD_GROUP_INHERIT) == (prev_group == PROCESS_THREAD_GROUP_INHERIT)) {
+		return; // Still its own owner.
+	}
+
+	Node *owner = nullptr;
+
+	if (p_group == PROCESS_THREAD_GROUP_INHERIT) {
+		if (data.parent) {
+			owner = data.parent->data.process_thread_group_owner;
+		}
+	} else {
+		owner = this;
+	}
+
+	_propagate_process_thread_group_owner(owner);
+}
+
+Node::ProcessThreadGroup Node::get_process_thread_group() const {
+	return data.process_thread_group;
+}
+
+void Node::_propagate_process_thread_group_owner(Node *p_owner) {
+	if (this != p_owner && data.process_thread_group != PROCESS_THREAD_GROUP_INHERIT) {
+		return;
+	}
+	data.process_thread_group_owner = p_owner;
+	for (int i = 0; i < data.children.size(); i++) {
+		data.children[i]->_propagate_process_thread_group_owner(p_owner);
+	}
+}
+
+bool Node::_is_thread_group_call() const {
+	// While thread groups run, nothing else runs on the main thread.
+	return data.tree && data.tree->process_thread_groups_active;
+}
+
 void Node::set_network_master(int p_peer_id, bool p_recursive) {
 	data.network_master = p_peer_id;
 
@@ -711,6 +801,50 @@ const Map<StringName, MultiplayerAPI::RPCMode>::Element *Node::get_node_rset_mod
 	return data.rpc_properties.find(p_property);
 }
 
+bool Node::_is_in_process_list(SceneTree::ProcessListType p_list) const {
+	switch (p_list) {
+		case SceneTree::PROCESS_LIST_IDLE:
+			return data.idle_process;
+		case SceneTree::PROCESS_LIST_IDLE_INTERNAL:
+			return data.idle_process_internal;
+		case SceneTree::PROCESS_LIST_PHYSICS:
+			return data.physics_process;
+		case SceneTree::PROCESS_LIST_PHYSICS_INTERNAL:
+			return data.physics_process_internal;
+		default:
+			return false;
+	}
+}
+
+void Node::_update_process_list(SceneTree::ProcessListType p_list) {
+	bool in_list = data.inside_tree && _is_in_process_list(p_list);
+
+	if (in_list && !data.process_bucket[p_list]) {
+		data.tree->_process_list_add(p_list, this);
+	} else if (!in_list && data.process_bucket[p_list]) {
+		data.tree->_process_list_remove(p_list, this);
+	}
+}
+
+bool Node::_script_has_process_method(uint32_t p_method) {
+	if (!(data.script_process_methods & SCRIPT_PROCESS_METHODS_CACHED)) {
+		// Scripts without the callback would only do a failed lookup every frame.
+		data.script_process_methods = SCRIPT_PROCESS_METHODS_CACHED;
+		if (get_script_instance()->has_method(SceneStringNames::get_singleton()->_process)) {
+			data.script_process_methods |= SCRIPT_HAS_PROCESS;
+		}
+		if (get_script_instance()->has_method(SceneStringNames::get_singleton()->_physics_process)) {
+			data.script_process_methods |= SCRIPT_HAS_PHYSICS_PROCESS;
+		}
+	}
+
+	return data.script_process_methods & p_method;
+}
+
+void Node::_script_instance_changed() {
+	data.script_process_methods = 0;
+}
+
 bool Node::can_process_notification(int p_what) const {
 	switch (p_what) {
 		case NOTIFICATION_PHYSICS_PROCESS:
@@ -775,13 +909,14 @@ void Node::set_process(bool p_idle_process) {
 		return;
 	}
 
+	if (_is_thread_group_call()) {
+		MessageQueue::get_singleton()->push_call(this, "set_process", p_idle_process);
+		return;
+	}
+
 	data.idle_process = p_idle_process;
 
-	if (data.idle_process) {
-		add_to_group("idle_process", false);
-	} else {
-		remove_from_group("idle_process");
-	}
+	_update_process_list(SceneTree::PROCESS_LIST_IDLE);
 
 	_change_notify("idle_process");
 }
@@ -795,13 +930,14 @@ void Node::set_process_internal(bool p_idle_process_internal) {
 		return;
 	}
 
+	if (_is_thread_group_call()) {
+		MessageQueue::get_singleton()->push_call(this, "set_process_internal", p_idle_process_internal);
+		return;
+	}
+
 	data.idle_process_internal = p_idle_process_internal;
 
-	if (data.idle_process_internal) {
-		add_to_group("idle_process_internal", false);
-	} else {
-		remove_from_group("idle_process_internal");
-	}
+	_update_process_list(SceneTree::PROCESS_LIST_IDLE_INTERNAL);
 
 	_change_notify("idle_process_internal");
 }
@@ -811,27 +947,26 @@ bool Node::is_processing_internal() const {
 }
 
 void Node::set_process_priority(int p_priority) {
-	data.process_priority = p_priority;
-
-	// Make sure we are in SceneTree.
-	if (data.tree == nullptr) {
+	if (data.process_priority == p_priority) {
 		return;
 	}
 
-	if (is_processing()) {
-		data.tree->make_group_changed("idle_process");
+	if (_is_thread_group_call()) {
+		MessageQueue::get_singleton()->push_call(this, "set_process_priority", p_priority);
+		return;
 	}
 
-	if (is_processing_internal()) {
-		data.tree->make_group_changed("idle_process_internal");
+	// Move to the bucket of the new priority.
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		if (data.process_bucket[i]) {
+			data.tree->_process_list_remove(SceneTree::ProcessListType(i), this);
+		}
 	}
 
-	if (is_physics_processing()) {
-		data.tree->make_group_changed("physics_process");
-	}
+	data.process_priority = p_priority;
 
-	if (is_physics_processing_internal()) {
-		data.tree->make_group_changed("physics_process_internal");
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		_update_process_list(SceneTree::ProcessListType(i));
 	}
 }
 
@@ -1133,6 +1268,7 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name) {
 	ERR_FAIL_COND_MSG(p_child->is_a_parent_of(this), vformat("Can't add child '%s' to '%s' as it would result in a cyclic dependency since '%s' is already a parent of '%s'.", p_child->get_name(), get_name(), p_child->get_name(), get_name()));
 #endif
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, add_node() failed. Consider using call_deferred(\"add_child\", child) instead.");
+	ERR_FAIL_COND_MSG(_is_thread_group_call(), "Can't add child nodes to the tree while processing thread groups, add_node() failed. Consider using call_deferred(\"add_child\", child) instead.");
 
 	/* Validate name */
 	_validate_child_name(p_child, p_legible_unique_name);
@@ -1181,6 +1317,7 @@ void Node::_propagate_validate_owner() {
 void Node::remove_child(Node *p_child) {
 	ERR_FAIL_NULL(p_child);
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, remove_node() failed. Consider using call_deferred(\"remove_child\", child) instead.");
+	ERR_FAIL_COND_MSG(_is_thread_group_call(), "Can't remove child nodes from the tree while processing thread groups, remove_node() failed. Consider using call_deferred(\"remove_child\", child) instead.");
 
 	int child_count = data.children.size();
 	Node **children = data.children.ptrw();
@@ -2766,6 +2903,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_processing_unhandled_key_input"), &Node::is_processing_unhandled_key_input);
 	ClassDB::bind_method(D_METHOD("set_pause_mode", "mode"), &Node::set_pause_mode);
 	ClassDB::bind_method(D_METHOD("get_pause_mode"), &Node::get_pause_mode);
+	ClassDB::bind_method(D_METHOD("set_process_thread_group", "group"), &Node::set_process_thread_group);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group"), &Node::get_process_thread_group);
 	ClassDB::bind_method(D_METHOD("can_process"), &Node::can_process);
 	ClassDB::bind_method(D_METHOD("print_stray_nodes"), &Node::_print_stray_nodes);
 	ClassDB::bind_method(D_METHOD("get_position_in_parent"), &Node::get_position_in_parent);
@@ -2874,6 +3013,10 @@ void Node::_bind_methods() {
 	BIND_ENUM_CONSTANT(PAUSE_MODE_STOP);
 	BIND_ENUM_CONSTANT(PAUSE_MODE_PROCESS);
 
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_INHERIT);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_MAIN_THREAD);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_SUB_THREAD);
+
 	BIND_ENUM_CONSTANT(DUPLICATE_SIGNALS);
 	BIND_ENUM_CONSTANT(DUPLICATE_GROUPS);
 	BIND_ENUM_CONSTANT(DUPLICATE_SCRIPTS);
@@ -2886,6 +3029,7 @@ void Node::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("tree_exited"));
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "pause_mode", PROPERTY_HINT_ENUM, "Inherit,Stop,Process"), "set_pause_mode", "get_pause_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_ENUM, "Inherit,Main Thread,Sub Thread"), "set_process_thread_group", "get_process_thread_group");
 
 #ifdef ENABLE_DEPRECATED
 	//no longer exists, but remains for compatibility (keep previous scenes folded
@@ -2933,6 +3077,11 @@ Node::Node() {
 	data.physics_process = false;
 	data.idle_process = false;
 	data.process_priority = 0;
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		data.process_bucket[i] = nullptr;
+		data.process_index[i] = 0;
+	}
+	data.script_process_methods = 0;
 	data.physics_process_internal = false;
 	data.idle_process_internal = false;
 	data.inside_tree = false;
@@ -2945,6 +3094,10 @@ Node::Node() {
 	data.unhandled_key_input = false;
 	data.pause_mode = PAUSE_MODE_INHERIT;
 	data.pause_owner = nullptr;
+	data.process_thread_group = PROCESS_THREAD_GROUP_INHERIT;
+	data.process_thread_group_owner = nullptr;
+	data.process_thread_group_pass = 0;
+	data.process_thread_group_run = 0;
 	data.network_master = 1; //server by default
 	data.path_cache = nullptr;
 	data.parent_owned = false;
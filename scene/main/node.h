@@ -53,6 +53,13 @@ public:
 		PAUSE_MODE_PROCESS
 	};
 
+	enum ProcessThreadGroup {
+
+		PROCESS_THREAD_GROUP_INHERIT,
+		PROCESS_THREAD_GROUP_MAIN_THREAD,
+		PROCESS_THREAD_GROUP_SUB_THREAD
+	};
+
 	enum DuplicateFlags {
 
 		DUPLICATE_SIGNALS = 1,
@@ -116,6 +123,12 @@ private:
 		PauseMode pause_mode;
 		Node *pause_owner;
 
+		ProcessThreadGroup process_thread_group;
+		Node *process_thread_group_owner;
+		// used by SceneTree to gather the nodes of this thread group
+		uint64_t process_thread_group_pass;
+		uint32_t process_thread_group_run;
+
 		int network_master;
 		Map<StringName, MultiplayerAPI::RPCMode> rpc_methods;
 		Map<StringName, MultiplayerAPI::RPCMode> rpc_properties;
@@ -129,6 +142,12 @@ private:
 		bool physics_process_internal;
 		bool idle_process_internal;
 
+		// position in the SceneTree process lists, while inside the tree
+		Map<int, SceneTree::ProcessBucket>::Element *process_bucket[SceneTree::PROCESS_LIST_MAX];
+		uint32_t process_index[SceneTree::PROCESS_LIST_MAX];
+
+		uint32_t script_process_methods; // cached for the current script instance
+
 		bool input;
 		bool unhandled_input;
 		bool unhandled_key_input;
@@ -165,6 +184,17 @@ private:
 	void _propagate_validate_owner();
 	void _print_stray_nodes();
 	void _propagate_pause_owner(Node *p_owner);
+	void _propagate_process_thread_group_owner(Node *p_owner);
+	bool _is_thread_group_call() const;
+	bool _is_in_process_list(SceneTree::ProcessListType p_list) const;
+	void _update_process_list(SceneTree::ProcessListType p_list);
+
+	enum {
+		SCRIPT_PROCESS_METHODS_CACHED = 1,
+		SCRIPT_HAS_PROCESS = 2,
+		SCRIPT_HAS_PHYSICS_PROCESS = 4,
+	};
+	bool _script_has_process_method(uint32_t p_method);
 	Array _get_node_and_resource(const NodePath &p_path);
 
 	void _duplicate_signals(const Node *p_original, Node *p_copy) const;
@@ -188,6 +218,7 @@ protected:
 	void _unblock() { data.blocked--; }
 
 	void _notification(int p_notification);
+	virtual void _script_instance_changed();
 
 	virtual void add_child_notify(Node *p_child);
 	virtual void remove_child_notify(Node *p_child);
@@ -376,6 +407,10 @@ public:
 
 	void set_pause_mode(PauseMode p_mode);
 	PauseMode get_pause_mode() const;
+
+	void set_process_thread_group(ProcessThreadGroup p_group);
+	ProcessThreadGroup get_process_thread_group() const;
+	_FORCE_INLINE_ bool is_processed_in_thread_group() const { return data.process_thread_group_owner && data.process_thread_group_owner->data.process_thread_group == PROCESS_THREAD_GROUP_SUB_THREAD; }
 	bool can_process() const;
 	bool can_process_notification(int p_what) const;
 
@@ -36,10 +36,12 @@
 #include "core/os/dir_access.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
+#include "core/os/thread_work_pool.h"
 #include "core/print_string.h"
 #include "core/project_settings.h"
 #include "main/input_default.h"
 #include "node.h"
+#include "scene/3d/spatial.h"
 #include "scene/debugger/script_debugger_remote.h"
 #include "scene/resources/dynamic_font.h"
 #include "scene/resources/material.h"
@@ -55,6 +57,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+static thread_local int32_t thread_group_run_index = -1; // Run processed by the calling thread, -1 outside of thread groups.
+
 void SceneTreeTimer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_time_left", "time"), &SceneTreeTimer::set_time_left);
 	ClassDB::bind_method(D_METHOD("get_time_left"), &SceneTreeTimer::get_time_left);
@@ -157,6 +161,10 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 }
 
 void SceneTree::flush_transform_notifications() {
+	if (spatial_xform_dirty_roots.first()) {
+		Spatial::_update_batched_transforms(this);
+	}
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 		Node *node = n->self();
@@ -167,6 +175,15 @@ void SceneTree::flush_transform_notifications() {
 	}
 }
 
+void SceneTree::_add_xform_change(SelfList<Node> *p_xform_change) {
+	if (thread_group_run_index >= 0) {
+		// Thread groups can't share the list, their changes are added once they are done.
+		thread_group_xform_changes[thread_group_run_index].push_back(p_xform_change);
+	} else {
+		xform_change_list.add(p_xform_change);
+	}
+}
+
 void SceneTree::_flush_ugc() {
 	ugc_locked = true;
 
@@ -485,11 +502,11 @@ bool SceneTree::iteration(float p_time) {
 
 	emit_signal("physics_frame");
 
-	_notify_group_pause("physics_process_internal", Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+	_notify_process_list(PROCESS_LIST_PHYSICS_INTERNAL, Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 	if (GLOBAL_GET("physics/common/enable_pause_aware_picking")) {
 		call_group_flags(GROUP_CALL_REALTIME, "_viewports", "_process_picking", true);
 	}
-	_notify_group_pause("physics_process", Node::NOTIFICATION_PHYSICS_PROCESS);
+	_notify_process_list(PROCESS_LIST_PHYSICS, Node::NOTIFICATION_PHYSICS_PROCESS);
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
 	flush_transform_notifications();
@@ -532,8 +549,8 @@ bool SceneTree::idle(float p_time) {
 
 	flush_transform_notifications();
 
-	_notify_group_pause("idle_process_internal", Node::NOTIFICATION_INTERNAL_PROCESS);
-	_notify_group_pause("idle_process", Node::NOTIFICATION_PROCESS);
+	_notify_process_list(PROCESS_LIST_IDLE_INTERNAL, Node::NOTIFICATION_INTERNAL_PROCESS);
+	_notify_process_list(PROCESS_LIST_IDLE, Node::NOTIFICATION_PROCESS);
 
 	Size2 win_size = Size2(OS::get_singleton()->get_window_size().width, OS::get_singleton()->get_window_size().height);
 
@@ -953,48 +970,213 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 	}
 }
 
-void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+void SceneTree::_process_list_add(ProcessListType p_list, Node *p_node) {
+	ProcessList &list = process_lists[p_list];
+
+	Map<int, ProcessBucket>::Element *E = list.buckets.find(p_node->data.process_priority);
 	if (!E) {
-		return;
+		E = list.buckets.insert(p_node->data.process_priority, ProcessBucket());
 	}
-	Group &g = E->get();
-	if (g.nodes.empty()) {
-		return;
+	ProcessBucket &bucket = E->get();
+
+	if (!bucket.changed && bucket.nodes.size()) {
+		// Appending keeps the order most of the time, e.g. when a scene is instanced.
+		Node *last = bucket.nodes[bucket.nodes.size() - 1];
+		if (!last || !p_node->is_greater_than(last)) {
+			bucket.changed = true;
+		}
 	}
 
-	_update_group_order(g, p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+	p_node->data.process_bucket[p_list] = E;
+	p_node->data.process_index[p_list] = bucket.nodes.size();
+	bucket.nodes.push_back(p_node);
+}
 
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
+void SceneTree::_process_list_remove(ProcessListType p_list, Node *p_node) {
+	Map<int, ProcessBucket>::Element *E = p_node->data.process_bucket[p_list];
+	ERR_FAIL_COND(!E);
 
-	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	ProcessBucket &bucket = E->get();
+	uint32_t index = p_node->data.process_index[p_list];
+	ERR_FAIL_COND(index >= bucket.nodes.size() || bucket.nodes[index] != p_node);
 
-	call_lock++;
+	// Don't move anything, the list may be being processed.
+	bucket.nodes[index] = nullptr;
+	bucket.removed++;
 
-	for (int i = 0; i < node_count; i++) {
-		Node *n = nodes[i];
-		if (call_lock && call_skip.has(n)) {
+	p_node->data.process_bucket[p_list] = nullptr;
+}
+
+void SceneTree::_update_process_list(ProcessListType p_list) {
+	ProcessList &list = process_lists[p_list];
+
+	Map<int, ProcessBucket>::Element *E = list.buckets.front();
+	while (E) {
+		Map<int, ProcessBucket>::Element *N = E->next();
+		ProcessBucket &bucket = E->get();
+
+		if (!bucket.removed && !bucket.changed) {
+			E = N;
 			continue;
 		}
 
-		if (!n->can_process()) {
-			continue;
+		if (bucket.removed) {
+			if (bucket.removed == bucket.nodes.size()) {
+				list.buckets.erase(E);
+				E = N;
+				continue;
+			}
+
+			uint32_t count = 0;
+			for (uint32_t i = 0; i < bucket.nodes.size(); i++) {
+				if (bucket.nodes[i]) {
+					bucket.nodes[count++] = bucket.nodes[i];
+				}
+			}
+			bucket.nodes.resize(count);
+			bucket.removed = 0;
 		}
-		if (!n->can_process_notification(p_notification)) {
+
+		if (bucket.changed) {
+			SortArray<Node *, Node::Comparator> node_sort;
+			node_sort.sort(bucket.nodes.ptr(), bucket.nodes.size());
+			bucket.changed = false;
+		}
+
+		for (uint32_t i = 0; i < bucket.nodes.size(); i++) {
+			bucket.nodes[i]->data.process_index[p_list] = i;
+		}
+
+		E = N;
+	}
+}
+
+void SceneTree::_notify_process_list(ProcessListType p_list, int p_notification) {
+	ProcessList &list = process_lists[p_list];
+	ERR_FAIL_COND(list.lock > 0);
+
+	_update_process_list(p_list);
+
+	if (list.buckets.empty()) {
+		return;
+	}
+
+	// Nodes (and buckets) added while processing wait for the next frame, removed ones are skipped.
+	for (Map<int, ProcessBucket>::Element *E = list.buckets.front(); E; E = E->next()) {
+		ProcessList::Pass pass;
+		pass.bucket = &E->get();
+		pass.count = E->get().nodes.size();
+		list.pass.push_back(pass);
+	}
+
+	// Only user processing can be threaded, built-in nodes are not expected to be thread-safe.
+	bool thread_groups = process_thread_group_count > 0 && (p_list == PROCESS_LIST_IDLE || p_list == PROCESS_LIST_PHYSICS);
+
+	list.lock++;
+
+	for (uint32_t i = 0; i < list.pass.size(); i++) {
+		ProcessBucket *bucket = list.pass[i].bucket;
+		uint32_t count = list.pass[i].count;
+
+		if (thread_groups) {
+			// Thread groups of each priority run before its main thread nodes.
+			_process_thread_groups(bucket, count, p_notification);
+		}
+
+		for (uint32_t j = 0; j < count; j++) {
+			Node *n = bucket->nodes[j];
+			if (!n) {
+				continue;
+			}
+
+			if (thread_groups && n->is_processed_in_thread_group()) {
+				continue;
+			}
+
+			if (!n->can_process()) {
+				continue;
+			}
+
+			n->notification(p_notification);
+		}
+	}
+
+	list.lock--;
+	list.pass.clear();
+}
+
+void SceneTree::_process_thread_groups(ProcessBucket *p_bucket, uint32_t p_count, int p_notification) {
+	// Each group is a run of nodes processed in order by a single thread, different groups run in parallel.
+	process_thread_group_pass++;
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		Node *n = p_bucket->nodes[i];
+		if (!n || !n->is_processed_in_thread_group() || !n->can_process()) {
 			continue;
 		}
 
-		n->notification(p_notification);
-		//ERR_FAIL_COND(node_count != g.nodes.size());
+		uint32_t index = thread_group_nodes.size();
+		thread_group_nodes.push_back(n);
+		thread_group_next.push_back(UINT32_MAX);
+
+		Node *owner = n->data.process_thread_group_owner;
+		if (owner->data.process_thread_group_pass != process_thread_group_pass) {
+			owner->data.process_thread_group_pass = process_thread_group_pass;
+			owner->data.process_thread_group_run = thread_group_runs.size();
+
+			ThreadGroupRun run;
+			run.first = index;
+			run.last = index;
+			thread_group_runs.push_back(run);
+		} else {
+			ThreadGroupRun &run = thread_group_runs[owner->data.process_thread_group_run];
+			thread_group_next[run.last] = index;
+			run.last = index;
+		}
 	}
 
-	call_lock--;
-	if (call_lock == 0) {
-		call_skip.clear();
+	if (thread_group_runs.size()) {
+		// Groups may read global transforms, which would otherwise update batched changes all over the tree.
+		if (spatial_xform_dirty_roots.first()) {
+			Spatial::_update_batched_transforms(this);
+		}
+		if (thread_group_xform_changes.size() < thread_group_runs.size()) {
+			thread_group_xform_changes.resize(thread_group_runs.size());
+		}
+
+		// Tree changes from the groups are rejected or deferred through the MessageQueue meanwhile, see Node::_is_thread_group_call().
+		process_thread_groups_active = true;
+		if (ThreadWorkPool::get_singleton()) {
+			ThreadWorkPool::get_singleton()->do_parallel_for(thread_group_runs.size(), this, &SceneTree::_process_thread_group_run, p_notification, 1);
+		} else {
+			for (uint32_t i = 0; i < thread_group_runs.size(); i++) {
+				_process_thread_group_run(i, p_notification);
+			}
+		}
+		process_thread_groups_active = false;
+
+		for (uint32_t i = 0; i < thread_group_runs.size(); i++) {
+			LocalVector<SelfList<Node> *> &xform_changes = thread_group_xform_changes[i];
+			for (uint32_t j = 0; j < xform_changes.size(); j++) {
+				if (!xform_changes[j]->in_list()) {
+					xform_change_list.add(xform_changes[j]);
+				}
+			}
+			xform_changes.clear();
+		}
 	}
+
+	thread_group_nodes.clear();
+	thread_group_next.clear();
+	thread_group_runs.clear();
+}
+
+void SceneTree::_process_thread_group_run(uint32_t p_index, int p_notification) {
+	thread_group_run_index = p_index;
+	for (uint32_t i = thread_group_runs[p_index].first; i != UINT32_MAX; i = thread_group_next[i]) {
+		thread_group_nodes[i]->notification(p_notification);
+	}
+	thread_group_run_index = -1;
 }
 
 /*
@@ -2024,6 +2206,12 @@ SceneTree::SceneTree() {
 
 	GLOBAL_DEF("debug/shapes/collision/draw_2d_outlines", true);
 
+	spatial_xform_batching = GLOBAL_DEF("node/spatial/batch_transform_propagation", false);
+
+	process_thread_group_count = 0;
+	process_thread_groups_active = false;
+	process_thread_group_pass = 0;
+
 	tree_version = 1;
 	physics_process_time = 1;
 	idle_process_time = 1;
@@ -32,6 +32,7 @@
 #define SCENE_MAIN_LOOP_H
 
 #include "core/io/multiplayer_api.h"
+#include "core/local_vector.h"
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
 #include "core/self_list.h"
@@ -41,6 +42,7 @@
 
 class PackedScene;
 class Node;
+class Spatial;
 class Viewport;
 class Material;
 class Mesh;
@@ -102,6 +104,54 @@ private:
 		Group() { changed = false; };
 	};
 
+	enum ProcessListType {
+		PROCESS_LIST_IDLE,
+		PROCESS_LIST_IDLE_INTERNAL,
+		PROCESS_LIST_PHYSICS,
+		PROCESS_LIST_PHYSICS_INTERNAL,
+		PROCESS_LIST_MAX
+	};
+
+	// Nodes sharing a process priority, kept in tree order.
+	struct ProcessBucket {
+		LocalVector<Node *> nodes; // Removed nodes are left as nullptr until the bucket is updated.
+		uint32_t removed;
+		bool changed;
+		ProcessBucket() {
+			removed = 0;
+			changed = false;
+		}
+	};
+
+	struct ProcessList {
+		Map<int, ProcessBucket> buckets; // By priority.
+
+		struct Pass {
+			ProcessBucket *bucket;
+			uint32_t count;
+		};
+		LocalVector<Pass> pass;
+		int lock;
+
+		ProcessList() { lock = 0; }
+	};
+
+	ProcessList process_lists[PROCESS_LIST_MAX];
+
+	// Nodes processed on worker threads, see Node::PROCESS_THREAD_GROUP_SUB_THREAD.
+	struct ThreadGroupRun {
+		uint32_t first;
+		uint32_t last;
+	};
+
+	int process_thread_group_count; // Sub thread group owners inside the tree.
+	bool process_thread_groups_active;
+	uint64_t process_thread_group_pass;
+	LocalVector<Node *> thread_group_nodes;
+	LocalVector<uint32_t> thread_group_next;
+	LocalVector<ThreadGroupRun> thread_group_runs;
+	LocalVector<LocalVector<SelfList<Node> *>> thread_group_xform_changes; // Per run, added to xform_change_list once the groups are done.
+
 	Viewport *root;
 
 	uint64_t tree_version;
@@ -207,7 +257,12 @@ private:
 	void remove_from_group(const StringName &p_group, Node *p_node);
 	void make_group_changed(const StringName &p_group);
 
-	void _notify_group_pause(const StringName &p_group, int p_notification);
+	void _process_list_add(ProcessListType p_list, Node *p_node);
+	void _process_list_remove(ProcessListType p_list, Node *p_node);
+	void _update_process_list(ProcessListType p_list);
+	void _notify_process_list(ProcessListType p_list, int p_notification);
+	void _process_thread_groups(ProcessBucket *p_bucket, uint32_t p_count, int p_notification);
+	void _process_thread_group_run(uint32_t p_index, int p_notification);
 	void _call_input_pause(const StringName &p_group, const StringName &p_method, const Ref<InputEvent> &p_input);
 	Variant _call_group_flags(const Variant **p_args, int p_argcount, Variant::CallError &r_error);
 	Variant _call_group(const Variant **p_args, int p_argcount, Variant::CallError &r_error);
@@ -219,6 +274,12 @@ private:
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
+	void _add_xform_change(SelfList<Node> *p_xform_change);
+
+	// Spatial transforms, when updated in batches (see Spatial::_update_batched_transforms()).
+	bool spatial_xform_batching;
+	SelfList<Node>::List spatial_xform_dirty_roots;
+	LocalVector<Spatial *> spatial_xform_batch;
 
 	friend class ScriptDebuggerRemote;
 #ifdef DEBUG_ENABLED
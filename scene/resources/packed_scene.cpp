@@ -82,6 +82,8 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 
 	bool gen_node_path_cache = p_edit_state != GEN_EDIT_STATE_DISABLED && node_path_cache.empty();
 
+	const InstancePlan *plan = p_edit_state == GEN_EDIT_STATE_DISABLED ? _get_instance_plan() : nullptr;
+
 	Map<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
 
 	for (int i = 0; i < nc; i++) {
@@ -151,7 +153,9 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 		} else {
 			Object *obj = nullptr;
 
-			if (ClassDB::is_class_enabled(snames[n.type])) {
+			if (plan && plan->nodes[i].instance_func) {
+				obj = plan->nodes[i].instance_func();
+			} else if (ClassDB::is_class_enabled(snames[n.type])) {
 				//node belongs to this scene and must be created
 				obj = ClassDB::instance(snames[n.type]);
 			}
@@ -188,9 +192,20 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 			int nprop_count = n.properties.size();
 			if (nprop_count) {
 				const NodeData::Property *nprops = &n.properties[0];
+				const InstancePlan::Property *plan_props = (plan && plan->nodes[i].instance_func) ? plan->nodes[i].properties.ptr() : nullptr;
 
 				for (int j = 0; j < nprop_count; j++) {
 					bool valid;
+
+					if (plan_props && plan_props[j].resolved && !node->get_script_instance()) {
+						// Same as Object::set() without the lookups, as long as there's no script to take the property first.
+						ClassDB::call_property_setter(node, plan_props[j].setget, props[nprops[j].value], &valid);
+#ifdef TOOLS_ENABLED
+						node->set_edited(true);
+#endif
+						continue;
+					}
+
 					ERR_FAIL_INDEX_V(nprops[j].name, sname_count, nullptr);
 					ERR_FAIL_INDEX_V(nprops[j].value, prop_count, nullptr);
 
@@ -319,7 +334,9 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 		}
 
 		Vector<Variant> binds;
-		if (c.binds.size()) {
+		if (plan) {
+			binds = plan->connection_binds[i];
+		} else if (c.binds.size()) {
 			binds.resize(c.binds.size());
 			for (int j = 0; j < c.binds.size(); j++) {
 				binds.write[j] = props[c.binds[j]];
@@ -347,6 +364,88 @@ Node *SceneState::instance(GenEditState p_edit_state) const {
 	return ret_nodes[0];
 }
 
+const SceneState::InstancePlan *SceneState::_get_instance_plan() const {
+	if (instance_plan_ready.is_set()) {
+		return instance_plan;
+	}
+
+	MutexLock lock(instance_plan_mutex);
+
+	if (instance_plan_ready.is_set()) {
+		return instance_plan; // built by another thread meanwhile
+	}
+
+	InstancePlan *plan = memnew(InstancePlan);
+
+	plan->nodes.resize(nodes.size());
+	for (int i = 0; i < nodes.size(); i++) {
+		const NodeData &n = nodes[i];
+		InstancePlan::Node &pn = plan->nodes.write[i];
+		pn.instance_func = nullptr;
+
+		if ((i == 0 && base_scene_idx >= 0) || n.instance >= 0 || n.type == TYPE_INSTANCED || n.type < 0 || n.type >= names.size()) {
+			continue; // not created from its type
+		}
+
+		StringName instanced_class;
+		ClassDB::InstanceFunc instance_func = ClassDB::get_instance_func(names[n.type], &instanced_class);
+		if (!instance_func) {
+			continue; // let instance() report it and create a placeholder
+		}
+
+		pn.properties.resize(n.properties.size());
+		bool valid_indices = true;
+		for (int j = 0; j < n.properties.size(); j++) {
+			const NodeData::Property &prop = n.properties[j];
+			InstancePlan::Property &pp = pn.properties.write[j];
+			pp.resolved = false;
+
+			if (prop.name < 0 || prop.name >= names.size() || prop.value < 0 || prop.value >= variants.size()) {
+				valid_indices = false;
+				break;
+			}
+
+			// The script needs its state kept, and resources may need duplicating for the scene, see instance().
+			if (names[prop.name] == CoreStringNames::get_singleton()->_script || variants[prop.value].get_type() == Variant::OBJECT) {
+				continue;
+			}
+
+			pp.resolved = ClassDB::get_property_setget(instanced_class, names[prop.name], pp.setget);
+		}
+
+		if (valid_indices) {
+			pn.instance_func = instance_func;
+		} else {
+			pn.properties.clear(); // let instance() report it
+		}
+	}
+
+	plan->connection_binds.resize(connections.size());
+	for (int i = 0; i < connections.size(); i++) {
+		const ConnectionData &c = connections[i];
+		Vector<Variant> &binds = plan->connection_binds.write[i];
+		binds.resize(c.binds.size());
+		for (int j = 0; j < c.binds.size(); j++) {
+			binds.write[j] = variants[c.binds[j]];
+		}
+	}
+
+	instance_plan = plan;
+	instance_plan_ready.set();
+
+	return instance_plan;
+}
+
+void SceneState::_clear_instance_plan() {
+	MutexLock lock(instance_plan_mutex);
+
+	instance_plan_ready.clear();
+	if (instance_plan) {
+		memdelete(instance_plan);
+		instance_plan = nullptr;
+	}
+}
+
 static int _nm_get_string(const String &p_string, Map<StringName, int> &name_map) {
 	if (name_map.has(p_string)) {
 		return name_map[p_string];
@@ -922,6 +1021,8 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_instance_plan();
+
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1080,6 +1181,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 	ERR_FAIL_COND(!p_dictionary.has("conns"));
 	//ERR_FAIL_COND( !p_dictionary.has("path"));
 
+	_clear_instance_plan();
+
 	int version = 1;
 	if (p_dictionary.has("version")) {
 		version = p_dictionary["version"];
@@ -1495,6 +1598,7 @@ Vector<NodePath> SceneState::get_editable_instances() const {
 //add
 
 int SceneState::add_name(const StringName &p_name) {
+	_clear_instance_plan();
 	names.push_back(p_name);
 	return names.size() - 1;
 }
@@ -1510,15 +1614,18 @@ int SceneState::find_name(const StringName &p_name) const {
 }
 
 int SceneState::add_value(const Variant &p_value) {
+	_clear_instance_plan();
 	variants.push_back(p_value);
 	return variants.size() - 1;
 }
 
 int SceneState::add_node_path(const NodePath &p_path) {
+	_clear_instance_plan();
 	node_paths.push_back(p_path);
 	return (node_paths.size() - 1) | FLAG_ID_IS_PATH;
 }
 int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int p_instance, int p_index) {
+	_clear_instance_plan();
 	NodeData nd;
 	nd.parent = p_parent;
 	nd.owner = p_owner;
@@ -1539,15 +1646,18 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	NodeData::Property prop;
 	prop.name = p_name;
 	prop.value = p_value;
+	_clear_instance_plan();
 	nodes.write[p_node].properties.push_back(prop);
 }
 void SceneState::add_node_group(int p_node, int p_group) {
 	ERR_FAIL_INDEX(p_node, nodes.size());
 	ERR_FAIL_INDEX(p_group, names.size());
+	_clear_instance_plan();
 	nodes.write[p_node].groups.push_back(p_group);
 }
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instance_plan();
 	base_scene_idx = p_idx;
 }
 void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method, int p_flags, const Vector<int> &p_binds) {
@@ -1564,9 +1674,11 @@ void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method
 	c.method = p_method;
 	c.flags = p_flags;
 	c.binds = p_binds;
+	_clear_instance_plan();
 	connections.push_back(c);
 }
 void SceneState::add_editable_instance(const NodePath &p_path) {
+	_clear_instance_plan();
 	editable_instances.push_back(p_path);
 }
 
@@ -1613,6 +1725,13 @@ void SceneState::_bind_methods() {
 SceneState::SceneState() {
 	base_scene_idx = -1;
 	last_modified_time = 0;
+	instance_plan = nullptr;
+}
+
+SceneState::~SceneState() {
+	if (instance_plan) {
+		memdelete(instance_plan);
+	}
 }
 
 ////////////////
@@ -88,6 +88,29 @@ class SceneState : public Reference {
 
 	Vector<ConnectionData> connections;
 
+	// What instance() resolves by name, resolved once and reused by every runtime (GEN_EDIT_STATE_DISABLED) instance.
+	struct InstancePlan {
+		struct Property {
+			ClassDB::PropertySetGet setget;
+			bool resolved; // otherwise set through Object::set()
+		};
+
+		struct Node {
+			ClassDB::InstanceFunc instance_func; // null unless the node is created from its type
+			Vector<Property> properties; // matches NodeData::properties when instance_func is set
+		};
+
+		Vector<Node> nodes;
+		Vector<Vector<Variant>> connection_binds;
+	};
+
+	mutable InstancePlan *instance_plan;
+	mutable SafeFlag instance_plan_ready;
+	mutable Mutex instance_plan_mutex;
+
+	const InstancePlan *_get_instance_plan() const;
+	void _clear_instance_plan();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -186,6 +209,7 @@ public:
 	uint64_t get_last_modified_time() const { return last_modified_time; }
 
 	SceneState();
+	~SceneState();
 };
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
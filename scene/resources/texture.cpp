@@ -613,12 +613,7 @@ Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &tw_
 			int size = Image::get_image_data_size(tw, th, format, false);
 
 			PoolVector<uint8_t> img_data;
-			img_data.resize(size);
-
-			{
-				PoolVector<uint8_t>::Write w = img_data.write();
-				f->get_buffer(w.ptr(), size);
-			}
+			f->get_pool_buffer(img_data, size);
 
 			memdelete(f);
 
@@ -649,11 +644,9 @@ Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &tw_
 			f->seek(f->get_position() + ofs);
 
 			PoolVector<uint8_t> img_data;
-			img_data.resize(total_size - ofs);
 
 			{
-				PoolVector<uint8_t>::Write w = img_data.write();
-				uint64_t bytes = f->get_buffer(w.ptr(), total_size - ofs);
+				uint64_t bytes = f->get_pool_buffer(img_data, total_size - ofs);
 				//print_line("requested read: " + itos(total_size - ofs) + " but got: " + itos(bytes));
 
 				memdelete(f);
@@ -661,6 +654,7 @@ Error StreamTexture::_load_data(const String &p_path, int &tw, int &th, int &tw_
 				uint64_t expected = total_size - ofs;
 				if (bytes < expected) {
 					//this is a compatibility workaround for older format, which saved less mipmaps2. It is still recommended the image is reimported.
+					PoolVector<uint8_t>::Write w = img_data.write();
 					memset(w.ptr() + bytes, 0, (expected - bytes));
 				} else if (bytes != expected) {
 					ERR_FAIL_V(ERR_FILE_CORRUPT);
@@ -48,12 +48,21 @@
 #define RELAXATION_TIMESTEPS 3
 #define MIN_VELOCITY 0.0001
 #define MAX_BIAS_ROTATION (Math_PI / 8)
+#define CONTACT_CACHE_TOLERANCE 0.1
 
 void BodyPairSW::_contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata) {
 	BodyPairSW *pair = (BodyPairSW *)p_userdata;
 	pair->contact_added_callback(p_point_A, p_point_B);
 }
 
+static real_t _get_area_4_points(const Vector3 &p0, const Vector3 &p1, const Vector3 &p2, const Vector3 &p3) {
+	// Squared area of the quad, whatever the order of the points.
+	real_t a0 = (p0 - p1).cross(p2 - p3).length_squared();
+	real_t a1 = (p0 - p2).cross(p1 - p3).length_squared();
+	real_t a2 = (p0 - p3).cross(p1 - p2).length_squared();
+	return MAX(a0, MAX(a1, a2));
+}
+
 void BodyPairSW::contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B) {
 	// check if we already have the contact
 
@@ -78,29 +87,36 @@ void BodyPairSW::contact_added_callback(const Vector3 &p_point_A, const Vector3
 	contact.normal = (p_point_A - p_point_B).normalized();
 	contact.mass_normal = 0; // will be computed in setup()
 
-	// attempt to determine if the contact will be reused
+	// attempt to determine if the contact will be reused, matching the closest one
 	real_t contact_recycle_radius = space->get_contact_recycle_radius();
+	real_t min_distance = contact_recycle_radius * contact_recycle_radius;
 
 	for (int i = 0; i < contact_count; i++) {
 		Contact &c = contacts[i];
-		if (c.local_A.distance_squared_to(local_A) < (contact_recycle_radius * contact_recycle_radius) &&
-				c.local_B.distance_squared_to(local_B) < (contact_recycle_radius * contact_recycle_radius)) {
-			contact.acc_normal_impulse = c.acc_normal_impulse;
-			contact.acc_bias_impulse = c.acc_bias_impulse;
-			contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
-			contact.acc_tangent_impulse = c.acc_tangent_impulse;
+		real_t distance = MAX(c.local_A.distance_squared_to(local_A), c.local_B.distance_squared_to(local_B));
+		if (distance < min_distance) {
+			min_distance = distance;
 			new_index = i;
-			break;
 		}
 	}
 
+	if (new_index < contact_count) {
+		// warm start from the cached impulses, friction is kept on the new tangent plane
+		Contact &c = contacts[new_index];
+		contact.acc_normal_impulse = c.acc_normal_impulse;
+		contact.acc_bias_impulse = c.acc_bias_impulse;
+		contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+		contact.acc_tangent_impulse = c.acc_tangent_impulse - contact.normal * contact.normal.dot(c.acc_tangent_impulse);
+	}
+
 	// figure out if the contact amount must be reduced to fit the new contact
 
 	if (new_index == MAX_CONTACTS) {
-		// remove the contact with the minimum depth
+		// keep the deepest contact, then the ones spanning the largest area, which is what keeps stacks stable
 
-		int least_deep = -1;
-		real_t min_depth = 1e10;
+		Vector3 points[MAX_CONTACTS + 1];
+		int deepest = -1;
+		real_t max_depth = -1e10;
 
 		for (int i = 0; i <= contact_count; i++) {
 			Contact &c = (i == contact_count) ? contact : contacts[i];
@@ -110,17 +126,43 @@ void BodyPairSW::contact_added_callback(const Vector3 &p_point_A, const Vector3
 			Vector3 axis = global_A - global_B;
 			real_t depth = axis.dot(c.normal);
 
-			if (depth < min_depth) {
-				min_depth = depth;
-				least_deep = i;
+			if (depth > max_depth) {
+				max_depth = depth;
+				deepest = i;
+			}
+			points[i] = c.local_A;
+		}
+
+		ERR_FAIL_COND(deepest == -1);
+
+		int removed = -1;
+		real_t max_area = -1;
+
+		for (int i = 0; i <= contact_count; i++) {
+			if (i == deepest) {
+				continue;
+			}
+
+			Vector3 remaining[MAX_CONTACTS];
+			int remaining_count = 0;
+			for (int j = 0; j <= contact_count; j++) {
+				if (j != i) {
+					remaining[remaining_count++] = points[j];
+				}
+			}
+
+			real_t area = _get_area_4_points(remaining[0], remaining[1], remaining[2], remaining[3]);
+			if (area > max_area) {
+				max_area = area;
+				removed = i;
 			}
 		}
 
-		ERR_FAIL_COND(least_deep == -1);
+		ERR_FAIL_COND(removed == -1);
 
-		if (least_deep < contact_count) { //replace the last deep contact by the new one
+		if (removed < contact_count) { //replace the removed contact by the new one
 
-			contacts[least_deep] = contact;
+			contacts[removed] = contact;
 		}
 
 		return;
@@ -201,6 +243,38 @@ bool BodyPairSW::_test_ccd(real_t p_step, BodySW *p_A, int p_shape_A, const Tran
 	return true;
 }
 
+static real_t _get_max_displacement(const Transform &p_from, const Transform &p_to, const AABB &p_aabb) {
+	// Upper bound of how far any point of the box moved between both transforms.
+	Vector3 extents;
+	for (int i = 0; i < 3; i++) {
+		extents[i] = MAX(Math::abs(p_aabb.position[i]), Math::abs(p_aabb.position[i] + p_aabb.size[i]));
+	}
+
+	real_t displacement = (p_to.origin - p_from.origin).length();
+	for (int i = 0; i < 3; i++) {
+		displacement += (p_to.basis.get_axis(i) - p_from.basis.get_axis(i)).length() * extents[i];
+	}
+	return displacement;
+}
+
+bool BodyPairSW::_can_reuse_contacts(const Transform &p_xform_A, ShapeSW *p_shape_A, const Transform &p_xform_B, ShapeSW *p_shape_B) const {
+	if (!contact_cache.valid || !collided || contact_count == 0) {
+		return false;
+	}
+
+	if (p_shape_A != contact_cache.shape_A || p_shape_B != contact_cache.shape_B || p_shape_A->get_version() != contact_cache.version_A || p_shape_B->get_version() != contact_cache.version_B) {
+		return false;
+	}
+
+	// Resting bodies, or bodies about to sleep, barely move from one step to the next. As long as
+	// no point of either shape moved further than a fraction of the recycle radius, no contact can
+	// have appeared, and the cached ones are kept up to date through their local anchors.
+	real_t tolerance = space->get_contact_recycle_radius() * CONTACT_CACHE_TOLERANCE;
+
+	return _get_max_displacement(contact_cache.xform_A, p_xform_A, p_shape_A->get_aabb()) < tolerance &&
+			_get_max_displacement(contact_cache.xform_B, p_xform_B, p_shape_B->get_aabb()) < tolerance;
+}
+
 real_t combine_bounce(BodySW *A, BodySW *B) {
 	return CLAMP(A->get_bounce() + B->get_bounce(), 0, 1);
 }
@@ -213,6 +287,7 @@ bool BodyPairSW::setup(real_t p_step) {
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self())) {
 		collided = false;
+		contact_cache.valid = false;
 		return false;
 	}
 
@@ -222,6 +297,7 @@ bool BodyPairSW::setup(real_t p_step) {
 			report_contacts_only = true;
 		} else {
 			collided = false;
+			contact_cache.valid = false;
 			return false;
 		}
 	}
@@ -241,7 +317,20 @@ bool BodyPairSW::setup(real_t p_step) {
 	ShapeSW *shape_A_ptr = A->get_shape(shape_A);
 	ShapeSW *shape_B_ptr = B->get_shape(shape_B);
 
-	bool collided = CollisionSolverSW::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
+	bool collided = true;
+
+	if (!_can_reuse_contacts(xform_A, shape_A_ptr, xform_B, shape_B_ptr)) {
+		collided = CollisionSolverSW::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
+
+		contact_cache.valid = true;
+		contact_cache.xform_A = xform_A;
+		contact_cache.xform_B = xform_B;
+		contact_cache.shape_A = shape_A_ptr;
+		contact_cache.shape_B = shape_B_ptr;
+		contact_cache.version_A = shape_A_ptr->get_version();
+		contact_cache.version_B = shape_B_ptr->get_version();
+	}
+
 	this->collided = collided;
 
 	if (!collided) {
@@ -472,6 +561,7 @@ BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B) :
 	B->add_constraint(this, 1);
 	contact_count = 0;
 	collided = false;
+	contact_cache.valid = false;
 }
 
 BodyPairSW::~BodyPairSW() {
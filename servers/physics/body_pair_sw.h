@@ -76,11 +76,23 @@ class BodyPairSW : public ConstraintSW {
 	int contact_count;
 	bool collided;
 
+	// Transforms and shapes the contacts were last computed with, so resting pairs can skip collision detection.
+	struct ContactCache {
+		bool valid;
+		Transform xform_A;
+		Transform xform_B;
+		ShapeSW *shape_A;
+		ShapeSW *shape_B;
+		uint32_t version_A;
+		uint32_t version_B;
+	} contact_cache;
+
 	static void _contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B);
 
 	void validate_contacts();
+	bool _can_reuse_contacts(const Transform &p_xform_A, ShapeSW *p_shape_A, const Transform &p_xform_B, ShapeSW *p_shape_B) const;
 	bool _test_ccd(real_t p_step, BodySW *p_A, int p_shape_A, const Transform &p_xform_A, BodySW *p_B, int p_shape_B, const Transform &p_xform_B);
 
 	SpaceSW *space;
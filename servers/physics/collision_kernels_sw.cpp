@@ -0,0 +1,279 @@
+/*************************************************************************/
+/*  collision_kernels_sw.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "collision_kernels_sw.h"
+
+#if !defined(REAL_T_IS_DOUBLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define COLLISION_KERNELS_SSE2
+#include <emmintrin.h>
+#elif !defined(REAL_T_IS_DOUBLE) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define COLLISION_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+/* SCALAR */
+
+void CollisionKernelsSW::project_points_scalar(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal, real_t &r_min, real_t &r_max) {
+	real_t min = p_normal.x * p_x[0] + p_normal.y * p_y[0] + p_normal.z * p_z[0];
+	real_t max = min;
+
+	for (int i = 1; i < p_count; i++) {
+		real_t d = p_normal.x * p_x[i] + p_normal.y * p_y[i] + p_normal.z * p_z[i];
+		min = MIN(min, d);
+		max = MAX(max, d);
+	}
+
+	r_min = min;
+	r_max = max;
+}
+
+int CollisionKernelsSW::get_support_index_scalar(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal) {
+	int index = 0;
+	real_t max = p_normal.x * p_x[0] + p_normal.y * p_y[0] + p_normal.z * p_z[0];
+
+	for (int i = 1; i < p_count; i++) {
+		real_t d = p_normal.x * p_x[i] + p_normal.y * p_y[i] + p_normal.z * p_z[i];
+		if (d > max) {
+			max = d;
+			index = i;
+		}
+	}
+
+	return index;
+}
+
+void CollisionKernelsSW::project_box_scalar(const Transform &p_transform, const Vector3 &p_half_extents, const Vector3 *p_axes, int p_count, real_t *r_min, real_t *r_max) {
+	for (int i = 0; i < p_count; i++) {
+		// Same as BoxShapeSW::project_range().
+		Vector3 local_axis = p_transform.basis.xform_inv(p_axes[i]);
+		real_t length = local_axis.abs().dot(p_half_extents);
+		real_t distance = p_axes[i].dot(p_transform.origin);
+
+		r_min[i] = distance - length;
+		r_max[i] = distance + length;
+	}
+}
+
+/* SIMD */
+
+#if defined(COLLISION_KERNELS_SSE2)
+
+typedef __m128 simd_float;
+typedef __m128i simd_int;
+
+#define SIMD_SPLAT(m_v) _mm_set1_ps(m_v)
+#define SIMD_LOAD(m_ptr) _mm_loadu_ps(m_ptr)
+#define SIMD_STORE(m_ptr, m_v) _mm_storeu_ps(m_ptr, m_v)
+#define SIMD_SET(m_a, m_b, m_c, m_d) _mm_setr_ps(m_a, m_b, m_c, m_d)
+#define SIMD_ADD(m_a, m_b) _mm_add_ps(m_a, m_b)
+#define SIMD_SUB(m_a, m_b) _mm_sub_ps(m_a, m_b)
+#define SIMD_MUL(m_a, m_b) _mm_mul_ps(m_a, m_b)
+#define SIMD_MIN(m_a, m_b) _mm_min_ps(m_a, m_b)
+#define SIMD_MAX(m_a, m_b) _mm_max_ps(m_a, m_b)
+#define SIMD_ABS(m_a) _mm_andnot_ps(_mm_set1_ps(-0.0f), m_a)
+#define SIMD_INT_SPLAT(m_v) _mm_set1_epi32(m_v)
+#define SIMD_INT_SET(m_a, m_b, m_c, m_d) _mm_setr_epi32(m_a, m_b, m_c, m_d)
+#define SIMD_INT_ADD(m_a, m_b) _mm_add_epi32(m_a, m_b)
+#define SIMD_INT_STORE(m_ptr, m_v) _mm_storeu_si128((simd_int *)(m_ptr), m_v)
+
+// Per lane, takes the value of p_a where it is strictly greater than p_max, along with its index.
+static _FORCE_INLINE_ void _simd_select_greater(simd_float p_a, simd_int p_index, simd_float &r_max, simd_int &r_index) {
+	__m128 mask = _mm_cmpgt_ps(p_a, r_max);
+	__m128i imask = _mm_castps_si128(mask);
+	r_max = _mm_or_ps(_mm_and_ps(mask, p_a), _mm_andnot_ps(mask, r_max));
+	r_index = _mm_or_si128(_mm_and_si128(imask, p_index), _mm_andnot_si128(imask, r_index));
+}
+
+#elif defined(COLLISION_KERNELS_NEON)
+
+typedef float32x4_t simd_float;
+typedef int32x4_t simd_int;
+
+static _FORCE_INLINE_ simd_float _simd_set(float p_a, float p_b, float p_c, float p_d) {
+	float v[4] = { p_a, p_b, p_c, p_d };
+	return vld1q_f32(v);
+}
+
+static _FORCE_INLINE_ simd_int _simd_int_set(int32_t p_a, int32_t p_b, int32_t p_c, int32_t p_d) {
+	int32_t v[4] = { p_a, p_b, p_c, p_d };
+	return vld1q_s32(v);
+}
+
+#define SIMD_SPLAT(m_v) vdupq_n_f32(m_v)
+#define SIMD_LOAD(m_ptr) vld1q_f32(m_ptr)
+#define SIMD_STORE(m_ptr, m_v) vst1q_f32(m_ptr, m_v)
+#define SIMD_SET(m_a, m_b, m_c, m_d) _simd_set(m_a, m_b, m_c, m_d)
+#define SIMD_ADD(m_a, m_b) vaddq_f32(m_a, m_b)
+#define SIMD_SUB(m_a, m_b) vsubq_f32(m_a, m_b)
+#define SIMD_MUL(m_a, m_b) vmulq_f32(m_a, m_b)
+#define SIMD_MIN(m_a, m_b) vminq_f32(m_a, m_b)
+#define SIMD_MAX(m_a, m_b) vmaxq_f32(m_a, m_b)
+#define SIMD_ABS(m_a) vabsq_f32(m_a)
+#define SIMD_INT_SPLAT(m_v) vdupq_n_s32(m_v)
+#define SIMD_INT_SET(m_a, m_b, m_c, m_d) _simd_int_set(m_a, m_b, m_c, m_d)
+#define SIMD_INT_ADD(m_a, m_b) vaddq_s32(m_a, m_b)
+#define SIMD_INT_STORE(m_ptr, m_v) vst1q_s32(m_ptr, m_v)
+
+static _FORCE_INLINE_ void _simd_select_greater(simd_float p_a, simd_int p_index, simd_float &r_max, simd_int &r_index) {
+	uint32x4_t mask = vcgtq_f32(p_a, r_max);
+	r_max = vbslq_f32(mask, p_a, r_max);
+	r_index = vbslq_s32(mask, p_index, r_index);
+}
+
+#endif
+
+#if defined(COLLISION_KERNELS_SSE2) || defined(COLLISION_KERNELS_NEON)
+
+bool CollisionKernelsSW::is_simd_supported() {
+	return true;
+}
+
+void CollisionKernelsSW::project_points(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal, real_t &r_min, real_t &r_max) {
+	simd_float nx = SIMD_SPLAT(p_normal.x);
+	simd_float ny = SIMD_SPLAT(p_normal.y);
+	simd_float nz = SIMD_SPLAT(p_normal.z);
+
+	int padded_count = get_padded_count(p_count);
+
+	simd_float d = SIMD_ADD(SIMD_ADD(SIMD_MUL(nx, SIMD_LOAD(p_x)), SIMD_MUL(ny, SIMD_LOAD(p_y))), SIMD_MUL(nz, SIMD_LOAD(p_z)));
+	simd_float min = d;
+	simd_float max = d;
+
+	for (int i = LANES; i < padded_count; i += LANES) {
+		d = SIMD_ADD(SIMD_ADD(SIMD_MUL(nx, SIMD_LOAD(p_x + i)), SIMD_MUL(ny, SIMD_LOAD(p_y + i))), SIMD_MUL(nz, SIMD_LOAD(p_z + i)));
+		min = SIMD_MIN(min, d);
+		max = SIMD_MAX(max, d);
+	}
+
+	float mins[LANES];
+	float maxs[LANES];
+	SIMD_STORE(mins, min);
+	SIMD_STORE(maxs, max);
+
+	r_min = MIN(MIN(mins[0], mins[1]), MIN(mins[2], mins[3]));
+	r_max = MAX(MAX(maxs[0], maxs[1]), MAX(maxs[2], maxs[3]));
+}
+
+int CollisionKernelsSW::get_support_index(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal) {
+	simd_float nx = SIMD_SPLAT(p_normal.x);
+	simd_float ny = SIMD_SPLAT(p_normal.y);
+	simd_float nz = SIMD_SPLAT(p_normal.z);
+
+	int padded_count = get_padded_count(p_count);
+
+	simd_int index = SIMD_INT_SET(0, 1, 2, 3);
+	simd_int step = SIMD_INT_SPLAT(LANES);
+
+	simd_float max = SIMD_ADD(SIMD_ADD(SIMD_MUL(nx, SIMD_LOAD(p_x)), SIMD_MUL(ny, SIMD_LOAD(p_y))), SIMD_MUL(nz, SIMD_LOAD(p_z)));
+	simd_int max_index = index;
+
+	for (int i = LANES; i < padded_count; i += LANES) {
+		index = SIMD_INT_ADD(index, step);
+		simd_float d = SIMD_ADD(SIMD_ADD(SIMD_MUL(nx, SIMD_LOAD(p_x + i)), SIMD_MUL(ny, SIMD_LOAD(p_y + i))), SIMD_MUL(nz, SIMD_LOAD(p_z + i)));
+		_simd_select_greater(d, index, max, max_index);
+	}
+
+	float maxs[LANES];
+	int32_t indices[LANES];
+	SIMD_STORE(maxs, max);
+	SIMD_INT_STORE(indices, max_index);
+
+	// Each lane kept its first maximum, so the lowest index among the lanes matches the scalar version.
+	int lane = 0;
+	for (int i = 1; i < LANES; i++) {
+		if (maxs[i] > maxs[lane] || (maxs[i] == maxs[lane] && indices[i] < indices[lane])) {
+			lane = i;
+		}
+	}
+
+	return indices[lane] < p_count ? indices[lane] : 0;
+}
+
+void CollisionKernelsSW::project_box(const Transform &p_transform, const Vector3 &p_half_extents, const Vector3 *p_axes, int p_count, real_t *r_min, real_t *r_max) {
+	const Basis &basis = p_transform.basis;
+
+	// Basis::xform_inv() dots with the columns, i.e. the box axes.
+	simd_float c0x = SIMD_SPLAT(basis.elements[0][0]);
+	simd_float c0y = SIMD_SPLAT(basis.elements[1][0]);
+	simd_float c0z = SIMD_SPLAT(basis.elements[2][0]);
+	simd_float c1x = SIMD_SPLAT(basis.elements[0][1]);
+	simd_float c1y = SIMD_SPLAT(basis.elements[1][1]);
+	simd_float c1z = SIMD_SPLAT(basis.elements[2][1]);
+	simd_float c2x = SIMD_SPLAT(basis.elements[0][2]);
+	simd_float c2y = SIMD_SPLAT(basis.elements[1][2]);
+	simd_float c2z = SIMD_SPLAT(basis.elements[2][2]);
+	simd_float hx = SIMD_SPLAT(p_half_extents.x);
+	simd_float hy = SIMD_SPLAT(p_half_extents.y);
+	simd_float hz = SIMD_SPLAT(p_half_extents.z);
+	simd_float ox = SIMD_SPLAT(p_transform.origin.x);
+	simd_float oy = SIMD_SPLAT(p_transform.origin.y);
+	simd_float oz = SIMD_SPLAT(p_transform.origin.z);
+
+	int i = 0;
+	for (; i + LANES <= p_count; i += LANES) {
+		const Vector3 *a = p_axes + i;
+		simd_float ax = SIMD_SET(a[0].x, a[1].x, a[2].x, a[3].x);
+		simd_float ay = SIMD_SET(a[0].y, a[1].y, a[2].y, a[3].y);
+		simd_float az = SIMD_SET(a[0].z, a[1].z, a[2].z, a[3].z);
+
+		simd_float l0 = SIMD_ABS(SIMD_ADD(SIMD_ADD(SIMD_MUL(ax, c0x), SIMD_MUL(ay, c0y)), SIMD_MUL(az, c0z)));
+		simd_float l1 = SIMD_ABS(SIMD_ADD(SIMD_ADD(SIMD_MUL(ax, c1x), SIMD_MUL(ay, c1y)), SIMD_MUL(az, c1z)));
+		simd_float l2 = SIMD_ABS(SIMD_ADD(SIMD_ADD(SIMD_MUL(ax, c2x), SIMD_MUL(ay, c2y)), SIMD_MUL(az, c2z)));
+		simd_float length = SIMD_ADD(SIMD_ADD(SIMD_MUL(l0, hx), SIMD_MUL(l1, hy)), SIMD_MUL(l2, hz));
+		simd_float distance = SIMD_ADD(SIMD_ADD(SIMD_MUL(ax, ox), SIMD_MUL(ay, oy)), SIMD_MUL(az, oz));
+
+		SIMD_STORE(r_min + i, SIMD_SUB(distance, length));
+		SIMD_STORE(r_max + i, SIMD_ADD(distance, length));
+	}
+
+	if (i < p_count) {
+		project_box_scalar(p_transform, p_half_extents, p_axes + i, p_count - i, r_min + i, r_max + i);
+	}
+}
+
+#else
+
+bool CollisionKernelsSW::is_simd_supported() {
+	return false;
+}
+
+void CollisionKernelsSW::project_points(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal, real_t &r_min, real_t &r_max) {
+	project_points_scalar(p_x, p_y, p_z, p_count, p_normal, r_min, r_max);
+}
+
+int CollisionKernelsSW::get_support_index(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal) {
+	return get_support_index_scalar(p_x, p_y, p_z, p_count, p_normal);
+}
+
+void CollisionKernelsSW::project_box(const Transform &p_transform, const Vector3 &p_half_extents, const Vector3 *p_axes, int p_count, real_t *r_min, real_t *r_max) {
+	project_box_scalar(p_transform, p_half_extents, p_axes, p_count, r_min, r_max);
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*************************************************************************/
+/*  collision_kernels_sw.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef COLLISION_KERNELS_SW_H
+#define COLLISION_KERNELS_SW_H
+
+#include "core/math/transform.h"
+
+// Batched kernels for the hot loops of the collision solvers, with SSE2 and NEON versions
+// and a scalar fallback (always used with double precision real_t).
+//
+// Point sets are stored as separate x, y and z arrays, each holding get_padded_count() values.
+// The padding repeats the first point, so it never changes projections nor support indices.
+class CollisionKernelsSW {
+public:
+	enum {
+		LANES = 4,
+	};
+
+	static _FORCE_INLINE_ int get_padded_count(int p_count) { return (p_count + LANES - 1) & ~(LANES - 1); }
+
+	static bool is_simd_supported();
+
+	// Range of the points projected on p_normal.
+	static void project_points(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal, real_t &r_min, real_t &r_max);
+	// Index of the first point furthest along p_normal.
+	static int get_support_index(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal);
+	// Ranges of a box, given by its transform and half extents, projected on each of the axes.
+	static void project_box(const Transform &p_transform, const Vector3 &p_half_extents, const Vector3 *p_axes, int p_count, real_t *r_min, real_t *r_max);
+
+	// Scalar versions, also used for benchmarking and validating the above.
+	static void project_points_scalar(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal, real_t &r_min, real_t &r_max);
+	static int get_support_index_scalar(const real_t *p_x, const real_t *p_y, const real_t *p_z, int p_count, const Vector3 &p_normal);
+	static void project_box_scalar(const Transform &p_transform, const Vector3 &p_half_extents, const Vector3 *p_axes, int p_count, real_t *r_min, real_t *r_max);
+};
+
+#endif // COLLISION_KERNELS_SW_H
@@ -31,6 +31,7 @@
 #include "collision_solver_sat.h"
 #include "core/math/geometry.h"
 
+#include "collision_kernels_sw.h"
 #include "gjk_epa.h"
 
 #define fallback_collision_solver gjk_epa_calculate_penetration
@@ -641,6 +642,11 @@ public:
 		shape_A->project_range(axis, *transform_A, min_A, max_A);
 		shape_B->project_range(axis, *transform_B, min_B, max_B);
 
+		return test_axis_range(axis, min_A, max_A, min_B, max_B);
+	}
+
+	// Same as test_axis(), for shapes already projected on the axis (by a batched kernel).
+	_FORCE_INLINE_ bool test_axis_range(const Vector3 &axis, real_t min_A, real_t max_A, real_t min_B, real_t max_B) {
 		if (withMargin) {
 			min_A -= margin_A;
 			max_A += margin_A;
@@ -1033,6 +1039,14 @@ static void _collision_sphere_face(const ShapeSW *p_a, const Transform &p_transf
 	separator.generate_contacts();
 }
 
+static _FORCE_INLINE_ Vector3 _get_box_axis(const Vector3 &p_axis) {
+	// Same fallback as SeparatorAxisTest::test_axis(), for degenerate box transforms.
+	if (Math::abs(p_axis.x) < CMP_EPSILON && Math::abs(p_axis.y) < CMP_EPSILON && Math::abs(p_axis.z) < CMP_EPSILON) {
+		return Vector3(0.0, 1.0, 0.0);
+	}
+	return p_axis;
+}
+
 template <bool withMargin>
 static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_a, const ShapeSW *p_b, const Transform &p_transform_b, _CollectorCallback *p_collector, real_t p_margin_a, real_t p_margin_b) {
 	const BoxShapeSW *box_A = static_cast<const BoxShapeSW *>(p_a);
@@ -1044,27 +1058,29 @@ static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_
 		return;
 	}
 
-	// test faces of A
+	// Both boxes are projected on several axes at once, faces first as they separate most often.
+	Vector3 axes[9];
+	real_t min_A[9], max_A[9], min_B[9], max_B[9];
 
-	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_a.basis.get_axis(i).normalized();
+	// test faces of A and B
 
-		if (!separator.test_axis(axis)) {
-			return;
-		}
+	for (int i = 0; i < 3; i++) {
+		axes[i] = _get_box_axis(p_transform_a.basis.get_axis(i).normalized());
+		axes[i + 3] = _get_box_axis(p_transform_b.basis.get_axis(i).normalized());
 	}
 
-	// test faces of B
-
-	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_b.basis.get_axis(i).normalized();
+	CollisionKernelsSW::project_box(p_transform_a, box_A->get_half_extents(), axes, 6, min_A, max_A);
+	CollisionKernelsSW::project_box(p_transform_b, box_B->get_half_extents(), axes, 6, min_B, max_B);
 
-		if (!separator.test_axis(axis)) {
+	for (int i = 0; i < 6; i++) {
+		if (!separator.test_axis_range(axes[i], min_A[i], max_A[i], min_B[i], max_B[i])) {
 			return;
 		}
 	}
 
 	// test combined edges
+
+	int axis_count = 0;
 	for (int i = 0; i < 3; i++) {
 		for (int j = 0; j < 3; j++) {
 			Vector3 axis = p_transform_a.basis.get_axis(i).cross(p_transform_b.basis.get_axis(j));
@@ -1072,11 +1088,16 @@ static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_
 			if (Math::is_zero_approx(axis.length_squared())) {
 				continue;
 			}
-			axis.normalize();
+			axes[axis_count++] = axis.normalized();
+		}
+	}
 
-			if (!separator.test_axis(axis)) {
-				return;
-			}
+	CollisionKernelsSW::project_box(p_transform_a, box_A->get_half_extents(), axes, axis_count, min_A, max_A);
+	CollisionKernelsSW::project_box(p_transform_b, box_B->get_half_extents(), axes, axis_count, min_B, max_B);
+
+	for (int i = 0; i < axis_count; i++) {
+		if (!separator.test_axis_range(axes[i], min_A[i], max_A[i], min_B[i], max_B[i])) {
+			return;
 		}
 	}
 
@@ -2029,14 +2050,17 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a, const T
 		}
 	}
 
-	// A<->B edges
+	// A<->B edges, with the edges of B transformed only once
+	Vector3 *edge_dirs_B = (Vector3 *)alloca(sizeof(Vector3) * edge_count_B);
+	for (int j = 0; j < edge_count_B; j++) {
+		edge_dirs_B[j] = p_transform_b.basis.xform(vertices_B[edges_B[j].a] - vertices_B[edges_B[j].b]);
+	}
+
 	for (int i = 0; i < edge_count_A; i++) {
-		Vector3 e1 = p_transform_a.basis.xform(vertices_A[edges_A[i].a]) - p_transform_a.basis.xform(vertices_A[edges_A[i].b]);
+		Vector3 e1 = p_transform_a.basis.xform(vertices_A[edges_A[i].a] - vertices_A[edges_A[i].b]);
 
 		for (int j = 0; j < edge_count_B; j++) {
-			Vector3 e2 = p_transform_b.basis.xform(vertices_B[edges_B[j].a]) - p_transform_b.basis.xform(vertices_B[edges_B[j].b]);
-
-			Vector3 axis = e1.cross(e2).normalized();
+			Vector3 axis = e1.cross(edge_dirs_B[j]).normalized();
 
 			if (!separator.test_axis(axis)) {
 				return;
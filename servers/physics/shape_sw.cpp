@@ -30,6 +30,7 @@
 
 #include "shape_sw.h"
 
+#include "collision_kernels_sw.h"
 #include "core/image.h"
 #include "core/math/convex_hull.h"
 #include "core/math/geometry.h"
@@ -61,6 +62,7 @@ subject to the following restrictions:
 void ShapeSW::configure(const AABB &p_aabb) {
 	aabb = p_aabb;
 	configured = true;
+	version++;
 	for (Map<ShapeOwnerSW *, int>::Element *E = owners.front(); E; E = E->next()) {
 		ShapeOwnerSW *co = (ShapeOwnerSW *)E->key();
 		co->_shape_changed();
@@ -104,6 +106,7 @@ const Map<ShapeOwnerSW *, int> &ShapeSW::get_owners() const {
 ShapeSW::ShapeSW() {
 	custom_bias = 0;
 	configured = false;
+	version = 0;
 }
 
 ShapeSW::~ShapeSW() {
@@ -861,43 +864,25 @@ void ConvexPolygonShapeSW::project_range(const Vector3 &p_normal, const Transfor
 		return;
 	}
 
-	const Vector3 *vrts = &mesh.vertices[0];
+	// Project on the normal in local space instead of transforming every vertex.
+	Vector3 local_normal = p_transform.basis.xform_inv(p_normal);
+	real_t offset = p_normal.dot(p_transform.origin);
 
-	for (int i = 0; i < vertex_count; i++) {
-		real_t d = p_normal.dot(p_transform.xform(vrts[i]));
+	const real_t *vrts = kernel_vertices.ptr();
+	CollisionKernelsSW::project_points(vrts, vrts + kernel_stride, vrts + kernel_stride * 2, vertex_count, local_normal, r_min, r_max);
 
-		if (i == 0 || d > r_max) {
-			r_max = d;
-		}
-		if (i == 0 || d < r_min) {
-			r_min = d;
-		}
-	}
+	r_min += offset;
+	r_max += offset;
 }
 
 Vector3 ConvexPolygonShapeSW::get_support(const Vector3 &p_normal) const {
-	Vector3 n = p_normal;
-
-	int vert_support_idx = -1;
-	real_t support_max = 0;
-
 	int vertex_count = mesh.vertices.size();
 	if (vertex_count == 0) {
 		return Vector3();
 	}
 
-	const Vector3 *vrts = &mesh.vertices[0];
-
-	for (int i = 0; i < vertex_count; i++) {
-		real_t d = n.dot(vrts[i]);
-
-		if (i == 0 || d > support_max) {
-			support_max = d;
-			vert_support_idx = i;
-		}
-	}
-
-	return vrts[vert_support_idx];
+	const real_t *vrts = kernel_vertices.ptr();
+	return mesh.vertices[CollisionKernelsSW::get_support_index(vrts, vrts + kernel_stride, vrts + kernel_stride * 2, vertex_count, p_normal)];
 }
 
 void ConvexPolygonShapeSW::get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const {
@@ -1104,6 +1089,16 @@ void ConvexPolygonShapeSW::_setup(const Vector<Vector3> &p_vertices) {
 		}
 	}
 
+	int vertex_count = mesh.vertices.size();
+	kernel_stride = CollisionKernelsSW::get_padded_count(vertex_count);
+	kernel_vertices.resize(kernel_stride * 3);
+	for (int i = 0; i < kernel_stride; i++) {
+		const Vector3 &v = mesh.vertices[i < vertex_count ? i : 0];
+		kernel_vertices[i] = v.x;
+		kernel_vertices[kernel_stride + i] = v.y;
+		kernel_vertices[kernel_stride * 2 + i] = v.z;
+	}
+
 	configure(_aabb);
 }
 
@@ -1116,6 +1111,7 @@ Variant ConvexPolygonShapeSW::get_data() const {
 }
 
 ConvexPolygonShapeSW::ConvexPolygonShapeSW() {
+	kernel_stride = 0;
 }
 
 /********** FACE POLYGON *************/
@@ -62,6 +62,7 @@ class ShapeSW : public RID_Data {
 	AABB aabb;
 	bool configured;
 	real_t custom_bias;
+	uint32_t version;
 
 	Map<ShapeOwnerSW *, int> owners;
 
@@ -85,6 +86,7 @@ public:
 
 	_FORCE_INLINE_ const AABB &get_aabb() const { return aabb; }
 	_FORCE_INLINE_ bool is_configured() const { return configured; }
+	_FORCE_INLINE_ uint32_t get_version() const { return version; } // Changes whenever the shape data does.
 
 	virtual bool is_concave() const { return false; }
 
@@ -289,6 +291,9 @@ public:
 
 struct ConvexPolygonShapeSW : public ShapeSW {
 	Geometry::MeshData mesh;
+	// Vertices as separate x, y and z arrays, for CollisionKernelsSW.
+	LocalVector<real_t> kernel_vertices;
+	int kernel_stride;
 
 	void _setup(const Vector<Vector3> &p_vertices);
 
@@ -32,8 +32,10 @@
 #include "joints_sw.h"
 
 #include "core/os/os.h"
+#include "core/os/thread_work_pool.h"
+#include "core/project_settings.h"
 
-void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island) {
+void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island, bool &r_shared_contacts) {
 	p_body->set_island_step(_step);
 	p_body->set_island_next(*p_island);
 	*p_island = p_body;
@@ -44,18 +46,29 @@ void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **
 			continue; //already processed
 		}
 		c->set_island_step(_step);
+		if (c->get_body_count() == 0) {
+			// Area pairs have no bodies to solve, but update the monitoring state of an area that can be
+			// shared by several islands. Keep them on the physics thread.
+			c->set_island_next(nullptr);
+			serial_constraint_islands.push_back(c);
+			continue;
+		}
 		c->set_island_next(*p_constraint_island);
 		*p_constraint_island = c;
 
 		for (int i = 0; i < c->get_body_count(); i++) {
+			BodySW *b = c->get_body_ptr()[i];
+			if (b->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && b->can_report_contacts()) {
+				// Static and kinematic bodies may be part of several islands.
+				r_shared_contacts = true;
+			}
 			if (i == E->get()) {
 				continue;
 			}
-			BodySW *b = c->get_body_ptr()[i];
 			if (b->get_island_step() == _step || b->get_mode() == PhysicsServer::BODY_MODE_STATIC || b->get_mode() == PhysicsServer::BODY_MODE_KINEMATIC) {
 				continue; //no go
 			}
-			_populate_island(c->get_body_ptr()[i], p_island, p_constraint_island);
+			_populate_island(c->get_body_ptr()[i], p_island, p_constraint_island, r_shared_contacts);
 		}
 	}
 }
@@ -139,6 +152,14 @@ void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 	}
 }
 
+void StepSW::_setup_island_task(uint32_t p_index, void *p_userdata) {
+	_setup_island(constraint_islands[p_index], island_delta);
+}
+
+void StepSW::_solve_island_task(uint32_t p_index, void *p_userdata) {
+	_solve_island(constraint_islands[p_index], island_iterations, island_delta);
+}
+
 void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	p_space->lock(); // can't access space during this
 
@@ -174,7 +195,8 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	/* GENERATE CONSTRAINT ISLANDS */
 
 	BodySW *island_list = nullptr;
-	ConstraintSW *constraint_island_list = nullptr;
+	constraint_islands.clear();
+	serial_constraint_islands.clear();
 	b = body_list->first();
 
 	int island_count = 0;
@@ -185,14 +207,18 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 		if (body->get_island_step() != _step) {
 			BodySW *island = nullptr;
 			ConstraintSW *constraint_island = nullptr;
-			_populate_island(body, &island, &constraint_island);
+			bool shared_contacts = false;
+			_populate_island(body, &island, &constraint_island, shared_contacts);
 
 			island->set_island_list_next(island_list);
 			island_list = island;
 
 			if (constraint_island) {
-				constraint_island->set_island_list_next(constraint_island_list);
-				constraint_island_list = constraint_island;
+				if (shared_contacts) {
+					serial_constraint_islands.push_back(constraint_island);
+				} else {
+					constraint_islands.push_back(constraint_island);
+				}
 				island_count++;
 			}
 		}
@@ -211,8 +237,7 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 			}
 			c->set_island_step(_step);
 			c->set_island_next(nullptr);
-			c->set_island_list_next(constraint_island_list);
-			constraint_island_list = c;
+			serial_constraint_islands.push_back(c);
 		}
 		p_space->area_remove_from_moved_list((SelfList<AreaSW> *)aml.first()); //faster to remove here
 	}
@@ -225,13 +250,23 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
-		ConstraintSW *ci = constraint_island_list;
-		while (ci) {
-			_setup_island(ci, p_delta);
-			ci = ci->get_island_list_next();
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	// Debug contacts are written to an array shared by the whole space.
+	bool parallel = pool && pool->get_thread_count() > 0 && (max_threads < 0 || max_threads > 1) && constraint_islands.size() > 1 && !p_space->is_debugging_contacts();
+	uint32_t max_tasks = max_threads > 0 ? max_threads : 0;
+	island_delta = p_delta;
+	island_iterations = p_iterations;
+
+	if (parallel) {
+		pool->do_parallel_for(constraint_islands.size(), this, &StepSW::_setup_island_task, nullptr, 0, max_tasks);
+	} else {
+		for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+			_setup_island(constraint_islands[i], p_delta);
 		}
 	}
+	for (uint32_t i = 0; i < serial_constraint_islands.size(); i++) {
+		_setup_island(serial_constraint_islands[i], p_delta);
+	}
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -241,14 +276,17 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		ConstraintSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
+	//iterating each island separatedly improves cache efficiency
+	if (parallel) {
+		pool->do_parallel_for(constraint_islands.size(), this, &StepSW::_solve_island_task, nullptr, 0, max_tasks);
+	} else {
+		for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+			_solve_island(constraint_islands[i], p_iterations, p_delta);
 		}
 	}
+	for (uint32_t i = 0; i < serial_constraint_islands.size(); i++) {
+		_solve_island(serial_constraint_islands[i], p_iterations, p_delta);
+	}
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -287,4 +325,7 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 StepSW::StepSW() {
 	_step = 1;
+	max_threads = GLOBAL_GET("physics/3d/godot_physics/max_threads");
+	island_delta = 0;
+	island_iterations = 0;
 }
@@ -31,16 +31,28 @@
 #ifndef STEP_SW_H
 #define STEP_SW_H
 
+#include "core/local_vector.h"
 #include "space_sw.h"
 
 class StepSW {
 	uint64_t _step;
 
-	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island);
+	// Islands only touch their own bodies, so they are set up and solved on the worker pool.
+	// Areas and islands that report contacts to a shared static or kinematic body stay on the physics thread.
+	LocalVector<ConstraintSW *> constraint_islands;
+	LocalVector<ConstraintSW *> serial_constraint_islands;
+	int max_threads;
+	real_t island_delta;
+	int island_iterations;
+
+	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island, bool &r_shared_contacts);
 	void _setup_island(ConstraintSW *p_island, real_t p_delta);
 	void _solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta);
 	void _check_suspend(BodySW *p_island, real_t p_delta);
 
+	void _setup_island_task(uint32_t p_index, void *p_userdata);
+	void _solve_island_task(uint32_t p_index, void *p_userdata);
+
 public:
 	void step(SpaceSW *p_space, real_t p_delta, int p_iterations);
 	StepSW();
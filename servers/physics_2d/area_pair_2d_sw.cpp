@@ -31,11 +31,15 @@
 #include "area_pair_2d_sw.h"
 #include "collision_solver_2d_sw.h"
 
-bool AreaPair2DSW::setup(real_t p_step) {
-	bool result = false;
+void AreaPair2DSW::pre_setup(real_t p_step) {
+	has_collision = false;
 	if (area->test_collision_mask(body) && CollisionSolver2DSW::solve(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), Vector2(), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), Vector2(), nullptr, this)) {
-		result = true;
+		has_collision = true;
 	}
+}
+
+bool AreaPair2DSW::setup(real_t p_step) {
+	bool result = has_collision;
 
 	if (result != colliding) {
 		if (result) {
@@ -70,6 +74,7 @@ AreaPair2DSW::AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area,
 	body_shape = p_body_shape;
 	area_shape = p_area_shape;
 	colliding = false;
+	has_collision = false;
 	body->add_constraint(this, 0);
 	area->add_constraint(this);
 	if (p_body->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC) { //need to be active to process pair
@@ -92,11 +97,15 @@ AreaPair2DSW::~AreaPair2DSW() {
 
 //////////////////////////////////
 
-bool Area2Pair2DSW::setup(real_t p_step) {
-	bool result = false;
+void Area2Pair2DSW::pre_setup(real_t p_step) {
+	has_collision = false;
 	if (area_a->test_collision_mask(area_b) && CollisionSolver2DSW::solve(area_a->get_shape(shape_a), area_a->get_transform() * area_a->get_shape_transform(shape_a), Vector2(), area_b->get_shape(shape_b), area_b->get_transform() * area_b->get_shape_transform(shape_b), Vector2(), nullptr, this)) {
-		result = true;
+		has_collision = true;
 	}
+}
+
+bool Area2Pair2DSW::setup(real_t p_step) {
+	bool result = has_collision;
 
 	if (result != colliding) {
 		if (result) {
@@ -133,6 +142,7 @@ Area2Pair2DSW::Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area
 	shape_a = p_shape_a;
 	shape_b = p_shape_b;
 	colliding = false;
+	has_collision = false;
 	area_a->add_constraint(this);
 	area_b->add_constraint(this);
 }
@@ -41,8 +41,10 @@ class AreaPair2DSW : public Constraint2DSW {
 	int body_shape;
 	int area_shape;
 	bool colliding;
+	bool has_collision;
 
 public:
+	void pre_setup(real_t p_step);
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
@@ -56,8 +58,10 @@ class Area2Pair2DSW : public Constraint2DSW {
 	int shape_a;
 	int shape_b;
 	bool colliding;
+	bool has_collision;
 
 public:
+	void pre_setup(real_t p_step);
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
@@ -33,6 +33,7 @@
 
 #include "area_2d_sw.h"
 #include "collision_object_2d_sw.h"
+#include "core/os/spin_lock.h"
 #include "core/vset.h"
 
 class Constraint2DSW;
@@ -113,6 +114,8 @@ class Body2DSW : public CollisionObject2DSW {
 
 	Vector<Contact> contacts; //no contacts by default
 	int contact_count;
+	// Only used for static and kinematic bodies, which can get contacts from islands set up in parallel.
+	SpinLock contacts_lock;
 
 	struct ForceIntegrationCallback {
 		ObjectID id;
@@ -203,16 +206,27 @@ public:
 		linear_velocity += p_impulse * _inv_mass;
 	}
 
+	// Static and kinematic bodies have no inverse mass, so impulses never change them. Skipping the write
+	// matters because they can be shared by constraint islands solved at the same time on different threads.
 	_FORCE_INLINE_ void apply_impulse(const Vector2 &p_offset, const Vector2 &p_impulse) {
+		if (mode <= Physics2DServer::BODY_MODE_KINEMATIC) {
+			return;
+		}
 		linear_velocity += p_impulse * _inv_mass;
 		angular_velocity += _inv_inertia * p_offset.cross(p_impulse);
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(real_t p_torque) {
+		if (mode <= Physics2DServer::BODY_MODE_KINEMATIC) {
+			return;
+		}
 		angular_velocity += _inv_inertia * p_torque;
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector2 &p_pos, const Vector2 &p_j) {
+		if (mode <= Physics2DServer::BODY_MODE_KINEMATIC) {
+			return;
+		}
 		biased_linear_velocity += p_j * _inv_mass;
 		biased_angular_velocity += _inv_inertia * p_pos.cross(p_j);
 	}
@@ -304,6 +318,10 @@ void Body2DSW::add_contact(const Vector2 &p_local_pos, const Vector2 &p_local_no
 		return;
 	}
 
+	if (mode <= Physics2DServer::BODY_MODE_KINEMATIC) {
+		contacts_lock.lock();
+	}
+
 	Contact *c = contacts.ptrw();
 
 	int idx = -1;
@@ -324,6 +342,9 @@ void Body2DSW::add_contact(const Vector2 &p_local_pos, const Vector2 &p_local_no
 			idx = least_deep;
 		}
 		if (idx == -1) {
+			if (mode <= Physics2DServer::BODY_MODE_KINEMATIC) {
+				contacts_lock.unlock();
+			}
 			return; //none least deepe than this
 		}
 	}
@@ -337,6 +358,10 @@ void Body2DSW::add_contact(const Vector2 &p_local_pos, const Vector2 &p_local_no
 	c[idx].collider_instance_id = p_collider_instance_id;
 	c[idx].collider = p_collider;
 	c[idx].collider_velocity_at_pos = p_collider_velocity_at_pos;
+
+	if (mode <= Physics2DServer::BODY_MODE_KINEMATIC) {
+		contacts_lock.unlock();
+	}
 }
 
 class Physics2DDirectBodyStateSW : public Physics2DDirectBodyState {
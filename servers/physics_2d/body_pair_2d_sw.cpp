@@ -219,20 +219,24 @@ real_t combine_friction(Body2DSW *A, Body2DSW *B) {
 	return ABS(MIN(A->get_friction(), B->get_friction()));
 }
 
-bool BodyPair2DSW::setup(real_t p_step) {
+void BodyPair2DSW::pre_setup(real_t p_step) {
+	setup_skipped = false;
+
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self())) {
 		collided = false;
-		return false;
+		setup_skipped = true;
+		return;
 	}
 
-	bool report_contacts_only = false;
+	report_contacts_only = false;
 	if ((A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC) && (B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC)) {
 		if ((A->get_max_contacts_reported() > 0) || (B->get_max_contacts_reported() > 0)) {
 			report_contacts_only = true;
 		} else {
 			collided = false;
-			return false;
+			setup_skipped = true;
+			return;
 		}
 	}
 
@@ -241,13 +245,12 @@ bool BodyPair2DSW::setup(real_t p_step) {
 
 	_validate_contacts();
 
-	Vector2 offset_A = A->get_transform().get_origin();
-	Transform2D xform_Au = A->get_transform().untranslated();
-	Transform2D xform_A = xform_Au * A->get_shape_transform(shape_A);
+	xform_Au = A->get_transform().untranslated();
+	xform_A = xform_Au * A->get_shape_transform(shape_A);
 
-	Transform2D xform_Bu = B->get_transform();
+	xform_Bu = B->get_transform();
 	xform_Bu.elements[2] -= A->get_transform().get_origin();
-	Transform2D xform_B = xform_Bu * B->get_shape_transform(shape_B);
+	xform_B = xform_Bu * B->get_shape_transform(shape_B);
 
 	Shape2DSW *shape_A_ptr = A->get_shape(shape_A);
 	Shape2DSW *shape_B_ptr = B->get_shape(shape_B);
@@ -261,7 +264,7 @@ bool BodyPair2DSW::setup(real_t p_step) {
 		motion_B = B->get_motion();
 	}
 
-	bool prev_collided = collided;
+	prev_collided = collided;
 
 	collided = CollisionSolver2DSW::solve(shape_A_ptr, xform_A, motion_A, shape_B_ptr, xform_B, motion_B, _add_contact, this, &sep_axis);
 	if (!collided) {
@@ -278,13 +281,24 @@ bool BodyPair2DSW::setup(real_t p_step) {
 				collided = true;
 			}
 		}
+	}
+}
 
-		if (!collided) {
-			oneway_disabled = false;
-			return false;
-		}
+bool BodyPair2DSW::setup(real_t p_step) {
+	if (setup_skipped) {
+		return false;
 	}
 
+	if (!collided) {
+		oneway_disabled = false;
+		return false;
+	}
+
+	Vector2 offset_A = A->get_transform().get_origin();
+
+	Shape2DSW *shape_A_ptr = A->get_shape(shape_A);
+	Shape2DSW *shape_B_ptr = B->get_shape(shape_B);
+
 	if (oneway_disabled) {
 		return false;
 	}
@@ -501,6 +515,9 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	B->add_constraint(this, 1);
 	contact_count = 0;
 	collided = false;
+	prev_collided = false;
+	report_contacts_only = false;
+	setup_skipped = true;
 	oneway_disabled = false;
 }
 
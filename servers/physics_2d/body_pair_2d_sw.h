@@ -71,6 +71,13 @@ class BodyPair2DSW : public Constraint2DSW {
 
 	Vector2 offset_B; //use local A coordinates to avoid numerical issues on collision detection
 
+	// Collision detection results from pre_setup(), consumed by setup().
+	Transform2D xform_Au, xform_A;
+	Transform2D xform_Bu, xform_B;
+	bool prev_collided;
+	bool report_contacts_only;
+	bool setup_skipped;
+
 	Vector2 sep_axis;
 	Contact contacts[MAX_CONTACTS];
 	int contact_count;
@@ -84,6 +91,7 @@ class BodyPair2DSW : public Constraint2DSW {
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
 
 public:
+	void pre_setup(real_t p_step);
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
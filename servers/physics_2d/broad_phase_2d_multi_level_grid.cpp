@@ -0,0 +1,505 @@
+/*************************************************************************/
+/*  broad_phase_2d_multi_level_grid.cpp                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "broad_phase_2d_multi_level_grid.h"
+#include "collision_object_2d_sw.h"
+#include "core/project_settings.h"
+
+void BroadPhase2DMultiLevelGrid::_get_cells(int p_level, const Rect2 &p_aabb, Point2i &r_from, Point2i &r_to) const {
+	// Divide by the base cell size first, then only scale by a power of two, so the cells
+	// of a coarser level always contain the cells of the finer ones.
+	real_t scale = levels[p_level].scale;
+	Vector2 from = p_aabb.position / cell_size;
+	Vector2 to = (p_aabb.position + p_aabb.size) / cell_size;
+	r_from = Point2i(Math::floor(from.x * scale), Math::floor(from.y * scale));
+	r_to = Point2i(Math::floor(to.x * scale), Math::floor(to.y * scale));
+}
+
+int BroadPhase2DMultiLevelGrid::_find_level(const Rect2 &p_aabb, Point2i &r_from, Point2i &r_to) const {
+	real_t extent = MAX(p_aabb.size.width, p_aabb.size.height);
+
+	int level = 0;
+	while (level < (int)levels.size() - 1 && extent > levels[level].cell_size) {
+		level++;
+	}
+
+	_get_cells(level, p_aabb, r_from, r_to);
+
+	if (extent > levels[level].cell_size) {
+		int64_t cells = int64_t(r_to.x - r_from.x + 1) * int64_t(r_to.y - r_from.y + 1);
+		if (cells > large_object_min_surface) {
+			return LEVEL_LARGE;
+		}
+	}
+
+	return level;
+}
+
+void BroadPhase2DMultiLevelGrid::_enter_grid(ID p_id, Element &p_elem) {
+	if (p_elem.aabb == Rect2()) {
+		p_elem.level = LEVEL_NONE;
+		return;
+	}
+
+	p_elem.level = _find_level(p_elem.aabb, p_elem.cell_from, p_elem.cell_to);
+
+	if (p_elem.level == LEVEL_LARGE) {
+		p_elem.level_index = large_elements.size();
+		large_elements.push_back(p_id);
+		return;
+	}
+
+	Level &level = levels[p_elem.level];
+	p_elem.level_index = level.elements.size();
+	level.elements.push_back(p_id);
+
+	for (int i = p_elem.cell_from.x; i <= p_elem.cell_to.x; i++) {
+		for (int j = p_elem.cell_from.y; j <= p_elem.cell_to.y; j++) {
+			level.cells[_get_cell_key(i, j)].elements.push_back(p_id);
+		}
+	}
+
+	for (uint32_t k = p_elem.level + 1; k < levels.size(); k++) {
+		Point2i from, to;
+		_get_cells(k, p_elem.aabb, from, to);
+		for (int i = from.x; i <= to.x; i++) {
+			for (int j = from.y; j <= to.y; j++) {
+				levels[k].cells[_get_cell_key(i, j)].guests.push_back(p_id);
+			}
+		}
+	}
+}
+
+void BroadPhase2DMultiLevelGrid::_exit_grid(ID p_id, Element &p_elem) {
+	if (p_elem.level == LEVEL_NONE) {
+		return;
+	}
+
+	LocalVector<ID> &list = p_elem.level == LEVEL_LARGE ? large_elements : levels[p_elem.level].elements;
+	uint32_t last = list.size() - 1;
+	if (p_elem.level_index != last) {
+		list[p_elem.level_index] = list[last];
+		_get_element(list[last]).level_index = p_elem.level_index;
+	}
+	list.resize(last);
+
+	if (p_elem.level == LEVEL_LARGE) {
+		p_elem.level = LEVEL_NONE;
+		return;
+	}
+
+	Level &level = levels[p_elem.level];
+	for (int i = p_elem.cell_from.x; i <= p_elem.cell_to.x; i++) {
+		for (int j = p_elem.cell_from.y; j <= p_elem.cell_to.y; j++) {
+			uint64_t key = _get_cell_key(i, j);
+			Cell *cell = level.cells.getptr(key);
+			ERR_CONTINUE(!cell);
+			cell->elements.erase(p_id);
+			if (cell->elements.empty() && cell->guests.empty()) {
+				level.cells.erase(key);
+			}
+		}
+	}
+
+	for (uint32_t k = p_elem.level + 1; k < levels.size(); k++) {
+		Point2i from, to;
+		_get_cells(k, p_elem.aabb, from, to);
+		for (int i = from.x; i <= to.x; i++) {
+			for (int j = from.y; j <= to.y; j++) {
+				uint64_t key = _get_cell_key(i, j);
+				Cell *cell = levels[k].cells.getptr(key);
+				ERR_CONTINUE(!cell);
+				cell->guests.erase(p_id);
+				if (cell->elements.empty() && cell->guests.empty()) {
+					levels[k].cells.erase(key);
+				}
+			}
+		}
+	}
+
+	p_elem.level = LEVEL_NONE;
+}
+
+void BroadPhase2DMultiLevelGrid::_mark_dirty(ID p_id, Element &p_elem) {
+	if (!p_elem.dirty) {
+		p_elem.dirty = true;
+		dirty_elements.push_back(p_id);
+	}
+}
+
+void BroadPhase2DMultiLevelGrid::_pair(ID p_id, Element &p_elem, ID p_with, Element &p_with_elem) {
+	Pair pair;
+	pair.ud = nullptr;
+	if (pair_callback) {
+		pair.ud = pair_callback(p_elem.owner, p_elem.subindex, p_with_elem.owner, p_with_elem.subindex, nullptr, pair_userdata);
+	}
+
+	pair_map.set(_get_pair_key(p_id, p_with), pair);
+	p_elem.pairs.push_back(p_with);
+	p_with_elem.pairs.push_back(p_id);
+}
+
+void BroadPhase2DMultiLevelGrid::_unpair(ID p_id, Element &p_elem, ID p_with, Element &p_with_elem) {
+	uint64_t key = _get_pair_key(p_id, p_with);
+	Pair *pair = pair_map.getptr(key);
+	ERR_FAIL_COND(!pair);
+
+	if (unpair_callback) {
+		unpair_callback(p_elem.owner, p_elem.subindex, p_with_elem.owner, p_with_elem.subindex, pair->ud, unpair_userdata);
+	}
+
+	pair_map.erase(key);
+	p_elem.pairs.erase(p_with);
+	p_with_elem.pairs.erase(p_id);
+}
+
+void BroadPhase2DMultiLevelGrid::_test_overlap(ID p_id, Element &p_elem, ID p_with) {
+	Element &with = _get_element(p_with);
+	if (with.pass == pass) {
+		return; // Already tested, or itself.
+	}
+	with.pass = pass;
+
+	if (with.owner == p_elem.owner || (with._static && p_elem._static) || !p_elem.aabb.intersects(with.aabb)) {
+		return;
+	}
+
+	with.overlap_pass = pass;
+	if (!pair_map.has(_get_pair_key(p_id, p_with))) {
+		_pair(p_id, p_elem, p_with, with);
+	}
+}
+
+void BroadPhase2DMultiLevelGrid::_update_pairs(ID p_id, Element &p_elem) {
+	pass++;
+	p_elem.pass = pass;
+
+	if (p_elem.level == LEVEL_LARGE) {
+		for (uint32_t k = 0; k < levels.size(); k++) {
+			for (uint32_t i = 0; i < levels[k].elements.size(); i++) {
+				_test_overlap(p_id, p_elem, levels[k].elements[i]);
+			}
+		}
+	} else if (p_elem.level != LEVEL_NONE) {
+		// Same or coarser elements share a cell in their own level, finer ones are guests in this one.
+		for (uint32_t k = p_elem.level; k < levels.size(); k++) {
+			Point2i from = p_elem.cell_from;
+			Point2i to = p_elem.cell_to;
+			if (k != (uint32_t)p_elem.level) {
+				_get_cells(k, p_elem.aabb, from, to);
+			}
+
+			for (int i = from.x; i <= to.x; i++) {
+				for (int j = from.y; j <= to.y; j++) {
+					const Cell *cell = levels[k].cells.getptr(_get_cell_key(i, j));
+					if (!cell) {
+						continue;
+					}
+					for (uint32_t e = 0; e < cell->elements.size(); e++) {
+						_test_overlap(p_id, p_elem, cell->elements[e]);
+					}
+					if (k == (uint32_t)p_elem.level) {
+						for (uint32_t e = 0; e < cell->guests.size(); e++) {
+							_test_overlap(p_id, p_elem, cell->guests[e]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (p_elem.level != LEVEL_NONE) {
+		for (uint32_t i = 0; i < large_elements.size(); i++) {
+			_test_overlap(p_id, p_elem, large_elements[i]);
+		}
+	}
+
+	// Whatever was not found overlapping now is unpaired, backwards as unpairing swaps the last pair in.
+	for (int i = (int)p_elem.pairs.size() - 1; i >= 0; i--) {
+		ID with = p_elem.pairs[i];
+		Element &with_elem = _get_element(with);
+		if (with_elem.overlap_pass != pass) {
+			_unpair(p_id, p_elem, with, with_elem);
+		}
+	}
+}
+
+BroadPhase2DSW::ID BroadPhase2DMultiLevelGrid::create(CollisionObject2DSW *p_object, int p_subindex, const Rect2 &p_aabb, bool p_static) {
+	ID id;
+	if (free_ids.size()) {
+		id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+	} else {
+		elements.push_back(Element());
+		id = elements.size();
+	}
+
+	Element &e = _get_element(id);
+	e.owner = p_object;
+	e.subindex = p_subindex;
+	e._static = p_static;
+	e.dirty = false;
+	e.level = LEVEL_NONE;
+	e.aabb = p_aabb;
+	e.level_index = 0;
+	e.pass = 0;
+	e.overlap_pass = 0;
+	e.pairs.clear();
+
+	_enter_grid(id, e);
+	_mark_dirty(id, e);
+
+	return id;
+}
+
+void BroadPhase2DMultiLevelGrid::move(ID p_id, const Rect2 &p_aabb) {
+	ERR_FAIL_COND(p_id == 0 || p_id > elements.size());
+	Element &e = _get_element(p_id);
+	ERR_FAIL_COND(!e.owner);
+
+	if (p_aabb == e.aabb) {
+		return;
+	}
+
+	Point2i from, to;
+	int level = p_aabb == Rect2() ? int(LEVEL_NONE) : _find_level(p_aabb, from, to);
+
+	if (level != e.level || level == LEVEL_LARGE || (level != LEVEL_NONE && (from != e.cell_from || to != e.cell_to))) {
+		_exit_grid(p_id, e);
+		e.aabb = p_aabb;
+		_enter_grid(p_id, e);
+	} else {
+		// Still in the same cells, the usual case for small motions.
+		e.aabb = p_aabb;
+	}
+
+	_mark_dirty(p_id, e);
+}
+
+void BroadPhase2DMultiLevelGrid::recheck_pairs(ID p_id) {
+	ERR_FAIL_COND(p_id == 0 || p_id > elements.size());
+	Element &e = _get_element(p_id);
+	ERR_FAIL_COND(!e.owner);
+
+	if (!pair_callback) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < e.pairs.size(); i++) {
+		Element &with = _get_element(e.pairs[i]);
+		Pair *pair = pair_map.getptr(_get_pair_key(p_id, e.pairs[i]));
+		ERR_CONTINUE(!pair);
+		pair->ud = pair_callback(e.owner, e.subindex, with.owner, with.subindex, pair->ud, pair_userdata);
+	}
+}
+
+void BroadPhase2DMultiLevelGrid::set_static(ID p_id, bool p_static) {
+	ERR_FAIL_COND(p_id == 0 || p_id > elements.size());
+	Element &e = _get_element(p_id);
+	ERR_FAIL_COND(!e.owner);
+
+	if (e._static == p_static) {
+		return;
+	}
+
+	e._static = p_static;
+	_mark_dirty(p_id, e);
+}
+
+void BroadPhase2DMultiLevelGrid::remove(ID p_id) {
+	ERR_FAIL_COND(p_id == 0 || p_id > elements.size());
+	Element &e = _get_element(p_id);
+	ERR_FAIL_COND(!e.owner);
+
+	_exit_grid(p_id, e);
+
+	while (e.pairs.size()) {
+		ID with = e.pairs[e.pairs.size() - 1];
+		_unpair(p_id, e, with, _get_element(with));
+	}
+
+	e.owner = nullptr;
+	e.dirty = false; // Left in the dirty list, skipped.
+	free_ids.push_back(p_id);
+}
+
+CollisionObject2DSW *BroadPhase2DMultiLevelGrid::get_object(ID p_id) const {
+	ERR_FAIL_COND_V(p_id == 0 || p_id > elements.size(), nullptr);
+	return _get_element(p_id).owner;
+}
+
+bool BroadPhase2DMultiLevelGrid::is_static(ID p_id) const {
+	ERR_FAIL_COND_V(p_id == 0 || p_id > elements.size(), false);
+	return _get_element(p_id)._static;
+}
+
+int BroadPhase2DMultiLevelGrid::get_subindex(ID p_id) const {
+	ERR_FAIL_COND_V(p_id == 0 || p_id > elements.size(), -1);
+	return _get_element(p_id).subindex;
+}
+
+bool BroadPhase2DMultiLevelGrid::_cull_element(const Element &p_elem, const Rect2 &p_aabb, const Vector2 &p_from, const Vector2 &p_to, bool p_segment) const {
+	if (!p_aabb.intersects(p_elem.aabb)) {
+		return false;
+	}
+	return !p_segment || p_elem.aabb.intersects_segment(p_from, p_to);
+}
+
+int BroadPhase2DMultiLevelGrid::_cull(const Rect2 &p_aabb, const Vector2 &p_from, const Vector2 &p_to, bool p_segment, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
+	pass++;
+	int count = 0;
+
+#define CULL_ELEMENT(m_id)                                                    \
+	{                                                                         \
+		Element &e = _get_element(m_id);                                      \
+		if (e.pass != pass) {                                                 \
+			e.pass = pass;                                                    \
+			if (_cull_element(e, p_aabb, p_from, p_to, p_segment)) {          \
+				p_results[count] = e.owner;                                   \
+				if (p_result_indices) {                                       \
+					p_result_indices[count] = e.subindex;                     \
+				}                                                             \
+				if (++count >= p_max_results) {                               \
+					return count;                                             \
+				}                                                             \
+			}                                                                 \
+		}                                                                     \
+	}
+
+	for (uint32_t k = 0; k < levels.size(); k++) {
+		const Level &level = levels[k];
+		if (level.elements.empty()) {
+			continue;
+		}
+
+		Point2i from, to;
+		_get_cells(k, p_aabb, from, to);
+
+		int64_t cells = int64_t(to.x - from.x + 1) * int64_t(to.y - from.y + 1);
+		if (cells > (int64_t)level.elements.size()) {
+			// Large query on a sparse level, faster to test everything.
+			for (uint32_t i = 0; i < level.elements.size(); i++) {
+				CULL_ELEMENT(level.elements[i]);
+			}
+			continue;
+		}
+
+		for (int i = from.x; i <= to.x; i++) {
+			for (int j = from.y; j <= to.y; j++) {
+				const Cell *cell = level.cells.getptr(_get_cell_key(i, j));
+				if (!cell) {
+					continue;
+				}
+				for (uint32_t n = 0; n < cell->elements.size(); n++) {
+					CULL_ELEMENT(cell->elements[n]);
+				}
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < large_elements.size(); i++) {
+		CULL_ELEMENT(large_elements[i]);
+	}
+
+#undef CULL_ELEMENT
+
+	return count;
+}
+
+int BroadPhase2DMultiLevelGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
+	if (p_max_results <= 0) {
+		return 0;
+	}
+
+	Rect2 aabb(p_from, Vector2());
+	aabb.expand_to(p_to);
+	return _cull(aabb, p_from, p_to, true, p_results, p_max_results, p_result_indices);
+}
+
+int BroadPhase2DMultiLevelGrid::cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
+	if (p_max_results <= 0) {
+		return 0;
+	}
+
+	return _cull(p_aabb, Vector2(), Vector2(), false, p_results, p_max_results, p_result_indices);
+}
+
+void BroadPhase2DMultiLevelGrid::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void BroadPhase2DMultiLevelGrid::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void BroadPhase2DMultiLevelGrid::update() {
+	// Pairs are only updated for elements that moved or changed since the last update.
+	for (uint32_t i = 0; i < dirty_elements.size(); i++) {
+		ID id = dirty_elements[i];
+		Element &e = _get_element(id);
+		if (!e.owner || !e.dirty) {
+			continue; // Removed meanwhile.
+		}
+		e.dirty = false;
+		_update_pairs(id, e);
+	}
+
+	dirty_elements.clear();
+}
+
+BroadPhase2DSW *BroadPhase2DMultiLevelGrid::_create() {
+	return memnew(BroadPhase2DMultiLevelGrid(GLOBAL_GET("physics/2d/hash_grid_levels"), GLOBAL_GET("physics/2d/cell_size"), GLOBAL_GET("physics/2d/large_object_surface_threshold_in_cells")));
+}
+
+BroadPhase2DMultiLevelGrid::BroadPhase2DMultiLevelGrid(int p_levels, real_t p_cell_size, int p_large_object_min_surface) {
+	ERR_FAIL_COND(p_cell_size <= 0);
+
+	cell_size = p_cell_size;
+	large_object_min_surface = p_large_object_min_surface;
+
+	levels.resize(CLAMP(p_levels, 1, 8));
+	real_t scale = 1.0;
+	for (uint32_t i = 0; i < levels.size(); i++) {
+		levels[i].cell_size = cell_size / scale;
+		levels[i].scale = scale;
+		scale /= LEVEL_RATIO;
+	}
+
+	pass = 1;
+	pair_callback = nullptr;
+	pair_userdata = nullptr;
+	unpair_callback = nullptr;
+	unpair_userdata = nullptr;
+}
+
+BroadPhase2DMultiLevelGrid::~BroadPhase2DMultiLevelGrid() {
+}
@@ -0,0 +1,144 @@
+/*************************************************************************/
+/*  broad_phase_2d_multi_level_grid.h                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BROAD_PHASE_2D_MULTI_LEVEL_GRID_H
+#define BROAD_PHASE_2D_MULTI_LEVEL_GRID_H
+
+#include "broad_phase_2d_sw.h"
+#include "core/hash_map.h"
+#include "core/local_vector.h"
+
+// Hierarchical hash grid: every element is placed in the level whose cells are
+// just large enough to hold it, so it always overlaps at most 2x2 cells there.
+// Cells of each level are LEVEL_RATIO times larger than those of the previous one.
+class BroadPhase2DMultiLevelGrid : public BroadPhase2DSW {
+	enum {
+		LEVEL_RATIO = 4,
+		LEVEL_NONE = -1, // Empty AABB, not in the grid.
+		LEVEL_LARGE = -2, // Too large even for the top level, checked against everything.
+	};
+
+	struct Element {
+		CollisionObject2DSW *owner; // nullptr when the slot is free.
+		int subindex;
+		bool _static;
+		bool dirty;
+		int level;
+		Rect2 aabb;
+		Point2i cell_from; // Cells covered in its own level.
+		Point2i cell_to;
+		uint32_t level_index;
+		uint64_t pass;
+		uint64_t overlap_pass;
+		LocalVector<ID> pairs;
+	};
+
+	struct Cell {
+		LocalVector<ID> elements; // Elements of this level.
+		LocalVector<ID> guests; // Elements of finer levels, so coarser ones can find them.
+	};
+
+	struct Level {
+		real_t cell_size;
+		real_t scale; // Power of two, so cells of every level are computed consistently.
+		HashMap<uint64_t, Cell> cells;
+		LocalVector<ID> elements;
+	};
+
+	struct Pair {
+		void *ud;
+	};
+
+	LocalVector<Element> elements; // Indexed by ID - 1.
+	LocalVector<ID> free_ids;
+	LocalVector<Level> levels;
+	LocalVector<ID> large_elements;
+	LocalVector<ID> dirty_elements;
+	HashMap<uint64_t, Pair> pair_map;
+
+	uint64_t pass;
+	real_t cell_size;
+	int large_object_min_surface;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+	static _FORCE_INLINE_ uint64_t _get_pair_key(ID p_a, ID p_b) {
+		return p_a < p_b ? ((uint64_t(p_a) << 32) | p_b) : ((uint64_t(p_b) << 32) | p_a);
+	}
+	static _FORCE_INLINE_ uint64_t _get_cell_key(int p_x, int p_y) {
+		return (uint64_t(uint32_t(p_x)) << 32) | uint32_t(p_y);
+	}
+
+	_FORCE_INLINE_ Element &_get_element(ID p_id) { return elements[p_id - 1]; }
+	_FORCE_INLINE_ const Element &_get_element(ID p_id) const { return elements[p_id - 1]; }
+
+	void _get_cells(int p_level, const Rect2 &p_aabb, Point2i &r_from, Point2i &r_to) const;
+	int _find_level(const Rect2 &p_aabb, Point2i &r_from, Point2i &r_to) const;
+	void _enter_grid(ID p_id, Element &p_elem);
+	void _exit_grid(ID p_id, Element &p_elem);
+	void _mark_dirty(ID p_id, Element &p_elem);
+
+	void _pair(ID p_id, Element &p_elem, ID p_with, Element &p_with_elem);
+	void _unpair(ID p_id, Element &p_elem, ID p_with, Element &p_with_elem);
+	_FORCE_INLINE_ void _test_overlap(ID p_id, Element &p_elem, ID p_with);
+	void _update_pairs(ID p_id, Element &p_elem);
+
+	_FORCE_INLINE_ bool _cull_element(const Element &p_elem, const Rect2 &p_aabb, const Vector2 &p_from, const Vector2 &p_to, bool p_segment) const;
+	int _cull(const Rect2 &p_aabb, const Vector2 &p_from, const Vector2 &p_to, bool p_segment, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices);
+
+public:
+	virtual ID create(CollisionObject2DSW *p_object, int p_subindex = 0, const Rect2 &p_aabb = Rect2(), bool p_static = false);
+	virtual void move(ID p_id, const Rect2 &p_aabb);
+	virtual void recheck_pairs(ID p_id);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObject2DSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices = nullptr);
+	virtual int cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices = nullptr);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update();
+
+	static BroadPhase2DSW *_create();
+
+	BroadPhase2DMultiLevelGrid(int p_levels = 4, real_t p_cell_size = 128, int p_large_object_min_surface = 512);
+	~BroadPhase2DMultiLevelGrid();
+};
+
+#endif // BROAD_PHASE_2D_MULTI_LEVEL_GRID_H
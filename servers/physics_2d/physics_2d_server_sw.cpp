@@ -32,6 +32,7 @@
 #include "broad_phase_2d_basic.h"
 #include "broad_phase_2d_bvh.h"
 #include "broad_phase_2d_hash_grid.h"
+#include "broad_phase_2d_multi_level_grid.h"
 #include "collision_solver_2d_sw.h"
 #include "core/os/os.h"
 #include "core/project_settings.h"
@@ -1325,13 +1326,20 @@ Physics2DServerSW::Physics2DServerSW() {
 	GLOBAL_DEF("physics/2d/bp_hash_table_size", 4096);
 	GLOBAL_DEF("physics/2d/cell_size", 128);
 	GLOBAL_DEF("physics/2d/large_object_surface_threshold_in_cells", 512);
+	GLOBAL_DEF("physics/2d/hash_grid_levels", 1);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/hash_grid_levels", PropertyInfo(Variant::INT, "physics/2d/hash_grid_levels", PROPERTY_HINT_RANGE, "1,8,1"));
 	GLOBAL_DEF("physics/2d/bvh_collision_margin", 1.0);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/bvh_collision_margin", PropertyInfo(Variant::REAL, "physics/2d/bvh_collision_margin", PROPERTY_HINT_RANGE, "0.0,20.0,0.1"));
+	GLOBAL_DEF("physics/2d/max_threads", -1);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/max_threads", PropertyInfo(Variant::INT, "physics/2d/max_threads", PROPERTY_HINT_RANGE, "-1,256,1,or_greater"));
+	GLOBAL_DEF("physics/2d/deterministic", true);
 
 	bool use_bvh = GLOBAL_GET("physics/2d/use_bvh");
 
 	if (use_bvh) {
 		BroadPhase2DSW::create_func = BroadPhase2DBVH::_create;
+	} else if (int(GLOBAL_GET("physics/2d/hash_grid_levels")) > 1) {
+		BroadPhase2DSW::create_func = BroadPhase2DMultiLevelGrid::_create;
 	} else {
 		BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
 	}
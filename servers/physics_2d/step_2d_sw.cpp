@@ -30,8 +30,10 @@
 
 #include "step_2d_sw.h"
 #include "core/os/os.h"
+#include "core/os/thread_work_pool.h"
+#include "core/project_settings.h"
 
-void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
+void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island, bool &r_shared_contacts) {
 	p_body->set_island_step(_step);
 	p_body->set_island_next(*p_island);
 	*p_island = p_body;
@@ -42,6 +44,13 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 			continue; //already processed
 		}
 		c->set_island_step(_step);
+		if (c->get_body_count() == 0) {
+			// Area pairs have no bodies to solve, but update the monitoring state of an area that can be
+			// shared by several islands. Keep them on the physics thread.
+			c->set_island_next(nullptr);
+			serial_constraint_islands.push_back(c);
+			continue;
+		}
 		c->set_island_next(*p_constraint_island);
 		*p_constraint_island = c;
 
@@ -50,15 +59,19 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 				continue;
 			}
 			Body2DSW *b = c->get_body_ptr()[i];
+			if (b->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && b->can_report_contacts()) {
+				// Static and kinematic bodies may be part of several islands.
+				r_shared_contacts = true;
+			}
 			if (b->get_island_step() == _step || b->get_mode() == Physics2DServer::BODY_MODE_STATIC || b->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC) {
 				continue; //no go
 			}
-			_populate_island(c->get_body_ptr()[i], p_island, p_constraint_island);
+			_populate_island(c->get_body_ptr()[i], p_island, p_constraint_island, r_shared_contacts);
 		}
 	}
 }
 
-bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
+Constraint2DSW *Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
 	Constraint2DSW *ci = p_island;
 	Constraint2DSW *prev_ci = nullptr;
 	bool removed_root = false;
@@ -79,7 +92,12 @@ bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
 		ci = ci->get_island_next();
 	}
 
-	return removed_root;
+	if (removed_root) {
+		//root from island being deleted no longer exists, replace by next (if any)
+		return p_island->get_island_next();
+	}
+
+	return p_island;
 }
 
 void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta) {
@@ -128,6 +146,20 @@ void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 	}
 }
 
+void Step2DSW::_pre_setup_task(uint32_t p_index, void *p_userdata) {
+	all_constraints[p_index]->pre_setup(island_delta);
+}
+
+void Step2DSW::_setup_island_task(uint32_t p_index, void *p_userdata) {
+	constraint_islands[p_index] = _setup_island(constraint_islands[p_index], island_delta);
+}
+
+void Step2DSW::_solve_island_task(uint32_t p_index, void *p_userdata) {
+	if (constraint_islands[p_index]) {
+		_solve_island(constraint_islands[p_index], island_iterations, island_delta);
+	}
+}
+
 void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	p_space->lock(); // can't access space during this
 
@@ -163,7 +195,8 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	/* GENERATE CONSTRAINT ISLANDS */
 
 	Body2DSW *island_list = nullptr;
-	Constraint2DSW *constraint_island_list = nullptr;
+	constraint_islands.clear();
+	serial_constraint_islands.clear();
 	b = body_list->first();
 
 	int island_count = 0;
@@ -174,14 +207,20 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 		if (body->get_island_step() != _step) {
 			Body2DSW *island = nullptr;
 			Constraint2DSW *constraint_island = nullptr;
-			_populate_island(body, &island, &constraint_island);
+			bool shared_contacts = false;
+			_populate_island(body, &island, &constraint_island, shared_contacts);
 
 			island->set_island_list_next(island_list);
 			island_list = island;
 
 			if (constraint_island) {
-				constraint_island->set_island_list_next(constraint_island_list);
-				constraint_island_list = constraint_island;
+				// Contacts reported to a shared body are added in the order islands are set up,
+				// which is only stable when they are set up on the same thread.
+				if (shared_contacts && deterministic) {
+					serial_constraint_islands.push_back(constraint_island);
+				} else {
+					constraint_islands.push_back(constraint_island);
+				}
 				island_count++;
 			}
 		}
@@ -200,8 +239,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 			}
 			c->set_island_step(_step);
 			c->set_island_next(nullptr);
-			c->set_island_list_next(constraint_island_list);
-			constraint_island_list = c;
+			serial_constraint_islands.push_back(c);
 		}
 		p_space->area_remove_from_moved_list((SelfList<Area2DSW> *)aml.first()); //faster to remove here
 	}
@@ -214,41 +252,47 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		Constraint2DSW *prev_ci = nullptr;
-		while (ci) {
-			if (_setup_island(ci, p_delta)) {
-				//removed the root from the island graph because it is not to be processed
-
-				Constraint2DSW *next = ci->get_island_next();
-
-				if (next) {
-					//root from list being deleted no longer exists, replace by next
-					next->set_island_list_next(ci->get_island_list_next());
-					if (prev_ci) {
-						prev_ci->set_island_list_next(next);
-					} else {
-						constraint_island_list = next;
-					}
-					prev_ci = next;
-				} else {
-					//list is empty, just skip
-					if (prev_ci) {
-						prev_ci->set_island_list_next(ci->get_island_list_next());
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	bool can_thread = pool && pool->get_thread_count() > 0 && (max_threads < 0 || max_threads > 1);
+	uint32_t max_tasks = max_threads > 0 ? max_threads : 0;
+	island_delta = p_delta;
+	island_iterations = p_iterations;
 
-					} else {
-						constraint_island_list = ci->get_island_list_next();
-					}
-				}
-			} else {
-				prev_ci = ci;
-			}
+	all_constraints.clear();
+	for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+		for (Constraint2DSW *ci = constraint_islands[i]; ci; ci = ci->get_island_next()) {
+			all_constraints.push_back(ci);
+		}
+	}
+	for (uint32_t i = 0; i < serial_constraint_islands.size(); i++) {
+		for (Constraint2DSW *ci = serial_constraint_islands[i]; ci; ci = ci->get_island_next()) {
+			all_constraints.push_back(ci);
+		}
+	}
 
-			ci = ci->get_island_list_next();
+	// Narrowphase, each constraint only writes to itself.
+	if (can_thread && all_constraints.size() > 1) {
+		pool->do_parallel_for(all_constraints.size(), this, &Step2DSW::_pre_setup_task, nullptr, 0, max_tasks);
+	} else {
+		for (uint32_t i = 0; i < all_constraints.size(); i++) {
+			all_constraints[i]->pre_setup(p_delta);
 		}
 	}
 
+	// Debug contacts are written to an array shared by the whole space.
+	bool parallel = can_thread && constraint_islands.size() > 1 && !p_space->is_debugging_contacts();
+
+	if (parallel) {
+		pool->do_parallel_for(constraint_islands.size(), this, &Step2DSW::_setup_island_task, nullptr, 0, max_tasks);
+	} else {
+		for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+			constraint_islands[i] = _setup_island(constraint_islands[i], p_delta);
+		}
+	}
+	for (uint32_t i = 0; i < serial_constraint_islands.size(); i++) {
+		serial_constraint_islands[i] = _setup_island(serial_constraint_islands[i], p_delta);
+	}
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_SETUP_CONSTRAINTS, profile_endtime - profile_begtime);
@@ -257,12 +301,19 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
-		Constraint2DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
+	//iterating each island separatedly improves cache efficiency
+	if (parallel) {
+		pool->do_parallel_for(constraint_islands.size(), this, &Step2DSW::_solve_island_task, nullptr, 0, max_tasks);
+	} else {
+		for (uint32_t i = 0; i < constraint_islands.size(); i++) {
+			if (constraint_islands[i]) {
+				_solve_island(constraint_islands[i], p_iterations, p_delta);
+			}
+		}
+	}
+	for (uint32_t i = 0; i < serial_constraint_islands.size(); i++) {
+		if (serial_constraint_islands[i]) {
+			_solve_island(serial_constraint_islands[i], p_iterations, p_delta);
 		}
 	}
 
@@ -303,4 +354,8 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 Step2DSW::Step2DSW() {
 	_step = 1;
+	max_threads = GLOBAL_GET("physics/2d/max_threads");
+	deterministic = GLOBAL_GET("physics/2d/deterministic");
+	island_delta = 0;
+	island_iterations = 0;
 }
@@ -31,16 +31,31 @@
 #ifndef STEP_2D_SW_H
 #define STEP_2D_SW_H
 
+#include "core/local_vector.h"
 #include "space_2d_sw.h"
 
 class Step2DSW {
 	uint64_t _step;
 
-	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
-	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
+	// Collision detection runs for every constraint on the worker pool, then islands are set up and solved there too.
+	// Areas, and islands that report contacts to a shared static or kinematic body when deterministic, stay on the physics thread.
+	LocalVector<Constraint2DSW *> all_constraints;
+	LocalVector<Constraint2DSW *> constraint_islands;
+	LocalVector<Constraint2DSW *> serial_constraint_islands;
+	int max_threads;
+	bool deterministic;
+	real_t island_delta;
+	int island_iterations;
+
+	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island, bool &r_shared_contacts);
+	Constraint2DSW *_setup_island(Constraint2DSW *p_island, real_t p_delta);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
 	void _check_suspend(Body2DSW *p_island, real_t p_delta);
 
+	void _pre_setup_task(uint32_t p_index, void *p_userdata);
+	void _setup_island_task(uint32_t p_index, void *p_userdata);
+	void _solve_island_task(uint32_t p_index, void *p_userdata);
+
 public:
 	void step(Space2DSW *p_space, real_t p_delta, int p_iterations);
 	Step2DSW();
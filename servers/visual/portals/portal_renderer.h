@@ -214,6 +214,7 @@ public:
 	}
 
 	bool is_active() const { return _active && _loaded; }
+	bool is_occlusion_culling_active() const { return _occluder_pool.active_size() && use_occlusion_culling; }
 
 	VSStatic &get_static(int p_id) { return _statics[p_id]; }
 	const VSStatic &get_static(int p_id) const { return _statics[p_id]; }
@@ -31,6 +31,7 @@
 #include "visual_server_scene.h"
 
 #include "core/os/os.h"
+#include "core/os/thread_work_pool.h"
 #include "visual_server_globals.h"
 #include "visual_server_raster.h"
 
@@ -120,6 +121,14 @@ void VisualServerScene::SpatialPartitioningScene_BVH::move(SpatialPartitionID p_
 	_bvh.move(p_handle - 1, p_aabb);
 }
 
+void VisualServerScene::SpatialPartitioningScene_BVH::move_batch(const SpatialPartitionID *p_handles, const AABB *p_aabbs, int p_count) {
+	_move_batch_handles.resize(p_count);
+	for (int n = 0; n < p_count; n++) {
+		_move_batch_handles[n] = p_handles[n] - 1;
+	}
+	_bvh.move_batch(_move_batch_handles.ptr(), p_aabbs, p_count);
+}
+
 void VisualServerScene::SpatialPartitioningScene_BVH::activate(SpatialPartitionID p_handle, const AABB &p_aabb) {
 	// be very careful here, we are deferring the collision check, expecting a set_pairable to be called
 	// immediately after.
@@ -151,6 +160,10 @@ int VisualServerScene::SpatialPartitioningScene_BVH::cull_convex(const Vector<Pl
 	return _bvh.cull_convex(p_convex, p_result_array, p_result_max, p_mask);
 }
 
+int VisualServerScene::SpatialPartitioningScene_BVH::cull_convex_concurrent(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask) {
+	return _bvh.cull_convex_concurrent(p_convex, p_result_array, p_result_max, p_mask);
+}
+
 int VisualServerScene::SpatialPartitioningScene_BVH::cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 	return _bvh.cull_aabb(p_aabb, p_result_array, p_result_max, p_subindex_array, p_mask);
 }
@@ -712,6 +725,8 @@ void VisualServerScene::instance_set_blend_shape_weight(RID p_instance, int p_sh
 
 	if (instance->update_item.in_list()) {
 		_update_dirty_instance(instance);
+		// _update_dirty_instance() only queues the new transformed AABB, apply it right away
+		_update_instance_transforms();
 	}
 
 	ERR_FAIL_INDEX(p_shape, instance->blend_values.size());
@@ -1458,7 +1473,7 @@ int VisualServerScene::_cull_convex_from_point(Scenario *p_scenario, const Vecto
 
 	// fallback to BVH  / octree if portals not active
 	if (res == -1) {
-		res = p_scenario->sps->cull_convex(p_convex, p_result_array, p_result_max, p_mask);
+		res = _cull_convex(p_scenario, p_convex, p_result_array, p_result_max, p_mask);
 
 		// Opportunity for occlusion culling on the main scene. This will be a noop if no occluders.
 		res = p_scenario->_portal_renderer.occlusion_cull(p_point, p_convex, (VSInstance **)p_result_array, res);
@@ -1580,48 +1595,146 @@ void VisualServerScene::_update_instance(Instance *p_instance) {
 		}
 	}
 
-	p_instance->mirror = p_instance->transform.basis.determinant() < 0.0;
+	// the transformed aabb, spatial partitioning and rooms are updated for all the dirty
+	// instances at once, in _update_instance_transforms()
+	_instance_transform_batch.instances.push_back(p_instance);
+}
 
-	AABB new_aabb;
+void VisualServerScene::_update_instance_transforms() {
+	InstanceTransformBatch &batch = _instance_transform_batch;
+	const uint32_t count = batch.instances.size();
+	if (!count) {
+		return;
+	}
 
-	new_aabb = p_instance->transform.xform(p_instance->aabb);
+	batch.data.resize(count * InstanceTransformBatch::COLUMN_MAX);
+	real_t *data = batch.data.ptr();
+
+	real_t *basis[3][3];
+	real_t *origin[3];
+	real_t *aabb_begin[3];
+	real_t *aabb_end[3];
+	real_t *result_begin[3];
+	real_t *result_end[3];
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			basis[i][j] = data + (InstanceTransformBatch::COLUMN_BASIS + i * 3 + j) * count;
+		}
+		origin[i] = data + (InstanceTransformBatch::COLUMN_ORIGIN + i) * count;
+		aabb_begin[i] = data + (InstanceTransformBatch::COLUMN_AABB_BEGIN + i) * count;
+		aabb_end[i] = data + (InstanceTransformBatch::COLUMN_AABB_END + i) * count;
+		result_begin[i] = data + (InstanceTransformBatch::COLUMN_RESULT_BEGIN + i) * count;
+		result_end[i] = data + (InstanceTransformBatch::COLUMN_RESULT_END + i) * count;
+	}
+	real_t *determinant = data + InstanceTransformBatch::COLUMN_DETERMINANT * count;
 
-	p_instance->transformed_aabb = new_aabb;
+	for (uint32_t n = 0; n < count; n++) {
+		const Instance *instance = batch.instances[n];
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				basis[i][j][n] = instance->transform.basis.elements[i][j];
+			}
+			origin[i][n] = instance->transform.origin[i];
+			aabb_begin[i][n] = instance->aabb.position[i];
+			aabb_end[i][n] = instance->aabb.position[i] + instance->aabb.size[i];
+		}
+	}
 
-	if (!p_instance->scenario) {
-		return;
+	// Same as Transform::xform(AABB) and Basis::determinant(), one component at a time over all
+	// the instances, with no branches so the inner loops can be vectorized.
+	for (int i = 0; i < 3; i++) {
+		const real_t *o = origin[i];
+		real_t *r_begin = result_begin[i];
+		real_t *r_end = result_end[i];
+		for (uint32_t n = 0; n < count; n++) {
+			r_begin[n] = o[n];
+			r_end[n] = o[n];
+		}
+		for (int j = 0; j < 3; j++) {
+			const real_t *b = basis[i][j];
+			const real_t *a_begin = aabb_begin[j];
+			const real_t *a_end = aabb_end[j];
+			for (uint32_t n = 0; n < count; n++) {
+				real_t e = b[n] * a_begin[n];
+				real_t f = b[n] * a_end[n];
+				r_begin[n] += e < f ? e : f;
+				r_end[n] += e < f ? f : e;
+			}
+		}
 	}
 
-	if (p_instance->spatial_partition_id == 0) {
-		uint32_t base_type = 1 << p_instance->base_type;
-		uint32_t pairable_mask = 0;
-		bool pairable = false;
+	for (uint32_t n = 0; n < count; n++) {
+		determinant[n] = basis[0][0][n] * (basis[1][1][n] * basis[2][2][n] - basis[2][1][n] * basis[1][2][n]) -
+				basis[1][0][n] * (basis[0][1][n] * basis[2][2][n] - basis[2][1][n] * basis[0][2][n]) +
+				basis[2][0][n] * (basis[0][1][n] * basis[1][2][n] - basis[1][1][n] * basis[0][2][n]);
+	}
+
+	// consecutive moves in the same scenario are sent to the spatial partitioning scheme together
+	Scenario *move_scenario = nullptr;
+
+	for (uint32_t n = 0; n < count; n++) {
+		Instance *instance = batch.instances[n];
+
+		instance->mirror = determinant[n] < 0.0;
+
+		AABB new_aabb;
+		new_aabb.position = Vector3(result_begin[0][n], result_begin[1][n], result_begin[2][n]);
+		new_aabb.size = Vector3(result_end[0][n], result_end[1][n], result_end[2][n]) - new_aabb.position;
 
-		if (p_instance->base_type == VS::INSTANCE_LIGHT || p_instance->base_type == VS::INSTANCE_REFLECTION_PROBE || p_instance->base_type == VS::INSTANCE_LIGHTMAP_CAPTURE) {
-			pairable_mask = p_instance->visible ? VS::INSTANCE_GEOMETRY_MASK : 0;
-			pairable = true;
+		instance->transformed_aabb = new_aabb;
+
+		if (!instance->scenario) {
+			continue;
 		}
 
-		if (p_instance->base_type == VS::INSTANCE_GI_PROBE) {
-			//lights and geometries
-			pairable_mask = p_instance->visible ? VS::INSTANCE_GEOMETRY_MASK | (1 << VS::INSTANCE_LIGHT) : 0;
-			pairable = true;
+		if (instance->spatial_partition_id == 0) {
+			uint32_t base_type = 1 << instance->base_type;
+			uint32_t pairable_mask = 0;
+			bool pairable = false;
+
+			if (instance->base_type == VS::INSTANCE_LIGHT || instance->base_type == VS::INSTANCE_REFLECTION_PROBE || instance->base_type == VS::INSTANCE_LIGHTMAP_CAPTURE) {
+				pairable_mask = instance->visible ? VS::INSTANCE_GEOMETRY_MASK : 0;
+				pairable = true;
+			}
+
+			if (instance->base_type == VS::INSTANCE_GI_PROBE) {
+				//lights and geometries
+				pairable_mask = instance->visible ? VS::INSTANCE_GEOMETRY_MASK | (1 << VS::INSTANCE_LIGHT) : 0;
+				pairable = true;
+			}
+
+			// not inside octree
+			instance->spatial_partition_id = instance->scenario->sps->create(instance, new_aabb, 0, pairable, base_type, pairable_mask);
+
+		} else {
+			if (instance->scenario != move_scenario) {
+				_flush_instance_moves(move_scenario);
+				move_scenario = instance->scenario;
+			}
+
+			batch.move_handles.push_back(instance->spatial_partition_id);
+			batch.move_aabbs.push_back(new_aabb);
 		}
 
-		// not inside octree
-		p_instance->spatial_partition_id = p_instance->scenario->sps->create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
+		// keep rooms and portals instance up to date if present
+		_rooms_instance_update(instance, new_aabb);
+	}
 
-	} else {
-		/*
-		if (new_aabb==p_instance->data.transformed_aabb)
-			return;
-		*/
+	_flush_instance_moves(move_scenario);
+
+	batch.instances.clear();
+}
 
-		p_instance->scenario->sps->move(p_instance->spatial_partition_id, new_aabb);
+void VisualServerScene::_flush_instance_moves(Scenario *p_scenario) {
+	InstanceTransformBatch &batch = _instance_transform_batch;
+	if (!batch.move_handles.size()) {
+		return;
 	}
 
-	// keep rooms and portals instance up to date if present
-	_rooms_instance_update(p_instance, new_aabb);
+	p_scenario->sps->move_batch(batch.move_handles.ptr(), batch.move_aabbs.ptr(), batch.move_handles.size());
+
+	batch.move_handles.clear();
+	batch.move_aabbs.clear();
 }
 
 void VisualServerScene::_update_instance_aabb(Instance *p_instance) {
@@ -1934,14 +2047,94 @@ void VisualServerScene::_update_instance_lightmap_captures(Instance *p_instance)
 	p_instance->lightmap_capture_data.write[0].a = interior ? 0.0f : 1.0f;
 }
 
-bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario) {
+int VisualServerScene::_cull_convex(Scenario *p_scenario, const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask) {
+	if (cull_jobs_concurrent) {
+		return p_scenario->sps->cull_convex_concurrent(p_convex, p_result_array, p_result_max, p_mask);
+	}
+	return p_scenario->sps->cull_convex(p_convex, p_result_array, p_result_max, p_mask);
+}
+
+VisualServerScene::Instance **VisualServerScene::_get_cull_buffer() {
+	// Shadow culls may run on several threads at once, each needs its own buffer.
+	static thread_local LocalVector<Instance *> buffer;
+	if (buffer.size() < MAX_INSTANCE_CULL) {
+		buffer.resize(MAX_INSTANCE_CULL);
+	}
+	return buffer.ptr();
+}
+
+void VisualServerScene::_light_instance_cull_shadow_pass(InstanceLightData::ShadowPass &r_pass, Scenario *p_scenario, const Vector3 &p_point, const Vector<Plane> &p_planes, int32_t &r_previous_room_id_hint, bool p_use_portals) {
+	Instance **cull_result = _get_cull_buffer();
+
+	int cull_count;
+	if (p_use_portals) {
+		cull_count = _cull_convex_from_point(p_scenario, p_point, p_planes, cull_result, MAX_INSTANCE_CULL, r_previous_room_id_hint, VS::INSTANCE_GEOMETRY_MASK);
+	} else {
+		cull_count = _cull_convex(p_scenario, p_planes, cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+	}
+
+	r_pass.cull_result.clear();
+	for (int i = 0; i < cull_count; i++) {
+		Instance *instance = cull_result[i];
+		if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
+			continue;
+		}
+		r_pass.cull_result.push_back(instance);
+	}
+
+	r_pass.active = true;
+}
+
+int VisualServerScene::_light_instance_begin_shadow_cull(Instance *p_instance) {
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
+
+	light->shadow_cube = false;
+
+	switch (VSG::storage->light_get_type(p_instance->base)) {
+		case VS::LIGHT_DIRECTIONAL: {
+			switch (VSG::storage->light_directional_get_shadow_mode(p_instance->base)) {
+				case VS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL:
+					light->shadow_pass_count = 1;
+					break;
+				case VS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_2_SPLITS:
+					light->shadow_pass_count = 2;
+					break;
+				case VS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_4_SPLITS:
+					light->shadow_pass_count = 4;
+					break;
+				default:
+					light->shadow_pass_count = 0;
+			}
+		} break;
+		case VS::LIGHT_OMNI: {
+			VS::LightOmniShadowMode shadow_mode = VSG::storage->light_omni_get_shadow_mode(p_instance->base);
+
+			if (shadow_mode == VS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID || !VSG::scene_render->light_instances_can_render_shadow_cube()) {
+				light->shadow_pass_count = 2;
+			} else {
+				light->shadow_pass_count = 6;
+				light->shadow_cube = true;
+			}
+		} break;
+		case VS::LIGHT_SPOT: {
+			light->shadow_pass_count = 1;
+		} break;
+	}
+
+	for (int i = 0; i < light->shadow_pass_count; i++) {
+		light->shadow_passes[i].active = false;
+	}
+
+	// The splits of a directional light depend on each other, so they are culled together.
+	return VSG::storage->light_get_type(p_instance->base) == VS::LIGHT_DIRECTIONAL ? 1 : light->shadow_pass_count;
+}
+
+void VisualServerScene::_light_instance_cull_shadow(Instance *p_instance, int p_pass, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, Scenario *p_scenario) {
 	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
 
 	Transform light_transform = p_instance->transform;
 	light_transform.orthonormalize(); //scale does not count on lights
 
-	bool animated_material_found = false;
-
 	switch (VSG::storage->light_get_type(p_instance->base)) {
 		case VS::LIGHT_DIRECTIONAL: {
 			float max_distance = p_cam_projection.get_z_far();
@@ -1957,7 +2150,8 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			if (depth_range_mode == VS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
 				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->sps->cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				Instance **cull_result = _get_cull_buffer();
+				int cull_count = _cull_convex(p_scenario, planes, cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
 				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
 				//check distance max and min
 
@@ -1966,15 +2160,11 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 				float z_min = 1e20;
 
 				for (int i = 0; i < cull_count; i++) {
-					Instance *instance = instance_shadow_cull_result[i];
+					Instance *instance = cull_result[i];
 					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 						continue;
 					}
 
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
-
 					float max, min;
 					instance->transformed_aabb.project_range_in_plane(base, min, max);
 
@@ -1997,18 +2187,7 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 
 			float range = max_distance - min_distance;
 
-			int splits = 0;
-			switch (VSG::storage->light_directional_get_shadow_mode(p_instance->base)) {
-				case VS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL:
-					splits = 1;
-					break;
-				case VS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_2_SPLITS:
-					splits = 2;
-					break;
-				case VS::LIGHT_DIRECTIONAL_SHADOW_PARALLEL_4_SPLITS:
-					splits = 4;
-					break;
-			}
+			int splits = light->shadow_pass_count;
 
 			float distances[5];
 
@@ -2161,145 +2340,96 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 				light_frustum_planes.write[4] = Plane(z_vec, z_max + 1e6);
 				light_frustum_planes.write[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->sps->cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
+				InstanceLightData::ShadowPass &pass = light->shadow_passes[i];
+				_light_instance_cull_shadow_pass(pass, p_scenario, light_transform.origin, light_frustum_planes, light->previous_room_id_hint, false);
 
 				// a pre pass will need to be needed to determine the actual z-near to be used
 
-				Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
+				pass.near_plane = Plane(light_transform.origin, -light_transform.basis.get_axis(2));
 
-				for (int j = 0; j < cull_count; j++) {
+				for (uint32_t j = 0; j < pass.cull_result.size(); j++) {
 					float min, max;
-					Instance *instance = instance_shadow_cull_result[j];
-					if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-						cull_count--;
-						SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-						j--;
-						continue;
-					}
-
-					instance->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
+					pass.cull_result[j]->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
 					if (max > z_max) {
 						z_max = max;
 					}
 				}
 
 				{
-					CameraMatrix ortho_camera;
 					real_t half_x = (x_max_cam - x_min_cam) * 0.5;
 					real_t half_y = (y_max_cam - y_min_cam) * 0.5;
 
-					ortho_camera.set_orthogonal(-half_x, half_x, -half_y, half_y, 0, (z_max - z_min_cam));
-
-					Transform ortho_transform;
-					ortho_transform.basis = transform.basis;
-					ortho_transform.origin = x_vec * (x_min_cam + half_x) + y_vec * (y_min_cam + half_y) + z_vec * z_max;
+					pass.camera.set_orthogonal(-half_x, half_x, -half_y, half_y, 0, (z_max - z_min_cam));
 
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, 0, distances[i + 1], i, bias_scale);
+					pass.transform.basis = transform.basis;
+					pass.transform.origin = x_vec * (x_min_cam + half_x) + y_vec * (y_min_cam + half_y) + z_vec * z_max;
+					pass.far = 0;
+					pass.split = distances[i + 1];
+					pass.bias_scale = bias_scale;
 				}
-
-				VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
 			}
 
 		} break;
 		case VS::LIGHT_OMNI: {
-			VS::LightOmniShadowMode shadow_mode = VSG::storage->light_omni_get_shadow_mode(p_instance->base);
-
-			if (shadow_mode == VS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID || !VSG::scene_render->light_instances_can_render_shadow_cube()) {
-				for (int i = 0; i < 2; i++) {
-					//using this one ensures that raster deferred will have it
-
-					float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
-
-					float z = i == 0 ? -1 : 1;
-					Vector<Plane> planes;
-					planes.resize(6);
-					planes.write[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
-					planes.write[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
-					planes.write[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
-					planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
-					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
-					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
-
-					int cull_count = p_scenario->sps->cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, VS::INSTANCE_GEOMETRY_MASK);
-					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
-
-					for (int j = 0; j < cull_count; j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-							cull_count--;
-							SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-							j--;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-
-							instance->depth = near_plane.distance_to(instance->transform.origin);
-							instance->depth_layer = 0;
-						}
-					}
-
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i);
-					VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
-				}
+			float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
+			InstanceLightData::ShadowPass &pass = light->shadow_passes[p_pass];
+
+			if (!light->shadow_cube) {
+				//using this one ensures that raster deferred will have it
+
+				float z = p_pass == 0 ? -1 : 1;
+				Vector<Plane> planes;
+				planes.resize(6);
+				planes.write[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
+				planes.write[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
+				planes.write[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
+				planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
+				planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
+				planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
+
+				_light_instance_cull_shadow_pass(pass, p_scenario, light_transform.origin, planes, light->previous_room_id_hint, false);
+
+				pass.near_plane = Plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
+				pass.camera = CameraMatrix();
+				pass.transform = light_transform;
 			} else { //shadow cube
 
-				float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
 				CameraMatrix cm;
 				cm.set_perspective(90, 1, 0.01, radius);
 
-				for (int i = 0; i < 6; i++) {
-					//using this one ensures that raster deferred will have it
-
-					static const Vector3 view_normals[6] = {
-						Vector3(-1, 0, 0),
-						Vector3(+1, 0, 0),
-						Vector3(0, -1, 0),
-						Vector3(0, +1, 0),
-						Vector3(0, 0, -1),
-						Vector3(0, 0, +1)
-					};
-					static const Vector3 view_up[6] = {
-						Vector3(0, -1, 0),
-						Vector3(0, -1, 0),
-						Vector3(0, 0, -1),
-						Vector3(0, 0, +1),
-						Vector3(0, -1, 0),
-						Vector3(0, -1, 0)
-					};
-
-					Transform xform = light_transform * Transform().looking_at(view_normals[i], view_up[i]);
-
-					Vector<Plane> planes = cm.get_projection_planes(xform);
-
-					int cull_count = _cull_convex_from_point(p_scenario, light_transform.origin, planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, light->previous_room_id_hint, VS::INSTANCE_GEOMETRY_MASK);
-
-					Plane near_plane(xform.origin, -xform.basis.get_axis(2));
-					for (int j = 0; j < cull_count; j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-							cull_count--;
-							SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-							j--;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-							instance->depth = near_plane.distance_to(instance->transform.origin);
-							instance->depth_layer = 0;
-						}
-					}
-
-					VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i);
-					VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
-				}
-
-				//restore the regular DP matrix
-				VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, 0);
+				//using this one ensures that raster deferred will have it
+
+				static const Vector3 view_normals[6] = {
+					Vector3(-1, 0, 0),
+					Vector3(+1, 0, 0),
+					Vector3(0, -1, 0),
+					Vector3(0, +1, 0),
+					Vector3(0, 0, -1),
+					Vector3(0, 0, +1)
+				};
+				static const Vector3 view_up[6] = {
+					Vector3(0, -1, 0),
+					Vector3(0, -1, 0),
+					Vector3(0, 0, -1),
+					Vector3(0, 0, +1),
+					Vector3(0, -1, 0),
+					Vector3(0, -1, 0)
+				};
+
+				Transform xform = light_transform * Transform().looking_at(view_normals[p_pass], view_up[p_pass]);
+
+				Vector<Plane> planes = cm.get_projection_planes(xform);
+
+				_light_instance_cull_shadow_pass(pass, p_scenario, light_transform.origin, planes, light->previous_room_id_hint, true);
+
+				pass.near_plane = Plane(xform.origin, -xform.basis.get_axis(2));
+				pass.camera = cm;
+				pass.transform = xform;
 			}
 
+			pass.far = radius;
+			pass.split = 0;
+			pass.bias_scale = 1.0;
 		} break;
 		case VS::LIGHT_SPOT: {
 			float radius = VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE);
@@ -2309,33 +2439,86 @@ bool VisualServerScene::_light_instance_update_shadow(Instance *p_instance, cons
 			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
 
 			Vector<Plane> planes = cm.get_projection_planes(light_transform);
-			int cull_count = _cull_convex_from_point(p_scenario, light_transform.origin, planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, light->previous_room_id_hint, VS::INSTANCE_GEOMETRY_MASK);
-
-			Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
-			for (int j = 0; j < cull_count; j++) {
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & VS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-					cull_count--;
-					SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
-					j--;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
-				}
-			}
 
-			VSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0);
-			VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+			InstanceLightData::ShadowPass &pass = light->shadow_passes[0];
+			_light_instance_cull_shadow_pass(pass, p_scenario, light_transform.origin, planes, light->previous_room_id_hint, true);
 
+			pass.near_plane = Plane(light_transform.origin, -light_transform.basis.get_axis(2));
+			pass.camera = cm;
+			pass.transform = light_transform;
+			pass.far = radius;
+			pass.split = 0;
+			pass.bias_scale = 1.0;
 		} break;
 	}
+}
+
+bool VisualServerScene::_light_instance_render_shadow(Instance *p_instance, RID p_shadow_atlas) {
+	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
+
+	bool animated_material_found = false;
+
+	for (int i = 0; i < light->shadow_pass_count; i++) {
+		InstanceLightData::ShadowPass &pass = light->shadow_passes[i];
+		if (!pass.active) {
+			continue;
+		}
+
+		// Depth is stored in the instances, so it can only be written once the culls are done.
+		for (uint32_t j = 0; j < pass.cull_result.size(); j++) {
+			Instance *instance = pass.cull_result[j];
+			if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
+				animated_material_found = true;
+			}
+
+			instance->depth = pass.near_plane.distance_to(instance->transform.origin);
+			instance->depth_layer = 0;
+		}
+
+		VSG::scene_render->light_instance_set_shadow_transform(light->instance, pass.camera, pass.transform, pass.far, pass.split, i, pass.bias_scale);
+		VSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)pass.cull_result.ptr(), pass.cull_result.size());
+	}
+
+	if (light->shadow_cube) {
+		//restore the regular DP matrix
+		Transform light_transform = p_instance->transform;
+		light_transform.orthonormalize(); //scale does not count on lights
+		VSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, VSG::storage->light_get_param(p_instance->base, VS::LIGHT_PARAM_RANGE), 0, 0);
+	}
 
 	return animated_material_found;
 }
 
+void VisualServerScene::_cull_job(uint32_t p_index, void *p_userdata) {
+	const CullJob &job = cull_jobs[p_index];
+	if (job.light) {
+		_light_instance_cull_shadow(job.light, job.pass, cull_cam_transform, cull_cam_projection, cull_cam_orthogonal, cull_scenario);
+	} else {
+		instance_cull_count = _cull_convex_from_point(cull_scenario, cull_cam_transform.origin, cull_cam_planes, instance_cull_result, MAX_INSTANCE_CULL, *cull_cam_room_id_hint);
+	}
+}
+
+void VisualServerScene::_run_cull_jobs() {
+	if (cull_jobs_concurrent && cull_jobs.size() > 1) {
+		ThreadWorkPool::get_singleton()->do_parallel_for(cull_jobs.size(), this, &VisualServerScene::_cull_job, nullptr);
+	} else {
+		for (uint32_t i = 0; i < cull_jobs.size(); i++) {
+			_cull_job(i, nullptr);
+		}
+	}
+	cull_jobs.clear();
+}
+
+void VisualServerScene::_add_shadow_cull_jobs(Instance *p_light) {
+	int job_count = _light_instance_begin_shadow_cull(p_light);
+	for (int i = 0; i < job_count; i++) {
+		CullJob job;
+		job.light = p_light;
+		job.pass = i;
+		cull_jobs.push_back(job);
+	}
+}
+
 void VisualServerScene::render_camera(RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
 // render to mono camera
 #ifndef _3D_DISABLED
@@ -2488,7 +2671,52 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 	float z_far = p_cam_projection.get_z_far();
 
 	/* STEP 2 - CULL */
-	instance_cull_count = _cull_convex_from_point(scenario, p_cam_transform.origin, planes, instance_cull_result, MAX_INSTANCE_CULL, r_previous_room_id_hint);
+
+	// The portal renderer and occlusion culling keep state between culls, so they can't cull concurrently.
+	ThreadWorkPool *pool = ThreadWorkPool::get_singleton();
+	cull_jobs_concurrent = pool && pool->get_thread_count() > 0 && scenario->sps->is_concurrent_cull_supported() && !scenario->_portal_renderer.is_active() && !scenario->_portal_renderer.is_occlusion_culling_active();
+	cull_scenario = scenario;
+	cull_cam_transform = p_cam_transform;
+	cull_cam_projection = p_cam_projection;
+	cull_cam_orthogonal = p_cam_orthogonal;
+	cull_cam_planes = planes;
+	cull_cam_room_id_hint = &r_previous_room_id_hint;
+
+	// Directional shadows only depend on the camera, so they are culled at the same time as it.
+	// The slots of the directional lights are reserved in the light cull result before the other lights are known,
+	// so every shadow announced here is also rendered in step 5.
+	Instance **lights_with_shadow = (Instance **)alloca(sizeof(Instance *) * scenario->directional_lights.size());
+	int directional_shadow_count = 0;
+	int directional_light_slots = 0;
+
+	for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
+		if (directional_light_slots >= MAX_LIGHTS_CULLED) {
+			break;
+		}
+
+		if (!E->get()->visible || !E->get()->base_data) {
+			continue;
+		}
+
+		directional_light_slots++;
+		if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(E->get()->base)) {
+			lights_with_shadow[directional_shadow_count++] = E->get();
+		}
+	}
+
+	VSG::scene_render->set_directional_shadow_count(directional_shadow_count);
+
+	CullJob camera_job;
+	camera_job.light = nullptr;
+	camera_job.pass = 0;
+	cull_jobs.push_back(camera_job);
+
+	for (int i = 0; i < directional_shadow_count; i++) {
+		_add_shadow_cull_jobs(lights_with_shadow[i]);
+	}
+
+	_run_cull_jobs();
+
 	light_cull_count = 0;
 
 	reflection_probe_cull_count = 0;
@@ -2515,7 +2743,7 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 		if ((camera_layer_mask & ins->layer_mask) == 0) {
 			//failure
 		} else if (ins->base_type == VS::INSTANCE_LIGHT && ins->visible) {
-			if (light_cull_count < MAX_LIGHTS_CULLED) {
+			if (light_cull_count < MAX_LIGHTS_CULLED - directional_light_slots) {
 				InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
 
 				if (!light->geometries.empty()) {
@@ -2644,8 +2872,7 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 
 	// directional lights
 	{
-		Instance **lights_with_shadow = (Instance **)alloca(sizeof(Instance *) * scenario->directional_lights.size());
-		int directional_shadow_count = 0;
+		int shadow_index = 0;
 
 		for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
 			if (light_cull_count + directional_light_count >= MAX_LIGHTS_CULLED) {
@@ -2661,23 +2888,21 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 			//check shadow..
 
 			if (light) {
-				if (p_shadow_atlas.is_valid() && VSG::storage->light_has_shadow(E->get()->base)) {
-					lights_with_shadow[directional_shadow_count++] = E->get();
+				if (shadow_index < directional_shadow_count && lights_with_shadow[shadow_index] == E->get()) {
+					_light_instance_render_shadow(E->get(), p_shadow_atlas);
+					shadow_index++;
 				}
 				//add to list
 				directional_light_ptr[directional_light_count++] = light->instance;
 			}
 		}
-
-		VSG::scene_render->set_directional_shadow_count(directional_shadow_count);
-
-		for (int i = 0; i < directional_shadow_count; i++) {
-			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
-		}
 	}
 
 	{ //setup shadow maps
 
+		Instance **lights_to_redraw = (Instance **)alloca(sizeof(Instance *) * light_cull_count);
+		int redraw_count = 0;
+
 		//SortArray<Instance*,_InstanceLightsort> sorter;
 		//sorter.sort(light_cull_result,light_cull_count);
 		for (int i = 0; i < light_cull_count; i++) {
@@ -2768,9 +2993,17 @@ void VisualServerScene::_prepare_scene(const Transform p_cam_transform, const Ca
 
 			if (redraw) {
 				//must redraw!
-				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_shadow_atlas, scenario);
+				lights_to_redraw[redraw_count++] = ins;
+				_add_shadow_cull_jobs(ins);
 			}
 		}
+
+		_run_cull_jobs();
+
+		for (int i = 0; i < redraw_count; i++) {
+			InstanceLightData *light = static_cast<InstanceLightData *>(lights_to_redraw[i]->base_data);
+			light->shadow_dirty = _light_instance_render_shadow(lights_to_redraw[i], p_shadow_atlas);
+		}
 	}
 
 	// Calculate instance->depth from the camera, after shadow calculation has stopped overwriting instance->depth
@@ -4014,11 +4247,19 @@ void VisualServerScene::update_dirty_instances() {
 	Scenario *scenario = nullptr;
 	if (_instance_update_list.first()) {
 		scenario = _instance_update_list.first()->self()->scenario;
+	} else if (_instance_transform_batch.instances.size()) {
+		scenario = _instance_transform_batch.instances[0]->scenario;
 	}
 
-	while (_instance_update_list.first()) {
-		_update_dirty_instance(_instance_update_list.first()->self());
-	}
+	// moving instances in the spatial partitioning scheme can pair them and queue more updates,
+	// the batch is flushed even when the list is empty, as instances may have been queued outside of here
+	do {
+		while (_instance_update_list.first()) {
+			_update_dirty_instance(_instance_update_list.first()->self());
+		}
+
+		_update_instance_transforms();
+	} while (_instance_update_list.first());
 
 	if (scenario) {
 		scenario->sps->update();
@@ -4058,6 +4299,12 @@ bool VisualServerScene::free(RID p_rid) {
 
 		update_dirty_instances(); //in case something changed this
 
+		// should already be flushed, but never leave a dangling pointer in the batch
+		int64_t batch_index;
+		while ((batch_index = _instance_transform_batch.instances.find(instance)) >= 0) {
+			_instance_transform_batch.instances.remove(batch_index);
+		}
+
 		instance_owner.free(p_rid);
 		memdelete(instance);
 	} else if (room_owner.owns(p_rid)) {
@@ -4095,6 +4342,12 @@ VisualServerScene::VisualServerScene() {
 
 	render_pass = 1;
 	singleton = this;
+
+	cull_jobs_concurrent = false;
+	cull_scenario = nullptr;
+	cull_cam_orthogonal = false;
+	cull_cam_room_id_hint = nullptr;
+
 	_use_bvh = GLOBAL_DEF("rendering/quality/spatial_partitioning/use_bvh", true);
 	GLOBAL_DEF("rendering/quality/spatial_partitioning/bvh_collision_margin", 0.1);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/quality/spatial_partitioning/bvh_collision_margin", PropertyInfo(Variant::REAL, "rendering/quality/spatial_partitioning/bvh_collision_margin", PROPERTY_HINT_RANGE, "0.0,2.0,0.01"));
@@ -33,6 +33,7 @@
 
 #include "servers/visual/rasterizer.h"
 
+#include "core/local_vector.h"
 #include "core/math/bvh.h"
 #include "core/math/geometry.h"
 #include "core/math/octree.h"
@@ -117,6 +118,11 @@ public:
 		virtual SpatialPartitionID create(Instance *p_userdata, const AABB &p_aabb = AABB(), int p_subindex = 0, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t pairable_mask = 1) = 0;
 		virtual void erase(SpatialPartitionID p_handle) = 0;
 		virtual void move(SpatialPartitionID p_handle, const AABB &p_aabb) = 0;
+		virtual void move_batch(const SpatialPartitionID *p_handles, const AABB *p_aabbs, int p_count) {
+			for (int n = 0; n < p_count; n++) {
+				move(p_handles[n], p_aabbs[n]);
+			}
+		}
 		virtual void activate(SpatialPartitionID p_handle, const AABB &p_aabb) {}
 		virtual void deactivate(SpatialPartitionID p_handle) {}
 		virtual void force_collision_check(SpatialPartitionID p_handle) {}
@@ -127,6 +133,10 @@ public:
 		virtual int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF) = 0;
 		virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF) = 0;
 
+		// can be called from several threads at once, as long as the scene is not modified meanwhile
+		virtual bool is_concurrent_cull_supported() const { return false; }
+		virtual int cull_convex_concurrent(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) { return cull_convex(p_convex, p_result_array, p_result_max, p_mask); }
+
 		typedef void *(*PairCallback)(void *, uint32_t, Instance *, int, uint32_t, Instance *, int);
 		typedef void (*UnpairCallback)(void *, uint32_t, Instance *, int, uint32_t, Instance *, int, void *);
 
@@ -162,12 +172,14 @@ public:
 	class SpatialPartitioningScene_BVH : public SpatialPartitioningScene {
 		// Note that SpatialPartitionIDs are +1 based when stored in visual server, to enable 0 to indicate invalid ID.
 		BVH_Manager<Instance, true, 256> _bvh;
+		LocalVector<uint32_t> _move_batch_handles;
 
 	public:
 		SpatialPartitioningScene_BVH();
 		SpatialPartitionID create(Instance *p_userdata, const AABB &p_aabb = AABB(), int p_subindex = 0, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t p_pairable_mask = 1);
 		void erase(SpatialPartitionID p_handle);
 		void move(SpatialPartitionID p_handle, const AABB &p_aabb);
+		void move_batch(const SpatialPartitionID *p_handles, const AABB *p_aabbs, int p_count);
 		void activate(SpatialPartitionID p_handle, const AABB &p_aabb);
 		void deactivate(SpatialPartitionID p_handle);
 		void force_collision_check(SpatialPartitionID p_handle);
@@ -177,6 +189,8 @@ public:
 		int cull_convex(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
 		int cull_aabb(const AABB &p_aabb, Instance **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF);
 		int cull_segment(const Vector3 &p_from, const Vector3 &p_to, Instance **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF);
+		bool is_concurrent_cull_supported() const { return true; }
+		int cull_convex_concurrent(const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
 		void set_pair_callback(PairCallback p_callback, void *p_userdata);
 		void set_unpair_callback(UnpairCallback p_callback, void *p_userdata);
 
@@ -309,6 +323,30 @@ public:
 	SelfList<Instance>::List _instance_update_list;
 	void _instance_queue_update(Instance *p_instance, bool p_update_aabb, bool p_update_materials = false);
 
+	// Instances whose transformed AABB is recalculated together at the end of update_dirty_instances().
+	// Their transforms and AABBs are copied as a structure of arrays (one column per component, see
+	// _update_instance_transforms()), so the AABB transform loop can be vectorized by the compiler.
+	struct InstanceTransformBatch {
+		enum {
+			COLUMN_BASIS = 0, // 9 columns, row major
+			COLUMN_ORIGIN = 9, // 3 columns
+			COLUMN_AABB_BEGIN = 12,
+			COLUMN_AABB_END = 15,
+			COLUMN_RESULT_BEGIN = 18,
+			COLUMN_RESULT_END = 21,
+			COLUMN_DETERMINANT = 24,
+			COLUMN_MAX = 25,
+		};
+
+		LocalVector<Instance *> instances;
+		LocalVector<real_t> data;
+		// scratch for the moves sent to the spatial partitioning scheme
+		LocalVector<SpatialPartitionID> move_handles;
+		LocalVector<AABB> move_aabbs;
+	};
+
+	InstanceTransformBatch _instance_transform_batch;
+
 	struct InstanceGeometryData : public InstanceBaseData {
 		List<Instance *> lighting;
 		bool lighting_dirty;
@@ -375,7 +413,26 @@ public:
 		Instance *baked_light;
 		int32_t previous_room_id_hint;
 
+		// Shadows are culled before any of them is rendered, so the culls can run in parallel.
+		// Each pass is only written by the cull of that pass (or of the whole light, for directional lights).
+		struct ShadowPass {
+			bool active;
+			LocalVector<Instance *> cull_result;
+			Plane near_plane;
+			CameraMatrix camera;
+			Transform transform;
+			float far;
+			float split;
+			float bias_scale;
+		};
+
+		ShadowPass shadow_passes[6];
+		int shadow_pass_count;
+		bool shadow_cube;
+
 		InstanceLightData() {
+			shadow_pass_count = 0;
+			shadow_cube = false;
 			shadow_dirty = true;
 			D = nullptr;
 			last_version = 0;
@@ -501,7 +558,6 @@ public:
 
 	int instance_cull_count;
 	Instance *instance_cull_result[MAX_INSTANCE_CULL];
-	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
 	Instance *light_cull_result[MAX_LIGHTS_CULLED];
 	RID light_instance_cull_result[MAX_LIGHTS_CULLED];
 	int light_cull_count;
@@ -509,6 +565,22 @@ public:
 	RID reflection_probe_instance_cull_result[MAX_REFLECTION_PROBES_CULLED];
 	int reflection_probe_cull_count;
 
+	// Culls done by _prepare_scene(), run on the worker pool when the scenario supports concurrent culling.
+	// A job without light culls the camera into instance_cull_result.
+	struct CullJob {
+		Instance *light;
+		int pass;
+	};
+
+	LocalVector<CullJob> cull_jobs;
+	bool cull_jobs_concurrent;
+	Scenario *cull_scenario;
+	Transform cull_cam_transform;
+	CameraMatrix cull_cam_projection;
+	bool cull_cam_orthogonal;
+	Vector<Plane> cull_cam_planes;
+	int32_t *cull_cam_room_id_hint;
+
 	RID_Owner<Instance> instance_owner;
 
 	virtual RID instance_create();
@@ -697,9 +769,20 @@ public:
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
+	void _update_instance_transforms();
+	void _flush_instance_moves(Scenario *p_scenario);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
-	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_shadow_atlas, Scenario *p_scenario);
+	int _cull_convex(Scenario *p_scenario, const Vector<Plane> &p_convex, Instance **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	static Instance **_get_cull_buffer();
+	void _light_instance_cull_shadow_pass(InstanceLightData::ShadowPass &r_pass, Scenario *p_scenario, const Vector3 &p_point, const Vector<Plane> &p_planes, int32_t &r_previous_room_id_hint, bool p_use_portals);
+	int _light_instance_begin_shadow_cull(Instance *p_instance);
+	void _light_instance_cull_shadow(Instance *p_instance, int p_pass, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, Scenario *p_scenario);
+	bool _light_instance_render_shadow(Instance *p_instance, RID p_shadow_atlas);
+
+	void _cull_job(uint32_t p_index, void *p_userdata);
+	void _run_cull_jobs();
+	void _add_shadow_cull_jobs(Instance *p_light);
 
 	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int32_t &r_previous_room_id_hint);
 	void _render_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, const int p_eye, bool p_cam_orthogonal, RID p_force_environment, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);